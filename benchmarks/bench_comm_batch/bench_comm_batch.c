@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "master_comm.h"
+#include "slave_comm.h"
+#include "state_mashine_types.h"
+#include "logger_timestamp.h"
+#include "comm_cfg.h"
+
+/**
+ * @file bench_comm_batch.c
+ * @brief Measures the slave-to-master throughput of the single and batched comm API.
+ *
+ * A slave task sends a fixed number of messages with sendMsgSlave() or
+ * sendMsgBatchSlave() and a master task receives them with reciveMsgMaster() or
+ * reciveMsgBatchMaster(). Each mode runs with the DELAY_SEND_MS pacing policy and
+ * without pacing. The channels are FIFO queues (mailboxes would drop messages),
+ * so every message sent is delivered.
+ *
+ * Reported per run: messages delivered, elapsed time and messages per second.
+ */
+
+#define BENCH_CHANNEL_LENGTH 64
+#define BENCH_BATCH_SIZE     32
+#define BENCH_PACED_MESSAGES 200u    // Paced single sends take about DELAY_SEND_MS each
+#define BENCH_FAST_MESSAGES  200000u
+
+/**
+ * @brief One benchmark run.
+ *
+ * - name: Label printed with the results.
+ * - batched: Set to use the batch API on both sides.
+ * - pacingMs: Send pacing delay (in ms), 0 for none.
+ * - messages: Number of messages to move.
+ */
+typedef struct {
+    const char *name;
+    uint8_t batched;
+    uint32_t pacingMs;
+    uint32_t messages;
+} BenchRun;
+
+static const BenchRun *run_ = NULL;
+static TaskHandle_t benchTask_ = NULL;
+
+/**
+ * @brief Called by configASSERT() when an assertion fails.
+ */
+void vAssertCalled(const char * const pcFileName, unsigned long ulLine) {
+    fprintf(stderr, "configASSERT failed at %s:%lu\n", pcFileName, ulLine);
+    abort();
+}
+
+static void vBenchSender(void *args) {
+    CommMessage messages[BENCH_BATCH_SIZE];
+    for (uint32_t i = 0; i < BENCH_BATCH_SIZE; i++) {
+        messages[i] = (CommMessage){COMM_MSG_SLAVE_STATE, COMM_SOURCE_SLAVE, 0, SLAVE_STATE_ACTIVE};
+    }
+
+    uint32_t remaining = run_->messages;
+    while (remaining > 0) {
+        if (run_->batched) {
+            uint32_t count = (remaining < BENCH_BATCH_SIZE) ? remaining : BENCH_BATCH_SIZE;
+            uint32_t sent = 0;
+            (void)sendMsgBatchSlave(messages, count, &sent);
+            remaining -= sent;
+        } else if (sendMsgSlave(&messages[0]) == RET_OK) {
+            remaining--;
+        }
+    }
+    vTaskDelete(NULL);
+}
+
+static void vBenchReceiver(void *args) {
+    CommMessage messages[BENCH_BATCH_SIZE];
+    uint32_t delivered = 0;
+
+    while (delivered < run_->messages) {
+        if (run_->batched) {
+            uint32_t received = 0;
+            (void)reciveMsgBatchMaster(messages, BENCH_BATCH_SIZE, &received);
+            delivered += received;
+        } else if (reciveMsgMaster(&messages[0]) == RET_OK) {
+            delivered++;
+        }
+    }
+    xTaskNotifyGive(benchTask_);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Moves run->messages messages from the slave to the master and prints the throughput.
+ */
+static void runBench(const BenchRun *run) {
+    run_ = run;
+    setSendPacingSlave(run->pacingMs);
+
+    uint64_t start = logTimestampMonotonicNs();
+    if (xTaskCreate(vBenchReceiver, "BenchRx", configMINIMAL_STACK_SIZE * 4, NULL, 1, NULL) != pdPASS ||
+        xTaskCreate(vBenchSender, "BenchTx", configMINIMAL_STACK_SIZE * 4, NULL, 1, NULL) != pdPASS) {
+        fprintf(stderr, "Failed to create the benchmark tasks\n");
+        exit(1);
+    }
+    (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    double seconds = (double)(logTimestampMonotonicNs() - start) / 1e9;
+
+    printf("%-8s pacing %3u ms  %7u messages in %7.3f s  %11.0f msg/s\n", run->name, run->pacingMs,
+           run->messages, seconds, (double)run->messages / seconds);
+}
+
+static void vBenchTask(void *args) {
+    static const BenchRun runs[] = {
+        {"single", 0, DELAY_SEND_MS, BENCH_PACED_MESSAGES},
+        {"single", 0, 0, BENCH_FAST_MESSAGES},
+        {"batch", 1, DELAY_SEND_MS, BENCH_PACED_MESSAGES * BENCH_BATCH_SIZE},
+        {"batch", 1, 0, BENCH_FAST_MESSAGES},
+    };
+
+    benchTask_ = xTaskGetCurrentTaskHandle();
+    QueueHandle_t masterToSlave = xQueueCreate(BENCH_CHANNEL_LENGTH, sizeof(CommMessage));
+    QueueHandle_t slaveToMaster = xQueueCreate(BENCH_CHANNEL_LENGTH, sizeof(CommMessage));
+    if (initMasterComm(masterToSlave, slaveToMaster) != RET_OK ||
+        initSlaveComm(slaveToMaster, masterToSlave) != RET_OK) {
+        fprintf(stderr, "Failed to create the queues\n");
+        exit(1);
+    }
+
+    printf("Slave-to-master throughput (channel length %d, batch size %d)\n", BENCH_CHANNEL_LENGTH,
+           BENCH_BATCH_SIZE);
+    for (uint32_t i = 0; i < sizeof(runs) / sizeof(runs[0]); i++) {
+        runBench(&runs[i]);
+    }
+    exit(0);
+}
+
+int main(void) {
+    if (xTaskCreate(vBenchTask, "Bench", configMINIMAL_STACK_SIZE * 4, NULL, 2, NULL) != pdPASS) {
+        return 1;
+    }
+    vTaskStartScheduler();
+    return 0;
+}
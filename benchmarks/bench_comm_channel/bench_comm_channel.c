@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "master_comm.h"
+#include "slave_comm.h"
+#include "state_mashine_types.h"
+#include "logger_timestamp.h"
+#include "comm_cfg.h"
+
+/**
+ * @file bench_comm_channel.c
+ * @brief Compares the shared state queue with the directional typed channels.
+ *
+ * Both runs use the same traffic: a master task and a slave task each send
+ * their state every DELAY_SEND_MS, and a receiver task on each side blocks on
+ * its channel. The shared run reproduces the previous wiring (one 1-byte queue
+ * used by both sides in both directions); the origin of a message is tagged in
+ * its high bit for accounting only. The directional run uses sendMsgMaster(),
+ * reciveMsgMaster(), sendMsgSlave() and reciveMsgSlave(); with COMM_STATE_MAILBOX
+ * its channels are latest-value mailboxes and overwritten states are skipped.
+ *
+ * Reported per run: slave messages sent, slave messages that reached the
+ * master, messages consumed by their own sender (misdelivered) and the
+ * slave-to-master propagation latency.
+ */
+
+#define BENCH_DURATION_MS 3000
+#define BENCH_QUEUE_LENGTH 10
+
+/* xQueueOverwrite() requires a queue of length 1 */
+#if COMM_STATE_MAILBOX
+#define BENCH_CHANNEL_LENGTH 1
+#else
+#define BENCH_CHANNEL_LENGTH BENCH_QUEUE_LENGTH
+#endif
+#define BENCH_SLOTS       128u // Send-time slots, indexed by sequence number
+#define BENCH_MAX_SAMPLES 4096u
+#define BENCH_SLAVE_FLAG  0x80u
+
+typedef struct {
+    volatile uint32_t sent;
+    volatile uint32_t delivered;
+    volatile uint32_t misdelivered;
+    uint64_t sentAtNs[BENCH_SLOTS];
+    uint64_t latencyNs[BENCH_MAX_SAMPLES];
+} BenchStats;
+
+static BenchStats stats_;
+static QueueHandle_t sharedQueue_ = NULL;
+
+/**
+ * @brief Called by configASSERT() when an assertion fails.
+ */
+void vAssertCalled(const char * const pcFileName, unsigned long ulLine) {
+    fprintf(stderr, "configASSERT failed at %s:%lu\n", pcFileName, ulLine);
+    abort();
+}
+
+static void recordDelivery(uint32_t sequence) {
+    uint32_t index = stats_.delivered++;
+    if (index < BENCH_MAX_SAMPLES) {
+        stats_.latencyNs[index] = logTimestampMonotonicNs() - stats_.sentAtNs[sequence % BENCH_SLOTS];
+    }
+}
+
+/* Shared queue, as wired before the directional channels */
+
+static void vSharedMasterSender(void *args) {
+    while (1) {
+        uint8_t data = MASTESR_STATE_PROCESSING;
+        (void)xQueueSend(sharedQueue_, &data, pdMS_TO_TICKS(TICK_TO_WAIT_SEND_MS));
+        vTaskDelay(pdMS_TO_TICKS(DELAY_SEND_MS));
+    }
+}
+
+static void vSharedSlaveSender(void *args) {
+    while (1) {
+        uint32_t sequence = stats_.sent;
+        stats_.sentAtNs[sequence % BENCH_SLOTS] = logTimestampMonotonicNs();
+        uint8_t data = (uint8_t)(BENCH_SLAVE_FLAG | (sequence % BENCH_SLOTS));
+        if (xQueueSend(sharedQueue_, &data, pdMS_TO_TICKS(TICK_TO_WAIT_SEND_MS)) == pdPASS) {
+            stats_.sent++;
+        }
+        vTaskDelay(pdMS_TO_TICKS(DELAY_SEND_MS));
+    }
+}
+
+static void vSharedMasterReceiver(void *args) {
+    uint8_t data;
+    while (1) {
+        if (xQueueReceive(sharedQueue_, &data, portMAX_DELAY) == pdPASS) {
+            if (data & BENCH_SLAVE_FLAG) {
+                recordDelivery(data & ~BENCH_SLAVE_FLAG);
+            } else {
+                stats_.misdelivered++;
+            }
+        }
+    }
+}
+
+static void vSharedSlaveReceiver(void *args) {
+    uint8_t data;
+    while (1) {
+        if (xQueueReceive(sharedQueue_, &data, portMAX_DELAY) == pdPASS && (data & BENCH_SLAVE_FLAG)) {
+            stats_.misdelivered++;
+        }
+    }
+}
+
+/* Directional channels */
+
+static void vChannelMasterSender(void *args) {
+    CommMessage message = {COMM_MSG_MASTER_STATE, COMM_SOURCE_MASTER, 0, MASTESR_STATE_PROCESSING};
+    while (1) {
+        (void)sendMsgMaster(&message); // Delays DELAY_SEND_MS after sending
+    }
+}
+
+static void vChannelSlaveSender(void *args) {
+    CommMessage message = {COMM_MSG_SLAVE_STATE, COMM_SOURCE_SLAVE, 0, SLAVE_STATE_ACTIVE};
+    while (1) {
+        // The comm module numbers messages from 0, one per successful send
+        stats_.sentAtNs[stats_.sent % BENCH_SLOTS] = logTimestampMonotonicNs();
+        if (sendMsgSlave(&message) == RET_OK) {
+            stats_.sent++;
+        }
+    }
+}
+
+static void vChannelMasterReceiver(void *args) {
+    CommMessage message;
+    while (1) {
+        if (reciveMsgMaster(&message) == RET_OK) {
+            recordDelivery(message.sequence);
+        } else {
+            stats_.misdelivered++;
+        }
+    }
+}
+
+static void vChannelSlaveReceiver(void *args) {
+    CommMessage message;
+    while (1) {
+        if (reciveMsgSlave(&message) != RET_OK) {
+            stats_.misdelivered++;
+        }
+    }
+}
+
+static int compareLatency(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Runs four tasks for BENCH_DURATION_MS and prints the statistics.
+ */
+static void runScenario(const char *name, TaskFunction_t tasks[4]) {
+    static const char *const names[4] = {"BenchMasterTx", "BenchSlaveTx", "BenchMasterRx", "BenchSlaveRx"};
+    TaskHandle_t handles[4] = {NULL, NULL, NULL, NULL};
+
+    memset(&stats_, 0, sizeof(stats_));
+    for (int i = 0; i < 4; i++) {
+        if (xTaskCreate(tasks[i], names[i], configMINIMAL_STACK_SIZE * 4, NULL, 1, &handles[i]) != pdPASS) {
+            fprintf(stderr, "Failed to create %s\n", names[i]);
+            exit(1);
+        }
+    }
+    vTaskDelay(pdMS_TO_TICKS(BENCH_DURATION_MS));
+    for (int i = 0; i < 4; i++) {
+        vTaskDelete(handles[i]);
+    }
+
+    uint32_t samples = (stats_.delivered < BENCH_MAX_SAMPLES) ? stats_.delivered : BENCH_MAX_SAMPLES;
+    qsort(stats_.latencyNs, samples, sizeof(stats_.latencyNs[0]), compareLatency);
+    double p50 = samples ? (double)stats_.latencyNs[samples / 2] / 1000.0 : 0.0;
+    double p99 = samples ? (double)stats_.latencyNs[(samples * 99) / 100] / 1000.0 : 0.0;
+    printf("%-12s sent %5u  delivered %5u  misdelivered %5u  latency p50 %9.1f us  p99 %9.1f us\n", name,
+           stats_.sent, stats_.delivered, stats_.misdelivered, p50, p99);
+}
+
+static void vBenchTask(void *args) {
+    TaskFunction_t shared[4] = {vSharedMasterSender, vSharedSlaveSender, vSharedMasterReceiver, vSharedSlaveReceiver};
+    TaskFunction_t channels[4] = {vChannelMasterSender, vChannelSlaveSender, vChannelMasterReceiver,
+                                  vChannelSlaveReceiver};
+
+    sharedQueue_ = xQueueCreate(BENCH_QUEUE_LENGTH, sizeof(uint8_t));
+    QueueHandle_t masterToSlave = xQueueCreate(BENCH_CHANNEL_LENGTH, sizeof(CommMessage));
+    QueueHandle_t slaveToMaster = xQueueCreate(BENCH_CHANNEL_LENGTH, sizeof(CommMessage));
+    if (sharedQueue_ == NULL || initMasterComm(masterToSlave, slaveToMaster) != RET_OK ||
+        initSlaveComm(slaveToMaster, masterToSlave) != RET_OK) {
+        fprintf(stderr, "Failed to create the queues\n");
+        exit(1);
+    }
+
+    printf("Slave-to-master state propagation over %d ms (send pacing %d ms)\n", BENCH_DURATION_MS, DELAY_SEND_MS);
+    runScenario("shared", shared);
+    runScenario("directional", channels);
+    printf("%-12s skipped by the master %u, by the slave %u\n", "", getSkippedMsgMaster(), getSkippedMsgSlave());
+    exit(0);
+}
+
+int main(void) {
+    if (xTaskCreate(vBenchTask, "Bench", configMINIMAL_STACK_SIZE * 4, NULL, 2, NULL) != pdPASS) {
+        return 1;
+    }
+    vTaskStartScheduler();
+    return 0;
+}
@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "comm_pipeline.h"
+#include "logger_timestamp.h"
+#include "comm_cfg.h"
+
+/**
+ * @file bench_comm_pipeline.c
+ * @brief Measures the sustained throughput of the payload pipeline.
+ *
+ * A producer task publishes BENCH_STREAM_BYTES of payloads of one size to one
+ * or two consumer tasks, waiting for space as long as needed, and the run
+ * reports payloads and bytes per second. The lossy run publishes with the
+ * publish wait of the application, COMM_PIPELINE_PUBLISH_WAIT_MS, to a fast
+ * consumer and one that stalls longer than that periodically, and reports
+ * how many payloads each of them lost.
+ */
+
+#define BENCH_STREAM_BYTES   (64u * 1024u * 1024u)
+#define BENCH_LOSSY_PAYLOADS 50000u
+#define BENCH_LOSSY_SIZE     256u
+#define BENCH_STALL_EVERY    1024u
+#define BENCH_STALL_MS       50u
+#define BENCH_IDLE_MS        50u
+
+static CommPipeline pipeline_;
+static TaskHandle_t benchTask_ = NULL;
+static uint32_t payloadSize_ = 0;
+static uint32_t payloadCount_ = 0;
+static TickType_t publishWait_ = portMAX_DELAY;
+static uint8_t lossy_ = 0;
+static volatile uint8_t producerDone_ = 0;
+static uint32_t received_[COMM_PIPELINE_MAX_CONSUMERS];
+static uint32_t outOfOrder_[COMM_PIPELINE_MAX_CONSUMERS];
+
+/**
+ * @brief Called by configASSERT() when an assertion fails.
+ */
+void vAssertCalled(const char * const pcFileName, unsigned long ulLine) {
+    fprintf(stderr, "configASSERT failed at %s:%lu\n", pcFileName, ulLine);
+    abort();
+}
+
+/**
+ * @brief Publishes payloadCount_ payloads that start with their sequence number.
+ */
+static void vProducer(void *args) {
+    static uint8_t payload[COMM_PIPELINE_MAX_PAYLOAD];
+
+    memset(payload, 0xa5, sizeof(payload));
+    for (uint32_t i = 0; i < payloadCount_; i++) {
+        memcpy(payload, &i, sizeof(i));
+        (void)commPipelinePublish(&pipeline_, payload, payloadSize_, publishWait_);
+    }
+    producerDone_ = 1;
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Receives payloads until the producer is done and the buffer stays empty.
+ *
+ * The consumer index is passed as the task argument; in the lossy run
+ * consumer 1 stalls every BENCH_STALL_EVERY payloads.
+ */
+static void vConsumer(void *args) {
+    static uint8_t payloads[COMM_PIPELINE_MAX_CONSUMERS][COMM_PIPELINE_MAX_PAYLOAD];
+    uint32_t consumer = (uint32_t)(uintptr_t)args;
+    uint32_t length = 0;
+    uint32_t last = 0;
+    uint32_t sequence = 0;
+
+    while (1) {
+        if (commPipelineReceive(&pipeline_, consumer, payloads[consumer], COMM_PIPELINE_MAX_PAYLOAD, &length,
+                                pdMS_TO_TICKS(BENCH_IDLE_MS)) != RET_OK) {
+            if (producerDone_) {
+                break;
+            }
+            continue;
+        }
+        memcpy(&sequence, payloads[consumer], sizeof(sequence));
+        outOfOrder_[consumer] += (received_[consumer] != 0 && sequence <= last) || length != payloadSize_;
+        last = sequence;
+        received_[consumer]++;
+        if (lossy_ && consumer == 1 && received_[consumer] % BENCH_STALL_EVERY == 0) {
+            vTaskDelay(pdMS_TO_TICKS(BENCH_STALL_MS));
+        }
+        if (!lossy_ && received_[consumer] == payloadCount_) {
+            break;
+        }
+    }
+    xTaskNotifyGive(benchTask_);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Runs the producer and consumerCount consumers over a new pipeline.
+ *
+ * @return Elapsed time in seconds, until the last consumer finished.
+ */
+static double runPipeline(uint32_t consumerCount) {
+    if (commPipelineInit(&pipeline_, consumerCount) != RET_OK) {
+        fprintf(stderr, "Failed to create the pipeline\n");
+        exit(1);
+    }
+    producerDone_ = 0;
+    memset(received_, 0, sizeof(received_));
+    memset(outOfOrder_, 0, sizeof(outOfOrder_));
+
+    uint64_t start = logTimestampMonotonicNs();
+    for (uint32_t i = 0; i < consumerCount; i++) {
+        if (xTaskCreate(vConsumer, "BenchConsumer", configMINIMAL_STACK_SIZE * 4, (void *)(uintptr_t)i, 1,
+                        NULL) != pdPASS) {
+            fprintf(stderr, "Failed to create the benchmark tasks\n");
+            exit(1);
+        }
+    }
+    if (xTaskCreate(vProducer, "BenchProducer", configMINIMAL_STACK_SIZE * 4, NULL, 1, NULL) != pdPASS) {
+        fprintf(stderr, "Failed to create the benchmark tasks\n");
+        exit(1);
+    }
+    for (uint32_t i = 0; i < consumerCount; i++) {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+    double seconds = (double)(logTimestampMonotonicNs() - start) / 1e9;
+
+    for (uint32_t i = 0; i < consumerCount; i++) {
+        if (outOfOrder_[i] != 0) {
+            fprintf(stderr, "Consumer %u got %u payloads out of order or truncated\n", i, outOfOrder_[i]);
+        }
+        vMessageBufferDelete(pipeline_.buffers[i]);
+    }
+    vTaskDelay(pdMS_TO_TICKS(10)); // Let the tasks finish before the next run
+    return seconds;
+}
+
+static void vBenchTask(void *args) {
+    static const uint32_t sizes[] = {64, 256, COMM_PIPELINE_MAX_PAYLOAD};
+
+    benchTask_ = xTaskGetCurrentTaskHandle();
+    printf("Pipeline of %u-byte message buffers: %u MiB streamed per run\n", COMM_PIPELINE_BUFFER_SIZE,
+           BENCH_STREAM_BYTES / (1024u * 1024u));
+
+    publishWait_ = portMAX_DELAY;
+    for (uint32_t consumers = 1; consumers <= 2; consumers++) {
+        for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+            payloadSize_ = sizes[i];
+            payloadCount_ = BENCH_STREAM_BYTES / payloadSize_;
+            double seconds = runPipeline(consumers);
+            printf("%u consumer(s) %5u B  %11.0f payloads/s  %8.1f MiB/s\n", consumers, payloadSize_,
+                   (double)payloadCount_ / seconds, (double)BENCH_STREAM_BYTES / seconds / (1024.0 * 1024.0));
+        }
+    }
+
+    lossy_ = 1;
+    publishWait_ = pdMS_TO_TICKS(COMM_PIPELINE_PUBLISH_WAIT_MS);
+    payloadSize_ = BENCH_LOSSY_SIZE;
+    payloadCount_ = BENCH_LOSSY_PAYLOADS;
+    double seconds = runPipeline(2);
+    printf("Lossy run, %u payloads of %u B in %.2f s, consumer 1 stalls %u ms every %u payloads:\n",
+           payloadCount_, payloadSize_, seconds, BENCH_STALL_MS, BENCH_STALL_EVERY);
+    for (uint32_t i = 0; i < 2; i++) {
+        printf("  consumer %u received %u, dropped %u\n", i, received_[i], commPipelineDropped(&pipeline_, i));
+    }
+    exit(0);
+}
+
+int main(void) {
+    if (xTaskCreate(vBenchTask, "Bench", configMINIMAL_STACK_SIZE * 4, NULL, 2, NULL) != pdPASS) {
+        return 1;
+    }
+    vTaskStartScheduler();
+    return 0;
+}
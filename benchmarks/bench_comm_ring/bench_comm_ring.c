@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "comm_ring.h"
+#include "logger_timestamp.h"
+#include "comm_cfg.h"
+
+/**
+ * @file bench_comm_ring.c
+ * @brief Compares the lock-free ring channel with a FreeRTOS queue.
+ *
+ * Both transports carry CommMessage items and hold COMM_RING_LENGTH of them.
+ * The throughput run streams BENCH_STREAM_MESSAGES messages from a producer
+ * task to a consumer task. The latency run bounces one message between two
+ * tasks over a pair of channels BENCH_PING_PONGS times and reports the round
+ * trip time.
+ */
+
+#define BENCH_STREAM_MESSAGES 1000000u
+#define BENCH_PING_PONGS      20000u
+
+/**
+ * @brief Transport under test.
+ *
+ * - name: Label printed with the results.
+ * - send: Sends on channel 0 or 1, blocking until there is space.
+ * - receive: Receives from channel 0 or 1, blocking until there is a message.
+ */
+typedef struct {
+    const char *name;
+    void (*send)(uint32_t channel, const CommMessage *message);
+    void (*receive)(uint32_t channel, CommMessage *message);
+} BenchTransport;
+
+static QueueHandle_t queues_[2];
+static CommRing rings_[2];
+static const BenchTransport *transport_ = NULL;
+static TaskHandle_t benchTask_ = NULL;
+static uint64_t roundTripNs_[BENCH_PING_PONGS];
+
+/**
+ * @brief Called by configASSERT() when an assertion fails.
+ */
+void vAssertCalled(const char * const pcFileName, unsigned long ulLine) {
+    fprintf(stderr, "configASSERT failed at %s:%lu\n", pcFileName, ulLine);
+    abort();
+}
+
+static void queueSendBench(uint32_t channel, const CommMessage *message) {
+    (void)xQueueSend(queues_[channel], message, portMAX_DELAY);
+}
+
+static void queueReceiveBench(uint32_t channel, CommMessage *message) {
+    (void)xQueueReceive(queues_[channel], message, portMAX_DELAY);
+}
+
+static void ringSendBench(uint32_t channel, const CommMessage *message) {
+    (void)commRingSend(&rings_[channel], message, portMAX_DELAY);
+}
+
+static void ringReceiveBench(uint32_t channel, CommMessage *message) {
+    (void)commRingReceive(&rings_[channel], message, portMAX_DELAY);
+}
+
+static void vStreamProducer(void *args) {
+    CommMessage message = {COMM_MSG_SLAVE_STATE, COMM_SOURCE_SLAVE, 0, 0};
+    for (uint32_t i = 0; i < BENCH_STREAM_MESSAGES; i++) {
+        message.payload = (int32_t)i;
+        transport_->send(0, &message);
+    }
+    vTaskDelete(NULL);
+}
+
+static void vStreamConsumer(void *args) {
+    CommMessage message;
+    uint32_t outOfOrder = 0;
+    for (uint32_t i = 0; i < BENCH_STREAM_MESSAGES; i++) {
+        transport_->receive(0, &message);
+        outOfOrder += (message.payload != (int32_t)i);
+    }
+    if (outOfOrder != 0) {
+        fprintf(stderr, "%s delivered %u messages out of order\n", transport_->name, outOfOrder);
+    }
+    xTaskNotifyGive(benchTask_);
+    vTaskDelete(NULL);
+}
+
+static void vPinger(void *args) {
+    CommMessage message = {COMM_MSG_MASTER_STATE, COMM_SOURCE_MASTER, 0, 0};
+    for (uint32_t i = 0; i < BENCH_PING_PONGS; i++) {
+        uint64_t start = logTimestampMonotonicNs();
+        transport_->send(0, &message);
+        transport_->receive(1, &message);
+        roundTripNs_[i] = logTimestampMonotonicNs() - start;
+    }
+    xTaskNotifyGive(benchTask_);
+    vTaskDelete(NULL);
+}
+
+static void vPonger(void *args) {
+    CommMessage message;
+    for (uint32_t i = 0; i < BENCH_PING_PONGS; i++) {
+        transport_->receive(0, &message);
+        transport_->send(1, &message);
+    }
+    vTaskDelete(NULL);
+}
+
+static int compareLatency(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Starts two tasks and waits for the one that notifies the end of the run.
+ *
+ * @return Elapsed time in seconds.
+ */
+static double runTasks(TaskFunction_t first, TaskFunction_t second) {
+    uint64_t start = logTimestampMonotonicNs();
+    if (xTaskCreate(first, "BenchA", configMINIMAL_STACK_SIZE * 4, NULL, 1, NULL) != pdPASS ||
+        xTaskCreate(second, "BenchB", configMINIMAL_STACK_SIZE * 4, NULL, 1, NULL) != pdPASS) {
+        fprintf(stderr, "Failed to create the benchmark tasks\n");
+        exit(1);
+    }
+    (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    return (double)(logTimestampMonotonicNs() - start) / 1e9;
+}
+
+static void runBench(const BenchTransport *transport) {
+    transport_ = transport;
+
+    double seconds = runTasks(vStreamConsumer, vStreamProducer);
+    (void)runTasks(vPonger, vPinger);
+    vTaskDelay(pdMS_TO_TICKS(10)); // Let the ponger finish before the next run
+
+    qsort(roundTripNs_, BENCH_PING_PONGS, sizeof(roundTripNs_[0]), compareLatency);
+    printf("%-6s %11.0f msg/s  round trip p50 %8.1f us  p99 %8.1f us\n", transport->name,
+           (double)BENCH_STREAM_MESSAGES / seconds, (double)roundTripNs_[BENCH_PING_PONGS / 2] / 1000.0,
+           (double)roundTripNs_[(BENCH_PING_PONGS * 99) / 100] / 1000.0);
+}
+
+static void vBenchTask(void *args) {
+    static const BenchTransport transports[] = {
+        {"queue", queueSendBench, queueReceiveBench},
+        {"ring", ringSendBench, ringReceiveBench},
+    };
+
+    benchTask_ = xTaskGetCurrentTaskHandle();
+    for (uint32_t i = 0; i < 2; i++) {
+        queues_[i] = xQueueCreate(COMM_RING_LENGTH, sizeof(CommMessage));
+        if (queues_[i] == NULL) {
+            fprintf(stderr, "Failed to create the queues\n");
+            exit(1);
+        }
+        commRingInit(&rings_[i]);
+    }
+
+    printf("CommMessage channels of %d items: %u streamed messages, %u round trips\n", COMM_RING_LENGTH,
+           BENCH_STREAM_MESSAGES, BENCH_PING_PONGS);
+    for (uint32_t i = 0; i < sizeof(transports) / sizeof(transports[0]); i++) {
+        runBench(&transports[i]);
+    }
+    exit(0);
+}
+
+int main(void) {
+    if (xTaskCreate(vBenchTask, "Bench", configMINIMAL_STACK_SIZE * 4, NULL, 2, NULL) != pdPASS) {
+        return 1;
+    }
+    vTaskStartScheduler();
+    return 0;
+}
@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "comm_transport.h"
+#include "logger_timestamp.h"
+#include "comm_cfg.h"
+
+/**
+ * @file bench_comm_transport.c
+ * @brief Compares the queue, Unix domain socket and shared-memory transports.
+ *
+ * The queue transport runs both ends in this process. For the socket and
+ * shared-memory transports the slave end runs in a child process forked
+ * before the scheduler starts, as it would with -r slave. The slave end
+ * streams BENCH_STREAM_MESSAGES messages to the master end, then echoes
+ * BENCH_PING_PONGS messages back; the master end reports the throughput and
+ * the round trip time.
+ */
+
+#define BENCH_STREAM_MESSAGES 200000u
+#define BENCH_PING_PONGS      2000u
+
+#define BENCH_UNIX_PATH "/tmp/bench_comm_transport.sock"
+#define BENCH_SHM_PATH  "/dev/shm/bench_comm_transport.link"
+
+static QueueHandle_t queues_[2];
+static CommTransportKind slaveKind_ = COMM_TRANSPORT_QUEUE;
+static CommTransport queueSlave_;
+static uint64_t roundTripNs_[BENCH_PING_PONGS];
+
+/**
+ * @brief Called by configASSERT() when an assertion fails.
+ */
+void vAssertCalled(const char * const pcFileName, unsigned long ulLine) {
+    fprintf(stderr, "configASSERT failed at %s:%lu\n", pcFileName, ulLine);
+    abort();
+}
+
+static int compareLatency(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Opens one end of the link of a transport kind.
+ */
+static RetVal_t openEnd(CommTransportKind kind, CommLinkSide side, CommTransport *transport) {
+    switch (kind) {
+    case COMM_TRANSPORT_UNIX:
+        return commTransportOpenUnix(transport, BENCH_UNIX_PATH, side);
+    case COMM_TRANSPORT_SHM:
+        return commTransportOpenShm(transport, BENCH_SHM_PATH, side);
+    default:
+        return (side == COMM_LINK_MASTER) ? commTransportOpenQueue(transport, queues_[0], queues_[1])
+                                          : commTransportOpenQueue(transport, queues_[1], queues_[0]);
+    }
+}
+
+/**
+ * @brief Slave end: streams the messages, then echoes the pings.
+ */
+static void vSlaveEnd(void *args) {
+    CommTransport *transport = (CommTransport *)args;
+    CommMessage message = {COMM_MSG_SLAVE_STATE, COMM_SOURCE_SLAVE, 0, 0};
+
+    for (uint32_t i = 0; i < BENCH_STREAM_MESSAGES; i++) {
+        message.payload = (int32_t)i;
+        (void)commTransportSend(transport, &message, portMAX_DELAY);
+    }
+    for (uint32_t i = 0; i < BENCH_PING_PONGS; i++) {
+        (void)commTransportReceive(transport, &message, portMAX_DELAY);
+        (void)commTransportSend(transport, &message, portMAX_DELAY);
+    }
+    if (transport != &queueSlave_) {
+        commTransportClose(transport);
+        exit(0);
+    }
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Master end: receives the stream, then measures the round trips.
+ */
+static void runMasterEnd(CommTransportKind kind) {
+    CommTransport transport;
+    CommMessage message = {COMM_MSG_MASTER_STATE, COMM_SOURCE_MASTER, 0, 0};
+    uint32_t outOfOrder = 0;
+
+    if (openEnd(kind, COMM_LINK_MASTER, &transport) != RET_OK) {
+        fprintf(stderr, "Failed to open the %s master end\n", commTransportName(kind));
+        exit(1);
+    }
+    if (kind == COMM_TRANSPORT_QUEUE) {
+        if (openEnd(kind, COMM_LINK_SLAVE, &queueSlave_) != RET_OK ||
+            xTaskCreate(vSlaveEnd, "SlaveEnd", configMINIMAL_STACK_SIZE * 4, &queueSlave_, 1, NULL) != pdPASS) {
+            fprintf(stderr, "Failed to start the queue slave end\n");
+            exit(1);
+        }
+    }
+
+    // The clock starts at the first message, once the slave end is connected
+    (void)commTransportReceive(&transport, &message, portMAX_DELAY);
+    uint64_t start = logTimestampMonotonicNs();
+    for (uint32_t i = 1; i < BENCH_STREAM_MESSAGES; i++) {
+        (void)commTransportReceive(&transport, &message, portMAX_DELAY);
+        outOfOrder += (message.payload != (int32_t)i);
+    }
+    double seconds = (double)(logTimestampMonotonicNs() - start) / 1e9;
+
+    for (uint32_t i = 0; i < BENCH_PING_PONGS; i++) {
+        uint64_t sent = logTimestampMonotonicNs();
+        (void)commTransportSend(&transport, &message, portMAX_DELAY);
+        (void)commTransportReceive(&transport, &message, portMAX_DELAY);
+        roundTripNs_[i] = logTimestampMonotonicNs() - sent;
+    }
+    commTransportClose(&transport);
+
+    if (outOfOrder != 0) {
+        fprintf(stderr, "%s delivered %u messages out of order\n", commTransportName(kind), outOfOrder);
+    }
+    qsort(roundTripNs_, BENCH_PING_PONGS, sizeof(roundTripNs_[0]), compareLatency);
+    printf("%-6s %11.0f msg/s  round trip p50 %8.1f us  p99 %8.1f us\n", commTransportName(kind),
+           (double)(BENCH_STREAM_MESSAGES - 1) / seconds, (double)roundTripNs_[BENCH_PING_PONGS / 2] / 1000.0,
+           (double)roundTripNs_[(BENCH_PING_PONGS * 99) / 100] / 1000.0);
+}
+
+static void vBenchTask(void *args) {
+    printf("CommMessage links: %u streamed messages, %u round trips, %d ms poll period\n", BENCH_STREAM_MESSAGES,
+           BENCH_PING_PONGS, COMM_TRANSPORT_POLL_MS);
+    for (uint32_t kind = 0; kind < COMM_TRANSPORT_MAX; kind++) {
+        runMasterEnd((CommTransportKind)kind);
+    }
+    while (wait(NULL) > 0) {
+    }
+    exit(0);
+}
+
+/**
+ * @brief Child process running the slave end of one transport kind.
+ */
+static void vChildTask(void *args) {
+    static CommTransport transport;
+
+    if (openEnd(slaveKind_, COMM_LINK_SLAVE, &transport) != RET_OK) {
+        fprintf(stderr, "Failed to open the %s slave end\n", commTransportName(slaveKind_));
+        exit(1);
+    }
+    vSlaveEnd(&transport);
+}
+
+int main(void) {
+    // Stale files from an earlier run would be mapped by the children
+    (void)unlink(BENCH_UNIX_PATH);
+    (void)unlink(BENCH_SHM_PATH);
+    fflush(stdout);
+
+    for (uint32_t kind = COMM_TRANSPORT_UNIX; kind < COMM_TRANSPORT_MAX; kind++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            return 1;
+        }
+        if (pid == 0) {
+            slaveKind_ = (CommTransportKind)kind;
+            if (xTaskCreate(vChildTask, "Child", configMINIMAL_STACK_SIZE * 4, NULL, 1, NULL) != pdPASS) {
+                return 1;
+            }
+            vTaskStartScheduler();
+            return 0;
+        }
+    }
+
+    queues_[0] = xQueueCreate(COMM_RING_LENGTH, sizeof(CommMessage));
+    queues_[1] = xQueueCreate(COMM_RING_LENGTH, sizeof(CommMessage));
+    if (queues_[0] == NULL || queues_[1] == NULL ||
+        xTaskCreate(vBenchTask, "Bench", configMINIMAL_STACK_SIZE * 4, NULL, 2, NULL) != pdPASS) {
+        return 1;
+    }
+    vTaskStartScheduler();
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "logger_stream.h"
+#include "logger_cfg.h"
+
+/**
+ * @file bench_log_stream.c
+ * @brief Measures the cost of shipping one log record off the flush task.
+ *
+ * Compares the previous synchronous path (open, append and close the log file
+ * for every record) with the collector stream, which copies the record into
+ * the stream queue and sends one batch per flush cycle with a single system
+ * call. A collector thread drains the socket; a batch is complete once the
+ * collector has read it, so the time includes delivery.
+ * Binds LOG_STREAM_SOCKET_PATH, so stop a running log_collector first.
+ */
+
+#define BENCH_RECORDS        1000000u // Multiple of BENCH_BATCH
+#define BENCH_LEGACY_RECORDS 100000u
+#define BENCH_BATCH          64u
+#define BENCH_FILE           "bench_log_stream.txt"
+
+static const char record_[] =
+    "[2025-01-01 10:00:00.123456] [DEBUG] [SlaveStateMachine] Status INIT -> RUN (tick 123456)\n";
+
+static volatile uint64_t received_ = 0;
+
+static uint64_t nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void report(const char *name, uint64_t elapsedNs, uint32_t records) {
+    printf("%-34s %8.1f ns/record  %8.1f MB/s\n", name, (double)elapsedNs / records,
+           (double)records * (sizeof(record_) - 1) * 1000.0 / (double)elapsedNs);
+}
+
+/**
+ * @brief Accepts one connection and reads until it is closed.
+ */
+static void *collectorThread(void *args) {
+    int listener = *(int *)args;
+    int connection = accept(listener, NULL, NULL);
+    char buffer[64 * 1024];
+    ssize_t length;
+    while ((length = read(connection, buffer, sizeof(buffer))) > 0) {
+        received_ += (uint64_t)length;
+    }
+    close(connection);
+    return NULL;
+}
+
+static void benchLegacyFile(void) {
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < BENCH_LEGACY_RECORDS; i++) {
+        FILE *file = fopen(BENCH_FILE, "a");
+        fprintf(file, "%s", record_);
+        fclose(file);
+    }
+    report("fopen/fprintf/fclose (previous)", nowNs() - start, BENCH_LEGACY_RECORDS);
+    remove(BENCH_FILE);
+}
+
+static void benchStream(void) {
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, LOG_STREAM_SOCKET_PATH, sizeof(address.sun_path) - 1);
+    unlink(LOG_STREAM_SOCKET_PATH);
+    if (bind(listener, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(listener, 1) != 0) {
+        perror("Failed to listen on the stream socket");
+        close(listener);
+        return;
+    }
+
+    pthread_t collector;
+    pthread_create(&collector, NULL, collectorThread, &listener);
+    logStreamInit(NULL);
+
+    // Every record counts as delivered only once the collector has read it
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < BENCH_RECORDS; i += BENCH_BATCH) {
+        for (uint32_t j = 0; j < BENCH_BATCH; j++) {
+            logStreamAppend(record_, sizeof(record_) - 1);
+        }
+        uint64_t expected = (uint64_t)(i + BENCH_BATCH - logStreamDroppedTotal()) * (sizeof(record_) - 1);
+        logStreamFlush();
+        while (received_ < expected) {
+            logStreamFlush();
+        }
+    }
+    uint64_t elapsed = nowNs() - start;
+    logStreamClose();
+    pthread_join(collector, NULL);
+    close(listener);
+    unlink(LOG_STREAM_SOCKET_PATH);
+
+    report("stream, batches of 64, delivered", elapsed, BENCH_RECORDS);
+    printf("%-34s %8u of %u records dropped (collector too slow)\n", "",
+           (unsigned)logStreamDroppedTotal(), (unsigned)BENCH_RECORDS);
+}
+
+int main(void) {
+    benchLegacyFile();
+    benchStream();
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <time.h>
+#include "logger.h"
+
+/**
+ * @file bench_logger_level.c
+ * @brief Measures the cost of a log call whose level is filtered out.
+ *
+ * Compares the previous DEBUG path (format the message, then open and close the
+ * log file before the record is dropped) with the runtime level check of
+ * logMessageFormatted(), the LOG_FMT() macro and a call site removed by
+ * LOG_COMPILE_MIN_LEVEL. Runs on the host without starting the scheduler.
+ * With LOG_FLIGHT_LEVEL 0 the flight recorder keeps DEBUG events, and the
+ * runtime-checked paths include recording the event.
+ */
+
+#define BENCH_ITERATIONS       5000000u
+#define BENCH_LEGACY_ITERATIONS 200000u
+
+static volatile uint32_t argumentEvaluations_ = 0;
+
+/**
+ * @brief Stand-in for an argument that is costly to compute.
+ */
+static int32_t expensiveArgument(void) {
+    argumentEvaluations_++;
+    return (int32_t)argumentEvaluations_;
+}
+
+static uint64_t nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Reproduces the dropped-record cost before the level check was moved.
+ */
+static void legacyDroppedCall(const char *format, ...) {
+    char message[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    FILE *logFile = fopen("/dev/null", "a");
+    if (logFile != NULL) {
+        fclose(logFile);
+    }
+}
+
+static void report(const char *name, uint64_t elapsedNs, uint32_t iterations, uint32_t evaluations) {
+    printf("%-34s %10.2f ns/call  (argument evaluated %u times)\n",
+           name, (double)elapsedNs / iterations, (unsigned)evaluations);
+}
+
+static void benchLegacy(void) {
+    argumentEvaluations_ = 0;
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < BENCH_LEGACY_ITERATIONS; i++) {
+        legacyDroppedCall("Dispatching state %d", expensiveArgument());
+    }
+    report("format + fopen/fclose (previous)", nowNs() - start, BENCH_LEGACY_ITERATIONS, argumentEvaluations_);
+}
+
+static void benchFunctionCheck(void) {
+    argumentEvaluations_ = 0;
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        logMessageFormatted(LOG_LEVEL_DEBUG, "Bench", "Dispatching state %d", expensiveArgument());
+    }
+    report("logMessageFormatted level check", nowNs() - start, BENCH_ITERATIONS, argumentEvaluations_);
+}
+
+static void benchRuntimeMacro(void) {
+    argumentEvaluations_ = 0;
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        LOG_FMT(LOG_LEVEL_DEBUG, "Bench", "Dispatching state %d", expensiveArgument());
+    }
+    report("LOG_FMT runtime filter", nowNs() - start, BENCH_ITERATIONS, argumentEvaluations_);
+}
+
+// Everything below is compiled as a release build would compile it
+#undef LOG_COMPILE_MIN_LEVEL
+#define LOG_COMPILE_MIN_LEVEL LOG_LEVEL_WARN
+
+static void benchCompiledOut(void) {
+    argumentEvaluations_ = 0;
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        LOG_FMT(LOG_LEVEL_DEBUG, "Bench", "Dispatching state %d", expensiveArgument());
+    }
+    report("LOG_FMT compiled out", nowNs() - start, BENCH_ITERATIONS, argumentEvaluations_);
+}
+
+int main(void) {
+    setLogLevel(LOG_LEVEL_INFO);
+
+    benchLegacy();
+    benchFunctionCheck();
+    benchRuntimeMacro();
+    benchCompiledOut();
+    return 0;
+}
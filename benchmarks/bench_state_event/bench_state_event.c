@@ -0,0 +1,263 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "master_comm.h"
+#include "master_state_machine.h"
+#include "slave_comm.h"
+#include "slave_state_machine.h"
+#include "state_mashine_types.h"
+#include "logger_timestamp.h"
+#include "comm_cfg.h"
+#include "thread_handler_cfg.h"
+
+/**
+ * @file bench_state_event.c
+ * @brief Compares polled and event-driven state propagation.
+ *
+ * Both runs use the real state machines and comm modules, with the state
+ * tasks of both sides: slave state publisher, master receiver, master state
+ * sender and slave master-state observer. The polled run reproduces the
+ * previous loops (the slave tasks every BENCH_POLL_SLAVE_MS, the master
+ * sender every BENCH_POLL_MASTER_MS); the event-driven run sleeps in
+ * waitStateChangeSlave(), waitStateChangeMaster() and reciveStateSyncSlave()
+ * with the heartbeats of thread_handler_cfg.h, as the handlers do.
+ *
+ * Each iteration faults the slave at a random phase of the loops and measures
+ * the time until the master is in ERROR (fault to master decision) and until
+ * the slave resets on the master error (fault to slave reaction).
+ */
+
+#define BENCH_ITERATIONS     32
+#define BENCH_POLL_SLAVE_MS  80  // Previous TASTK_TIME_SLAVE_STATUS_OBSERVATION_HANDLING
+#define BENCH_POLL_MASTER_MS 500 // Previous TASTK_TIME_MASTER_STATUS_CHECK_HANDLER
+#define BENCH_PHASE_MS       500 // Range of the random fault phase
+#define BENCH_TIMEOUT_MS     5000
+#define BENCH_QUEUE_LENGTH       10
+#define BENCH_RESET_QUEUE_LENGTH (BENCH_ITERATIONS * 2)
+
+typedef struct {
+    volatile uint64_t masterErrorAtNs;
+    volatile uint64_t slaveResetAtNs;
+    uint64_t decisionNs[BENCH_ITERATIONS];
+    uint64_t reactionNs[BENCH_ITERATIONS];
+} BenchStats;
+
+static BenchStats stats_;
+static volatile uint8_t eventDriven_ = 0;
+static volatile MasterStates observedMaster_ = MASTESR_STATE_IDLE; // Master state last seen by the slave
+
+/**
+ * @brief Called by configASSERT() when an assertion fails.
+ */
+void vAssertCalled(const char * const pcFileName, unsigned long ulLine) {
+    fprintf(stderr, "configASSERT failed at %s:%lu\n", pcFileName, ulLine);
+    abort();
+}
+
+static void vBenchSlavePublisher(void *args) {
+    SlaveStates state = SLAVE_STATE_MAX;
+    while (1) {
+        if (getState(&state) == RET_OK) {
+            (void)syncStateSlave(COMM_SYNC_SLAVE_ID, (int32_t)state, 0, NULL);
+        }
+        if (eventDriven_) {
+            (void)waitStateChangeSlave(pdMS_TO_TICKS(TASTK_TIME_SLAVE_STATUS_OBSERVATION_HANDLING));
+        } else {
+            vTaskDelay(pdMS_TO_TICKS(BENCH_POLL_SLAVE_MS));
+        }
+    }
+}
+
+static void vBenchMasterReceiver(void *args) {
+    CommMessage messages[COMM_RECEIVE_BATCH_SIZE];
+    uint32_t received = 0;
+    MasterStates state = MASTESR_STATE_MAX;
+    while (1) {
+        if (reciveMsgBatchMaster(messages, COMM_RECEIVE_BATCH_SIZE, &received) != RET_OK) {
+            received = 0;
+        }
+        for (uint32_t i = 0; i < received; i++) {
+            if (messages[i].type == COMM_MSG_SLAVE_STATE) {
+                (void)stateDispatcher((SlaveStates)messages[i].payload);
+            }
+        }
+        if (getCurrentState(&state) == RET_OK && state == MASTESR_STATE_ERROR && stats_.masterErrorAtNs == 0) {
+            stats_.masterErrorAtNs = logTimestampMonotonicNs();
+        }
+    }
+}
+
+static void vBenchMasterSender(void *args) {
+    MasterStates state = MASTESR_STATE_MAX;
+    while (1) {
+        (void)getCurrentState(&state);
+        (void)syncStateMaster((int32_t)state, 0, NULL);
+        if (eventDriven_) {
+            (void)waitStateChangeMaster(pdMS_TO_TICKS(TASTK_TIME_MASTER_STATUS_CHECK_HANDLER));
+        } else {
+            vTaskDelay(pdMS_TO_TICKS(BENCH_POLL_MASTER_MS));
+        }
+    }
+}
+
+static void vBenchSlaveObserver(void *args) {
+    CommMessage messages[COMM_RECEIVE_BATCH_SIZE];
+    uint32_t received = 0;
+    MasterStates masterState = MASTESR_STATE_IDLE;
+    while (1) {
+        TickType_t ticksToWait = eventDriven_ ? pdMS_TO_TICKS(TASTK_TIME_SLAVE_MASTER_STATE_HANDLER) : 0;
+        if (reciveStateSyncSlave(messages, COMM_RECEIVE_BATCH_SIZE, &received, ticksToWait) != RET_OK) {
+            received = 0;
+        }
+        for (uint32_t i = 0; i < received; i++) {
+            if (messages[i].type == COMM_MSG_MASTER_STATE) {
+                masterState = (MasterStates)messages[i].payload;
+            }
+        }
+        observedMaster_ = masterState;
+        if (received != 0) {
+            (void)setMasterStateSlave(masterState);
+        }
+        if (!eventDriven_) {
+            vTaskDelay(pdMS_TO_TICKS(BENCH_POLL_SLAVE_MS));
+        }
+    }
+}
+
+static int compareLatency(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Waits until a flag set by another task is non-zero.
+ *
+ * @return 1 if it was set within BENCH_TIMEOUT_MS, 0 otherwise.
+ */
+static uint8_t waitFor(volatile uint64_t *flag) {
+    for (uint32_t waited = 0; *flag == 0; waited++) {
+        if (waited >= BENCH_TIMEOUT_MS) {
+            return 0;
+        }
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+    return 1;
+}
+
+/**
+ * @brief Waits until both sides are back to their resting states.
+ *
+ * The slave must also have seen the master leave ERROR, or it would reset on
+ * the next fault before the master decides.
+ */
+static uint8_t waitIdle(void) {
+    MasterStates master = MASTESR_STATE_MAX;
+    SlaveStates slave = SLAVE_STATE_MAX;
+    for (uint32_t waited = 0; waited < BENCH_TIMEOUT_MS; waited++) {
+        (void)getCurrentState(&master);
+        (void)getState(&slave);
+        if (master == MASTESR_STATE_IDLE && slave == SLAVE_STATE_SLEEP && observedMaster_ == MASTESR_STATE_IDLE) {
+            return 1;
+        }
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+    return 0;
+}
+
+static void printLatencies(const char *name, uint64_t *latencies, uint32_t count) {
+    qsort(latencies, count, sizeof(latencies[0]), compareLatency);
+    double p50 = count ? (double)latencies[count / 2] / 1000000.0 : 0.0;
+    double p99 = count ? (double)latencies[(count * 99) / 100] / 1000000.0 : 0.0;
+    printf("  %-24s p50 %8.1f ms  p99 %8.1f ms\n", name, p50, p99);
+}
+
+/**
+ * @brief Runs BENCH_ITERATIONS faults with the four state tasks and prints the statistics.
+ */
+static void runScenario(const char *name, uint8_t eventDriven, QueueHandle_t resetQueue) {
+    static const char *const names[4] = {"BenchSlavePub", "BenchMasterRx", "BenchMasterTx", "BenchSlaveObs"};
+    TaskFunction_t tasks[4] = {vBenchSlavePublisher, vBenchMasterReceiver, vBenchMasterSender, vBenchSlaveObserver};
+    TaskHandle_t handles[4] = {NULL, NULL, NULL, NULL};
+    uint32_t count = 0;
+    int8_t signal = 0;
+
+    memset(&stats_, 0, sizeof(stats_));
+    eventDriven_ = eventDriven;
+    for (int i = 0; i < 4; i++) {
+        if (xTaskCreate(tasks[i], names[i], configMINIMAL_STACK_SIZE * 4, NULL, 1, &handles[i]) != pdPASS) {
+            fprintf(stderr, "Failed to create %s\n", names[i]);
+            exit(1);
+        }
+    }
+
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        if (!waitIdle()) {
+            fprintf(stderr, "%s: states did not settle\n", name);
+            break;
+        }
+        // Fault at a random point of the loops, so the polled run pays its average wait
+        vTaskDelay(pdMS_TO_TICKS(1 + rand() % BENCH_PHASE_MS));
+
+        stats_.masterErrorAtNs = 0;
+        stats_.slaveResetAtNs = 0;
+        uint64_t faultAtNs = logTimestampMonotonicNs();
+        (void)handelStatus(SLAVE_INPUT_STATE_ERROR_OR_FAULT);
+        // The reset sends the restart signal, which this higher priority task takes right away
+        if (xQueueReceive(resetQueue, &signal, pdMS_TO_TICKS(BENCH_TIMEOUT_MS)) == pdPASS) {
+            stats_.slaveResetAtNs = logTimestampMonotonicNs();
+        }
+        if (!waitFor(&stats_.masterErrorAtNs) || stats_.slaveResetAtNs == 0) {
+            fprintf(stderr, "%s: no reaction to fault %u\n", name, i);
+            break;
+        }
+        stats_.decisionNs[count] = stats_.masterErrorAtNs - faultAtNs;
+        stats_.reactionNs[count] = stats_.slaveResetAtNs - faultAtNs;
+        count++;
+
+        // Nothing restarts the slave tasks here; drop the restart signal
+        while (xQueueReceive(resetQueue, &signal, 0) == pdPASS) {
+        }
+    }
+
+    for (int i = 0; i < 4; i++) {
+        vTaskDelete(handles[i]);
+    }
+    printf("%s (%u faults)\n", name, count);
+    printLatencies("fault to master ERROR", stats_.decisionNs, count);
+    printLatencies("fault to slave reset", stats_.reactionNs, count);
+}
+
+static void vBenchTask(void *args) {
+    QueueHandle_t masterToSlave = xQueueCreate(BENCH_QUEUE_LENGTH, sizeof(CommMessage));
+    QueueHandle_t slaveToMaster = xQueueCreate(BENCH_QUEUE_LENGTH, sizeof(CommMessage));
+    QueueHandle_t resetQueue = xQueueCreate(BENCH_RESET_QUEUE_LENGTH, sizeof(int8_t));
+    if (masterToSlave == NULL || slaveToMaster == NULL || resetQueue == NULL ||
+        initMasterComm(masterToSlave, slaveToMaster) != RET_OK ||
+        initSlaveComm(slaveToMaster, masterToSlave) != RET_OK) {
+        fprintf(stderr, "Failed to create the queues\n");
+        exit(1);
+    }
+    if (initStateSemaphoreMaster() != RET_OK || initStateMachineSlave(resetQueue) != RET_OK) {
+        fprintf(stderr, "Failed to set up the state machines\n");
+        exit(1);
+    }
+
+    srand(1);
+    printf("Fault propagation latency, %d faults per run\n", BENCH_ITERATIONS);
+    runScenario("polled", 0, resetQueue);
+    runScenario("event-driven", 1, resetQueue);
+    exit(0);
+}
+
+int main(void) {
+    if (xTaskCreate(vBenchTask, "Bench", configMINIMAL_STACK_SIZE * 4, NULL, 2, NULL) != pdPASS) {
+        return 1;
+    }
+    vTaskStartScheduler();
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "logger_timestamp.h"
+
+/**
+ * @file bench_timestamp.c
+ * @brief Measures the cost of timestamping and formatting one log record.
+ *
+ * Compares the previous time() + ctime_r() prefix with logTimestampNow() and
+ * logTimestampFormat(), which only formats the date once per second, and
+ * checks how many records of a burst share the same timestamp (records that
+ * cannot be ordered by time).
+ */
+
+#define BENCH_ITERATIONS 2000000u
+
+static volatile uint32_t sink_ = 0;
+
+static uint64_t nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void report(const char *name, uint64_t elapsedNs, uint32_t iterations, uint32_t ties) {
+    printf("%-30s %8.2f ns/record  (%u of %u records share the previous timestamp)\n",
+           name, (double)elapsedNs / iterations, (unsigned)ties, (unsigned)iterations);
+}
+
+static void benchCtime(void) {
+    char text[32];
+    char previous[32] = "";
+    uint32_t ties = 0;
+
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        time_t now = time(NULL);
+        ctime_r(&now, text);
+        text[strlen(text) - 1] = '\0';
+        ties += (strcmp(text, previous) == 0);
+        memcpy(previous, text, sizeof(previous));
+        sink_ += (uint8_t)text[18];
+    }
+    report("time() + ctime_r() (previous)", nowNs() - start, BENCH_ITERATIONS, ties);
+}
+
+static void benchTimestamp(void) {
+    char text[LOG_TIMESTAMP_TEXT_SIZE];
+    char previous[LOG_TIMESTAMP_TEXT_SIZE] = "";
+    uint32_t ties = 0;
+
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        LogTimestamp now = logTimestampNow();
+        logTimestampFormat(&now, text, sizeof(text));
+        ties += (strcmp(text, previous) == 0);
+        memcpy(previous, text, sizeof(previous));
+        sink_ += (uint8_t)text[25];
+    }
+    report("logTimestampNow() + Format()", nowNs() - start, BENCH_ITERATIONS, ties);
+}
+
+static void benchNowOnly(void) {
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+        LogTimestamp now = logTimestampNow();
+        sink_ += now.nanoseconds;
+    }
+    report("logTimestampNow() only", nowNs() - start, BENCH_ITERATIONS, 0);
+}
+
+int main(void) {
+    benchCtime();
+    benchTimestamp();
+    benchNowOnly();
+    return 0;
+}
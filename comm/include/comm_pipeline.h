@@ -0,0 +1,91 @@
+#ifndef COMM_PIPELINE_H
+#define COMM_PIPELINE_H
+
+#include <stdint.h>
+#include "types.h"
+#include "comm_types.h"
+#include "comm_cfg.h"
+#include "FreeRTOS.h"
+#include "message_buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file comm_pipeline.h
+ * @brief Fan-out pipeline of variable-length payloads over FreeRTOS message buffers.
+ *
+ * One producer task publishes payloads of up to COMM_PIPELINE_MAX_PAYLOAD
+ * bytes; every consumer task receives each payload from its own message
+ * buffer of COMM_PIPELINE_BUFFER_SIZE bytes. A message buffer stores each
+ * payload behind its length, so payloads keep their boundaries and no
+ * per-message memory is allocated: the payload is copied into the buffer of
+ * each consumer and out into the buffer given by the consumer. The message
+ * buffers are created once by commPipelineInit().
+ *
+ * A consumer that stays full for the publish wait loses that payload; the
+ * others still get it. Lost payloads are counted per consumer.
+ */
+
+/**
+ * @brief Pipeline, allocated by the caller and set up with commPipelineInit().
+ *
+ * - consumerCount: Number of consumers.
+ * - buffers: Message buffer of each consumer.
+ * - dropped: Payloads each consumer lost because its buffer stayed full.
+ */
+struct CommPipeline {
+    uint32_t consumerCount;
+    MessageBufferHandle_t buffers[COMM_PIPELINE_MAX_CONSUMERS];
+    uint32_t dropped[COMM_PIPELINE_MAX_CONSUMERS];
+};
+
+/**
+ * @brief Creates the message buffers of a pipeline.
+ *
+ * @param pipeline Pipeline to set up.
+ * @param consumerCount Number of consumers, 1 to COMM_PIPELINE_MAX_CONSUMERS.
+ * @return RET_OK on success, RET_ERROR otherwise.
+ */
+RetVal_t commPipelineInit(CommPipeline *pipeline, uint32_t consumerCount);
+
+/**
+ * @brief Publishes a payload to every consumer; only the producer task may call this.
+ *
+ * @param pipeline Pipeline.
+ * @param payload Payload to copy.
+ * @param length Payload length, 1 to COMM_PIPELINE_MAX_PAYLOAD bytes.
+ * @param ticksToWait Maximum time to wait for space, shared by all consumers.
+ * @return RET_OK if every consumer got the payload, RET_ERROR otherwise.
+ */
+RetVal_t commPipelinePublish(CommPipeline *pipeline, const void *payload, uint32_t length, TickType_t ticksToWait);
+
+/**
+ * @brief Receives the next payload of a consumer; only that consumer's task may call this.
+ *
+ * @param pipeline Pipeline.
+ * @param consumer Consumer index.
+ * @param payload Buffer to copy the payload into.
+ * @param capacity Size of payload, at least COMM_PIPELINE_MAX_PAYLOAD bytes.
+ * @param length Pointer to store the payload length.
+ * @param ticksToWait Maximum time to wait for a payload.
+ * @return RET_OK if a payload was received, RET_ERROR otherwise.
+ */
+RetVal_t commPipelineReceive(CommPipeline *pipeline, uint32_t consumer, void *payload, uint32_t capacity,
+                             uint32_t *length, TickType_t ticksToWait);
+
+/**
+ * @brief Returns the number of payloads a consumer lost.
+ *
+ * @param pipeline Pipeline.
+ * @param consumer Consumer index.
+ * @return Number of payloads dropped for the consumer.
+ */
+uint32_t commPipelineDropped(const CommPipeline *pipeline, uint32_t consumer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COMM_PIPELINE_H
@@ -0,0 +1,86 @@
+#ifndef COMM_POOL_H
+#define COMM_POOL_H
+
+#include <stdint.h>
+#include "types.h"
+#include "comm_types.h"
+#include "comm_cfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file comm_pool.h
+ * @brief Preallocated pool of reference-counted message blocks.
+ *
+ * Payloads too large to be copied through a FreeRTOS queue live in message
+ * blocks. A producer takes a block from the pool, fills it in place and sends
+ * only its pointer through a queue; every holder drops its reference with
+ * commBlockRelease() and the last one returns the block to the pool. The
+ * blocks are allocated statically, so the pool never touches the heap after
+ * commPoolInit().
+ */
+
+/**
+ * @brief Message block.
+ *
+ * - refCount: Number of references held, managed by the pool.
+ * - length: Number of valid bytes in data.
+ * - data: Payload, filled in place by the producer.
+ */
+struct CommBlock {
+    uint32_t refCount;
+    uint32_t length;
+    uint8_t data[COMM_BLOCK_SIZE];
+};
+
+/**
+ * @brief Initializes the pool with COMM_POOL_BLOCKS free blocks.
+ *
+ * Must be called once before any block is allocated; later calls do nothing.
+ *
+ * @return RET_OK on success, RET_ERROR if the free list could not be created.
+ */
+RetVal_t commPoolInit(void);
+
+/**
+ * @brief Takes a free block from the pool without blocking.
+ *
+ * @return Block holding one reference with length 0, or NULL if the pool is empty.
+ */
+CommBlock *commBlockAlloc(void);
+
+/**
+ * @brief Adds a reference to a block, e.g. before passing it to a second consumer.
+ *
+ * @param block Block the caller holds a reference to.
+ */
+void commBlockRetain(CommBlock *block);
+
+/**
+ * @brief Drops a reference to a block; the last one returns it to the pool.
+ *
+ * @param block Block the caller holds a reference to.
+ */
+void commBlockRelease(CommBlock *block);
+
+/**
+ * @brief Returns the number of free blocks.
+ *
+ * @return Blocks currently in the pool.
+ */
+uint32_t commPoolAvailable(void);
+
+/**
+ * @brief Returns the number of allocations that failed because the pool was empty.
+ *
+ * @return Failed allocations since start-up.
+ */
+uint32_t commPoolExhausted(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COMM_POOL_H
@@ -0,0 +1,108 @@
+#ifndef COMM_RING_H
+#define COMM_RING_H
+
+#include <stdint.h>
+#include "types.h"
+#include "comm_types.h"
+#include "comm_cfg.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file comm_ring.h
+ * @brief Lock-free single-producer, single-consumer ring channel for CommMessage.
+ *
+ * A ring channel has exactly one sending task and one receiving task. Sending
+ * and receiving copy the message into or out of a slot and publish it with
+ * one atomic store, without entering a critical section. A side that has to
+ * wait (ring full or empty) registers itself and blocks on task notification
+ * COMM_RING_NOTIFY_INDEX; the other side notifies it only when it is waiting.
+ *
+ * The producer and consumer indexes live on separate cache lines so the two
+ * tasks do not invalidate each other's line on every message. Each waiter
+ * slot has a line of its own as well, so blocking on one side does not touch
+ * the line of the other side's waiter or of either index.
+ *
+ * A task that may be blocked on a ring must be removed from it with
+ * commRingForget() before it is deleted, with the scheduler suspended across
+ * both calls.
+ */
+
+#if (COMM_RING_LENGTH & (COMM_RING_LENGTH - 1)) != 0
+#error "COMM_RING_LENGTH must be a power of two"
+#endif
+
+/**
+ * @brief Ring channel, allocated by the caller and set up with commRingInit().
+ *
+ * - head: Next slot to write; written by the producer only.
+ * - cachedTail: Last tail seen by the producer.
+ * - tail: Next slot to read; written by the consumer only.
+ * - cachedHead: Last head seen by the consumer.
+ * - producerWaiting: Producer task blocked on a full ring, or NULL.
+ * - consumerWaiting: Consumer task blocked on an empty ring, or NULL.
+ * - slots: Message storage.
+ */
+struct CommRing {
+    uint32_t head __attribute__((aligned(COMM_CACHE_LINE_SIZE)));
+    uint32_t cachedTail;
+    uint32_t tail __attribute__((aligned(COMM_CACHE_LINE_SIZE)));
+    uint32_t cachedHead;
+    TaskHandle_t producerWaiting __attribute__((aligned(COMM_CACHE_LINE_SIZE)));
+    TaskHandle_t consumerWaiting __attribute__((aligned(COMM_CACHE_LINE_SIZE)));
+    CommMessage slots[COMM_RING_LENGTH] __attribute__((aligned(COMM_CACHE_LINE_SIZE)));
+};
+
+/**
+ * @brief Initializes an empty ring.
+ *
+ * Must be called before the producer or the consumer uses the ring.
+ *
+ * @param ring Ring to initialize.
+ */
+void commRingInit(CommRing *ring);
+
+/**
+ * @brief Sends a message; only the producer task may call this.
+ *
+ * @param ring Ring channel.
+ * @param message Message to copy into the ring.
+ * @param ticksToWait Maximum time to wait for a free slot.
+ * @return RET_OK if the message was sent, RET_ERROR if the ring stayed full.
+ */
+RetVal_t commRingSend(CommRing *ring, const CommMessage *message, TickType_t ticksToWait);
+
+/**
+ * @brief Receives a message; only the consumer task may call this.
+ *
+ * @param ring Ring channel.
+ * @param message Pointer to store the message.
+ * @param ticksToWait Maximum time to wait for a message.
+ * @return RET_OK if a message was received, RET_ERROR if the ring stayed empty.
+ */
+RetVal_t commRingReceive(CommRing *ring, CommMessage *message, TickType_t ticksToWait);
+
+/**
+ * @brief Removes a task from the waiter slots of a ring.
+ *
+ * Must be called before deleting a task that may be blocked on the ring, so
+ * the other side never notifies a deleted task. The caller suspends the
+ * scheduler around this call and vTaskDelete(); the other side notifies with
+ * the scheduler suspended, so it either notifies before the task is forgotten
+ * or finds the slot empty. The task that replaces it registers itself again
+ * when it has to wait.
+ *
+ * @param ring Ring channel.
+ * @param task Task about to be deleted.
+ */
+void commRingForget(CommRing *ring, TaskHandle_t task);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COMM_RING_H
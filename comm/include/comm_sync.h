@@ -0,0 +1,169 @@
+#ifndef COMM_SYNC_H
+#define COMM_SYNC_H
+
+#include <stdint.h>
+#include "types.h"
+#include "comm_types.h"
+#include "comm_cfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file comm_sync.h
+ * @brief Versioned delta sync of states between a holder and a receiver.
+ *
+ * A holder keeps (slave id, state) entries and a version that grows by one
+ * with every change of an entry; each entry remembers the version of its
+ * last change (commSyncSet()). A receiver keeps the version of the holder up
+ * to which it has every change, and asks the holder for the changes after it
+ * with a COMM_MSG_SYNC_REQUEST (commSyncRequest()). The holder answers with
+ * the changed entries only, in version order, as one batch of state messages
+ * (commSyncCollect()), and then assumes the receiver has them
+ * (commSyncSent()), so later batches carry only newer changes and nothing is
+ * sent while no state changes.
+ *
+ * Each state message also carries the version of the change sent before it
+ * (baseVersion), so a receiver detects a lost message when a change does not
+ * follow the version it has, and asks again from there (commSyncAccept()). A
+ * receiver starts at version 0 and asks once at start-up; a holder that
+ * starts over sends its first change with baseVersion 0, which the receivers
+ * take as a new history.
+ *
+ * A latest-value mailbox keeps only the newest message, so it may overwrite
+ * a request or a change. Over a mailbox the holder instead sends every entry
+ * on each sync call (commSyncCollectSnapshot()), with baseVersion 0, which the
+ * receiver always applies; with one entry per holder, the newest message in
+ * the mailbox is then the whole state.
+ *
+ * The functions hold no lock: a holder, and a receiver version, belong to one
+ * task.
+ */
+
+/**
+ * @brief State entry of a holder.
+ *
+ * - slaveId: Slave the state belongs to; 0 for the master state.
+ * - state: Latest state.
+ * - traceId: Trace of the client input that caused the state, 0 if untraced.
+ * - version: Holder version of the last change of the entry.
+ */
+typedef struct {
+    uint32_t slaveId;
+    int32_t state;
+    uint32_t traceId;
+    uint32_t version;
+} CommSyncEntry;
+
+/**
+ * @brief Holder, allocated by the caller and set up with commSyncInit().
+ *
+ * - entries: State entries, in the order they were added.
+ * - entryCount: Number of entries.
+ * - version: Version of the latest change, 0 before the first one.
+ * - sentVersion: Version up to which the receiver has every change.
+ */
+struct CommSyncHolder {
+    CommSyncEntry entries[COMM_SYNC_MAX_ENTRIES];
+    uint32_t entryCount;
+    uint32_t version;
+    uint32_t sentVersion;
+};
+
+/**
+ * @brief What a receiver does with a received state message.
+ */
+typedef enum {
+    COMM_SYNC_APPLY, ///< New change following the receiver's version; use the state.
+    COMM_SYNC_STALE, ///< Change the receiver already has; drop it.
+    COMM_SYNC_GAP,   ///< Changes before it were lost; drop it and request the changes after the receiver's version.
+} CommSyncResult;
+
+/**
+ * @brief Empties a holder.
+ *
+ * @param holder Holder to set up.
+ */
+void commSyncInit(CommSyncHolder *holder);
+
+/**
+ * @brief Sets the state of an entry, adding the entry if it is new.
+ *
+ * Setting the state an entry already has is not a change and keeps the
+ * versions.
+ *
+ * @param holder Holder.
+ * @param slaveId Slave the state belongs to.
+ * @param state New state.
+ * @param traceId Trace of the change, 0 if untraced.
+ * @return RET_OK on success, RET_ERROR if the entry is new and the holder already has COMM_SYNC_MAX_ENTRIES.
+ */
+RetVal_t commSyncSet(CommSyncHolder *holder, uint32_t slaveId, int32_t state, uint32_t traceId);
+
+/**
+ * @brief Handles a receiver's request for the changes after a version.
+ *
+ * The next commSyncCollect() starts after that version. A version above the
+ * holder's comes from a receiver that outlived a restart of the holder: the
+ * holder then continues from that version and counts every entry as changed.
+ *
+ * @param holder Holder.
+ * @param version Version the receiver has.
+ */
+void commSyncRequest(CommSyncHolder *holder, uint32_t version);
+
+/**
+ * @brief Builds the state messages of the changes the receiver does not have.
+ *
+ * The messages are in version order, so any prefix of them brings the
+ * receiver to a consistent version. Source id and sequence number are left to
+ * the sending comm module.
+ *
+ * @param holder Holder.
+ * @param type Message type (COMM_MSG_MASTER_STATE or COMM_MSG_SLAVE_STATE).
+ * @param messages Array to store the messages.
+ * @param capacity Size of the array.
+ * @return Number of messages built, 0 if the receiver has every change.
+ */
+uint32_t commSyncCollect(const CommSyncHolder *holder, uint8_t type, CommMessage *messages, uint32_t capacity);
+
+/**
+ * @brief Builds the state messages of every entry, for a channel that may lose messages.
+ *
+ * Same as commSyncCollect() after version 0, except that every message has
+ * baseVersion 0, so the receiver applies each one whatever version it has.
+ * Does not change what commSyncCollect() sends next.
+ *
+ * @param holder Holder.
+ * @param type Message type (COMM_MSG_MASTER_STATE or COMM_MSG_SLAVE_STATE).
+ * @param messages Array to store the messages.
+ * @param capacity Size of the array.
+ * @return Number of messages built, 0 if the holder has no entry.
+ */
+uint32_t commSyncCollectSnapshot(const CommSyncHolder *holder, uint8_t type, CommMessage *messages,
+                                 uint32_t capacity);
+
+/**
+ * @brief Records that the first count messages built by commSyncCollect() were sent.
+ *
+ * @param holder Holder.
+ * @param messages Messages built by commSyncCollect().
+ * @param count Number of them sent, in order.
+ */
+void commSyncSent(CommSyncHolder *holder, const CommMessage *messages, uint32_t count);
+
+/**
+ * @brief Checks a received state message against the receiver's version.
+ *
+ * @param version Version of the holder the receiver has; advanced when the change is applied.
+ * @param message Received state message.
+ * @return What to do with the message.
+ */
+CommSyncResult commSyncAccept(uint32_t *version, const CommMessage *message);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COMM_SYNC_H
@@ -0,0 +1,171 @@
+#ifndef COMM_TRANSPORT_H
+#define COMM_TRANSPORT_H
+
+#include <stdint.h>
+#include "types.h"
+#include "comm_types.h"
+#include "comm_cfg.h"
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "semphr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file comm_transport.h
+ * @brief Transports that carry CommMessage envelopes between a master and a slave.
+ *
+ * A transport is one end of a bidirectional master-slave link. The comm
+ * modules send and receive through it (initMasterCommTransport(),
+ * initSlaveCommTransport()), so the master and the slave can run in the same
+ * process or in separate processes on one host:
+ *
+ * - COMM_TRANSPORT_QUEUE: two FreeRTOS queues, in-process only.
+ * - COMM_TRANSPORT_UNIX: a SOCK_SEQPACKET Unix domain socket; the master end
+ *   listens on the path and the slave end connects to it.
+ * - COMM_TRANSPORT_SHM: two single-producer, single-consumer rings in a
+ *   memory-mapped file; the master end creates the file and the slave end
+ *   maps it.
+ *
+ * The socket and shared-memory transports never block in a system call: a
+ * side that has to wait polls every COMM_TRANSPORT_POLL_MS. Each end connects
+ * lazily, so the two processes can start in any order. Each direction of a
+ * link must have one sending task and one receiving task.
+ */
+
+/**
+ * @brief Enumeration of transport kinds.
+ */
+typedef enum {
+    COMM_TRANSPORT_QUEUE, ///< In-process FreeRTOS queues.
+    COMM_TRANSPORT_UNIX,  ///< Unix domain socket.
+    COMM_TRANSPORT_SHM,   ///< Shared-memory rings.
+    COMM_TRANSPORT_MAX    ///< Maximum transport kind value.
+} CommTransportKind;
+
+/**
+ * @brief End of the link a transport belongs to.
+ */
+typedef enum {
+    COMM_LINK_MASTER, ///< Master end; owns the socket path or the shared-memory file.
+    COMM_LINK_SLAVE   ///< Slave end; connects to the master end.
+} CommLinkSide;
+
+/**
+ * @brief Transport end, allocated by the caller and set up by one of the open functions.
+ *
+ * A zeroed or closed transport end is not open: sending and receiving on it
+ * fail, and closing it again does nothing.
+ *
+ * - kind: Transport kind.
+ * - side: End of the link.
+ * - path: Socket path or shared-memory file (not copied).
+ * - lock: Serializes connecting and disconnecting between the two tasks; NULL while not open.
+ * - sendQueue: Queue of the outgoing direction (queue transport).
+ * - receiveQueue: Queue of the incoming direction (queue transport).
+ * - listenFd: Listening socket of the master end, or -1.
+ * - socketFd: Connected socket, or -1 while not connected.
+ * - link: Mapped shared-memory link, or NULL while not mapped.
+ */
+struct CommTransport {
+    CommTransportKind kind;
+    CommLinkSide side;
+    const char *path;
+    SemaphoreHandle_t lock;
+    QueueHandle_t sendQueue;
+    QueueHandle_t receiveQueue;
+    int32_t listenFd;
+    int32_t socketFd;
+    void *link;
+};
+
+/**
+ * @brief Opens an in-process transport end over two FreeRTOS queues.
+ *
+ * @param transport Transport end to set up.
+ * @param sendQueue Queue of CommMessage items carrying the outgoing direction.
+ * @param receiveQueue Queue of CommMessage items carrying the incoming direction.
+ * @return RET_OK on success, RET_ERROR otherwise.
+ */
+RetVal_t commTransportOpenQueue(CommTransport *transport, QueueHandle_t sendQueue, QueueHandle_t receiveQueue);
+
+/**
+ * @brief Opens a Unix domain socket transport end.
+ *
+ * The master end replaces any stale socket file at path and listens on it; the
+ * slave end connects on first use.
+ *
+ * @param transport Transport end to set up.
+ * @param path Socket path, must stay valid while the transport is open.
+ * @param side End of the link.
+ * @return RET_OK on success, RET_ERROR otherwise.
+ */
+RetVal_t commTransportOpenUnix(CommTransport *transport, const char *path, CommLinkSide side);
+
+/**
+ * @brief Opens a shared-memory transport end.
+ *
+ * The master end creates and initializes the file at path; the slave end maps
+ * it on first use, once the master end has initialized it.
+ *
+ * @param transport Transport end to set up.
+ * @param path Shared-memory file, must stay valid while the transport is open.
+ * @param side End of the link.
+ * @return RET_OK on success, RET_ERROR otherwise.
+ */
+RetVal_t commTransportOpenShm(CommTransport *transport, const char *path, CommLinkSide side);
+
+/**
+ * @brief Sends a message to the other end.
+ *
+ * @param transport Transport end.
+ * @param message Message to send.
+ * @param ticksToWait Maximum time to wait for the peer and for space.
+ * @return RET_OK if the message was sent, RET_ERROR otherwise or if the transport is not open.
+ */
+RetVal_t commTransportSend(CommTransport *transport, const CommMessage *message, TickType_t ticksToWait);
+
+/**
+ * @brief Receives a message from the other end.
+ *
+ * @param transport Transport end.
+ * @param message Pointer to store the message.
+ * @param ticksToWait Maximum time to wait for a message.
+ * @return RET_OK if a message was received, RET_ERROR otherwise or if the transport is not open.
+ */
+RetVal_t commTransportReceive(CommTransport *transport, CommMessage *message, TickType_t ticksToWait);
+
+/**
+ * @brief Closes a transport end and releases its socket or mapping.
+ *
+ * The master end also removes the socket path or the shared-memory file.
+ * Closing a transport end that is not open does nothing.
+ *
+ * @param transport Transport end.
+ */
+void commTransportClose(CommTransport *transport);
+
+/**
+ * @brief Looks up a transport kind by name ("queue", "unix" or "shm").
+ *
+ * @param name Transport name, e.g. from the command line.
+ * @param kind Pointer to store the transport kind.
+ * @return RET_OK if the name is known, RET_ERROR otherwise.
+ */
+RetVal_t commTransportParse(const char *name, CommTransportKind *kind);
+
+/**
+ * @brief Returns the name of a transport kind.
+ *
+ * @param kind Transport kind.
+ * @return Transport name, or "unknown".
+ */
+const char *commTransportName(CommTransportKind kind);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COMM_TRANSPORT_H
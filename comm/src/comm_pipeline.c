@@ -0,0 +1,114 @@
+#include <stdint.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "message_buffer.h"
+#include "comm_pipeline.h"
+#include "logger.h"
+
+/**
+ * @file comm_pipeline.c
+ * @brief Implements the payload pipeline.
+ *
+ * A FreeRTOS message buffer has one writer and one reader, so each consumer
+ * gets its own buffer and the producer writes every payload into each of
+ * them. Writing and reading need no lock. The publish wait is one deadline
+ * shared by all consumers, so a stalled consumer costs the producer at most
+ * ticksToWait per payload.
+ */
+
+/**
+ * @brief Creates the message buffers of a pipeline.
+ *
+ * @param pipeline Pipeline to set up.
+ * @param consumerCount Number of consumers.
+ * @return RET_OK on success, RET_ERROR otherwise.
+ */
+RetVal_t commPipelineInit(CommPipeline *pipeline, uint32_t consumerCount) {
+    if (consumerCount == 0 || consumerCount > COMM_PIPELINE_MAX_CONSUMERS) {
+        LOG_MSG(LOG_LEVEL_ERROR, "CommPipeline", "Invalid number of consumers");
+        return RET_ERROR;
+    }
+
+    memset(pipeline, 0, sizeof(*pipeline));
+    for (uint32_t i = 0; i < consumerCount; i++) {
+        pipeline->buffers[i] = xMessageBufferCreate(COMM_PIPELINE_BUFFER_SIZE);
+        if (pipeline->buffers[i] == NULL) {
+            LOG_MSG(LOG_LEVEL_ERROR, "CommPipeline", "Failed to create a consumer buffer");
+            for (uint32_t j = 0; j < i; j++) {
+                vMessageBufferDelete(pipeline->buffers[j]);
+                pipeline->buffers[j] = NULL;
+            }
+            return RET_ERROR;
+        }
+    }
+    pipeline->consumerCount = consumerCount;
+    return RET_OK;
+}
+
+/**
+ * @brief Publishes a payload to every consumer.
+ *
+ * @param pipeline Pipeline.
+ * @param payload Payload to copy.
+ * @param length Payload length.
+ * @param ticksToWait Maximum time to wait for space, shared by all consumers.
+ * @return RET_OK if every consumer got the payload, RET_ERROR otherwise.
+ */
+RetVal_t commPipelinePublish(CommPipeline *pipeline, const void *payload, uint32_t length, TickType_t ticksToWait) {
+    RetVal_t ret = RET_OK;
+    TimeOut_t timeOut;
+
+    if (pipeline->consumerCount == 0 || length == 0 || length > COMM_PIPELINE_MAX_PAYLOAD) {
+        return RET_ERROR;
+    }
+
+    vTaskSetTimeOutState(&timeOut);
+    for (uint32_t i = 0; i < pipeline->consumerCount; i++) {
+        // A consumer that needs the whole wait leaves none for the next ones
+        if (i != 0 && ticksToWait != 0) {
+            (void)xTaskCheckForTimeOut(&timeOut, &ticksToWait);
+        }
+        if (xMessageBufferSend(pipeline->buffers[i], payload, length, ticksToWait) != length) {
+            __atomic_fetch_add(&pipeline->dropped[i], 1, __ATOMIC_RELAXED);
+            ret = RET_ERROR;
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief Receives the next payload of a consumer.
+ *
+ * @param pipeline Pipeline.
+ * @param consumer Consumer index.
+ * @param payload Buffer to copy the payload into.
+ * @param capacity Size of payload.
+ * @param length Pointer to store the payload length.
+ * @param ticksToWait Maximum time to wait for a payload.
+ * @return RET_OK if a payload was received, RET_ERROR otherwise.
+ */
+RetVal_t commPipelineReceive(CommPipeline *pipeline, uint32_t consumer, void *payload, uint32_t capacity,
+                             uint32_t *length, TickType_t ticksToWait) {
+    // A payload larger than the capacity would stay at the head of the buffer
+    if (consumer >= pipeline->consumerCount || capacity < COMM_PIPELINE_MAX_PAYLOAD) {
+        return RET_ERROR;
+    }
+
+    *length = (uint32_t)xMessageBufferReceive(pipeline->buffers[consumer], payload, capacity, ticksToWait);
+    return (*length != 0) ? RET_OK : RET_ERROR;
+}
+
+/**
+ * @brief Returns the number of payloads a consumer lost.
+ *
+ * @param pipeline Pipeline.
+ * @param consumer Consumer index.
+ * @return Number of payloads dropped for the consumer.
+ */
+uint32_t commPipelineDropped(const CommPipeline *pipeline, uint32_t consumer) {
+    if (consumer >= pipeline->consumerCount) {
+        return 0;
+    }
+    return __atomic_load_n(&pipeline->dropped[consumer], __ATOMIC_RELAXED);
+}
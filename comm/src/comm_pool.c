@@ -0,0 +1,106 @@
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "comm_pool.h"
+#include "logger.h"
+
+/**
+ * @file comm_pool.c
+ * @brief Implements the message block pool.
+ *
+ * The free list is a FreeRTOS queue of block pointers, so allocating and
+ * returning a block moves one pointer and is safe from any task. Reference
+ * counts use atomic operations; a block goes back to the free list exactly
+ * once, when its count drops to zero, so the free list can never overflow.
+ */
+
+/**
+ * @brief Block storage.
+ */
+static CommBlock blocks_[COMM_POOL_BLOCKS];
+
+/**
+ * @brief Free list, holding pointers into blocks_.
+ */
+static QueueHandle_t freeQueue_ = NULL;
+
+/**
+ * @brief Allocations that failed because the pool was empty.
+ */
+static uint32_t exhausted_ = 0;
+
+/**
+ * @brief Creates the free list and fills it with every block.
+ *
+ * @return RET_OK on success, RET_ERROR if the free list could not be created.
+ */
+RetVal_t commPoolInit(void) {
+    if (freeQueue_ != NULL) {
+        return RET_OK;
+    }
+
+    freeQueue_ = xQueueCreate(COMM_POOL_BLOCKS, sizeof(CommBlock *));
+    if (freeQueue_ == NULL) {
+        LOG_MSG(LOG_LEVEL_ERROR, "CommPool", "Failed to create the free block list");
+        return RET_ERROR;
+    }
+
+    for (uint32_t i = 0; i < COMM_POOL_BLOCKS; i++) {
+        CommBlock *block = &blocks_[i];
+        block->refCount = 0;
+        (void)xQueueSend(freeQueue_, &block, 0);
+    }
+    return RET_OK;
+}
+
+/**
+ * @brief Takes a free block from the pool without blocking.
+ *
+ * @return Block holding one reference, or NULL if the pool is empty.
+ */
+CommBlock *commBlockAlloc(void) {
+    CommBlock *block = NULL;
+
+    if (freeQueue_ == NULL || xQueueReceive(freeQueue_, &block, 0) != pdPASS) {
+        __atomic_fetch_add(&exhausted_, 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    __atomic_store_n(&block->refCount, 1, __ATOMIC_RELAXED);
+    block->length = 0;
+    return block;
+}
+
+/**
+ * @brief Adds a reference to a block.
+ *
+ * @param block Block the caller holds a reference to.
+ */
+void commBlockRetain(CommBlock *block) {
+    __atomic_fetch_add(&block->refCount, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Drops a reference and returns the block to the pool on the last one.
+ *
+ * @param block Block the caller holds a reference to.
+ */
+void commBlockRelease(CommBlock *block) {
+    // Acquire-release so the last holder sees every write made by the others before reuse
+    if (__atomic_sub_fetch(&block->refCount, 1, __ATOMIC_ACQ_REL) == 0) {
+        (void)xQueueSend(freeQueue_, &block, 0);
+    }
+}
+
+/**
+ * @brief Returns the number of free blocks.
+ */
+uint32_t commPoolAvailable(void) {
+    return (freeQueue_ != NULL) ? (uint32_t)uxQueueMessagesWaiting(freeQueue_) : 0;
+}
+
+/**
+ * @brief Returns the number of failed allocations.
+ */
+uint32_t commPoolExhausted(void) {
+    return __atomic_load_n(&exhausted_, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,155 @@
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "comm_ring.h"
+
+/**
+ * @file comm_ring.c
+ * @brief Implements the single-producer, single-consumer ring channel.
+ *
+ * The producer owns head and the consumer owns tail; each reads the other's
+ * index only when its cached copy says the ring is full or empty. Blocking
+ * follows a store-then-check protocol: the waiter publishes its task handle
+ * and then re-reads the index it waits on, while the other side publishes its
+ * index and then reads the waiter slot, with a full fence in between on both
+ * sides. At least one of them sees the other's store, so a wake-up is never
+ * lost. A stale notification only causes one extra check.
+ */
+
+#define COMM_RING_MASK (COMM_RING_LENGTH - 1)
+
+/**
+ * @brief Blocks until an index moves away from a value or the timeout expires.
+ *
+ * @param waiter Waiter slot of the calling side.
+ * @param index Index owned by the other side.
+ * @param value Value of the index that means "full" or "empty".
+ * @param ticksToWait Maximum time to wait.
+ * @return RET_OK if the index changed, RET_ERROR on timeout.
+ */
+static RetVal_t waitWhileEqual(TaskHandle_t *waiter, const uint32_t *index, uint32_t value, TickType_t ticksToWait) {
+    TimeOut_t timeOut;
+    RetVal_t result = RET_OK;
+
+    vTaskSetTimeOutState(&timeOut);
+    while (1) {
+        __atomic_store_n(waiter, xTaskGetCurrentTaskHandle(), __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(index, __ATOMIC_SEQ_CST) != value) {
+            break;
+        }
+        if (ticksToWait == 0 || xTaskCheckForTimeOut(&timeOut, &ticksToWait) != pdFALSE) {
+            result = RET_ERROR;
+            break;
+        }
+        (void)ulTaskNotifyTakeIndexed(COMM_RING_NOTIFY_INDEX, pdTRUE, ticksToWait);
+    }
+    __atomic_store_n(waiter, NULL, __ATOMIC_RELAXED);
+    return result;
+}
+
+/**
+ * @brief Notifies the other side if it is blocked on the ring.
+ *
+ * The slot is read again and notified with the scheduler suspended, so the
+ * waiter cannot be forgotten and deleted (see commRingForget()) between the
+ * two. A free slot is checked first, which keeps the common path lock-free.
+ *
+ * @param waiter Waiter slot of the other side.
+ */
+static void wakeWaiter(TaskHandle_t *waiter) {
+    // Order the index store before the waiter load (pairs with waitWhileEqual())
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(waiter, __ATOMIC_RELAXED) == NULL) {
+        return;
+    }
+    vTaskSuspendAll();
+    TaskHandle_t task = __atomic_load_n(waiter, __ATOMIC_RELAXED);
+    if (task != NULL) {
+        (void)xTaskNotifyGiveIndexed(task, COMM_RING_NOTIFY_INDEX);
+    }
+    (void)xTaskResumeAll();
+}
+
+/**
+ * @brief Resets the indexes and the waiter slots of the ring.
+ *
+ * @param ring Ring to initialize.
+ */
+void commRingInit(CommRing *ring) {
+    ring->head = 0;
+    ring->cachedTail = 0;
+    ring->tail = 0;
+    ring->cachedHead = 0;
+    ring->producerWaiting = NULL;
+    ring->consumerWaiting = NULL;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Copies a message into the next free slot and publishes it.
+ *
+ * @param ring Ring channel.
+ * @param message Message to send.
+ * @param ticksToWait Maximum time to wait for a free slot.
+ * @return RET_OK if the message was sent, RET_ERROR if the ring stayed full.
+ */
+RetVal_t commRingSend(CommRing *ring, const CommMessage *message, TickType_t ticksToWait) {
+    uint32_t head = ring->head;
+
+    if (head - ring->cachedTail == COMM_RING_LENGTH) {
+        ring->cachedTail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        if (head - ring->cachedTail == COMM_RING_LENGTH) {
+            if (waitWhileEqual(&ring->producerWaiting, &ring->tail, ring->cachedTail, ticksToWait) != RET_OK) {
+                return RET_ERROR;
+            }
+            ring->cachedTail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        }
+    }
+
+    ring->slots[head & COMM_RING_MASK] = *message;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    wakeWaiter(&ring->consumerWaiting);
+    return RET_OK;
+}
+
+/**
+ * @brief Copies the oldest message out of the ring and frees its slot.
+ *
+ * @param ring Ring channel.
+ * @param message Pointer to store the message.
+ * @param ticksToWait Maximum time to wait for a message.
+ * @return RET_OK if a message was received, RET_ERROR if the ring stayed empty.
+ */
+RetVal_t commRingReceive(CommRing *ring, CommMessage *message, TickType_t ticksToWait) {
+    uint32_t tail = ring->tail;
+
+    if (tail == ring->cachedHead) {
+        ring->cachedHead = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        if (tail == ring->cachedHead) {
+            if (waitWhileEqual(&ring->consumerWaiting, &ring->head, tail, ticksToWait) != RET_OK) {
+                return RET_ERROR;
+            }
+            ring->cachedHead = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        }
+    }
+
+    *message = ring->slots[tail & COMM_RING_MASK];
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+    wakeWaiter(&ring->producerWaiting);
+    return RET_OK;
+}
+
+/**
+ * @brief Removes a task from the waiter slots of a ring.
+ *
+ * @param ring Ring channel.
+ * @param task Task about to be deleted.
+ */
+void commRingForget(CommRing *ring, TaskHandle_t task) {
+    TaskHandle_t expected = task;
+    (void)__atomic_compare_exchange_n(&ring->producerWaiting, &expected, NULL, 0, __ATOMIC_SEQ_CST,
+                                      __ATOMIC_RELAXED);
+    expected = task;
+    (void)__atomic_compare_exchange_n(&ring->consumerWaiting, &expected, NULL, 0, __ATOMIC_SEQ_CST,
+                                      __ATOMIC_RELAXED);
+}
@@ -0,0 +1,174 @@
+#include <stdint.h>
+#include <string.h>
+#include "comm_sync.h"
+
+/**
+ * @file comm_sync.c
+ * @brief Implements the versioned delta sync.
+ *
+ * Every entry keeps only the version of its last change, so the changes after
+ * a version are the entries with a newer version, one message per entry
+ * however often it changed. A holder has at most COMM_SYNC_MAX_ENTRIES
+ * entries, so the changes are put in version order by selection instead of
+ * being kept in a log.
+ */
+
+/**
+ * @brief Empties a holder.
+ *
+ * @param holder Holder to set up.
+ */
+void commSyncInit(CommSyncHolder *holder) {
+    memset(holder, 0, sizeof(*holder));
+}
+
+/**
+ * @brief Sets the state of an entry, adding the entry if it is new.
+ *
+ * @param holder Holder.
+ * @param slaveId Slave the state belongs to.
+ * @param state New state.
+ * @param traceId Trace of the change, 0 if untraced.
+ * @return RET_OK on success, RET_ERROR if the holder is full.
+ */
+RetVal_t commSyncSet(CommSyncHolder *holder, uint32_t slaveId, int32_t state, uint32_t traceId) {
+    CommSyncEntry *entry = NULL;
+
+    for (uint32_t i = 0; i < holder->entryCount; i++) {
+        if (holder->entries[i].slaveId == slaveId) {
+            entry = &holder->entries[i];
+            break;
+        }
+    }
+    if (entry == NULL) {
+        if (holder->entryCount == COMM_SYNC_MAX_ENTRIES) {
+            return RET_ERROR;
+        }
+        entry = &holder->entries[holder->entryCount++];
+        entry->slaveId = slaveId;
+    } else if (entry->state == state) {
+        return RET_OK;
+    }
+
+    entry->state = state;
+    entry->traceId = traceId;
+    entry->version = ++holder->version;
+    return RET_OK;
+}
+
+/**
+ * @brief Handles a receiver's request for the changes after a version.
+ *
+ * @param holder Holder.
+ * @param version Version the receiver has.
+ */
+void commSyncRequest(CommSyncHolder *holder, uint32_t version) {
+    if (version > holder->version) {
+        // The receiver saw versions of an earlier run of the holder; continue above them
+        holder->version = version;
+        for (uint32_t i = 0; i < holder->entryCount; i++) {
+            holder->entries[i].version = ++holder->version;
+        }
+    }
+    holder->sentVersion = version;
+}
+
+/**
+ * @brief Builds the state messages of the entries changed after a version, in version order.
+ *
+ * @param holder Holder.
+ * @param type Message type.
+ * @param baseVersion Version the receiver has.
+ * @param snapshot Set to mark every message as a new history (baseVersion 0).
+ * @param messages Array to store the messages.
+ * @param capacity Size of the array.
+ * @return Number of messages built.
+ */
+static uint32_t collectAfter(const CommSyncHolder *holder, uint8_t type, uint32_t baseVersion, uint8_t snapshot,
+                             CommMessage *messages, uint32_t capacity) {
+    uint32_t count = 0;
+
+    while (count < capacity) {
+        const CommSyncEntry *next = NULL;
+        for (uint32_t i = 0; i < holder->entryCount; i++) {
+            const CommSyncEntry *entry = &holder->entries[i];
+            if (entry->version > baseVersion && (next == NULL || entry->version < next->version)) {
+                next = entry;
+            }
+        }
+        if (next == NULL) {
+            break;
+        }
+
+        CommMessage *message = &messages[count++];
+        memset(message, 0, sizeof(*message));
+        message->type = type;
+        message->payload = next->state;
+        message->traceId = next->traceId;
+        message->slaveId = next->slaveId;
+        message->version = next->version;
+        message->baseVersion = snapshot ? 0 : baseVersion;
+        baseVersion = next->version;
+    }
+    return count;
+}
+
+/**
+ * @brief Builds the state messages of the changes the receiver does not have.
+ *
+ * @param holder Holder.
+ * @param type Message type.
+ * @param messages Array to store the messages.
+ * @param capacity Size of the array.
+ * @return Number of messages built.
+ */
+uint32_t commSyncCollect(const CommSyncHolder *holder, uint8_t type, CommMessage *messages, uint32_t capacity) {
+    return collectAfter(holder, type, holder->sentVersion, 0, messages, capacity);
+}
+
+/**
+ * @brief Builds the state messages of every entry, each one a full history.
+ *
+ * @param holder Holder.
+ * @param type Message type.
+ * @param messages Array to store the messages.
+ * @param capacity Size of the array.
+ * @return Number of messages built.
+ */
+uint32_t commSyncCollectSnapshot(const CommSyncHolder *holder, uint8_t type, CommMessage *messages,
+                                 uint32_t capacity) {
+    return collectAfter(holder, type, 0, 1, messages, capacity);
+}
+
+/**
+ * @brief Records that the first count messages built by commSyncCollect() were sent.
+ *
+ * @param holder Holder.
+ * @param messages Messages built by commSyncCollect().
+ * @param count Number of them sent.
+ */
+void commSyncSent(CommSyncHolder *holder, const CommMessage *messages, uint32_t count) {
+    if (count != 0) {
+        holder->sentVersion = messages[count - 1].version;
+    }
+}
+
+/**
+ * @brief Checks a received state message against the receiver's version.
+ *
+ * @param version Version of the holder the receiver has.
+ * @param message Received state message.
+ * @return What to do with the message.
+ */
+CommSyncResult commSyncAccept(uint32_t *version, const CommMessage *message) {
+    if (message->baseVersion <= *version && message->version > *version) {
+        *version = message->version;
+        return COMM_SYNC_APPLY;
+    }
+    if (message->baseVersion == 0) {
+        // The holder started over, so its versions restart below the receiver's
+        *version = message->version;
+        return COMM_SYNC_APPLY;
+    }
+    return (message->version <= *version) ? COMM_SYNC_STALE : COMM_SYNC_GAP;
+}
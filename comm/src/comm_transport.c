@@ -0,0 +1,582 @@
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "comm_transport.h"
+#include "logger.h"
+
+/**
+ * @file comm_transport.c
+ * @brief Implements the queue, Unix domain socket and shared-memory transports.
+ *
+ * Each kind provides a send, a receive and a close operation, looked up in
+ * transportOps_ by the kind of the transport. The socket and shared-memory
+ * kinds only provide a non-blocking attempt; pollTransfer() turns it into a
+ * wait with a timeout: it retries COMM_TRANSPORT_SPIN_ATTEMPTS times with a
+ * yield, then sleeps COMM_TRANSPORT_POLL_MS between attempts, so a waiting
+ * task never holds the scheduler inside a system call.
+ */
+
+/**
+ * @brief Marks a shared-memory link initialized by its master end.
+ */
+#define COMM_SHM_MAGIC 0x434e5953u
+
+#define COMM_SHM_RING_MASK (COMM_RING_LENGTH - 1)
+
+/**
+ * @brief One direction of a shared-memory link.
+ *
+ * - head: Next slot to write; written by the producing process only.
+ * - tail: Next slot to read; written by the consuming process only.
+ * - slots: Message storage.
+ */
+typedef struct {
+    uint32_t head __attribute__((aligned(COMM_CACHE_LINE_SIZE)));
+    uint32_t tail __attribute__((aligned(COMM_CACHE_LINE_SIZE)));
+    CommMessage slots[COMM_RING_LENGTH] __attribute__((aligned(COMM_CACHE_LINE_SIZE)));
+} CommShmRing;
+
+/**
+ * @brief Layout of the shared-memory file.
+ *
+ * - magic: COMM_SHM_MAGIC while the master end has the link open, 0 otherwise.
+ * - rings: Master-to-slave ring (COMM_LINK_MASTER) and slave-to-master ring (COMM_LINK_SLAVE).
+ */
+typedef struct {
+    uint32_t magic;
+    CommShmRing rings[2];
+} CommShmLink;
+
+/**
+ * @brief Operations of a transport kind.
+ *
+ * - send: Sends a message, waiting up to the given ticks.
+ * - receive: Receives a message, waiting up to the given ticks.
+ * - close: Releases the resources of the transport end.
+ */
+typedef struct {
+    RetVal_t (*send)(CommTransport *transport, const CommMessage *message, TickType_t ticksToWait);
+    RetVal_t (*receive)(CommTransport *transport, CommMessage *message, TickType_t ticksToWait);
+    void (*close)(CommTransport *transport);
+} CommTransportOps;
+
+/**
+ * @brief Names of the transport kinds, indexed by CommTransportKind.
+ */
+static const char *const transportNames_[COMM_TRANSPORT_MAX] = {"queue", "unix", "shm"};
+
+/**
+ * @brief Repeats a non-blocking attempt until it succeeds or the timeout expires.
+ *
+ * @param transport Transport end.
+ * @param message Message passed to the attempt.
+ * @param ticksToWait Maximum time to wait.
+ * @param attempt Non-blocking send or receive attempt.
+ * @return RET_OK if an attempt succeeded, RET_ERROR on timeout.
+ */
+static RetVal_t pollTransfer(CommTransport *transport, void *message, TickType_t ticksToWait,
+                             RetVal_t (*attempt)(CommTransport *, void *)) {
+    TimeOut_t timeOut;
+    uint32_t spins = 0;
+
+    vTaskSetTimeOutState(&timeOut);
+    while (attempt(transport, message) != RET_OK) {
+        if (ticksToWait == 0 || xTaskCheckForTimeOut(&timeOut, &ticksToWait) != pdFALSE) {
+            return RET_ERROR;
+        }
+        if (spins < COMM_TRANSPORT_SPIN_ATTEMPTS) {
+            // The peer is usually just behind; a short retry avoids a whole poll period
+            spins++;
+            taskYIELD();
+        } else {
+            vTaskDelay(pdMS_TO_TICKS(COMM_TRANSPORT_POLL_MS));
+        }
+    }
+    return RET_OK;
+}
+
+/**
+ * @brief Sets up the fields shared by every transport kind.
+ *
+ * @return RET_OK on success, RET_ERROR if the lock could not be created.
+ */
+static RetVal_t initTransport(CommTransport *transport, CommTransportKind kind, const char *path, CommLinkSide side) {
+    memset(transport, 0, sizeof(*transport));
+    transport->kind = kind;
+    transport->side = side;
+    transport->path = path;
+    transport->listenFd = -1;
+    transport->socketFd = -1;
+    transport->lock = xSemaphoreCreateMutex();
+    if (transport->lock == NULL) {
+        LOG_MSG(LOG_LEVEL_ERROR, "CommTransport", "Failed to create the transport lock");
+        return RET_ERROR;
+    }
+    return RET_OK;
+}
+
+/**
+ * @brief Sends on the outgoing queue.
+ */
+static RetVal_t queueSendOp(CommTransport *transport, const CommMessage *message, TickType_t ticksToWait) {
+    return (xQueueSend(transport->sendQueue, message, ticksToWait) == pdPASS) ? RET_OK : RET_ERROR;
+}
+
+/**
+ * @brief Receives from the incoming queue.
+ */
+static RetVal_t queueReceiveOp(CommTransport *transport, CommMessage *message, TickType_t ticksToWait) {
+    return (xQueueReceive(transport->receiveQueue, message, ticksToWait) == pdPASS) ? RET_OK : RET_ERROR;
+}
+
+/**
+ * @brief Nothing to release; the queues belong to the caller.
+ */
+static void queueCloseOp(CommTransport *transport) {
+    (void)transport;
+}
+
+/**
+ * @brief Fills a Unix socket address for a path.
+ *
+ * @return RET_OK on success, RET_ERROR if the path is too long.
+ */
+static RetVal_t unixAddress(const char *path, struct sockaddr_un *address) {
+    if (strlen(path) >= sizeof(address->sun_path)) {
+        LOG_MSG(LOG_LEVEL_ERROR, "CommTransport", "Unix socket path is too long");
+        return RET_ERROR;
+    }
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    strcpy(address->sun_path, path);
+    return RET_OK;
+}
+
+/**
+ * @brief Creates a non-blocking SOCK_SEQPACKET Unix socket.
+ *
+ * @return Socket descriptor, or -1 on failure.
+ */
+static int32_t unixSocket(void) {
+    int32_t fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    if (fd >= 0 && fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK) < 0) {
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Returns the connected socket, connecting first if needed.
+ *
+ * The master end accepts a pending connection, the slave end connects to the
+ * master end. Both calls are non-blocking.
+ *
+ * @return Socket descriptor, or -1 while the peer is not connected.
+ */
+static int32_t unixConnected(CommTransport *transport) {
+    int32_t fd = __atomic_load_n(&transport->socketFd, __ATOMIC_ACQUIRE);
+    struct sockaddr_un address;
+
+    if (fd >= 0) {
+        return fd;
+    }
+    (void)xSemaphoreTake(transport->lock, portMAX_DELAY);
+    fd = transport->socketFd;
+    if (fd < 0) {
+        if (transport->side == COMM_LINK_MASTER) {
+            fd = accept(transport->listenFd, NULL, NULL);
+            if (fd >= 0 && fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK) < 0) {
+                close(fd);
+                fd = -1;
+            }
+        } else if (unixAddress(transport->path, &address) == RET_OK) {
+            fd = unixSocket();
+            if (fd >= 0 && connect(fd, (struct sockaddr *)&address, sizeof(address)) < 0 && errno != EINPROGRESS) {
+                close(fd);
+                fd = -1;
+            }
+        }
+        if (fd >= 0) {
+            LOG_MSG(LOG_LEVEL_INFO, "CommTransport", "Unix socket peer connected");
+            __atomic_store_n(&transport->socketFd, fd, __ATOMIC_RELEASE);
+        }
+    }
+    (void)xSemaphoreGive(transport->lock);
+    return fd;
+}
+
+/**
+ * @brief Drops a broken connection so the next attempt reconnects.
+ *
+ * @param fd Socket the caller found broken; ignored if already replaced.
+ */
+static void unixDisconnect(CommTransport *transport, int32_t fd) {
+    (void)xSemaphoreTake(transport->lock, portMAX_DELAY);
+    if (transport->socketFd == fd) {
+        __atomic_store_n(&transport->socketFd, -1, __ATOMIC_RELEASE);
+        close(fd);
+        LOG_MSG(LOG_LEVEL_WARN, "CommTransport", "Unix socket peer disconnected");
+    }
+    (void)xSemaphoreGive(transport->lock);
+}
+
+/**
+ * @brief Sends one packet without blocking.
+ */
+static RetVal_t unixTrySend(CommTransport *transport, void *message) {
+    int32_t fd = unixConnected(transport);
+    if (fd < 0) {
+        return RET_ERROR;
+    }
+    ssize_t sent = send(fd, message, sizeof(CommMessage), MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (sent == (ssize_t)sizeof(CommMessage)) {
+        return RET_OK;
+    }
+    if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        unixDisconnect(transport, fd);
+    }
+    return RET_ERROR;
+}
+
+/**
+ * @brief Receives one packet without blocking.
+ */
+static RetVal_t unixTryReceive(CommTransport *transport, void *message) {
+    int32_t fd = unixConnected(transport);
+    if (fd < 0) {
+        return RET_ERROR;
+    }
+    ssize_t received = recv(fd, message, sizeof(CommMessage), MSG_DONTWAIT);
+    if (received == (ssize_t)sizeof(CommMessage)) {
+        return RET_OK;
+    }
+    if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        unixDisconnect(transport, fd);
+    }
+    return RET_ERROR;
+}
+
+static RetVal_t unixSendOp(CommTransport *transport, const CommMessage *message, TickType_t ticksToWait) {
+    return pollTransfer(transport, (void *)message, ticksToWait, unixTrySend);
+}
+
+static RetVal_t unixReceiveOp(CommTransport *transport, CommMessage *message, TickType_t ticksToWait) {
+    return pollTransfer(transport, message, ticksToWait, unixTryReceive);
+}
+
+/**
+ * @brief Closes the sockets; the master end also removes the socket path.
+ */
+static void unixCloseOp(CommTransport *transport) {
+    if (transport->socketFd >= 0) {
+        close(transport->socketFd);
+        transport->socketFd = -1;
+    }
+    if (transport->listenFd >= 0) {
+        close(transport->listenFd);
+        transport->listenFd = -1;
+        (void)unlink(transport->path);
+    }
+}
+
+/**
+ * @brief Returns the mapped link, mapping it first on the slave end.
+ *
+ * The slave end maps the file only once the master end has initialized it,
+ * and drops its mapping when the master end has closed the link.
+ *
+ * @return Mapped link, or NULL while the master end is not ready.
+ */
+static CommShmLink *shmMapped(CommTransport *transport) {
+    CommShmLink *link = (CommShmLink *)__atomic_load_n(&transport->link, __ATOMIC_ACQUIRE);
+    struct stat info;
+
+    if (link != NULL || transport->side == COMM_LINK_MASTER) {
+        return link;
+    }
+    (void)xSemaphoreTake(transport->lock, portMAX_DELAY);
+    link = (CommShmLink *)transport->link;
+    if (link == NULL) {
+        int32_t fd = open(transport->path, O_RDWR);
+        if (fd >= 0) {
+            if (fstat(fd, &info) == 0 && info.st_size >= (off_t)sizeof(CommShmLink)) {
+                link = mmap(NULL, sizeof(CommShmLink), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (link == MAP_FAILED) {
+                    link = NULL;
+                } else if (__atomic_load_n(&link->magic, __ATOMIC_ACQUIRE) != COMM_SHM_MAGIC) {
+                    (void)munmap(link, sizeof(CommShmLink));
+                    link = NULL;
+                }
+            }
+            close(fd);
+        }
+        if (link != NULL) {
+            LOG_MSG(LOG_LEVEL_INFO, "CommTransport", "Shared-memory link mapped");
+            __atomic_store_n(&transport->link, (void *)link, __ATOMIC_RELEASE);
+        }
+    }
+    (void)xSemaphoreGive(transport->lock);
+    return link;
+}
+
+/**
+ * @brief Unmaps a link whose master end has gone, so the slave end maps the new one.
+ *
+ * Only checked when the ring is full or empty, off the fast path.
+ */
+static void shmCheckPeer(CommTransport *transport, CommShmLink *link) {
+    if (transport->side == COMM_LINK_MASTER || __atomic_load_n(&link->magic, __ATOMIC_ACQUIRE) == COMM_SHM_MAGIC) {
+        return;
+    }
+    (void)xSemaphoreTake(transport->lock, portMAX_DELAY);
+    if (transport->link == link) {
+        __atomic_store_n(&transport->link, (void *)NULL, __ATOMIC_RELEASE);
+        (void)munmap(link, sizeof(CommShmLink));
+        LOG_MSG(LOG_LEVEL_WARN, "CommTransport", "Shared-memory link closed by the master");
+    }
+    (void)xSemaphoreGive(transport->lock);
+}
+
+/**
+ * @brief Writes one message into the outgoing ring without blocking.
+ */
+static RetVal_t shmTrySend(CommTransport *transport, void *message) {
+    CommShmLink *link = shmMapped(transport);
+    if (link == NULL) {
+        return RET_ERROR;
+    }
+    CommShmRing *ring = &link->rings[transport->side];
+    uint32_t head = ring->head;
+    if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == COMM_RING_LENGTH) {
+        shmCheckPeer(transport, link);
+        return RET_ERROR;
+    }
+    ring->slots[head & COMM_SHM_RING_MASK] = *(const CommMessage *)message;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    return RET_OK;
+}
+
+/**
+ * @brief Reads one message from the incoming ring without blocking.
+ */
+static RetVal_t shmTryReceive(CommTransport *transport, void *message) {
+    CommShmLink *link = shmMapped(transport);
+    if (link == NULL) {
+        return RET_ERROR;
+    }
+    CommShmRing *ring = &link->rings[1 - transport->side];
+    uint32_t tail = ring->tail;
+    if (tail == __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) {
+        shmCheckPeer(transport, link);
+        return RET_ERROR;
+    }
+    *(CommMessage *)message = ring->slots[tail & COMM_SHM_RING_MASK];
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+    return RET_OK;
+}
+
+static RetVal_t shmSendOp(CommTransport *transport, const CommMessage *message, TickType_t ticksToWait) {
+    return pollTransfer(transport, (void *)message, ticksToWait, shmTrySend);
+}
+
+static RetVal_t shmReceiveOp(CommTransport *transport, CommMessage *message, TickType_t ticksToWait) {
+    return pollTransfer(transport, message, ticksToWait, shmTryReceive);
+}
+
+/**
+ * @brief Unmaps the link; the master end also marks it closed and removes the file.
+ */
+static void shmCloseOp(CommTransport *transport) {
+    CommShmLink *link = (CommShmLink *)transport->link;
+    if (link == NULL) {
+        return;
+    }
+    if (transport->side == COMM_LINK_MASTER) {
+        __atomic_store_n(&link->magic, 0, __ATOMIC_RELEASE);
+        (void)unlink(transport->path);
+    }
+    (void)munmap(link, sizeof(CommShmLink));
+    transport->link = NULL;
+}
+
+/**
+ * @brief Operations of each transport kind, indexed by CommTransportKind.
+ */
+static const CommTransportOps transportOps_[COMM_TRANSPORT_MAX] = {
+    {queueSendOp, queueReceiveOp, queueCloseOp},
+    {unixSendOp, unixReceiveOp, unixCloseOp},
+    {shmSendOp, shmReceiveOp, shmCloseOp},
+};
+
+/**
+ * @brief Opens an in-process transport end over two FreeRTOS queues.
+ *
+ * @param transport Transport end to set up.
+ * @param sendQueue Queue carrying the outgoing direction.
+ * @param receiveQueue Queue carrying the incoming direction.
+ * @return RET_OK on success, RET_ERROR otherwise.
+ */
+RetVal_t commTransportOpenQueue(CommTransport *transport, QueueHandle_t sendQueue, QueueHandle_t receiveQueue) {
+    if (sendQueue == NULL || receiveQueue == NULL) {
+        LOG_MSG(LOG_LEVEL_ERROR, "CommTransport", "Queue handle is NULL");
+        return RET_ERROR;
+    }
+    if (initTransport(transport, COMM_TRANSPORT_QUEUE, NULL, COMM_LINK_MASTER) != RET_OK) {
+        return RET_ERROR;
+    }
+    transport->sendQueue = sendQueue;
+    transport->receiveQueue = receiveQueue;
+    return RET_OK;
+}
+
+/**
+ * @brief Opens a Unix domain socket transport end.
+ *
+ * @param transport Transport end to set up.
+ * @param path Socket path.
+ * @param side End of the link; the master end listens.
+ * @return RET_OK on success, RET_ERROR otherwise.
+ */
+RetVal_t commTransportOpenUnix(CommTransport *transport, const char *path, CommLinkSide side) {
+    struct sockaddr_un address;
+
+    if (path == NULL || unixAddress(path, &address) != RET_OK ||
+        initTransport(transport, COMM_TRANSPORT_UNIX, path, side) != RET_OK) {
+        return RET_ERROR;
+    }
+    if (side == COMM_LINK_SLAVE) {
+        return RET_OK;
+    }
+
+    transport->listenFd = unixSocket();
+    if (transport->listenFd < 0) {
+        LOG_MSG(LOG_LEVEL_ERROR, "CommTransport", "Failed to create the Unix socket");
+        return RET_ERROR;
+    }
+    (void)unlink(path);
+    if (bind(transport->listenFd, (struct sockaddr *)&address, sizeof(address)) < 0 ||
+        listen(transport->listenFd, 1) < 0) {
+        LOG_MSG(LOG_LEVEL_ERROR, "CommTransport", "Failed to listen on the Unix socket");
+        close(transport->listenFd);
+        transport->listenFd = -1;
+        return RET_ERROR;
+    }
+    return RET_OK;
+}
+
+/**
+ * @brief Opens a shared-memory transport end.
+ *
+ * @param transport Transport end to set up.
+ * @param path Shared-memory file.
+ * @param side End of the link; the master end creates the file.
+ * @return RET_OK on success, RET_ERROR otherwise.
+ */
+RetVal_t commTransportOpenShm(CommTransport *transport, const char *path, CommLinkSide side) {
+    if (path == NULL || initTransport(transport, COMM_TRANSPORT_SHM, path, side) != RET_OK) {
+        return RET_ERROR;
+    }
+    if (side == COMM_LINK_SLAVE) {
+        return RET_OK;
+    }
+
+    // A fresh file, so a slave still mapping the previous one sees it closed
+    (void)unlink(path);
+    int32_t fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0 || ftruncate(fd, sizeof(CommShmLink)) < 0) {
+        LOG_MSG(LOG_LEVEL_ERROR, "CommTransport", "Failed to create the shared-memory file");
+        if (fd >= 0) {
+            close(fd);
+        }
+        return RET_ERROR;
+    }
+    CommShmLink *link = mmap(NULL, sizeof(CommShmLink), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (link == MAP_FAILED) {
+        LOG_MSG(LOG_LEVEL_ERROR, "CommTransport", "Failed to map the shared-memory file");
+        return RET_ERROR;
+    }
+    // ftruncate() zero-fills the rings; publish the link once it is complete
+    __atomic_store_n(&link->magic, COMM_SHM_MAGIC, __ATOMIC_RELEASE);
+    transport->link = link;
+    return RET_OK;
+}
+
+/**
+ * @brief Checks that a transport end was opened and not closed since.
+ *
+ * Every open function creates the lock and commTransportClose() deletes it,
+ * so a zeroed or closed transport has none.
+ *
+ * @return 1 if the transport is open, 0 otherwise.
+ */
+static uint8_t isOpen(const CommTransport *transport) {
+    return transport->lock != NULL && transport->kind < COMM_TRANSPORT_MAX;
+}
+
+/**
+ * @brief Sends a message through the operations of the transport kind.
+ */
+RetVal_t commTransportSend(CommTransport *transport, const CommMessage *message, TickType_t ticksToWait) {
+    if (!isOpen(transport)) {
+        LOG_MSG(LOG_LEVEL_ERROR, "CommTransport", "Send on a transport that is not open");
+        return RET_ERROR;
+    }
+    return transportOps_[transport->kind].send(transport, message, ticksToWait);
+}
+
+/**
+ * @brief Receives a message through the operations of the transport kind.
+ */
+RetVal_t commTransportReceive(CommTransport *transport, CommMessage *message, TickType_t ticksToWait) {
+    if (!isOpen(transport)) {
+        LOG_MSG(LOG_LEVEL_ERROR, "CommTransport", "Receive on a transport that is not open");
+        return RET_ERROR;
+    }
+    return transportOps_[transport->kind].receive(transport, message, ticksToWait);
+}
+
+/**
+ * @brief Closes a transport end and deletes its lock.
+ */
+void commTransportClose(CommTransport *transport) {
+    if (!isOpen(transport)) {
+        return;
+    }
+    transportOps_[transport->kind].close(transport);
+    if (transport->lock != NULL) {
+        vSemaphoreDelete(transport->lock);
+        transport->lock = NULL;
+    }
+}
+
+/**
+ * @brief Looks up a transport kind by name.
+ */
+RetVal_t commTransportParse(const char *name, CommTransportKind *kind) {
+    for (uint32_t i = 0; i < COMM_TRANSPORT_MAX; i++) {
+        if (strcmp(name, transportNames_[i]) == 0) {
+            *kind = (CommTransportKind)i;
+            return RET_OK;
+        }
+    }
+    return RET_ERROR;
+}
+
+/**
+ * @brief Returns the name of a transport kind.
+ */
+const char *commTransportName(CommTransportKind kind) {
+    return (kind < COMM_TRANSPORT_MAX) ? transportNames_[kind] : "unknown";
+}
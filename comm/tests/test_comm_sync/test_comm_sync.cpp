@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+extern "C" {
+    #include "comm_sync.h"
+    #include "state_mashine_types.h"
+}
+
+// ==========================
+// Test Fixture
+// ==========================
+// A holder and the version of the receiver it syncs to
+class CommSyncTest : public ::testing::Test {
+protected:
+    CommSyncHolder holder_;
+    uint32_t receiverVersion_ = 0;
+    CommMessage messages_[COMM_SYNC_MAX_ENTRIES];
+
+    void SetUp() override {
+        commSyncInit(&holder_);
+        receiverVersion_ = 0;
+    }
+
+    // Collects the changes the receiver does not have and records them as sent
+    uint32_t collectAndSend() {
+        uint32_t count = commSyncCollect(&holder_, COMM_MSG_SLAVE_STATE, messages_, COMM_SYNC_MAX_ENTRIES);
+        commSyncSent(&holder_, messages_, count);
+        return count;
+    }
+};
+
+// ==========================
+// Unit Tests
+// ==========================
+// Test that each change is sent once, follows the previous one and is applied
+TEST_F(CommSyncTest, Collect_InOrderDelta_Applies) {
+    ASSERT_EQ(commSyncSet(&holder_, 0, SLAVE_STATE_ACTIVE, 7), RET_OK);
+    ASSERT_EQ(collectAndSend(), 1u);
+    EXPECT_EQ(messages_[0].type, COMM_MSG_SLAVE_STATE);
+    EXPECT_EQ(messages_[0].payload, SLAVE_STATE_ACTIVE);
+    EXPECT_EQ(messages_[0].traceId, 7u);
+    EXPECT_EQ(messages_[0].baseVersion, 0u);
+    EXPECT_EQ(messages_[0].version, 1u);
+    EXPECT_EQ(commSyncAccept(&receiverVersion_, &messages_[0]), COMM_SYNC_APPLY);
+
+    // The same state is not a change
+    ASSERT_EQ(commSyncSet(&holder_, 0, SLAVE_STATE_ACTIVE, 0), RET_OK);
+    EXPECT_EQ(collectAndSend(), 0u);
+
+    ASSERT_EQ(commSyncSet(&holder_, 0, SLAVE_STATE_FAULT, 0), RET_OK);
+    ASSERT_EQ(collectAndSend(), 1u);
+    EXPECT_EQ(messages_[0].baseVersion, 1u);
+    EXPECT_EQ(messages_[0].version, 2u);
+    EXPECT_EQ(commSyncAccept(&receiverVersion_, &messages_[0]), COMM_SYNC_APPLY);
+    EXPECT_EQ(receiverVersion_, 2u);
+}
+
+// Test that a change after a lost one is a gap, and the request resends from the receiver's version
+TEST_F(CommSyncTest, Accept_SequenceGap_ResyncsFromReceiverVersion) {
+    CommMessage lost[COMM_SYNC_MAX_ENTRIES];
+    ASSERT_EQ(commSyncSet(&holder_, 0, SLAVE_STATE_ACTIVE, 0), RET_OK);
+    ASSERT_EQ(collectAndSend(), 1u);
+    EXPECT_EQ(commSyncAccept(&receiverVersion_, &messages_[0]), COMM_SYNC_APPLY);
+
+    ASSERT_EQ(commSyncSet(&holder_, 1, SLAVE_STATE_SLEEP, 0), RET_OK);
+    ASSERT_EQ(commSyncCollect(&holder_, COMM_MSG_SLAVE_STATE, lost, COMM_SYNC_MAX_ENTRIES), 1u);
+    commSyncSent(&holder_, lost, 1);
+    ASSERT_EQ(commSyncSet(&holder_, 0, SLAVE_STATE_FAULT, 0), RET_OK);
+    ASSERT_EQ(collectAndSend(), 1u);
+    EXPECT_EQ(commSyncAccept(&receiverVersion_, &messages_[0]), COMM_SYNC_GAP);
+    EXPECT_EQ(receiverVersion_, 1u);
+
+    commSyncRequest(&holder_, receiverVersion_);
+    ASSERT_EQ(collectAndSend(), 2u);
+    EXPECT_EQ(messages_[0].slaveId, 1u);
+    EXPECT_EQ(messages_[1].payload, SLAVE_STATE_FAULT);
+    EXPECT_EQ(commSyncAccept(&receiverVersion_, &messages_[0]), COMM_SYNC_APPLY);
+    EXPECT_EQ(commSyncAccept(&receiverVersion_, &messages_[1]), COMM_SYNC_APPLY);
+    EXPECT_EQ(receiverVersion_, 3u);
+}
+
+// Test that a duplicate or older change is stale and leaves the receiver's version alone
+TEST_F(CommSyncTest, Accept_DuplicateOrOldVersion_IsStale) {
+    ASSERT_EQ(commSyncSet(&holder_, 0, SLAVE_STATE_ACTIVE, 0), RET_OK);
+    ASSERT_EQ(collectAndSend(), 1u);
+    CommMessage first = messages_[0];
+    ASSERT_EQ(commSyncSet(&holder_, 0, SLAVE_STATE_SLEEP, 0), RET_OK);
+    ASSERT_EQ(collectAndSend(), 1u);
+    CommMessage second = messages_[0];
+
+    EXPECT_EQ(commSyncAccept(&receiverVersion_, &first), COMM_SYNC_APPLY);
+    EXPECT_EQ(commSyncAccept(&receiverVersion_, &second), COMM_SYNC_APPLY);
+    EXPECT_EQ(commSyncAccept(&receiverVersion_, &second), COMM_SYNC_STALE);
+    second.baseVersion = 1;
+    second.version = 1;
+    EXPECT_EQ(commSyncAccept(&receiverVersion_, &second), COMM_SYNC_STALE);
+    EXPECT_EQ(receiverVersion_, 2u);
+}
+
+// Test that the holder refuses a new entry past COMM_SYNC_MAX_ENTRIES but still updates the others
+TEST_F(CommSyncTest, Set_TableFull_RefusesNewEntry) {
+    for (uint32_t i = 0; i < COMM_SYNC_MAX_ENTRIES; i++) {
+        ASSERT_EQ(commSyncSet(&holder_, i, SLAVE_STATE_ACTIVE, 0), RET_OK);
+    }
+    EXPECT_EQ(commSyncSet(&holder_, COMM_SYNC_MAX_ENTRIES, SLAVE_STATE_ACTIVE, 0), RET_ERROR);
+    EXPECT_EQ(holder_.entryCount, (uint32_t)COMM_SYNC_MAX_ENTRIES);
+    EXPECT_EQ(collectAndSend(), (uint32_t)COMM_SYNC_MAX_ENTRIES);
+
+    EXPECT_EQ(commSyncSet(&holder_, 0, SLAVE_STATE_FAULT, 0), RET_OK);
+    ASSERT_EQ(collectAndSend(), 1u);
+    EXPECT_EQ(messages_[0].slaveId, 0u);
+    EXPECT_EQ(messages_[0].version, (uint32_t)COMM_SYNC_MAX_ENTRIES + 1);
+}
+
+// Test that a holder that restarted below the receiver's version continues above it
+TEST_F(CommSyncTest, Request_VersionAboveHolder_ContinuesAboveIt) {
+    receiverVersion_ = 9;
+    ASSERT_EQ(commSyncSet(&holder_, 0, SLAVE_STATE_SLEEP, 0), RET_OK);
+    commSyncRequest(&holder_, receiverVersion_);
+    ASSERT_EQ(collectAndSend(), 1u);
+    EXPECT_EQ(messages_[0].baseVersion, 9u);
+    EXPECT_EQ(messages_[0].version, 10u);
+    EXPECT_EQ(commSyncAccept(&receiverVersion_, &messages_[0]), COMM_SYNC_APPLY);
+}
+
+// Test that a snapshot carries every entry as a new history and does not count as sent
+TEST_F(CommSyncTest, CollectSnapshot_SendsEveryEntryWithBaseVersionZero) {
+    ASSERT_EQ(commSyncSet(&holder_, 0, SLAVE_STATE_ACTIVE, 0), RET_OK);
+    ASSERT_EQ(commSyncSet(&holder_, 1, SLAVE_STATE_SLEEP, 0), RET_OK);
+    ASSERT_EQ(collectAndSend(), 2u);
+
+    receiverVersion_ = 5;
+    ASSERT_EQ(commSyncCollectSnapshot(&holder_, COMM_MSG_SLAVE_STATE, messages_, COMM_SYNC_MAX_ENTRIES), 2u);
+    EXPECT_EQ(messages_[0].baseVersion, 0u);
+    EXPECT_EQ(messages_[1].baseVersion, 0u);
+    EXPECT_EQ(commSyncAccept(&receiverVersion_, &messages_[1]), COMM_SYNC_APPLY);
+    EXPECT_EQ(commSyncCollect(&holder_, COMM_MSG_SLAVE_STATE, messages_, COMM_SYNC_MAX_ENTRIES), 0u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
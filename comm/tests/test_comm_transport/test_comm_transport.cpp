@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <deque>
+#include <map>
+#include "comm_transport.h"
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "task.h"
+#include "logger.h"
+
+// ==========================
+// Fake FreeRTOS Queues
+// ==========================
+// Each queue handle maps to a FIFO of messages of a fixed length, so both ends of a link can be run in one test
+#define FAKE_QUEUE_LENGTH 2
+
+std::map<QueueHandle_t, std::deque<CommMessage>> fakeQueues;
+int mutexCount = 0;
+
+// Logger mock, to check that misuse is reported
+class LoggerMock {
+public:
+    MOCK_METHOD(void, logMessage, (LogLevel, const char*, const char*));
+};
+
+LoggerMock* loggerMock = nullptr;
+
+// ==========================
+// C Function Redirection
+// ==========================
+extern "C" {
+    __attribute__((weak)) BaseType_t xQueueGenericSend(QueueHandle_t queue, const void* item, TickType_t wait,
+                                                       BaseType_t copyPosition) {
+        std::deque<CommMessage>& fifo = fakeQueues[queue];
+        if (fifo.size() == FAKE_QUEUE_LENGTH) {
+            return pdFAIL;
+        }
+        fifo.push_back(*static_cast<const CommMessage*>(item));
+        return pdPASS;
+    }
+
+    __attribute__((weak)) BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t wait) {
+        std::deque<CommMessage>& fifo = fakeQueues[queue];
+        if (fifo.empty()) {
+            return pdFAIL;
+        }
+        *static_cast<CommMessage*>(item) = fifo.front();
+        fifo.pop_front();
+        return pdPASS;
+    }
+
+    __attribute__((weak)) QueueHandle_t xQueueCreateMutex(uint8_t queueType) {
+        mutexCount++;
+        return reinterpret_cast<QueueHandle_t>(0x100);
+    }
+
+    __attribute__((weak)) void vQueueDelete(QueueHandle_t queue) {
+        mutexCount--;
+    }
+
+    __attribute__((weak)) BaseType_t xQueueSemaphoreTake(QueueHandle_t queue, TickType_t wait) {
+        return pdTRUE;
+    }
+
+    __attribute__((weak)) void vTaskSetTimeOutState(TimeOut_t* timeOut) {
+    }
+
+    __attribute__((weak)) BaseType_t xTaskCheckForTimeOut(TimeOut_t* timeOut, TickType_t* ticksToWait) {
+        return pdTRUE;
+    }
+
+    __attribute__((weak)) void vTaskDelay(TickType_t ticks) {
+    }
+
+    __attribute__((weak)) void vPortYield(void) {
+    }
+
+    void logMessage(LogLevel level, const char* module, const char* message) {
+        if (loggerMock == nullptr) {
+            abort();
+        }
+        loggerMock->logMessage(level, module, message);
+    }
+
+    uint8_t logComponentLevelEnabled(LogComponentId* site, const char* component, LogLevel level) {
+        return 1;
+    }
+}
+
+// ==========================
+// Test Fixture
+// ==========================
+// The master end sends on masterToSlave_ and receives on slaveToMaster_; the slave end the other way round
+class CommTransportTest : public ::testing::Test {
+protected:
+    QueueHandle_t masterToSlave_ = reinterpret_cast<QueueHandle_t>(0x10);
+    QueueHandle_t slaveToMaster_ = reinterpret_cast<QueueHandle_t>(0x20);
+    CommTransport master_;
+    CommTransport slave_;
+
+    void SetUp() override {
+        loggerMock = new LoggerMock();
+        fakeQueues.clear();
+        mutexCount = 0;
+    }
+
+    void TearDown() override {
+        delete loggerMock;
+        loggerMock = nullptr;
+    }
+};
+
+// ==========================
+// Unit Tests
+// ==========================
+// Test that messages sent by one end of a queue link are received in order by the other end
+TEST_F(CommTransportTest, QueueTransport_SendsAndReceivesBothWays) {
+    CommMessage first = {COMM_MSG_MASTER_STATE, COMM_SOURCE_MASTER, 1, 2};
+    CommMessage second = {COMM_MSG_MASTER_STATE, COMM_SOURCE_MASTER, 2, 0};
+    CommMessage reply = {COMM_MSG_SLAVE_STATE, COMM_SOURCE_SLAVE, 1, 1};
+    CommMessage received = {};
+    EXPECT_CALL(*loggerMock, logMessage(testing::_, testing::_, testing::_)).Times(0);
+    ASSERT_EQ(commTransportOpenQueue(&master_, masterToSlave_, slaveToMaster_), RET_OK);
+    ASSERT_EQ(commTransportOpenQueue(&slave_, slaveToMaster_, masterToSlave_), RET_OK);
+    EXPECT_EQ(master_.kind, COMM_TRANSPORT_QUEUE);
+
+    EXPECT_EQ(commTransportSend(&master_, &first, 0), RET_OK);
+    EXPECT_EQ(commTransportSend(&master_, &second, 0), RET_OK);
+    EXPECT_EQ(commTransportReceive(&slave_, &received, 0), RET_OK);
+    EXPECT_EQ(received.sequence, 1u);
+    EXPECT_EQ(received.payload, 2);
+    EXPECT_EQ(commTransportReceive(&slave_, &received, 0), RET_OK);
+    EXPECT_EQ(received.sequence, 2u);
+
+    EXPECT_EQ(commTransportSend(&slave_, &reply, 0), RET_OK);
+    EXPECT_EQ(commTransportReceive(&master_, &received, 0), RET_OK);
+    EXPECT_EQ(received.type, COMM_MSG_SLAVE_STATE);
+    EXPECT_EQ(received.sourceId, COMM_SOURCE_SLAVE);
+
+    commTransportClose(&master_);
+    commTransportClose(&slave_);
+    EXPECT_EQ(mutexCount, 0);
+}
+
+// Test that an empty or full queue fails without waiting instead of blocking
+TEST_F(CommTransportTest, QueueTransport_EmptyOrFull_ReturnsRET_ERROR) {
+    CommMessage message = {COMM_MSG_MASTER_STATE, COMM_SOURCE_MASTER, 0, 0};
+    ASSERT_EQ(commTransportOpenQueue(&master_, masterToSlave_, slaveToMaster_), RET_OK);
+    EXPECT_EQ(commTransportReceive(&master_, &message, 0), RET_ERROR);
+    for (int i = 0; i < FAKE_QUEUE_LENGTH; i++) {
+        EXPECT_EQ(commTransportSend(&master_, &message, 0), RET_OK);
+    }
+    EXPECT_EQ(commTransportSend(&master_, &message, 0), RET_ERROR);
+    commTransportClose(&master_);
+}
+
+// Test that a queue transport needs both queues
+TEST_F(CommTransportTest, OpenQueue_NullQueue_ReturnsRET_ERROR) {
+    EXPECT_CALL(*loggerMock, logMessage(LOG_LEVEL_ERROR, testing::_, testing::_)).Times(2);
+    EXPECT_EQ(commTransportOpenQueue(&master_, nullptr, slaveToMaster_), RET_ERROR);
+    EXPECT_EQ(commTransportOpenQueue(&master_, masterToSlave_, nullptr), RET_ERROR);
+}
+
+// Test that a transport that was never opened fails to send and receive and is not closed
+TEST_F(CommTransportTest, UnopenedTransport_ReturnsRET_ERROR) {
+    CommTransport transport = {};
+    CommMessage message = {COMM_MSG_MASTER_STATE, COMM_SOURCE_MASTER, 0, 0};
+    EXPECT_CALL(*loggerMock, logMessage(LOG_LEVEL_ERROR, testing::_, testing::_)).Times(2);
+    EXPECT_EQ(commTransportSend(&transport, &message, 0), RET_ERROR);
+    EXPECT_EQ(commTransportReceive(&transport, &message, 0), RET_ERROR);
+    commTransportClose(&transport);
+    EXPECT_EQ(mutexCount, 0);
+    EXPECT_TRUE(fakeQueues.empty());
+}
+
+// Test that a closed transport no longer reaches its queues and can be closed again
+TEST_F(CommTransportTest, ClosedTransport_ReturnsRET_ERROR) {
+    CommMessage message = {COMM_MSG_MASTER_STATE, COMM_SOURCE_MASTER, 0, 0};
+    ASSERT_EQ(commTransportOpenQueue(&master_, masterToSlave_, slaveToMaster_), RET_OK);
+    commTransportClose(&master_);
+    EXPECT_EQ(mutexCount, 0);
+
+    EXPECT_CALL(*loggerMock, logMessage(LOG_LEVEL_ERROR, testing::_, testing::_)).Times(2);
+    EXPECT_EQ(commTransportSend(&master_, &message, 0), RET_ERROR);
+    EXPECT_EQ(commTransportReceive(&master_, &message, 0), RET_ERROR);
+    EXPECT_TRUE(fakeQueues[masterToSlave_].empty());
+    commTransportClose(&master_);
+    EXPECT_EQ(mutexCount, 0);
+}
+
+// Test the transport names used on the command line
+TEST_F(CommTransportTest, ParseAndName_RoundTrip) {
+    CommTransportKind kind = COMM_TRANSPORT_MAX;
+    for (int i = 0; i < COMM_TRANSPORT_MAX; i++) {
+        ASSERT_EQ(commTransportParse(commTransportName((CommTransportKind)i), &kind), RET_OK);
+        EXPECT_EQ(kind, (CommTransportKind)i);
+    }
+    EXPECT_EQ(commTransportParse("pipe", &kind), RET_ERROR);
+    EXPECT_STREQ(commTransportName(COMM_TRANSPORT_MAX), "unknown");
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
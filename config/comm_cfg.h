@@ -18,11 +18,177 @@
 #define TICK_TO_WAIT_SEND_MS 100
 
 /**
- * @brief Delay after sending a message (in ms).
+ * @brief Default pacing delay after a send call (in ms).
  *
- * Specifies a delay (in milliseconds) after successfully sending a message
- * to allow communication systems to stabilize.
+ * Specifies a delay (in milliseconds) after successfully sending a message,
+ * or a batch of messages, to allow communication systems to stabilize. It can
+ * be changed or disabled at run time with setSendPacingMaster() and
+ * setSendPacingSlave().
  */
 #define DELAY_SEND_MS 10
 
+/**
+ * @brief Uses latest-value mailboxes for the master-slave state channels.
+ *
+ * When set to 1, each directional channel holds only the newest message: a send
+ * overwrites the pending message instead of waiting for space, so writers never
+ * block and a reader always gets the latest state. The sequence number of the
+ * envelope is its version; overwritten intermediate states are counted as
+ * skipped. When set to 0, the channels are FIFO queues.
+ *
+ * The comm modules treat any channel of length 1 as a mailbox. The state sync
+ * (comm_sync.h) would lose requests and changes overwritten in a mailbox, so on
+ * a mailbox it sends no request and sends the whole state on every sync call,
+ * including each heartbeat.
+ */
+#define COMM_STATE_MAILBOX 0
+
+/**
+ * @brief Number of message blocks in the pool.
+ *
+ * Bounds the blocks in flight between producers and consumers; allocation
+ * fails when all of them are held.
+ */
+#define COMM_POOL_BLOCKS 16
+
+/**
+ * @brief Payload size of a message block (in bytes).
+ */
+#define COMM_BLOCK_SIZE 1024
+
+/**
+ * @brief Length of the slave-to-master block channel.
+ *
+ * The channel carries block pointers only; a full channel drops the block
+ * instead of blocking the producer.
+ */
+#define COMM_BLOCK_CHANNEL_LENGTH 8
+
+/**
+ * @brief Largest payload carried by a payload pipeline (in bytes).
+ */
+#define COMM_PIPELINE_MAX_PAYLOAD 1024
+
+/**
+ * @brief Message buffer size of each payload pipeline consumer (in bytes).
+ *
+ * Every queued payload takes its length plus a sizeof(size_t) length prefix.
+ */
+#define COMM_PIPELINE_BUFFER_SIZE (16 * 1024)
+
+/**
+ * @brief Maximum number of consumers of a payload pipeline.
+ */
+#define COMM_PIPELINE_MAX_CONSUMERS 4
+
+/**
+ * @brief Time the TCP task waits for space in a consumer's pipeline buffer before dropping the payload for it (in ms).
+ */
+#define COMM_PIPELINE_PUBLISH_WAIT_MS 10
+
+/**
+ * @brief Uses lock-free ring channels for the master-slave state channels.
+ *
+ * When set to 1, main.c connects the master and the slave with two CommRing
+ * single-producer, single-consumer rings (comm_ring.h) instead of FreeRTOS
+ * queues. The rings are FIFO, so COMM_STATE_MAILBOX must be 0.
+ */
+#define COMM_STATE_RING 0
+
+/**
+ * @brief Number of messages a ring channel holds (a power of two).
+ */
+#define COMM_RING_LENGTH 16
+
+/**
+ * @brief Task notification index used to block on a ring channel.
+ *
+ * Must be below configTASK_NOTIFICATION_ARRAY_ENTRIES; index 0 is left to the
+ * tasks themselves.
+ */
+#define COMM_RING_NOTIFY_INDEX 1
+
+/**
+ * @brief Cache line size (in bytes) the ring channel indexes are padded to.
+ */
+#define COMM_CACHE_LINE_SIZE 64
+
+/**
+ * @brief Overflow policies of the master-to-slave and slave-to-master channels.
+ *
+ * Applied by main.c at start-up (CommOverflowPolicy in comm_types.h); they
+ * only matter for FIFO channels, since a mailbox is always overwritten.
+ * COMM_OVERFLOW_BLOCK waits up to COMM_OVERFLOW_DEADLINE_MS and fails,
+ * COMM_OVERFLOW_DROP_OLDEST discards the oldest queued message and
+ * COMM_OVERFLOW_COALESCE holds back only the newest message until there is
+ * room. The slave channel is read through the master fan-in queue set, so it
+ * must not use COMM_OVERFLOW_DROP_OLDEST (main.c fails to build with it).
+ */
+#define COMM_OVERFLOW_POLICY_MASTER COMM_OVERFLOW_BLOCK
+#define COMM_OVERFLOW_POLICY_SLAVE  COMM_OVERFLOW_BLOCK
+
+/**
+ * @brief Deadline of the COMM_OVERFLOW_BLOCK policy (in ms).
+ */
+#define COMM_OVERFLOW_DEADLINE_MS TICK_TO_WAIT_SEND_MS
+
+/**
+ * @brief Maximum number of slave-to-master channels of the master fan-in.
+ */
+#define COMM_FANIN_MAX_CHANNELS 32
+
+/**
+ * @brief Number of messages the master receiver task takes per wake-up.
+ *
+ * With fan-in, one wake-up serves up to this many messages from the ready
+ * slave channels before the task sleeps again.
+ */
+#define COMM_RECEIVE_BATCH_SIZE 8
+
+/**
+ * @brief Maximum number of state entries of a sync holder (comm_sync.h).
+ *
+ * Also the largest batch of changes sent at once.
+ */
+#define COMM_SYNC_MAX_ENTRIES 32
+
+/**
+ * @brief Slave id of the slave run by this process, in its state messages.
+ *
+ * The master takes a slave's channel id as its holder: main.c adds the
+ * slave-to-master channel of the slave with this id at the same index of the
+ * fan-in.
+ */
+#define COMM_SYNC_SLAVE_ID 0
+
+/**
+ * @brief Default transport of the master-slave link.
+ *
+ * One of COMM_TRANSPORT_QUEUE, COMM_TRANSPORT_UNIX or COMM_TRANSPORT_SHM
+ * (comm_transport.h); the -t command line option overrides it. With
+ * COMM_TRANSPORT_QUEUE the master and the slave run in one process over the
+ * channels selected by COMM_STATE_MAILBOX and COMM_STATE_RING.
+ */
+#define COMM_TRANSPORT_DEFAULT COMM_TRANSPORT_QUEUE
+
+/**
+ * @brief Socket path of the Unix domain socket transport.
+ */
+#define COMM_TRANSPORT_UNIX_PATH "/tmp/state_sync.sock"
+
+/**
+ * @brief File of the shared-memory transport.
+ */
+#define COMM_TRANSPORT_SHM_PATH "/dev/shm/state_sync.link"
+
+/**
+ * @brief Poll period of a socket or shared-memory transport end waiting for its peer (in ms).
+ */
+#define COMM_TRANSPORT_POLL_MS 1
+
+/**
+ * @brief Attempts a waiting socket or shared-memory transport end retries with a yield before it sleeps.
+ */
+#define COMM_TRANSPORT_SPIN_ATTEMPTS 64
+
 #endif // COMM_CFG_H
@@ -0,0 +1,344 @@
+#ifndef LOGGER_CFG_H
+#define LOGGER_CFG_H
+
+/**
+ * @file logger_cfg.h
+ * @brief Configuration file for the logger.
+ *
+ * This file defines the log file location, the sizing of the asynchronous
+ * logging path (record ring buffer and flush batching), the binary record
+ * format options, the rotation of the memory-mapped log segments and their
+ * query index, the component registry and the per-task flight recorder.
+ */
+
+/**
+ * @brief Text log file name.
+ *
+ * Used when log segments are disabled, and for records logged before initLogger().
+ */
+#define LOG_FILE "system_log.txt"
+
+/**
+ * @brief Enables the asynchronous logging path.
+ *
+ * When set to 1, log records are copied into a lock-free ring buffer and
+ * written to the log file by a dedicated flush task. When set to 0, every
+ * record is written synchronously by the calling task.
+ */
+#define LOG_ASYNC_ENABLED 1
+
+/**
+ * @brief Number of records held by the log ring buffer.
+ *
+ * Must be a power of two.
+ */
+#define LOG_RING_SIZE 256
+
+/**
+ * @brief Maximum size of one formatted log record (in bytes).
+ *
+ * Records longer than this are truncated.
+ */
+#define LOG_RECORD_SIZE 320
+
+/**
+ * @brief Size of the stdio buffer used by the flush task (in bytes).
+ *
+ * The flush task keeps the log file open and lets stdio merge the records
+ * of one batch into large writes.
+ */
+#define LOG_FILE_BUFFER_SIZE (64 * 1024)
+
+/**
+ * @brief Enables the binary (deferred-format) log output.
+ *
+ * When set to 1, records are written to LOG_BINARY_FILE as format ids, tick
+ * timestamps and raw arguments instead of formatted text. Use printLogMessages()
+ * or the log_decoder tool to turn the file back into text.
+ */
+#define LOG_BINARY_ENABLED 0
+
+/**
+ * @brief Binary log file name.
+ */
+#define LOG_BINARY_FILE "system_log.bin"
+
+/**
+ * @brief Number of entries of the format and component id tables.
+ *
+ * Must be a power of two. Formats that do not fit are logged as plain text records.
+ */
+#define LOG_BINARY_TABLE_SIZE 256
+
+/**
+ * @brief Maximum number of arguments of a binary-encoded format string.
+ *
+ * Format strings with more arguments are logged as plain text records.
+ */
+#define LOG_BINARY_MAX_ARGS 8
+
+/**
+ * @brief Maximum number of bytes stored for one string (%s) argument.
+ */
+#define LOG_BINARY_MAX_STRING_ARG 64
+
+/**
+ * @brief Numeric value of the LogLevel used until setLogLevel() is called.
+ *
+ * 0 = DEBUG, 1 = INFO, 2 = WARN, 3 = ERROR.
+ */
+#define LOG_DEFAULT_LEVEL 1
+
+/**
+ * @brief Maximum number of log components, "Other" included.
+ *
+ * Components registered after the table is full are logged as "Other".
+ */
+#define LOG_COMPONENT_MAX 64
+
+/**
+ * @brief Maximum length of a component name, terminating NUL included.
+ */
+#define LOG_COMPONENT_NAME_SIZE 32
+
+/**
+ * @brief Number of entries of the component name address cache.
+ *
+ * Must be a power of two, larger than the number of distinct component
+ * strings passed to logMessage()/logMessageFormatted().
+ */
+#define LOG_COMPONENT_CACHE_SIZE 256
+
+/**
+ * @brief Length of one rate-limiting window (in milliseconds).
+ *
+ * LOG_MSG_LIMITED()/LOG_FMT_LIMITED() call sites log at most their limit of
+ * records per window.
+ */
+#define LOG_RATE_LIMIT_WINDOW_MS 1000
+
+/**
+ * @brief Records per window of the hot-path debug call sites.
+ *
+ * Used by the per-message queue traffic and state dispatch logs, which fire
+ * every few tens of milliseconds per task.
+ */
+#define LOG_RATE_LIMIT_HOT_PATH 5
+
+/**
+ * @brief Enables the memory-mapped log segments.
+ *
+ * When set to 1, the log is written into preallocated files of LOG_SEGMENT_SIZE
+ * bytes named LOG_SEGMENT_PREFIX.<sequence>.txt (.bin in binary mode) instead of
+ * a single ever-growing file. Writing a record is a copy into the mapped file,
+ * without a system call.
+ */
+#define LOG_SEGMENT_ENABLED 1
+
+/**
+ * @brief Directory holding the log segments.
+ */
+#define LOG_SEGMENT_DIR "."
+
+/**
+ * @brief File name prefix of the log segments.
+ */
+#define LOG_SEGMENT_PREFIX "system_log"
+
+/**
+ * @brief Size of one log segment (in bytes).
+ *
+ * The file is preallocated and mapped in full when the segment is opened and
+ * truncated to its used length when the next segment is started.
+ */
+#define LOG_SEGMENT_SIZE (4 * 1024 * 1024)
+
+/**
+ * @brief Maximum age of a log segment (in seconds) before a new one is started.
+ */
+#define LOG_SEGMENT_MAX_AGE_S 3600
+
+/**
+ * @brief Number of log segments kept on disk, the active one included.
+ *
+ * Older segments are deleted when a new segment is started.
+ */
+#define LOG_SEGMENT_MAX_COUNT 8
+
+/**
+ * @brief Target size of one indexed block of a log segment (in bytes).
+ *
+ * Every block gets one entry in the segment index. Smaller blocks let queries
+ * skip more data at the cost of a larger index.
+ */
+#define LOG_INDEX_BLOCK_SIZE (64 * 1024)
+
+/**
+ * @brief Compresses sealed text log segments in the background.
+ *
+ * When set to 1 (and LOG_SEGMENT_ENABLED is 1), a low-priority task replaces
+ * every sealed segment with a compressed file (LOG_SEGMENT_PREFIX.<sequence>.txt.lz)
+ * whose frames follow the index blocks, so queries decompress only the blocks
+ * they scan. Binary segments are not compressed.
+ */
+#define LOG_COMPRESS_ENABLED 1
+
+/**
+ * @brief Polling period of a tail-follow query (in milliseconds).
+ */
+#define LOG_QUERY_FOLLOW_POLL_MS 200
+
+/**
+ * @brief Enables the per-task flight recorder.
+ *
+ * When set to 1, every log call at or above LOG_FLIGHT_LEVEL is also stored as
+ * a compact binary event in a circular buffer of the calling task, whatever the
+ * current log level. The buffers are written to LOG_FLIGHT_FILE by
+ * logFlightDump().
+ */
+#define LOG_FLIGHT_ENABLED 1
+
+/**
+ * @brief Numeric value of the lowest LogLevel kept by the flight recorder.
+ *
+ * 0 = DEBUG, 1 = INFO, 2 = WARN, 3 = ERROR. Call sites at or above it count as
+ * enabled for LOG_MSG()/LOG_FMT() whatever the current log level, so 0 makes
+ * every DEBUG site evaluate its arguments.
+ */
+#define LOG_FLIGHT_LEVEL 1
+
+/**
+ * @brief Number of tasks that can own a flight recorder buffer.
+ *
+ * Tasks started after all buffers are taken are not recorded.
+ */
+#define LOG_FLIGHT_TASKS 16
+
+/**
+ * @brief Number of events kept per task.
+ *
+ * Must be a power of two.
+ */
+#define LOG_FLIGHT_EVENTS 256
+
+/**
+ * @brief Size of one flight recorder event (in bytes).
+ *
+ * The event header takes 16 bytes; the rest holds the raw arguments, or the
+ * start of the message text for logMessage() calls.
+ */
+#define LOG_FLIGHT_EVENT_SIZE 64
+
+/**
+ * @brief Maximum number of bytes stored for one string (%s) argument of an event.
+ */
+#define LOG_FLIGHT_MAX_STRING_ARG 16
+
+/**
+ * @brief File the flight recorder is dumped to (dumps are appended).
+ */
+#define LOG_FLIGHT_FILE "flight_recorder.txt"
+
+/**
+ * @brief Enables streaming of the log records to a local collector socket.
+ *
+ * When set to 1 (requires LOG_ASYNC_ENABLED), the flush task also sends every
+ * record it writes to the Unix domain socket LOG_STREAM_SOCKET_PATH, e.g. to
+ * the log_collector tool. The file log is written as before.
+ */
+#define LOG_STREAM_ENABLED 0
+
+/**
+ * @brief Path of the collector's Unix domain socket.
+ */
+#define LOG_STREAM_SOCKET_PATH "/tmp/state_machine_log.sock"
+
+/**
+ * @brief Number of records queued for the collector.
+ *
+ * Records that do not fit while the collector is slow are dropped and counted.
+ * Must be a power of two.
+ */
+#define LOG_STREAM_QUEUE_SIZE 512
+
+/**
+ * @brief Maximum number of records sent with one system call.
+ */
+#define LOG_STREAM_BATCH_RECORDS 64
+
+/**
+ * @brief Interval between connection attempts while no collector is connected (in milliseconds).
+ */
+#define LOG_STREAM_RECONNECT_MS 1000
+
+/**
+ * @brief Send buffer size requested for the collector socket (in bytes).
+ */
+#define LOG_STREAM_SOCKET_BUFFER_SIZE (256 * 1024)
+
+/**
+ * @brief Enables the shared-memory status page.
+ *
+ * When set to 1, the master and slave states, their transition counters and
+ * the heartbeats of the periodic tasks are published in the memory-mapped
+ * file LOG_STATUS_FILE, which monitors read without locking (see
+ * logger_status.h and the status_monitor tool).
+ */
+#define LOG_STATUS_ENABLED 1
+
+/**
+ * @brief File of the status page.
+ *
+ * A process running only the master or only the slave appends ".master" or
+ * ".slave" to the name.
+ */
+#define LOG_STATUS_FILE "/dev/shm/state_sync.status"
+
+/**
+ * @brief Number of tasks that can own a health slot of the status page.
+ *
+ * Tasks started after all slots are taken are not published.
+ */
+#define LOG_STATUS_TASKS 16
+
+/**
+ * @brief Cache line size the status page sections are aligned to (in bytes).
+ */
+#define LOG_STATUS_CACHE_LINE_SIZE 64
+
+/**
+ * @brief Attempts of a status page reader on a section that keeps changing before it gives up.
+ */
+#define LOG_STATUS_READ_RETRIES 1000
+
+/**
+ * @brief Enables the end-to-end traces of client inputs.
+ *
+ * When set to 1, every client message starts a trace whose hops, from the TCP
+ * server to the master state transition, are recorded as spans in the
+ * memory-mapped file LOG_TRACE_FILE (see logger_trace.h and the trace_report
+ * tool).
+ */
+#define LOG_TRACE_ENABLED 1
+
+/**
+ * @brief File of the span ring.
+ *
+ * A process running only the master or only the slave appends ".master" or
+ * ".slave" to the name.
+ */
+#define LOG_TRACE_FILE "/dev/shm/state_sync.trace"
+
+/**
+ * @brief Number of span slots in the trace file; the oldest spans are overwritten.
+ *
+ * A trace records up to LOG_TRACE_HOP_MAX spans.
+ */
+#define LOG_TRACE_SPANS 8192
+
+/**
+ * @brief Cache line size the span ring header is aligned to (in bytes).
+ */
+#define LOG_TRACE_CACHE_LINE_SIZE 64
+
+#endif // LOGGER_CFG_H
@@ -32,20 +32,29 @@
  */
 #define TASTK_PRIO_MASTER_COMM_HANDLER               1 ///< Priority for Master Communication Handler.
 #define TASTK_PRIO_MASTER_STATUS_CHECK_HANDLER       1 ///< Priority for Master Status Check Handler.
+#define TASTK_PRIO_MASTER_TELEMETRY_HANDLER          1 ///< Priority for Master Telemetry Handler.
 #define TASTK_PRIO_SLAVE_STATUS_OBSERVATION_HANDLING 1 ///< Priority for Slave Status Observation Handler.
+#define TASTK_PRIO_SLAVE_MASTER_STATE_HANDLER        1 ///< Priority for Slave Master State Handler.
 #define TASTK_PRIO_SLAVE_RESTAT_STATUS               2 ///< Priority for Slave Restart Status Handler.
 #define TASTK_PRIO_ECHO_SERVER_HANDLER               1 ///< Priority for Echo Server Handler.
+#define TASTK_PRIO_SLAVE_PAYLOAD_HANDLER             1 ///< Priority for Slave Payload Handler.
+#define TASTK_PRIO_LOGGER_FLUSH_HANDLER              0 ///< Priority for Logger Flush Handler (runs with the idle task).
+#define TASTK_PRIO_LOGGER_COMPRESS_HANDLER           0 ///< Priority for Logger Compress Handler (runs with the idle task).
 
 /**
  * @brief Task execution time intervals (in milliseconds).
  *
  * These macros define the delay intervals for periodic task execution
- * across master and slave systems.
+ * across master and slave systems. The state tasks wake on state changes
+ * and messages; their interval is only the heartbeat of a task that saw
+ * neither.
  */
-#define TASTK_TIME_MASTER_COMM_HANDLER               10  ///< Time interval for Master Communication Handler.
-#define TASTK_TIME_MASTER_STATUS_CHECK_HANDLER       500 ///< Time interval for Master Status Check Handler.
-#define TASTK_TIME_SLAVE_STATUS_OBSERVATION_HANDLING 80  ///< Time interval for Slave Status Observation Handler.
+#define TASTK_TIME_MASTER_STATUS_CHECK_HANDLER       500 ///< Heartbeat of Master Status Check Handler.
+#define TASTK_TIME_SLAVE_STATUS_OBSERVATION_HANDLING 500 ///< Heartbeat of Slave Status Observation Handler.
+#define TASTK_TIME_SLAVE_MASTER_STATE_HANDLER        500 ///< Heartbeat of Slave Master State Handler.
 #define TASTK_TIME_SLAVE_RESTAT_STATUS               10  ///< Time interval for Slave Restart Status Handler.
 #define TASTK_TIME_ECHO_SERVER_HANDLER               10  ///< Time interval for Echo Server Handler.
+#define TASTK_TIME_LOGGER_FLUSH_HANDLER              50  ///< Time interval for Logger Flush Handler.
+#define TASTK_TIME_LOGGER_COMPRESS_HANDLER           1000 ///< Time interval for Logger Compress Handler.
 
 #endif // THREAD_HANDLER_CFG_H
@@ -27,6 +27,7 @@
 #define configUSE_ALTERNATIVE_API				0
 #define configUSE_QUEUE_SETS					1
 #define configUSE_TASK_NOTIFICATIONS			1
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES	2 /* Index 1 is used by the comm ring channels */
 
 
 #define configMAX_PRIORITIES					( 7 )
@@ -61,7 +62,7 @@ it is correctly capped back to configMAX_PRIORITIES - 1. */
 #define configTIMER_TASK_STACK_DEPTH			( configMINIMAL_STACK_SIZE * 2 )
 
 /* Define to trap errors during development. */
-//#define configASSERT( x ) if( ( x ) == 0 ) vAssertCalled( __FILE__, __LINE__ )
+#define configASSERT( x ) if( ( x ) == 0 ) vAssertCalled( __FILE__, __LINE__ )
 extern void vAssertCalled( const char * const pcFileName,  unsigned long ulLine );
 
 /* Enables the test whereby a stack larger than the total heap size is
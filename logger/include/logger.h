@@ -1,6 +1,9 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include <stdint.h>
+#include "types.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -12,14 +15,251 @@ typedef enum {
     LOG_LEVEL_ERROR
 } LogLevel;
 
+/**
+ * @brief Compile-time minimum log level.
+ *
+ * Numeric value of the lowest LogLevel that is compiled in (0 = DEBUG,
+ * 1 = INFO, 2 = WARN, 3 = ERROR). Calls made through LOG_MSG()/LOG_FMT() below
+ * this level are removed by the compiler, arguments included. Set it from the
+ * build (e.g. -DLOG_COMPILE_MIN_LEVEL=2 for release builds).
+ */
+#ifndef LOG_COMPILE_MIN_LEVEL
+#define LOG_COMPILE_MIN_LEVEL 0
+#endif
+
+/**
+ * @brief Evaluates to 1 if records of the given level are compiled in.
+ */
+#define LOG_LEVEL_COMPILED(level) ((int)(level) >= LOG_COMPILE_MIN_LEVEL)
+
+/**
+ * @brief Compact id of a registered log component.
+ */
+typedef uint8_t LogComponentId;
+
+/**
+ * @brief Component id of a call site that has not logged yet.
+ */
+#define LOG_COMPONENT_UNREGISTERED 0xFF
+
+/**
+ * @brief Evaluates to 1 if a call site passes the compile-time and component filters.
+ *
+ * Must be used where a `logComponentSite_` variable is declared; it caches the
+ * component id of the call site.
+ */
+#define LOG_SITE_ENABLED(level, component)                                  \
+    (LOG_LEVEL_COMPILED(level) &&                                           \
+     logComponentLevelEnabled(&logComponentSite_, (component), (level)))
+
+/**
+ * @brief Logs a simple message if its level is compiled in and enabled.
+ *
+ * The message expression is not evaluated when the record is filtered out.
+ */
+#define LOG_MSG(level, component, message)                                  \
+    do {                                                                    \
+        static LogComponentId logComponentSite_ = LOG_COMPONENT_UNREGISTERED; \
+        if (LOG_SITE_ENABLED(level, component)) {                           \
+            logMessage((level), (component), (message));                    \
+        }                                                                   \
+    } while (0)
+
+/**
+ * @brief Logs a formatted message if its level is compiled in and enabled.
+ *
+ * Neither the arguments nor the format string are evaluated when the record
+ * is filtered out.
+ */
+#define LOG_FMT(level, component, ...)                                      \
+    do {                                                                    \
+        static LogComponentId logComponentSite_ = LOG_COMPONENT_UNREGISTERED; \
+        if (LOG_SITE_ENABLED(level, component)) {                           \
+            logMessageFormatted((level), (component), __VA_ARGS__);         \
+        }                                                                   \
+    } while (0)
+
+/**
+ * @brief State of one rate-limited call site.
+ *
+ * - windowStart: Tick count at the start of the current window.
+ * - count: Calls made in the current window.
+ */
+typedef struct {
+    uint32_t windowStart;
+    uint32_t count;
+} LogRateLimit;
+
+/**
+ * @brief Logs a simple message at most `limit` times per LOG_RATE_LIMIT_WINDOW_MS.
+ *
+ * Every call site keeps its own counter. The first call of the next window
+ * logs one summary record with the number of suppressed records.
+ */
+#define LOG_MSG_LIMITED(level, component, limit, message)                   \
+    do {                                                                    \
+        static LogComponentId logComponentSite_ = LOG_COMPONENT_UNREGISTERED; \
+        static LogRateLimit logRateSite_ = {0, 0};                          \
+        if (LOG_SITE_ENABLED(level, component) &&                           \
+            logRateLimitAllow(&logRateSite_, (limit), (level), (component), (message))) { \
+            logMessage((level), (component), (message));                    \
+        }                                                                   \
+    } while (0)
+
+/**
+ * @brief Logs a formatted message at most `limit` times per LOG_RATE_LIMIT_WINDOW_MS.
+ *
+ * The arguments are only evaluated for records that are logged.
+ */
+#define LOG_FMT_LIMITED(level, component, limit, format, ...)               \
+    do {                                                                    \
+        static LogComponentId logComponentSite_ = LOG_COMPONENT_UNREGISTERED; \
+        static LogRateLimit logRateSite_ = {0, 0};                          \
+        if (LOG_SITE_ENABLED(level, component) &&                           \
+            logRateLimitAllow(&logRateSite_, (limit), (level), (component), (format))) { \
+            logMessageFormatted((level), (component), (format), __VA_ARGS__); \
+        }                                                                   \
+    } while (0)
+
+/**
+ * @brief Logs one out of every `every` calls of a formatted message.
+ *
+ * The arguments are only evaluated for records that are logged.
+ */
+#define LOG_FMT_SAMPLED(level, component, every, format, ...)               \
+    do {                                                                    \
+        static LogComponentId logComponentSite_ = LOG_COMPONENT_UNREGISTERED; \
+        static uint32_t logSampleCounter_ = 0;                              \
+        if (LOG_SITE_ENABLED(level, component) &&                           \
+            logSampleAllow(&logSampleCounter_, (every))) {                  \
+            logMessageFormatted((level), (component), (format), __VA_ARGS__); \
+        }                                                                   \
+    } while (0)
+
+/**
+ * @brief Initializes the logger.
+ *
+ * Opens the log file and prepares the asynchronous record ring buffer. After
+ * this call, records are queued and written by vLoggerFlushHandler(); before it
+ * (or when LOG_ASYNC_ENABLED is 0) records are written synchronously.
+ *
+ * @return RET_OK on success, RET_ERROR if the log file could not be opened.
+ */
+RetVal_t initLogger(void);
+
+/**
+ * @brief Logger flush task function.
+ *
+ * Drains the record ring buffer into the open log file in batches and reports
+ * records dropped because the ring was full.
+ *
+ * @param args Pointer to task arguments (unused).
+ */
+void vLoggerFlushHandler(void *args);
+
+/**
+ * @brief Logger compress task function.
+ *
+ * Replaces the sealed text log segments with their compressed form (see
+ * LOG_COMPRESS_ENABLED). The active segment is never touched.
+ *
+ * @param args Pointer to task arguments (unused).
+ */
+void vLoggerCompressHandler(void *args);
+
+/**
+ * @brief Returns the number of records dropped because the ring buffer was full.
+ *
+ * @return Total number of dropped records since start-up.
+ */
+uint32_t getLogDroppedRecords(void);
+
+/**
+ * @brief Returns the number of records not delivered to the log collector.
+ *
+ * Counts the records dropped while the collector was too slow and the records
+ * lost with a broken connection (see LOG_STREAM_ENABLED).
+ *
+ * @return Total number of dropped records since start-up.
+ */
+uint32_t getLogStreamDroppedRecords(void);
+
 /**
  * @brief Sets the minimum log level for filtering log messages.
  * @param level The minimum log level.
  */
 void setLogLevel(LogLevel level);
 
+/**
+ * @brief Checks whether records of a level pass the runtime log level filter.
+ * @param level The level to check.
+ * @return 1 if records of this level are logged, 0 otherwise.
+ */
+uint8_t logLevelEnabled(LogLevel level);
+
+/**
+ * @brief Checks whether a call site passes the level of its component.
+ *
+ * Registers the component on the first call of the site and caches its id in
+ * `*site`, whatever the level; later calls are one array lookup. A call site
+ * must therefore always pass the same component name.
+ *
+ * @param site Cached component id of the call site (LOG_COMPONENT_UNREGISTERED initially).
+ * @param component Component name.
+ * @param level The level to check.
+ * @return 1 if records of this level are logged for the component, 0 otherwise.
+ */
+uint8_t logComponentLevelEnabled(LogComponentId *site, const char *component, LogLevel level);
+
+/**
+ * @brief Sets the minimum log level of one component.
+ *
+ * Overrides the level set with setLogLevel() for this component only, e.g. to
+ * get DEBUG records from "TCPComm" without the DEBUG records of the others.
+ *
+ * @param component Component name.
+ * @param level The minimum log level of the component.
+ */
+void setComponentLogLevel(const char *component, LogLevel level);
+
+/**
+ * @brief Makes a component follow the level set with setLogLevel() again.
+ * @param component Component name.
+ */
+void resetComponentLogLevel(const char *component);
+
+/**
+ * @brief Counts a call of a rate-limited call site.
+ *
+ * Costs one atomic increment while the window is open. When a new window
+ * starts, a summary record with the number of calls suppressed in the previous
+ * window is logged first.
+ *
+ * @param site State of the call site.
+ * @param limit Maximum number of records per window.
+ * @param level Level of the call site (used for the summary record).
+ * @param component Component of the call site (used for the summary record).
+ * @param text Message or format string of the call site (used for the summary record).
+ * @return 1 if the record is to be logged, 0 if it is suppressed.
+ */
+uint8_t logRateLimitAllow(LogRateLimit *site, uint32_t limit, LogLevel level,
+                          const char *component, const char *text);
+
+/**
+ * @brief Counts a call of a sampled call site.
+ *
+ * @param counter Call counter of the call site.
+ * @param every Sampling period (1 logs every call).
+ * @return 1 for the first call and every `every`-th call after it, 0 otherwise.
+ */
+uint8_t logSampleAllow(uint32_t *counter, uint32_t every);
+
 /**
  * @brief Logs a simple message with priority, thread, and message content.
+ *
+ * The component is looked up by the content of its name, so the name may be
+ * passed in any buffer, including one reused for other names.
+ *
  * @param priority The priority level of the message (e.g., INFO, ERROR).
  * @param thread The thread or component generating the log.
  * @param message The log message content.
@@ -35,6 +275,19 @@ void logMessage(LogLevel priority, const char* thread, const char* message);
  */
 void logMessageFormatted(LogLevel level, const char *component, const char *format, ...);
 
+/**
+ * @brief Writes an ERROR message and every queued record before the process stops.
+ *
+ * For fatal paths such as a failed configASSERT(), where the flush task never
+ * runs again. Suspends the scheduler for good, writes the records still in the
+ * ring buffer from the calling task and then the message, synchronously. The
+ * caller must stop the process afterwards.
+ *
+ * @param component The component generating the log.
+ * @param message The log message content.
+ */
+void logMessageFatal(const char *component, const char *message);
+
 /**
  * @brief Prints messages of a specific log level and higher.
  * @param level The log level to filter messages.
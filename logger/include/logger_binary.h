@@ -0,0 +1,203 @@
+#ifndef LOGGER_BINARY_H
+#define LOGGER_BINARY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include "types.h"
+#include "logger.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file logger_binary.h
+ * @brief Binary (deferred-format) log record encoding and decoding.
+ *
+ * In binary mode a log call stores only the id of its format string, the tick
+ * timestamp, the level, the id of its component and the raw arguments. Format
+ * strings and component names are written once, the first time they are used.
+ * Turning records back into text is left to the decoder (printLogMessages() or
+ * the host-side log_decoder tool).
+ *
+ * Stream layout: a sequence of records, each starting with LogBinaryRecordHeader.
+ * Every logger start writes a SESSION record; format and component ids are only
+ * valid inside the session that defined them. A new log segment repeats the
+ * SESSION record followed by all definitions known so far.
+ */
+
+#define LOG_BINARY_MAGIC    0x474F4C53u ///< "SLOG" in little-endian byte order.
+#define LOG_BINARY_VERSION  1
+
+/**
+ * @brief Format id reserved for pre-formatted text (the payload is one string).
+ */
+#define LOG_BINARY_TEXT_FORMAT_ID 0
+
+/**
+ * @brief Binary record types.
+ */
+typedef enum {
+    LOG_BINARY_RECORD_SESSION = 1,   ///< Start of a logging session.
+    LOG_BINARY_RECORD_FORMAT_DEF,    ///< Defines the text of a format id.
+    LOG_BINARY_RECORD_COMPONENT_DEF, ///< Defines the name of a component id.
+    LOG_BINARY_RECORD_MESSAGE        ///< Log message with raw arguments.
+} LogBinaryRecordType;
+
+/**
+ * @brief Argument types stored in a MESSAGE record.
+ */
+typedef enum {
+    LOG_BINARY_ARG_INT32 = 1, ///< 32-bit integer (%d, %u, %x, %c, ...).
+    LOG_BINARY_ARG_INT64,     ///< 64-bit integer (%ld, %lld, %zu, ...).
+    LOG_BINARY_ARG_DOUBLE,    ///< Floating point (%f, %g, %e, ...).
+    LOG_BINARY_ARG_STRING,    ///< String (%s): 1-byte length followed by the bytes.
+    LOG_BINARY_ARG_POINTER    ///< Pointer (%p) stored as 64 bits.
+} LogBinaryArgType;
+
+/**
+ * @brief Common header of every binary record.
+ *
+ * - type: LogBinaryRecordType.
+ * - level: LogLevel of a MESSAGE record.
+ * - length: Total record length in bytes, header included.
+ * - tick: FreeRTOS tick count when the record was created.
+ * - formatId: Format id (MESSAGE, FORMAT_DEF).
+ * - componentId: Component id (MESSAGE, COMPONENT_DEF).
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t type;
+    uint8_t level;
+    uint16_t length;
+    uint32_t tick;
+    uint16_t formatId;
+    uint16_t componentId;
+} LogBinaryRecordHeader;
+
+/**
+ * @brief Payload of a SESSION record.
+ *
+ * - magic: LOG_BINARY_MAGIC.
+ * - version: LOG_BINARY_VERSION.
+ * - tickRateHz: Tick rate used to convert record ticks to time.
+ * - startEpoch: Wall-clock time (seconds since the epoch) at tick 0.
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t tickRateHz;
+    int64_t startEpoch;
+} LogBinarySession;
+
+/**
+ * @brief Resets the format and component tables for a new session.
+ */
+void logBinaryInit(void);
+
+/**
+ * @brief Encodes a SESSION record.
+ *
+ * @param buffer Destination buffer.
+ * @param size Size of the destination buffer.
+ * @param tickRateHz Tick rate of the record timestamps.
+ * @param startEpoch Wall-clock time at tick 0.
+ * @return Number of bytes written, or 0 if the buffer is too small.
+ */
+uint16_t logBinaryEncodeSession(char *buffer, size_t size, uint16_t tickRateHz, int64_t startEpoch);
+
+/**
+ * @brief Encodes a log call with its raw arguments.
+ *
+ * The format string must be a string literal (its address identifies it).
+ * Definition records for a format or component seen for the first time are
+ * written in front of the MESSAGE record.
+ *
+ * @param buffer Destination buffer.
+ * @param size Size of the destination buffer.
+ * @param tick Tick count of the record.
+ * @param level Log level.
+ * @param component Component name.
+ * @param format printf-style format string.
+ * @param args Arguments of the format string.
+ * @return Number of bytes written, or 0 if the record could not be encoded.
+ */
+uint16_t logBinaryEncodeMessage(char *buffer, size_t size, uint32_t tick, LogLevel level,
+                                const char *component, const char *format, va_list args);
+
+/**
+ * @brief Encodes the next known format or component definition.
+ *
+ * Used to repeat all definitions at the start of a new log segment, so that
+ * each segment can be decoded on its own. Start with *cursor set to 0 and call
+ * until 0 is returned.
+ *
+ * @param buffer Destination buffer.
+ * @param size Size of the destination buffer.
+ * @param cursor Iteration state; advanced past the encoded definition.
+ * @return Number of bytes written, or 0 when all definitions have been encoded.
+ */
+uint16_t logBinaryEncodeNextDefinition(char *buffer, size_t size, uint32_t *cursor);
+
+/**
+ * @brief Encodes an already formatted message.
+ *
+ * @param buffer Destination buffer.
+ * @param size Size of the destination buffer.
+ * @param tick Tick count of the record.
+ * @param level Log level.
+ * @param component Component name.
+ * @param message Message text.
+ * @return Number of bytes written, or 0 if the record could not be encoded.
+ */
+uint16_t logBinaryEncodeText(char *buffer, size_t size, uint32_t tick, LogLevel level,
+                             const char *component, const char *message);
+
+/**
+ * @brief Encodes only the raw arguments of a log call.
+ *
+ * Uses the same argument layout as a MESSAGE record payload, without interning
+ * the format string; the caller keeps the format pointer itself.
+ *
+ * @param buffer Destination buffer.
+ * @param size Size of the destination buffer.
+ * @param maxString Maximum number of bytes stored for one string (%s) argument.
+ * @param format printf-style format string.
+ * @param args Arguments of the format string.
+ * @return Number of bytes written, or -1 if the format has unsupported
+ *         conversions or the arguments do not fit.
+ */
+int32_t logBinaryEncodeArguments(char *buffer, size_t size, size_t maxString,
+                                 const char *format, va_list args);
+
+/**
+ * @brief Formats a message from its format string and encoded arguments.
+ *
+ * @param out Destination buffer of the message text.
+ * @param outSize Size of the destination buffer.
+ * @param format printf-style format string.
+ * @param payload Arguments encoded by logBinaryEncodeArguments().
+ * @param length Number of bytes of the encoded arguments.
+ */
+void logBinaryFormatArguments(char *out, size_t outSize, const char *format,
+                              const char *payload, size_t length);
+
+/**
+ * @brief Decodes a binary log stream into text lines.
+ *
+ * Produces the same "[time] [LEVEL] [component] message" lines as the text
+ * logger. The input must be seekable (it is read twice: once to collect the
+ * format and component definitions, once to print the messages).
+ *
+ * @param input Binary log stream.
+ * @param output Destination for the text lines.
+ * @param level Minimum level of the printed messages.
+ * @return RET_OK on success, RET_ERROR if the stream could not be read.
+ */
+RetVal_t logBinaryDecode(FILE *input, FILE *output, LogLevel level);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOGGER_BINARY_H
@@ -0,0 +1,94 @@
+#ifndef LOGGER_COMPONENT_H
+#define LOGGER_COMPONENT_H
+
+#include <stdint.h>
+#include "types.h"
+#include "logger.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file logger_component.h
+ * @brief Registry of log components.
+ *
+ * Every component name is registered once and gets a small integer id. The
+ * logger filters and stores records by id: the effective level of each
+ * component lives in an array indexed by id, and queued records carry the id
+ * instead of the name. Id 0 is reserved for "Other", which collects the
+ * components registered after the table is full.
+ */
+
+/**
+ * @brief Id of the component that collects names registered after the table is full.
+ */
+#define LOG_COMPONENT_OTHER 0
+
+/**
+ * @brief Returns the id of a component, registering it on first use.
+ *
+ * Names are compared by content, so the same name always gets the same id.
+ *
+ * @param name Component name.
+ * @return Component id (LOG_COMPONENT_OTHER if the table is full).
+ */
+LogComponentId logComponentRegister(const char *name);
+
+/**
+ * @brief Returns the id of a component name passed by a log call.
+ *
+ * The id is cached by the content of the name, so the name may be passed in
+ * any buffer and a known name costs one hash and one comparison. A name that
+ * does not fit a full table costs a check of the table size.
+ *
+ * @param name Component name.
+ * @return Component id (LOG_COMPONENT_OTHER if the table is full).
+ */
+LogComponentId logComponentLookup(const char *name);
+
+/**
+ * @brief Returns the name of a registered component.
+ *
+ * The returned pointer stays valid and is the same for every call with the same id.
+ *
+ * @param id Component id.
+ * @return Component name.
+ */
+const char *logComponentName(LogComponentId id);
+
+/**
+ * @brief Returns the effective minimum level of a component.
+ *
+ * @param id Component id.
+ * @return The component level if one was set, the global level otherwise.
+ */
+LogLevel logComponentLevel(LogComponentId id);
+
+/**
+ * @brief Sets the level of every component without a level of its own.
+ *
+ * @param level New global level.
+ */
+void logComponentSetDefaultLevel(LogLevel level);
+
+/**
+ * @brief Gives a component a level of its own.
+ *
+ * @param id Component id.
+ * @param level Minimum level of the component.
+ */
+void logComponentSetLevel(LogComponentId id, LogLevel level);
+
+/**
+ * @brief Makes a component follow the global level again.
+ *
+ * @param id Component id.
+ */
+void logComponentResetLevel(LogComponentId id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOGGER_COMPONENT_H
@@ -0,0 +1,137 @@
+#ifndef LOGGER_COMPRESS_H
+#define LOGGER_COMPRESS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file logger_compress.h
+ * @brief Compressed archive form of the sealed text log segments.
+ *
+ * A sealed segment is split into frames that match the blocks of its index
+ * sidecar (uncovered bytes get frames of at most LOG_INDEX_BLOCK_SIZE). Every
+ * frame is compressed on its own with logger_lz.h, so a reader decompresses
+ * only the frames holding the blocks it needs. The compressed file replaces the
+ * segment (see logSegmentCompressedPath()); the index sidecar is kept and still
+ * addresses the uncompressed offsets.
+ *
+ * File layout: LogCompressHeader, frameCount LogCompressFrame entries, then the
+ * frame data. A frame whose length equals its raw length is stored as is.
+ *
+ * This module has no FreeRTOS dependency and is also built into the host tools.
+ */
+
+#define LOG_COMPRESS_MAGIC   0x5A4C4753u ///< "SGLZ" in little-endian byte order.
+#define LOG_COMPRESS_VERSION 1
+
+/**
+ * @brief Header of a compressed segment.
+ *
+ * - magic: LOG_COMPRESS_MAGIC.
+ * - version: LOG_COMPRESS_VERSION.
+ * - sequence: Sequence number of the segment.
+ * - frameCount: Number of frames.
+ * - rawSize: Size of the uncompressed segment.
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t sequence;
+    uint32_t frameCount;
+    uint64_t rawSize;
+} LogCompressHeader;
+
+/**
+ * @brief Table entry of one frame.
+ *
+ * - rawOffset: Offset of the frame in the uncompressed segment.
+ * - rawLength: Uncompressed length.
+ * - offset: Offset of the frame data in the compressed file.
+ * - length: Length of the frame data (equal to rawLength if stored uncompressed).
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t rawOffset;
+    uint32_t rawLength;
+    uint32_t offset;
+    uint32_t length;
+} LogCompressFrame;
+
+/**
+ * @brief Random-access reader of a compressed segment.
+ *
+ * - data: Uncompressed segment; only the ranges passed to logCompressRead() are valid.
+ * - size: Size of the uncompressed segment.
+ * - fd: Compressed file.
+ * - frames: Frame table, sorted by rawOffset.
+ * - frameCount: Number of frames.
+ * - frameStates: Decoding state of each frame (not decoded, decoding, decoded, failed).
+ */
+typedef struct {
+    char *data;
+    size_t size;
+    int fd;
+    LogCompressFrame *frames;
+    uint32_t frameCount;
+    uint8_t *frameStates;
+} LogCompressReader;
+
+/**
+ * @brief Compresses a sealed segment and removes the uncompressed file.
+ *
+ * The compressed file is written under a temporary name, synced and renamed,
+ * so a crash leaves either the segment or its complete compressed form.
+ *
+ * @param sequence Sequence number of a sealed text segment.
+ * @return RET_OK on success, RET_ERROR if the segment could not be compressed.
+ */
+RetVal_t logCompressSegment(uint32_t sequence);
+
+/**
+ * @brief Compresses every sealed segment that is not compressed yet.
+ *
+ * The newest segment is the active one and is left alone.
+ *
+ * @return Number of segments compressed.
+ */
+uint32_t logCompressSealedSegments(void);
+
+/**
+ * @brief Opens a compressed segment for random access.
+ *
+ * @param sequence Segment sequence number.
+ * @param reader Reader to initialize.
+ * @return RET_OK on success, RET_ERROR if there is no valid compressed segment.
+ */
+RetVal_t logCompressOpen(uint32_t sequence, LogCompressReader *reader);
+
+/**
+ * @brief Decompresses the frames covering a range of the segment into reader->data.
+ *
+ * Frames already decoded are skipped. Safe to call from several threads, also
+ * for overlapping ranges.
+ *
+ * @param reader Open reader.
+ * @param start First byte of the range.
+ * @param end Byte past the range.
+ * @return RET_OK if the range is valid in reader->data, RET_ERROR if a frame is corrupted.
+ */
+RetVal_t logCompressRead(LogCompressReader *reader, size_t start, size_t end);
+
+/**
+ * @brief Releases a reader.
+ *
+ * @param reader Reader opened with logCompressOpen().
+ */
+void logCompressClose(LogCompressReader *reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOGGER_COMPRESS_H
@@ -0,0 +1,63 @@
+#ifndef LOGGER_FLIGHT_H
+#define LOGGER_FLIGHT_H
+
+#include <stdint.h>
+#include <stdarg.h>
+#include "types.h"
+#include "logger.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file logger_flight.h
+ * @brief Per-task in-memory flight recorder.
+ *
+ * Every task gets a circular buffer of the last LOG_FLIGHT_EVENTS log calls it
+ * made, recorded whatever the current log level. An event holds the tick, the
+ * level, the component id, the format pointer and the raw arguments; it is only
+ * formatted when the recorder is dumped. Each buffer has a single writer (its
+ * task), so recording is lock-free and never blocks.
+ *
+ * A task claims a buffer on its first log call. The buffer is keyed by the
+ * task name, so a task that is deleted and created again (see
+ * restartAllTasks()) keeps appending to its previous history. Log calls made
+ * before the scheduler starts are recorded under "Main".
+ */
+
+/**
+ * @brief Records a logMessage() call of the calling task.
+ *
+ * @param level Log level.
+ * @param component Component id.
+ * @param message Message text (copied, possibly truncated).
+ */
+void logFlightRecordText(LogLevel level, LogComponentId component, const char *message);
+
+/**
+ * @brief Records a logMessageFormatted() call of the calling task.
+ *
+ * @param level Log level.
+ * @param component Component id.
+ * @param format Format string (must stay valid, e.g. a string literal).
+ * @param args Arguments of the format string (copied).
+ */
+void logFlightRecordFormatted(LogLevel level, LogComponentId component, const char *format, va_list args);
+
+/**
+ * @brief Appends the events of all task buffers to LOG_FLIGHT_FILE.
+ *
+ * Events overwritten while the dump is running are left out. Concurrent dumps
+ * are skipped.
+ *
+ * @param reason Text written in the dump header.
+ * @return RET_OK if the dump was written, RET_ERROR otherwise.
+ */
+RetVal_t logFlightDump(const char *reason);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOGGER_FLIGHT_H
@@ -0,0 +1,107 @@
+#ifndef LOGGER_INDEX_H
+#define LOGGER_INDEX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "types.h"
+#include "logger_ring.h"
+#include "logger_segment.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file logger_index.h
+ * @brief Sidecar block index of the log segments.
+ *
+ * Every log segment gets an index file (LOG_SEGMENT_PREFIX.<sequence>.idx).
+ * The segment is divided into blocks of about LOG_INDEX_BLOCK_SIZE bytes, each
+ * ending on a record boundary. For every block the index stores its position,
+ * its time range, the levels it contains and a component filter, so a query
+ * only reads the blocks that can hold matching records.
+ *
+ * File layout: LogIndexHeader followed by LogIndexBlock entries. A block is
+ * appended when it is complete; records after the last block (the block being
+ * filled, or a segment whose index was not finished) are scanned linearly.
+ */
+
+#define LOG_INDEX_MAGIC   0x58444E49u ///< "INDX" in little-endian byte order.
+#define LOG_INDEX_VERSION 1
+
+/**
+ * @brief Header of an index file.
+ *
+ * - magic: LOG_INDEX_MAGIC.
+ * - version: LOG_INDEX_VERSION.
+ * - sequence: Sequence number of the indexed segment.
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t sequence;
+} LogIndexHeader;
+
+/**
+ * @brief Index entry of one block.
+ *
+ * - offset: Offset of the first record of the block in the segment.
+ * - length: Number of bytes of the block.
+ * - minTime: Earliest record timestamp (seconds since the epoch).
+ * - maxTime: Latest record timestamp (seconds since the epoch).
+ * - records: Number of records in the block.
+ * - levelMask: Bit (1 << level) set for every LogLevel present.
+ * - componentMask: Bit (1 << logIndexComponentBit()) set for every component present.
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t offset;
+    uint32_t length;
+    int64_t minTime;
+    int64_t maxTime;
+    uint32_t records;
+    uint8_t levelMask;
+    uint8_t reserved[3];
+    uint64_t componentMask;
+} LogIndexBlock;
+
+/**
+ * @brief Returns the component filter bit of a component name.
+ *
+ * Different components may share a bit; the filter only rules blocks out.
+ *
+ * @param component Component name.
+ * @return Bit number in the range 0..63.
+ */
+uint8_t logIndexComponentBit(const char *component);
+
+/**
+ * @brief Adds a record written to a log segment to the index.
+ *
+ * Records must be added in write order. A record in a new segment completes
+ * the index of the previous segment.
+ *
+ * @param location Position of the record returned by logSegmentWrite().
+ * @param length Length of the record in bytes.
+ * @param info Metadata of the record.
+ */
+void logIndexAdd(const LogSegmentLocation *location, uint16_t length, const LogRecordInfo *info);
+
+/**
+ * @brief Reads the index sidecar of a segment.
+ *
+ * Entries that point past the segment data are dropped; a missing or invalid
+ * index yields no entries (the segment is then scanned linearly).
+ *
+ * @param sequence Segment sequence number.
+ * @param segmentSize Number of bytes of the segment holding records.
+ * @param blocks Pointer to store the entries (allocated with malloc, to be freed by the caller).
+ * @return Number of entries.
+ */
+uint32_t logIndexLoad(uint32_t sequence, size_t segmentSize, LogIndexBlock **blocks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOGGER_INDEX_H
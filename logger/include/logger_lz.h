@@ -0,0 +1,73 @@
+#ifndef LOGGER_LZ_H
+#define LOGGER_LZ_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file logger_lz.h
+ * @brief Small LZ77 block compressor used for archived log segments.
+ *
+ * The block layout follows LZ4: a sequence is a token byte (literal count in
+ * the high nibble, match length - 4 in the low nibble, 15 meaning "more length
+ * bytes follow"), the literals, a 16-bit little-endian match offset and the
+ * extra match length bytes. The last sequence only holds literals. Matches are
+ * found with a single hash table of 4-byte prefixes, which suits the repetitive
+ * text of log lines.
+ *
+ * This module has no FreeRTOS dependency and is also built into the host tools.
+ */
+
+/**
+ * @brief log2 of the number of entries of the match finder hash table.
+ */
+#define LOG_LZ_HASH_BITS 12
+
+/**
+ * @brief Worst-case compressed size of a block of the given size.
+ */
+#define LOG_LZ_BOUND(size) ((size) + (size) / 255u + 16u)
+
+/**
+ * @brief Working memory of the compressor (16 KB; keep it off small task stacks).
+ */
+typedef struct {
+    uint32_t table[1u << LOG_LZ_HASH_BITS];
+} LogLzState;
+
+/**
+ * @brief Compresses one block.
+ *
+ * @param state Working memory.
+ * @param source Data to compress.
+ * @param size Number of bytes to compress.
+ * @param destination Destination buffer.
+ * @param capacity Size of the destination buffer.
+ * @return Compressed size, or 0 if it does not fit the destination buffer.
+ */
+size_t logLzCompress(LogLzState *state, const char *source, size_t size, char *destination, size_t capacity);
+
+/**
+ * @brief Decompresses one block.
+ *
+ * Every length and offset is checked against the buffers, so a corrupted
+ * block fails instead of reading or writing out of bounds.
+ *
+ * @param source Compressed block.
+ * @param size Size of the compressed block.
+ * @param destination Destination buffer.
+ * @param expected Exact decompressed size.
+ * @return RET_OK if the block decompressed to exactly the expected size, RET_ERROR otherwise.
+ */
+RetVal_t logLzDecompress(const char *source, size_t size, char *destination, size_t expected);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOGGER_LZ_H
@@ -0,0 +1,67 @@
+#ifndef LOGGER_QUERY_H
+#define LOGGER_QUERY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "types.h"
+#include "logger.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file logger_query.h
+ * @brief Indexed queries over the text log segments.
+ *
+ * A query selects records by minimum level, component and time range. The
+ * segment indexes (see logger_index.h) are used to skip every block that cannot
+ * hold a matching record; only the remaining blocks are read, through a
+ * read-only mapping of the segment, and optionally split over several threads.
+ * Matching lines are printed in log order.
+ */
+
+/**
+ * @brief Record filter of a query.
+ *
+ * - level: Minimum level of the returned records.
+ * - component: Exact component name, or NULL for all components.
+ * - from: Earliest timestamp (seconds since the epoch), or 0 for no lower bound.
+ * - until: Latest timestamp (seconds since the epoch), or 0 for no upper bound.
+ */
+typedef struct {
+    LogLevel level;
+    const char *component;
+    int64_t from;
+    int64_t until;
+} LogQuery;
+
+/**
+ * @brief Prints all records of the log segments that match a query.
+ *
+ * @param query Record filter.
+ * @param threads Number of threads used to scan the selected blocks (1 scans
+ *        in the calling thread).
+ * @param output Destination of the matching lines.
+ * @return RET_OK on success, RET_ERROR if no log segment was found.
+ */
+RetVal_t logQueryRun(const LogQuery *query, uint32_t threads, FILE *output);
+
+/**
+ * @brief Prints matching records as they are written (tail-follow).
+ *
+ * Starts at the current end of the newest segment and follows it across
+ * segment rotations, polling every LOG_QUERY_FOLLOW_POLL_MS. Only returns on
+ * error.
+ *
+ * @param query Record filter (the time range is ignored).
+ * @param output Destination of the matching lines.
+ * @return RET_ERROR if the log segments could not be read.
+ */
+RetVal_t logQueryFollow(const LogQuery *query, FILE *output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOGGER_QUERY_H
@@ -0,0 +1,116 @@
+#ifndef LOGGER_RING_H
+#define LOGGER_RING_H
+
+#include <stdint.h>
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file logger_ring.h
+ * @brief Lock-free multi-producer, single-consumer ring buffer for log records.
+ *
+ * Producers (any task) reserve a slot, write the record directly into it and
+ * commit it. A single consumer (the logger flush task) reads committed records
+ * in order and releases their slots. When the ring is full the record is
+ * dropped and counted instead of blocking the producer.
+ *
+ * The consumer stops at a reserved slot until it is committed, so a producer
+ * must not block, be switched out or be deleted between logRingReserve() and
+ * logRingCommit(); the logger suspends the scheduler for that window.
+ */
+
+/**
+ * @brief Metadata of a record, used to format and index the log.
+ *
+ * - timestamp: Wall-clock time of the record (seconds since the epoch).
+ * - nanoseconds: Nanoseconds within the second of the record.
+ * - level: LogLevel of the record.
+ * - componentId: Registered id of the component (see logger_component.h).
+ * - componentBit: Component filter bit (see logIndexComponentBit()), set when the record is indexed.
+ */
+typedef struct {
+    int64_t timestamp;
+    uint32_t nanoseconds;
+    uint8_t level;
+    uint8_t componentId;
+    uint8_t componentBit;
+} LogRecordInfo;
+
+/**
+ * @brief Reservation of one ring slot by a producer.
+ *
+ * - data: Buffer of LOG_RECORD_SIZE bytes to write the record into.
+ * - info: Metadata of the record, filled by the producer.
+ * - position: Ring position of the slot (used on commit).
+ */
+typedef struct {
+    char *data;          ///< Slot payload buffer.
+    LogRecordInfo *info; ///< Slot record metadata.
+    uint32_t position;   ///< Ring position of the reserved slot.
+} LogRingTicket;
+
+/**
+ * @brief Initializes the ring buffer.
+ *
+ * Must be called once before any producer or consumer uses the ring.
+ */
+void logRingInit(void);
+
+/**
+ * @brief Reserves a free slot for a new record.
+ *
+ * @param ticket Pointer to store the reservation.
+ * @return RET_OK if a slot was reserved, RET_ERROR if the ring is full
+ *         (the record is counted as dropped).
+ */
+RetVal_t logRingReserve(LogRingTicket *ticket);
+
+/**
+ * @brief Publishes a previously reserved slot to the consumer.
+ *
+ * @param ticket Reservation returned by logRingReserve().
+ * @param length Number of valid bytes written into the slot.
+ */
+void logRingCommit(const LogRingTicket *ticket, uint16_t length);
+
+/**
+ * @brief Returns the oldest committed record without removing it.
+ *
+ * Must only be called by the single consumer.
+ *
+ * @param data Pointer to store the record payload.
+ * @param length Pointer to store the record length in bytes.
+ * @param info Pointer to store the record metadata.
+ * @return RET_OK if a record is available, RET_ERROR if the ring is empty.
+ */
+RetVal_t logRingFront(const char **data, uint16_t *length, const LogRecordInfo **info);
+
+/**
+ * @brief Releases the record returned by logRingFront().
+ *
+ * Must only be called by the single consumer.
+ */
+void logRingPop(void);
+
+/**
+ * @brief Returns and clears the number of records dropped since the last call.
+ *
+ * @return Number of dropped records.
+ */
+uint32_t logRingTakeDropped(void);
+
+/**
+ * @brief Returns the total number of records dropped since start-up.
+ *
+ * @return Total number of dropped records.
+ */
+uint32_t logRingDroppedTotal(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOGGER_RING_H
@@ -0,0 +1,126 @@
+#ifndef LOGGER_SEGMENT_H
+#define LOGGER_SEGMENT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file logger_segment.h
+ * @brief Preallocated memory-mapped log segments with rotation.
+ *
+ * The log is stored in a sequence of files named
+ * LOG_SEGMENT_PREFIX.<sequence>.txt (.bin in binary mode). Each segment is
+ * preallocated to LOG_SEGMENT_SIZE bytes and mapped with mmap, so appending a
+ * record is a memcpy into the mapping followed by an atomic update of the
+ * published length. A segment is sealed (truncated to its used length) and the
+ * next one started when a record does not fit or the segment is older than
+ * LOG_SEGMENT_MAX_AGE_S. Only the newest LOG_SEGMENT_MAX_COUNT segments (and
+ * their LOG_SEGMENT_PREFIX.<sequence>.idx index sidecars) are kept. Sealed
+ * segments may be replaced by their compressed form (<segment name>.lz).
+ *
+ * The unsealed part of the active segment is zero-filled, so readers stop at
+ * the first zero byte (text) or zero record header (binary).
+ *
+ * The writer functions are not reentrant; the caller serializes them (the
+ * logger flush task is the only writer in asynchronous mode).
+ */
+
+/**
+ * @brief Position of a record in the log segments.
+ *
+ * - sequence: Sequence number of the segment holding the record.
+ * - offset: Byte offset of the record in the segment.
+ */
+typedef struct {
+    uint32_t sequence;
+    uint32_t offset;
+} LogSegmentLocation;
+
+/**
+ * @brief Called after a new segment has been opened.
+ *
+ * Used to write records that every segment must start with (e.g. the binary
+ * session and definition records). The hook may call logSegmentWrite().
+ */
+typedef void (*LogSegmentOpenHook)(void);
+
+/**
+ * @brief Opens the first segment of this run.
+ *
+ * Trims the unused tail of the segment left by the previous run, deletes
+ * segments beyond the retention limit and starts a new segment after the
+ * newest existing one. A segment left open by an earlier call is sealed first.
+ *
+ * @param openHook Hook called after each segment is opened (may be NULL).
+ * @return RET_OK on success, RET_ERROR if the segment could not be created.
+ */
+RetVal_t logSegmentInit(LogSegmentOpenHook openHook);
+
+/**
+ * @brief Appends one record to the active segment.
+ *
+ * Starts a new segment first if the record does not fit.
+ *
+ * @param data Record bytes.
+ * @param length Number of bytes.
+ * @param location Pointer to store where the record was written (may be NULL).
+ * @return RET_OK on success, RET_ERROR if no segment is open or the record is
+ *         larger than a segment.
+ */
+RetVal_t logSegmentWrite(const char *data, uint16_t length, LogSegmentLocation *location);
+
+/**
+ * @brief Starts a new segment if the active one is older than LOG_SEGMENT_MAX_AGE_S.
+ *
+ * Empty segments are not rotated.
+ */
+void logSegmentRotateIfExpired(void);
+
+/**
+ * @brief Finds the range of segment sequence numbers present on disk.
+ *
+ * Compressed segments are included.
+ *
+ * @param first Pointer to store the oldest sequence number.
+ * @param last Pointer to store the newest sequence number.
+ * @return RET_OK if at least one segment exists, RET_ERROR otherwise.
+ */
+RetVal_t logSegmentFind(uint32_t *first, uint32_t *last);
+
+/**
+ * @brief Builds the file path of a segment.
+ *
+ * @param path Destination buffer.
+ * @param size Size of the destination buffer.
+ * @param sequence Segment sequence number.
+ */
+void logSegmentPath(char *path, size_t size, uint32_t sequence);
+
+/**
+ * @brief Builds the file path of the compressed form of a segment (see logger_compress.h).
+ *
+ * @param path Destination buffer.
+ * @param size Size of the destination buffer.
+ * @param sequence Segment sequence number.
+ */
+void logSegmentCompressedPath(char *path, size_t size, uint32_t sequence);
+
+/**
+ * @brief Builds the file path of the index sidecar of a segment.
+ *
+ * @param path Destination buffer.
+ * @param size Size of the destination buffer.
+ * @param sequence Segment sequence number.
+ */
+void logSegmentIndexPath(char *path, size_t size, uint32_t sequence);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOGGER_SEGMENT_H
@@ -0,0 +1,213 @@
+#ifndef LOGGER_STATUS_H
+#define LOGGER_STATUS_H
+
+#include <stdint.h>
+#include "types.h"
+#include "state_mashine_types.h"
+#include "logger_cfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file logger_status.h
+ * @brief Shared-memory status page for external monitors.
+ *
+ * The application publishes its current state in a memory-mapped file
+ * (logStatusInit()): the master and slave states with their transition
+ * counters, and one health slot per periodic task. Other processes map the file
+ * read-only and take snapshots without system calls or locks
+ * (logStatusOpenView(), logStatusRead()).
+ *
+ * Every section is protected by its own sequence lock. Its single writer makes
+ * the sequence odd, updates the fields and makes it even again; a reader copies
+ * the section and retries if the sequence was odd or changed meanwhile. The
+ * master and slave sections are written by their state machines under the
+ * state lock, a task slot only by its task. Each section starts on its own
+ * cache line, so a transition touches only the lines of its section.
+ *
+ * The writer functions do nothing until logStatusInit() has succeeded. The
+ * view functions do not depend on FreeRTOS, so host tools can link them.
+ */
+
+/**
+ * @brief Marks a status page initialized by its writer ("STAT").
+ */
+#define LOG_STATUS_MAGIC 0x54415453u
+
+/**
+ * @brief Layout version of the status page.
+ */
+#define LOG_STATUS_VERSION 1u
+
+/**
+ * @brief Size of a task name in a health slot, including the terminator.
+ */
+#define LOG_STATUS_TASK_NAME_SIZE 16
+
+/**
+ * @brief Header of the status page, written once by logStatusInit().
+ *
+ * - magic: LOG_STATUS_MAGIC once the page is initialized.
+ * - version: LOG_STATUS_VERSION.
+ * - pid: Process id of the writer.
+ * - taskSlots: Number of task health slots (LOG_STATUS_TASKS).
+ * - startNs: CLOCK_MONOTONIC time the page was created (in nanoseconds).
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t pid;
+    uint32_t taskSlots;
+    uint64_t startNs;
+} __attribute__((aligned(LOG_STATUS_CACHE_LINE_SIZE))) LogStatusHeader;
+
+/**
+ * @brief Master section.
+ *
+ * - sequence: Sequence lock; odd while the section is written.
+ * - state: Current MasterStates, or MASTESR_STATE_MAX if no master runs in the writer.
+ * - transitions: Number of state changes.
+ * - counts: Number of changes per [from][to] state pair.
+ * - enteredNs: CLOCK_MONOTONIC time the current state was entered (in nanoseconds).
+ */
+typedef struct {
+    uint32_t sequence;
+    uint32_t state;
+    uint32_t transitions;
+    uint32_t counts[MASTESR_STATE_MAX][MASTESR_STATE_MAX];
+    uint64_t enteredNs;
+} __attribute__((aligned(LOG_STATUS_CACHE_LINE_SIZE))) LogStatusMaster;
+
+/**
+ * @brief Slave section.
+ *
+ * - sequence: Sequence lock; odd while the section is written.
+ * - state: Current SlaveStates, or SLAVE_STATE_MAX if no slave runs in the writer.
+ * - transitions: Number of state changes.
+ * - counts: Number of changes per [from][to] state pair.
+ * - enteredNs: CLOCK_MONOTONIC time the current state was entered (in nanoseconds).
+ */
+typedef struct {
+    uint32_t sequence;
+    uint32_t state;
+    uint32_t transitions;
+    uint32_t counts[SLAVE_STATE_MAX][SLAVE_STATE_MAX];
+    uint64_t enteredNs;
+} __attribute__((aligned(LOG_STATUS_CACHE_LINE_SIZE))) LogStatusSlave;
+
+/**
+ * @brief Health slot of one task.
+ *
+ * - sequence: Sequence lock; odd while the slot is written, 0 while it is unused.
+ * - starts: Number of times a task of this name started (restarts + 1).
+ * - heartbeats: Number of loop iterations reported by the task.
+ * - lastHeartbeatNs: CLOCK_MONOTONIC time of the last heartbeat (in nanoseconds).
+ * - name: Task name.
+ */
+typedef struct {
+    uint32_t sequence;
+    uint32_t starts;
+    uint32_t heartbeats;
+    uint64_t lastHeartbeatNs;
+    char name[LOG_STATUS_TASK_NAME_SIZE];
+} __attribute__((aligned(LOG_STATUS_CACHE_LINE_SIZE))) LogStatusTask;
+
+/**
+ * @brief Layout of the status page file.
+ */
+typedef struct {
+    LogStatusHeader header;
+    LogStatusMaster master;
+    LogStatusSlave slave;
+    LogStatusTask tasks[LOG_STATUS_TASKS];
+} LogStatusPage;
+
+/**
+ * @brief Consistent copy of a status page.
+ *
+ * - pid: Process id of the writer.
+ * - master: Master section.
+ * - slave: Slave section.
+ * - taskCount: Number of used entries of tasks.
+ * - tasks: Health slots in use.
+ */
+typedef struct {
+    uint32_t pid;
+    LogStatusMaster master;
+    LogStatusSlave slave;
+    uint32_t taskCount;
+    LogStatusTask tasks[LOG_STATUS_TASKS];
+} LogStatusSnapshot;
+
+/**
+ * @brief Creates the status page at path and maps it.
+ *
+ * Any previous file at path is replaced, so monitors still mapping it see no
+ * further updates and should open the new one.
+ *
+ * @param path Status page file.
+ * @return RET_OK on success, RET_ERROR otherwise (the writer functions then do nothing).
+ */
+RetVal_t logStatusInit(const char *path);
+
+/**
+ * @brief Publishes the current master state; call only under the master state lock.
+ *
+ * A change of state is counted as a transition; the first call only sets the state.
+ *
+ * @param state Current master state.
+ */
+void logStatusSetMasterState(MasterStates state);
+
+/**
+ * @brief Publishes the current slave state; call only under the slave state lock.
+ *
+ * A change of state is counted as a transition; the first call only sets the state.
+ *
+ * @param state Current slave state.
+ */
+void logStatusSetSlaveState(SlaveStates state);
+
+/**
+ * @brief Records one loop iteration of the calling task in its health slot.
+ *
+ * The task claims a slot, keyed by its name, on its first call; a restarted
+ * task takes over its previous slot and increments its start count.
+ */
+void logStatusHeartbeat(void);
+
+/**
+ * @brief Maps a status page read-only.
+ *
+ * @param path Status page file.
+ * @param page Pointer to store the mapped page.
+ * @return RET_OK on success, RET_ERROR if the file is missing, too small or not initialized.
+ */
+RetVal_t logStatusOpenView(const char *path, const LogStatusPage **page);
+
+/**
+ * @brief Unmaps a page mapped by logStatusOpenView().
+ *
+ * @param page Mapped page.
+ */
+void logStatusCloseView(const LogStatusPage *page);
+
+/**
+ * @brief Takes a snapshot of a mapped status page.
+ *
+ * Every section is copied consistently; different sections may be copied at
+ * slightly different times.
+ *
+ * @param page Mapped page.
+ * @param snapshot Pointer to store the snapshot.
+ * @return RET_OK on success, RET_ERROR if a section kept changing for LOG_STATUS_READ_RETRIES attempts.
+ */
+RetVal_t logStatusRead(const LogStatusPage *page, LogStatusSnapshot *snapshot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOGGER_STATUS_H
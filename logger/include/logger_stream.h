@@ -0,0 +1,87 @@
+#ifndef LOGGER_STREAM_H
+#define LOGGER_STREAM_H
+
+#include <stdint.h>
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file logger_stream.h
+ * @brief Streams log records to a local collector over a Unix domain socket.
+ *
+ * Records are copied into a bounded queue of LOG_STREAM_QUEUE_SIZE slots and
+ * sent in batches with one sendmsg() (a writev() with flags) of up to
+ * LOG_STREAM_BATCH_RECORDS records per system call. The socket is non-blocking
+ * from before connect(), so an absent or slow collector never stalls the
+ * caller: records that do not fit the queue are dropped and counted. When the
+ * collector is not listening, cannot accept the connection at once or the
+ * connection breaks, queued records are discarded and a new connection is
+ * attempted every LOG_STREAM_RECONNECT_MS.
+ *
+ * The functions are not reentrant; the logger flush task is the only caller.
+ */
+
+/**
+ * @brief Called after a connection has been established, before any queued record is sent.
+ *
+ * Used to send the records a collector needs first (e.g. the binary session
+ * and definition records). The hook may call logStreamAppend(). It is also
+ * called again once the queue has drained after records were dropped.
+ */
+typedef void (*LogStreamConnectHook)(void);
+
+/**
+ * @brief Initializes the stream and attempts the first connection.
+ *
+ * @param connectHook Hook called after each (re)connection (may be NULL).
+ */
+void logStreamInit(LogStreamConnectHook connectHook);
+
+/**
+ * @brief Queues one record for sending.
+ *
+ * The record is dropped and counted if the queue is full. Records appended
+ * while no collector is connected are ignored (and not counted).
+ *
+ * @param data Record bytes.
+ * @param length Record length (at most LOG_RECORD_SIZE).
+ */
+void logStreamAppend(const char *data, uint16_t length);
+
+/**
+ * @brief Sends the queued records and reconnects if the reconnect interval has elapsed.
+ *
+ * Sends as much as the socket accepts without blocking; the rest stays queued
+ * for the next call.
+ */
+void logStreamFlush(void);
+
+/**
+ * @brief Returns the records dropped since the previous call and resets that count.
+ *
+ * @return Number of records dropped while the collector was slow or absent.
+ */
+uint32_t logStreamTakeDropped(void);
+
+/**
+ * @brief Returns the total number of dropped records since start-up.
+ *
+ * May be called from any task.
+ *
+ * @return Total number of dropped records.
+ */
+uint32_t logStreamDroppedTotal(void);
+
+/**
+ * @brief Closes the connection and discards the queued records.
+ */
+void logStreamClose(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOGGER_STREAM_H
@@ -0,0 +1,68 @@
+#ifndef LOGGER_TIMESTAMP_H
+#define LOGGER_TIMESTAMP_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file logger_timestamp.h
+ * @brief High-resolution timestamp service shared by the logger, tracing and metrics.
+ *
+ * Timestamps are wall-clock times with nanosecond resolution that never go
+ * backwards: the wall clock is sampled once, and every later timestamp adds the
+ * elapsed monotonic time to it. Formatting caches the date and time text of the
+ * current second, so a record only costs the sub-second digits.
+ *
+ * This module has no FreeRTOS dependency and is also built into the host tools.
+ */
+
+/**
+ * @brief Size of a formatted timestamp ("YYYY-MM-DD HH:MM:SS.uuuuuu"), terminating NUL included.
+ */
+#define LOG_TIMESTAMP_TEXT_SIZE 27
+
+/**
+ * @brief Wall-clock time with nanosecond resolution.
+ *
+ * - seconds: Seconds since the epoch.
+ * - nanoseconds: Nanoseconds within the second (0..999999999).
+ */
+typedef struct {
+    int64_t seconds;
+    uint32_t nanoseconds;
+} LogTimestamp;
+
+/**
+ * @brief Returns the current time.
+ *
+ * @return Wall-clock time, monotonic across calls and tasks.
+ */
+LogTimestamp logTimestampNow(void);
+
+/**
+ * @brief Returns the monotonic clock in nanoseconds, for measuring durations.
+ *
+ * @return Nanoseconds since an arbitrary fixed point.
+ */
+uint64_t logTimestampMonotonicNs(void);
+
+/**
+ * @brief Formats a timestamp as local time "YYYY-MM-DD HH:MM:SS.uuuuuu".
+ *
+ * @param timestamp Time to format.
+ * @param buffer Destination buffer.
+ * @param size Size of the destination buffer (at least LOG_TIMESTAMP_TEXT_SIZE).
+ * @return Number of characters written (without the terminating NUL), or 0 if
+ *         the buffer is too small.
+ */
+size_t logTimestampFormat(const LogTimestamp *timestamp, char *buffer, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOGGER_TIMESTAMP_H
@@ -0,0 +1,179 @@
+#ifndef LOGGER_TRACE_H
+#define LOGGER_TRACE_H
+
+#include <stdint.h>
+#include "types.h"
+#include "logger_cfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file logger_trace.h
+ * @brief End-to-end traces of client inputs through the slave and the master.
+ *
+ * The TCP server starts a trace for every client message (logTraceBegin()).
+ * The trace id travels with the message: in the header of the pipeline
+ * payload, as the trace of the slave state it caused, and in the CommMessage
+ * reporting that state to the master. Every hop records a span holding the
+ * trace id, the hop, a CLOCK_MONOTONIC timestamp and a hop value, such as the
+ * state that was entered (logTraceSpan()). A trace id of 0 means untraced, and
+ * hops ignore it.
+ *
+ * Within a task the trace being handled is kept in a thread-local context
+ * (logTraceSetCurrent()), so the state machines find the trace that caused a
+ * transition without changing their interfaces.
+ *
+ * Spans go to a ring of LOG_TRACE_SPANS slots in a memory-mapped file
+ * (logTraceInit()). A writer claims a slot with one atomic increment and fills
+ * it under the sequence lock of the slot, so any task can record spans
+ * without a lock, and the oldest spans are overwritten. The trace_report tool
+ * maps the files of the master and slave processes read-only
+ * (logTraceOpenView(), logTraceRead()), joins the spans by trace id and
+ * prints the latency of every hop and of the whole trace.
+ *
+ * The writer functions do nothing until logTraceInit() has succeeded. The
+ * view functions do not depend on FreeRTOS, so host tools can link them.
+ */
+
+/**
+ * @brief Marks a trace file initialized by its writer ("TRCE").
+ */
+#define LOG_TRACE_MAGIC 0x45435254u
+
+/**
+ * @brief Layout version of the trace file.
+ */
+#define LOG_TRACE_VERSION 1u
+
+/**
+ * @brief Hops of a trace, in the order a client input passes them.
+ */
+typedef enum {
+    LOG_TRACE_HOP_TCP_RECEIVED,      ///< TCP server received the client message; value: message length.
+    LOG_TRACE_HOP_SLAVE_RECEIVED,    ///< Slave payload handler took the payload; value: parsed DATA.
+    LOG_TRACE_HOP_SLAVE_TRANSITION,  ///< Slave state machine changed state; value: new SlaveStates.
+    LOG_TRACE_HOP_SLAVE_SENT,        ///< Slave is sending its state to the master; value: SlaveStates sent.
+    LOG_TRACE_HOP_MASTER_RECEIVED,   ///< Master received the slave state; value: SlaveStates received.
+    LOG_TRACE_HOP_MASTER_TRANSITION, ///< Master state machine changed state; value: new MasterStates.
+    LOG_TRACE_HOP_MAX                ///< Number of hops.
+} LogTraceHop;
+
+/**
+ * @brief One recorded hop of a trace.
+ *
+ * - sequence: Sequence lock; odd while the slot is written, 0 while it is unused.
+ * - traceId: Trace the span belongs to.
+ * - timeNs: CLOCK_MONOTONIC time of the hop (in nanoseconds).
+ * - hop: LogTraceHop.
+ * - value: Hop value, see LogTraceHop.
+ */
+typedef struct {
+    uint32_t sequence;
+    uint32_t traceId;
+    uint64_t timeNs;
+    uint32_t hop;
+    uint32_t value;
+} LogTraceSpan;
+
+/**
+ * @brief Header of the trace file, written once by logTraceInit() except for head.
+ *
+ * - magic: LOG_TRACE_MAGIC once the file is initialized.
+ * - version: LOG_TRACE_VERSION.
+ * - pid: Process id of the writer.
+ * - spanSlots: Number of span slots (LOG_TRACE_SPANS).
+ * - head: Number of spans recorded; the next span goes to slot head % spanSlots.
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t pid;
+    uint32_t spanSlots;
+    uint32_t head;
+} __attribute__((aligned(LOG_TRACE_CACHE_LINE_SIZE))) LogTraceHeader;
+
+/**
+ * @brief Layout of the trace file.
+ */
+typedef struct {
+    LogTraceHeader header;
+    LogTraceSpan spans[LOG_TRACE_SPANS];
+} LogTracePage;
+
+/**
+ * @brief Creates the trace file at path and maps it.
+ *
+ * Any previous file at path is replaced.
+ *
+ * @param path Trace file.
+ * @return RET_OK on success, RET_ERROR otherwise (the writer functions then do nothing).
+ */
+RetVal_t logTraceInit(const char *path);
+
+/**
+ * @brief Starts a trace and records its first span.
+ *
+ * @param hop First hop of the trace.
+ * @param value Hop value.
+ * @return Id of the new trace, or 0 if tracing is not active.
+ */
+uint32_t logTraceBegin(LogTraceHop hop, uint32_t value);
+
+/**
+ * @brief Records a span of a trace.
+ *
+ * @param traceId Trace id; nothing is recorded for 0.
+ * @param hop Hop reached.
+ * @param value Hop value.
+ */
+void logTraceSpan(uint32_t traceId, LogTraceHop hop, uint32_t value);
+
+/**
+ * @brief Sets the trace handled by the calling task.
+ *
+ * @param traceId Trace id, or 0 when the task is done with it.
+ */
+void logTraceSetCurrent(uint32_t traceId);
+
+/**
+ * @brief Returns the trace handled by the calling task.
+ *
+ * @return Trace id set by logTraceSetCurrent(), or 0.
+ */
+uint32_t logTraceCurrent(void);
+
+/**
+ * @brief Maps a trace file read-only.
+ *
+ * @param path Trace file.
+ * @param page Pointer to store the mapped file.
+ * @return RET_OK on success, RET_ERROR if the file is missing, too small or not initialized.
+ */
+RetVal_t logTraceOpenView(const char *path, const LogTracePage **page);
+
+/**
+ * @brief Unmaps a file mapped by logTraceOpenView().
+ *
+ * @param page Mapped file.
+ */
+void logTraceCloseView(const LogTracePage *page);
+
+/**
+ * @brief Copies the spans of a mapped trace file.
+ *
+ * Every span is copied consistently; slots being written or unused are skipped.
+ *
+ * @param page Mapped file.
+ * @param spans Buffer to store the spans.
+ * @param capacity Size of spans, at least LOG_TRACE_SPANS to get every span.
+ * @param count Pointer to store the number of spans copied.
+ */
+void logTraceRead(const LogTracePage *page, LogTraceSpan *spans, uint32_t capacity, uint32_t *count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOGGER_TRACE_H
@@ -1,65 +1,589 @@
 #include "logger.h"
+#include "logger_ring.h"
+#include "logger_binary.h"
+#include "logger_segment.h"
+#include "logger_index.h"
+#include "logger_query.h"
+#include "logger_flight.h"
+#include "logger_component.h"
+#include "logger_timestamp.h"
+#include "logger_stream.h"
+#include "logger_compress.h"
+#include "logger_status.h"
+#include "logger_cfg.h"
+#include "thread_handler_cfg.h"
+#include "FreeRTOS.h"
+#include "task.h"
 #include <stdio.h>
 #include <time.h>
 #include <string.h>
 #include <stdarg.h>
 
-#define LOG_FILE "system_log.txt"
-#define PRIORITY_LEVEL LOG_LEVEL_INFO
+#define PRIORITY_LEVEL ((LogLevel)LOG_DEFAULT_LEVEL)
 
-// Global variable to store the minimum log level
-static LogLevel currentLogLevel = LOG_LEVEL_DEBUG;
+#if LOG_BINARY_ENABLED
+#define LOG_OUTPUT_FILE LOG_BINARY_FILE
+#define LOG_OUTPUT_MODE "ab"
+#else
+#define LOG_OUTPUT_FILE LOG_FILE
+#define LOG_OUTPUT_MODE "a"
+#endif
 
-void setLogLevel(LogLevel level) {
-    currentLogLevel = level;
+// Global variable to store the minimum log level (PRIORITY_LEVEL until changed by setLogLevel)
+static LogLevel currentLogLevel = PRIORITY_LEVEL;
+
+/**
+ * @brief State of the logger output path.
+ *
+ * - initialized: Set by initLogger(); selects the configured output format.
+ * - active: Set once the ring buffer is ready; records are queued from then on.
+ * - startTime: Wall-clock time of initLogger() (tick 0 of binary records).
+ * - file: Log file kept open by the flush task (without log segments).
+ * - fileBuffer: stdio buffer used to batch writes of the flush task.
+ */
+typedef struct {
+    uint8_t initialized;
+    uint8_t active;
+    time_t startTime;
+    FILE* file;
+    char fileBuffer[LOG_FILE_BUFFER_SIZE];
+} LoggerState;
+
+static LoggerState loggerState_ = {0, 0, 0, NULL, {0}};
+
+static const char* priorityToString(LogLevel priority) {
+    switch (priority) {
+        case LOG_LEVEL_DEBUG: return "DEBUG";
+        case LOG_LEVEL_INFO: return "INFO";
+        case LOG_LEVEL_WARN: return "WARN";
+        case LOG_LEVEL_ERROR: return "ERROR";
+        default: return "UNKNOWN";
+    }
 }
 
-void logMessage(LogLevel priority, const char* thread, const char* message) {
-    if (priority < currentLogLevel) {
-        return; // Do not log messages below the current log level
+/**
+ * @brief Fills the metadata of a new record.
+ */
+static void describeRecord(LogRecordInfo* info, LogLevel priority, LogComponentId component) {
+    LogTimestamp now = logTimestampNow();
+    info->timestamp = now.seconds;
+    info->nanoseconds = now.nanoseconds;
+    info->level = (uint8_t)priority;
+    info->componentId = component;
+    info->componentBit = 0;
+}
+
+/**
+ * @brief Formats one complete log line into the provided buffer.
+ *
+ * Lines that do not fit are truncated and still terminated with a newline.
+ *
+ * @return Number of bytes written (without the terminating NUL).
+ */
+static uint16_t formatRecord(char* buffer, size_t size, const LogRecordInfo* info,
+                             const char* message, size_t messageLength) {
+    LogTimestamp when = {info->timestamp, info->nanoseconds};
+    char timestamp[LOG_TIMESTAMP_TEXT_SIZE];
+    logTimestampFormat(&when, timestamp, sizeof(timestamp));
+
+    int32_t length = snprintf(buffer, size, "[%s] [%s] [%s] %.*s\n",
+                              timestamp, priorityToString((LogLevel)info->level),
+                              logComponentName(info->componentId), (int)messageLength, message);
+    if (length < 0) {
+        return 0;
+    }
+    if ((size_t)length >= size) {
+        length = (int32_t)size - 1;
+        buffer[length - 1] = '\n';
+    }
+    return (uint16_t)length;
+}
+
+/**
+ * @brief Encodes one record in the configured output format.
+ *
+ * @return Number of bytes written into the buffer.
+ */
+static uint16_t encodeRecord(char* buffer, size_t size, const LogRecordInfo* info, const char* message) {
+#if LOG_BINARY_ENABLED
+    if (loggerState_.initialized) {
+        return logBinaryEncodeText(buffer, size, xTaskGetTickCount(), (LogLevel)info->level,
+                                   logComponentName(info->componentId), message);
+    }
+#endif
+    return formatRecord(buffer, size, info, message, strlen(message));
+}
+
+#if LOG_BINARY_ENABLED
+/**
+ * @brief Writes the session record and all known definitions, so the records that follow can be decoded.
+ *
+ * @param write Function writing one record.
+ */
+static void writeSessionHeader(void (*write)(const char* record, uint16_t length)) {
+    char record[LOG_RECORD_SIZE];
+    uint32_t cursor = 0;
+    uint16_t length;
+
+    write(record, logBinaryEncodeSession(record, sizeof(record), configTICK_RATE_HZ,
+                                         (int64_t)loggerState_.startTime));
+    while ((length = logBinaryEncodeNextDefinition(record, sizeof(record), &cursor)) != 0) {
+        write(record, length);
+    }
+}
+#endif
+
+#if LOG_SEGMENT_ENABLED
+/**
+ * @brief Appends one record to the active log segment and indexes it.
+ */
+static void writeSegmentRecord(const char* record, uint16_t length, const LogRecordInfo* info) {
+    LogSegmentLocation location;
+    if (logSegmentWrite(record, length, &location) == RET_OK) {
+        LogRecordInfo indexInfo = *info;
+        indexInfo.componentBit = logIndexComponentBit(logComponentName(info->componentId));
+        logIndexAdd(&location, length, &indexInfo);
+    }
+}
+
+/**
+ * @brief Appends one record to the active log segment from any task.
+ *
+ * Segment writes are not reentrant; once the scheduler runs, concurrent
+ * synchronous writers are serialized with a critical section.
+ */
+static void writeSegmentRecordLocked(const char* record, uint16_t length, const LogRecordInfo* info) {
+    if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+        taskENTER_CRITICAL();
+        writeSegmentRecord(record, length, info);
+        taskEXIT_CRITICAL();
+    } else {
+        writeSegmentRecord(record, length, info);
+    }
+}
+
+#if LOG_BINARY_ENABLED
+static void writeSegmentHeaderRecord(const char* record, uint16_t length) {
+    logSegmentWrite(record, length, NULL);
+}
+
+/**
+ * @brief Starts every log segment with the session record and all known definitions.
+ */
+static void writeSegmentHeader(void) {
+    writeSessionHeader(writeSegmentHeaderRecord);
+}
+#define LOG_SEGMENT_OPEN_HOOK writeSegmentHeader
+#else
+#define LOG_SEGMENT_OPEN_HOOK NULL
+#endif
+#endif
+
+#if LOG_ASYNC_ENABLED && LOG_STREAM_ENABLED
+#if LOG_BINARY_ENABLED
+/**
+ * @brief Starts every collector connection with the session record and all known definitions.
+ */
+static void writeStreamHeader(void) {
+    writeSessionHeader(logStreamAppend);
+}
+#define LOG_STREAM_CONNECT_HOOK writeStreamHeader
+#else
+#define LOG_STREAM_CONNECT_HOOK NULL
+#endif
+#endif
+
+/**
+ * @brief Appends one encoded record to the log with a synchronous write.
+ */
+static void writeRecordSync(const char* record, uint16_t length, const LogRecordInfo* info) {
+#if LOG_SEGMENT_ENABLED
+    if (loggerState_.initialized) {
+        writeSegmentRecordLocked(record, length, info);
+        return;
     }
+#else
+    (void)info;
+#endif
 
-    FILE* logFile = fopen(LOG_FILE, "a");
+    FILE* logFile = fopen(loggerState_.initialized ? LOG_OUTPUT_FILE : LOG_FILE,
+                          loggerState_.initialized ? LOG_OUTPUT_MODE : "a");
     if (logFile == NULL) {
         perror("Failed to open log file");
         return;
     }
+    fwrite(record, 1, length, logFile);
+    fclose(logFile);
+}
 
-    time_t now = time(NULL);
-    char* timestamp = ctime(&now);
-    timestamp[strlen(timestamp) - 1] = '\0'; // Remove newline character
+RetVal_t initLogger(void) {
+    loggerState_.startTime = (time_t)logTimestampNow().seconds;
+#if LOG_BINARY_ENABLED
+    logBinaryInit();
+#endif
+    loggerState_.initialized = 1;
 
-    const char* priorityStr;
-    switch (priority) {
-        case LOG_LEVEL_DEBUG: priorityStr = "DEBUG"; break;
-        case LOG_LEVEL_INFO: priorityStr = "INFO"; break;
-        case LOG_LEVEL_WARN: priorityStr = "WARN"; break;
-        case LOG_LEVEL_ERROR: priorityStr = "ERROR"; break;
-        default: priorityStr = "UNKNOWN"; break;
+#if LOG_SEGMENT_ENABLED
+    if (logSegmentInit(LOG_SEGMENT_OPEN_HOOK) != RET_OK) {
+        loggerState_.initialized = 0;
+        return RET_ERROR;
     }
+#elif LOG_BINARY_ENABLED
+    char session[sizeof(LogBinaryRecordHeader) + sizeof(LogBinarySession)];
+    writeRecordSync(session, logBinaryEncodeSession(session, sizeof(session), configTICK_RATE_HZ,
+                                                    (int64_t)loggerState_.startTime), NULL);
+#endif
 
-    if(priority >= PRIORITY_LEVEL){ 
-        fprintf(logFile, "[%s] [%s] [%s] %s\n", timestamp, priorityStr, thread, message);
+#if LOG_ASYNC_ENABLED
+#if !LOG_SEGMENT_ENABLED
+    loggerState_.file = fopen(LOG_OUTPUT_FILE, LOG_OUTPUT_MODE);
+    if (loggerState_.file == NULL) {
+        perror("Failed to open log file");
+        return RET_ERROR;
     }
-    fclose(logFile);
+    setvbuf(loggerState_.file, loggerState_.fileBuffer, _IOFBF, sizeof(loggerState_.fileBuffer));
+#endif
+
+    logRingInit();
+#if LOG_STREAM_ENABLED
+    logStreamInit(LOG_STREAM_CONNECT_HOOK);
+#endif
+    __atomic_store_n(&loggerState_.active, 1, __ATOMIC_RELEASE);
+#endif
+    return RET_OK;
+}
+
+uint32_t getLogDroppedRecords(void) {
+    return logRingDroppedTotal();
+}
+
+uint32_t getLogStreamDroppedRecords(void) {
+#if LOG_ASYNC_ENABLED && LOG_STREAM_ENABLED
+    return logStreamDroppedTotal();
+#else
+    return 0;
+#endif
+}
+
+void setLogLevel(LogLevel level) {
+    currentLogLevel = level;
+    logComponentSetDefaultLevel(level);
+}
+
+void setComponentLogLevel(const char *component, LogLevel level) {
+    logComponentSetLevel(logComponentRegister(component), level);
+}
+
+void resetComponentLogLevel(const char *component) {
+    logComponentResetLevel(logComponentRegister(component));
+}
+
+uint8_t logLevelEnabled(LogLevel level) {
+#if LOG_FLIGHT_ENABLED
+    if ((int)level >= LOG_FLIGHT_LEVEL) {
+        return 1; // Kept by the flight recorder
+    }
+#endif
+    return level >= currentLogLevel;
+}
+
+uint8_t logComponentLevelEnabled(LogComponentId *site, const char *component, LogLevel level) {
+    LogComponentId id = __atomic_load_n(site, __ATOMIC_RELAXED);
+    if (id == LOG_COMPONENT_UNREGISTERED) {
+        id = logComponentLookup(component);
+        __atomic_store_n(site, id, __ATOMIC_RELAXED);
+    }
+#if LOG_FLIGHT_ENABLED
+    if ((int)level >= LOG_FLIGHT_LEVEL) {
+        return 1; // Kept by the flight recorder
+    }
+#endif
+    return level >= logComponentLevel(id);
+}
+
+/**
+ * @brief Keeps the calling task running from logRingReserve() to logRingCommit().
+ *
+ * The flush task never reads past a reserved slot, so a producer that was
+ * deleted (see deleteAllTasks()) or switched out for long between the two
+ * calls would stall every later record. The window only copies the record and
+ * never blocks, so the scheduler is suspended for a few microseconds.
+ *
+ * @return 1 if the scheduler was suspended and must be resumed with closeRecordWindow().
+ */
+static uint8_t openRecordWindow(void) {
+    if (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING) {
+        return 0;
+    }
+    vTaskSuspendAll();
+    return 1;
+}
+
+static void closeRecordWindow(uint8_t suspended) {
+    if (suspended) {
+        (void)xTaskResumeAll();
+    }
+}
+
+/**
+ * @brief Copies one record into the ring buffer.
+ *
+ * Text records only carry the message and the component id; the flush task
+ * adds the timestamp, level and component name. Never blocks: when the ring is
+ * full the record is dropped and counted.
+ */
+static void queueRecord(LogLevel priority, LogComponentId component, const char* message) {
+    LogRingTicket ticket;
+    uint8_t suspended = openRecordWindow();
+    if (logRingReserve(&ticket) != RET_OK) {
+        closeRecordWindow(suspended);
+        return;
+    }
+    describeRecord(ticket.info, priority, component);
+#if LOG_BINARY_ENABLED
+    logRingCommit(&ticket, encodeRecord(ticket.data, LOG_RECORD_SIZE, ticket.info, message));
+#else
+    size_t length = strnlen(message, LOG_RECORD_SIZE);
+    memcpy(ticket.data, message, length);
+    logRingCommit(&ticket, (uint16_t)length);
+#endif
+    closeRecordWindow(suspended);
 }
 
-void logMessageFormatted(LogLevel level, const char *component, const char *format, ...) {
+/**
+ * @brief Writes a message that passed the level filter to the log output.
+ */
+static void writeMessage(LogLevel priority, LogComponentId component, const char* message) {
+    if (__atomic_load_n(&loggerState_.active, __ATOMIC_ACQUIRE)) {
+        queueRecord(priority, component, message);
+        return;
+    }
+
+    char record[LOG_RECORD_SIZE];
+    LogRecordInfo info;
+    describeRecord(&info, priority, component);
+    writeRecordSync(record, encodeRecord(record, sizeof(record), &info, message), &info);
+}
+
+void logMessage(LogLevel priority, const char* thread, const char* message) {
+    LogComponentId component = logComponentLookup(thread);
+#if LOG_FLIGHT_ENABLED
+    logFlightRecordText(priority, component, message);
+#endif
+    if (priority < logComponentLevel(component)) {
+        return; // Do not log messages below the level of the component
+    }
+    writeMessage(priority, component, message);
+}
+
+#if LOG_BINARY_ENABLED
+/**
+ * @brief Stores a formatted log call as a binary record without formatting it.
+ */
+static void logBinaryMessage(LogLevel level, LogComponentId component, const char *format, va_list args) {
+    // The registry name pointer is stable, so every name is interned once
+    const char *name = logComponentName(component);
+
+    if (__atomic_load_n(&loggerState_.active, __ATOMIC_ACQUIRE)) {
+        LogRingTicket ticket;
+        uint8_t suspended = openRecordWindow();
+        if (logRingReserve(&ticket) == RET_OK) {
+            describeRecord(ticket.info, level, component);
+            logRingCommit(&ticket, logBinaryEncodeMessage(ticket.data, LOG_RECORD_SIZE, xTaskGetTickCount(),
+                                                          level, name, format, args));
+        }
+        closeRecordWindow(suspended);
+        return;
+    }
+
+    char record[LOG_RECORD_SIZE];
+    LogRecordInfo info;
+    describeRecord(&info, level, component);
+    writeRecordSync(record, logBinaryEncodeMessage(record, sizeof(record), xTaskGetTickCount(),
+                                                   level, name, format, args), &info);
+}
+#endif
+
+void logMessageFormatted(LogLevel level, const char *name, const char *format, ...) {
+    LogComponentId component = logComponentLookup(name);
+#if LOG_FLIGHT_ENABLED
+    va_list flightArgs;
+    va_start(flightArgs, format);
+    logFlightRecordFormatted(level, component, format, flightArgs);
+    va_end(flightArgs);
+#endif
+    if (level < logComponentLevel(component)) {
+        return; // Filter before formatting
+    }
+
+#if LOG_BINARY_ENABLED
+    if (loggerState_.initialized) {
+        va_list args;
+        va_start(args, format);
+        logBinaryMessage(level, component, format, args);
+        va_end(args);
+        return;
+    }
+#endif
+
     char message[256];
     va_list args;
     va_start(args, format);
     vsnprintf(message, sizeof(message), format, args);
     va_end(args);
-    logMessage(level, component, message);
+    writeMessage(level, component, message);
 }
 
-void printLogMessages(LogLevel level) {
-    FILE* logFile = fopen(LOG_FILE, "r");
-    if (logFile == NULL) {
-        perror("Failed to open log file");
+/**
+ * @brief Writes one record of a flush batch to the log output.
+ */
+static void writeBatchRecord(const char* data, uint16_t length, const LogRecordInfo* info) {
+#if LOG_SEGMENT_ENABLED
+    writeSegmentRecord(data, length, info);
+#else
+    (void)info;
+    fwrite(data, 1, length, loggerState_.file);
+#endif
+#if LOG_STREAM_ENABLED
+    logStreamAppend(data, length);
+#endif
+}
+
+/**
+ * @brief Writes one record of a component from the flush task.
+ */
+static void writeBatchMessage(LogLevel level, const char* component, const char* message) {
+    char record[LOG_RECORD_SIZE];
+    LogRecordInfo info;
+    describeRecord(&info, level, logComponentLookup(component));
+    writeBatchRecord(record, encodeRecord(record, sizeof(record), &info, message), &info);
+}
+
+/**
+ * @brief Writes a WARN record of the Logger component from the flush task.
+ */
+static void writeBatchWarning(const char* message) {
+    writeBatchMessage(LOG_LEVEL_WARN, "Logger", message);
+}
+
+/**
+ * @brief Writes all records currently queued in the ring to the log output.
+ *
+ * Text records are formatted here, off the logging tasks. With log segments
+ * every record is copied into the mapped segment. Otherwise records are handed
+ * to stdio one by one and flushed once per batch, so the file sees a few large
+ * writes instead of one open/write/close per record. With LOG_STREAM_ENABLED the
+ * batch is also sent to the collector socket.
+ *
+ * @return Number of records written.
+ */
+static uint32_t flushRecords(void) {
+    const char* data = NULL;
+    const LogRecordInfo* info = NULL;
+    uint16_t length = 0;
+    uint32_t written = 0;
+
+    while (written < LOG_RING_SIZE && logRingFront(&data, &length, &info) == RET_OK) {
+#if LOG_BINARY_ENABLED
+        writeBatchRecord(data, length, info);
+#else
+        char record[LOG_RECORD_SIZE];
+        writeBatchRecord(record, formatRecord(record, sizeof(record), info, data, length), info);
+#endif
+        logRingPop();
+        written++;
+    }
+
+    char message[64];
+    uint32_t dropped = logRingTakeDropped();
+    if (dropped != 0) {
+        snprintf(message, sizeof(message), "Dropped %u log records (ring buffer full)", (unsigned)dropped);
+        writeBatchWarning(message);
+    }
+
+#if LOG_STREAM_ENABLED
+    uint32_t streamDropped = logStreamTakeDropped();
+    if (streamDropped != 0) {
+        snprintf(message, sizeof(message), "Dropped %u streamed log records (collector too slow)",
+                 (unsigned)streamDropped);
+        writeBatchWarning(message);
+    }
+    logStreamFlush();
+#endif
+
+#if !LOG_SEGMENT_ENABLED
+    if (written != 0 || dropped != 0) {
+        fflush(loggerState_.file);
+    }
+#endif
+    return written;
+}
+
+void logMessageFatal(const char *component, const char *message) {
+    // Never resumed: the caller stops the process, and no other task may log or flush meanwhile
+    if (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) {
+        vTaskSuspendAll();
+    }
+    if (!__atomic_load_n(&loggerState_.active, __ATOMIC_ACQUIRE)) {
+        writeMessage(LOG_LEVEL_ERROR, logComponentLookup(component), message);
         return;
     }
 
+    // Take over from the flush task: write what is queued, then the message
+    while (flushRecords() == LOG_RING_SIZE) {
+    }
+    writeBatchMessage(LOG_LEVEL_ERROR, component, message);
+#if LOG_STREAM_ENABLED
+    logStreamFlush();
+#endif
+#if !LOG_SEGMENT_ENABLED
+    fflush(loggerState_.file);
+#endif
+}
+
+void vLoggerFlushHandler(void *args) {
+    if (!__atomic_load_n(&loggerState_.active, __ATOMIC_ACQUIRE)) {
+        logMessage(LOG_LEVEL_ERROR, "Logger", "Logger is not initialized");
+        // A task function must not return
+        vTaskDelete(NULL);
+        return;
+    }
+
+#ifndef UNIT_TEST
+    while (1) {
+#endif
+#if LOG_SEGMENT_ENABLED
+        logSegmentRotateIfExpired();
+#endif
+        logStatusHeartbeat();
+
+        // A full batch means more records are probably waiting; keep draining
+        if (flushRecords() < LOG_RING_SIZE) {
+            vTaskDelay(pdMS_TO_TICKS(TASTK_TIME_LOGGER_FLUSH_HANDLER));
+        }
+#ifndef UNIT_TEST
+    }
+#endif
+}
+
+void vLoggerCompressHandler(void *args) {
+#ifndef UNIT_TEST
+    while (1) {
+#endif
+#if LOG_SEGMENT_ENABLED && LOG_COMPRESS_ENABLED && !LOG_BINARY_ENABLED
+        logCompressSealedSegments();
+#endif
+        vTaskDelay(pdMS_TO_TICKS(TASTK_TIME_LOGGER_COMPRESS_HANDLER));
+#ifndef UNIT_TEST
+    }
+#endif
+}
+
+#if !LOG_SEGMENT_ENABLED && !LOG_BINARY_ENABLED
+/**
+ * @brief Prints the lines of a text log at or above the given level.
+ */
+static void printTextLog(FILE* logFile, LogLevel level) {
     char line[512];
     while (fgets(line, sizeof(line), logFile) != NULL) {
         LogLevel messageLevel;
@@ -79,6 +603,50 @@ void printLogMessages(LogLevel level) {
             printf("%s", line);
         }
     }
+}
+#endif
+
+#if !LOG_SEGMENT_ENABLED || LOG_BINARY_ENABLED
+/**
+ * @brief Prints the records of one log file at or above the given level.
+ */
+static void printLogFile(const char* path, LogLevel level) {
+    FILE* logFile = fopen(path, "rb");
+    if (logFile == NULL) {
+        perror("Failed to open log file");
+        return;
+    }
 
+#if LOG_BINARY_ENABLED
+    if (logBinaryDecode(logFile, stdout, level) != RET_OK) {
+        fprintf(stderr, "Failed to decode %s\n", path);
+    }
+#else
+    printTextLog(logFile, level);
+#endif
     fclose(logFile);
 }
+#endif
+
+void printLogMessages(LogLevel level) {
+#if LOG_SEGMENT_ENABLED && !LOG_BINARY_ENABLED
+    // Text segments are indexed; let the query engine skip the blocks without matches
+    LogQuery query = {level, NULL, 0, 0};
+    logQueryRun(&query, 1, stdout);
+#elif LOG_SEGMENT_ENABLED
+    uint32_t first = 0;
+    uint32_t last = 0;
+    if (logSegmentFind(&first, &last) != RET_OK) {
+        fprintf(stderr, "No log segments found\n");
+        return;
+    }
+
+    for (uint32_t sequence = first; sequence <= last; sequence++) {
+        char path[256];
+        logSegmentPath(path, sizeof(path), sequence);
+        printLogFile(path, level);
+    }
+#else
+    printLogFile(LOG_OUTPUT_FILE, level);
+#endif
+}
@@ -0,0 +1,774 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "logger_binary.h"
+#include "logger_timestamp.h"
+#include "logger_cfg.h"
+
+/**
+ * @file logger_binary.c
+ * @brief Implements the binary log record encoder and decoder.
+ *
+ * Format strings and component names are identified by their address and
+ * interned into small open-addressing tables. The first use of a key assigns it
+ * an id and parses the argument signature of the format string, so later calls
+ * only copy the raw arguments. This file has no FreeRTOS dependency and is also
+ * built into the host-side log_decoder tool.
+ */
+
+#if (LOG_BINARY_TABLE_SIZE & (LOG_BINARY_TABLE_SIZE - 1)) != 0
+#error "LOG_BINARY_TABLE_SIZE must be a power of two"
+#endif
+
+#define LOG_BINARY_TABLE_MASK (LOG_BINARY_TABLE_SIZE - 1)
+
+/**
+ * @brief Marker of a table entry that is being filled by another task.
+ */
+#define LOG_BINARY_ENTRY_BUSY ((const char *)1)
+
+/**
+ * @brief Component id used when the component table is full.
+ */
+#define LOG_BINARY_UNKNOWN_ID 0xFFFF
+
+/**
+ * @brief Argument count of formats that cannot be stored as raw arguments.
+ */
+#define LOG_BINARY_TEXT_ONLY 0xFF
+
+/**
+ * @brief Interned format string or component name.
+ *
+ * - key: Address of the string (NULL when free, LOG_BINARY_ENTRY_BUSY while filled).
+ * - id: Id assigned on first use.
+ * - argCount: Number of arguments, or LOG_BINARY_TEXT_ONLY.
+ * - argTypes: LogBinaryArgType of each argument.
+ */
+typedef struct {
+    const char *key;
+    uint16_t id;
+    uint8_t argCount;
+    uint8_t argTypes[LOG_BINARY_MAX_ARGS];
+} LogBinaryEntry;
+
+/**
+ * @brief Id tables of the current session.
+ */
+typedef struct {
+    LogBinaryEntry formats[LOG_BINARY_TABLE_SIZE];
+    LogBinaryEntry components[LOG_BINARY_TABLE_SIZE];
+    uint16_t nextFormatId;
+    uint16_t nextComponentId;
+} LogBinaryTables;
+
+static LogBinaryTables tables_ = {.nextFormatId = LOG_BINARY_TEXT_FORMAT_ID + 1};
+
+/**
+ * @brief Skips the flags, width, precision and length of a conversion.
+ *
+ * @param spec Pointer to the character following '%'.
+ * @param stars Pointer to store the number of '*' width/precision arguments.
+ * @param lengthModifier Pointer to store the length modifier ('\0', 'h', 'H' for hh,
+ *        'l', 'q' for ll, 'z', 'j', 't' or 'L').
+ * @return Pointer to the conversion character.
+ */
+static const char *skipConversionPrefix(const char *spec, uint8_t *stars, char *lengthModifier) {
+    *stars = 0;
+    *lengthModifier = '\0';
+
+    while (*spec != '\0' && strchr("-+ #0'", *spec) != NULL) {
+        spec++;
+    }
+    if (*spec == '*') {
+        (*stars)++;
+        spec++;
+    }
+    while (*spec >= '0' && *spec <= '9') {
+        spec++;
+    }
+    if (*spec == '.') {
+        spec++;
+        if (*spec == '*') {
+            (*stars)++;
+            spec++;
+        }
+        while (*spec >= '0' && *spec <= '9') {
+            spec++;
+        }
+    }
+
+    if (*spec == 'h' || *spec == 'l') {
+        *lengthModifier = *spec;
+        spec++;
+        if (*spec == *lengthModifier) {
+            *lengthModifier = (*lengthModifier == 'h') ? 'H' : 'q';
+            spec++;
+        }
+    } else if (*spec == 'z' || *spec == 'j' || *spec == 't' || *spec == 'L') {
+        *lengthModifier = *spec;
+        spec++;
+    }
+    return spec;
+}
+
+/**
+ * @brief Maps a conversion character to the stored argument type.
+ *
+ * @return LogBinaryArgType, or 0 if the conversion cannot be deferred.
+ */
+static uint8_t conversionArgType(char conversion, char lengthModifier) {
+    switch (conversion) {
+        case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+            if (lengthModifier == 'l' || lengthModifier == 'q' || lengthModifier == 'z' ||
+                lengthModifier == 'j' || lengthModifier == 't') {
+                return LOG_BINARY_ARG_INT64;
+            }
+            return (lengthModifier == 'L') ? 0 : LOG_BINARY_ARG_INT32;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            return (lengthModifier == 'L') ? 0 : LOG_BINARY_ARG_DOUBLE;
+        case 's':
+            return (lengthModifier == '\0') ? LOG_BINARY_ARG_STRING : 0;
+        case 'p':
+            return LOG_BINARY_ARG_POINTER;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Parses the argument signature of a format string into a table entry.
+ */
+static void parseSignature(const char *format, LogBinaryEntry *entry) {
+    uint8_t count = 0;
+
+    for (const char *p = format; *p != '\0'; p++) {
+        if (*p != '%') {
+            continue;
+        }
+        p++;
+        if (*p == '%') {
+            continue;
+        }
+
+        uint8_t stars = 0;
+        char lengthModifier = '\0';
+        p = skipConversionPrefix(p, &stars, &lengthModifier);
+        uint8_t type = conversionArgType(*p, lengthModifier);
+
+        if (type == 0 || count + stars + 1 > LOG_BINARY_MAX_ARGS) {
+            entry->argCount = LOG_BINARY_TEXT_ONLY;
+            return;
+        }
+        while (stars-- > 0) {
+            entry->argTypes[count++] = LOG_BINARY_ARG_INT32;
+        }
+        entry->argTypes[count++] = type;
+    }
+    entry->argCount = count;
+}
+
+static uint32_t hashPointer(const char *key) {
+    uintptr_t value = (uintptr_t)key;
+    value ^= value >> 17;
+    value *= 0x9E3779B1u;
+    return (uint32_t)(value ^ (value >> 15));
+}
+
+/**
+ * @brief Looks up a key in an id table and inserts it on first use.
+ *
+ * @param table Table to search.
+ * @param key String address to look up.
+ * @param nextId Id counter of the table.
+ * @param isFormat Non-zero to parse the argument signature of a new entry.
+ * @param created Set to 1 if the entry was inserted by this call.
+ * @return The entry, or NULL if the table is full or the entry is being inserted
+ *         by another task.
+ */
+static LogBinaryEntry *internKey(LogBinaryEntry *table, const char *key, uint16_t *nextId,
+                                 uint8_t isFormat, uint8_t *created) {
+    uint32_t index = hashPointer(key) & LOG_BINARY_TABLE_MASK;
+    *created = 0;
+
+    for (uint32_t probe = 0; probe < LOG_BINARY_TABLE_SIZE; probe++) {
+        LogBinaryEntry *entry = &table[index];
+        const char *current = __atomic_load_n(&entry->key, __ATOMIC_ACQUIRE);
+
+        if (current == NULL) {
+            if (__atomic_compare_exchange_n(&entry->key, &current, LOG_BINARY_ENTRY_BUSY, 0,
+                                            __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+                entry->id = __atomic_fetch_add(nextId, 1, __ATOMIC_RELAXED);
+                if (isFormat) {
+                    parseSignature(key, entry);
+                }
+                __atomic_store_n(&entry->key, key, __ATOMIC_RELEASE);
+                *created = 1;
+                return entry;
+            }
+        }
+
+        if (current == key) {
+            return entry;
+        }
+        if (current == LOG_BINARY_ENTRY_BUSY) {
+            return NULL;
+        }
+        index = (index + 1) & LOG_BINARY_TABLE_MASK;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Writes a record header at the start of a record.
+ */
+static void writeHeader(char *buffer, uint8_t type, uint8_t level, uint16_t length,
+                        uint32_t tick, uint16_t formatId, uint16_t componentId) {
+    LogBinaryRecordHeader header = {type, level, length, tick, formatId, componentId};
+    memcpy(buffer, &header, sizeof(header));
+}
+
+/**
+ * @brief Writes a FORMAT_DEF or COMPONENT_DEF record.
+ *
+ * Definitions longer than the remaining space are truncated.
+ *
+ * @return Number of bytes written, or 0 if not even the header fits.
+ */
+static uint16_t encodeDefinition(char *buffer, size_t size, uint8_t type, uint32_t tick,
+                                 uint16_t id, const char *text) {
+    if (size <= sizeof(LogBinaryRecordHeader)) {
+        return 0;
+    }
+    size_t length = strlen(text);
+    if (length > size - sizeof(LogBinaryRecordHeader)) {
+        length = size - sizeof(LogBinaryRecordHeader);
+    }
+    memcpy(buffer + sizeof(LogBinaryRecordHeader), text, length);
+
+    uint16_t total = (uint16_t)(sizeof(LogBinaryRecordHeader) + length);
+    writeHeader(buffer, type, 0, total, tick,
+                (type == LOG_BINARY_RECORD_FORMAT_DEF) ? id : 0,
+                (type == LOG_BINARY_RECORD_COMPONENT_DEF) ? id : 0);
+    return total;
+}
+
+/**
+ * @brief Resolves the component id, writing its definition on first use.
+ *
+ * @param offset Current write offset; advanced past a written definition.
+ * @return The component id.
+ */
+static uint16_t resolveComponent(char *buffer, size_t size, size_t *offset,
+                                 uint32_t tick, const char *component) {
+    uint8_t created = 0;
+    LogBinaryEntry *entry = internKey(tables_.components, component,
+                                      &tables_.nextComponentId, 0, &created);
+    if (entry == NULL) {
+        return LOG_BINARY_UNKNOWN_ID;
+    }
+    if (created) {
+        *offset += encodeDefinition(buffer + *offset, size - *offset,
+                                    LOG_BINARY_RECORD_COMPONENT_DEF, tick, entry->id, component);
+    }
+    return entry->id;
+}
+
+void logBinaryInit(void) {
+    memset(&tables_, 0, sizeof(tables_));
+    tables_.nextFormatId = LOG_BINARY_TEXT_FORMAT_ID + 1;
+}
+
+uint16_t logBinaryEncodeSession(char *buffer, size_t size, uint16_t tickRateHz, int64_t startEpoch) {
+    uint16_t total = sizeof(LogBinaryRecordHeader) + sizeof(LogBinarySession);
+    if (size < total) {
+        return 0;
+    }
+
+    LogBinarySession session = {LOG_BINARY_MAGIC, LOG_BINARY_VERSION, tickRateHz, startEpoch};
+    writeHeader(buffer, LOG_BINARY_RECORD_SESSION, 0, total, 0, 0, 0);
+    memcpy(buffer + sizeof(LogBinaryRecordHeader), &session, sizeof(session));
+    return total;
+}
+
+uint16_t logBinaryEncodeNextDefinition(char *buffer, size_t size, uint32_t *cursor) {
+    while (*cursor < 2 * LOG_BINARY_TABLE_SIZE) {
+        uint32_t index = (*cursor)++;
+        uint8_t isFormat = (index < LOG_BINARY_TABLE_SIZE);
+        const LogBinaryEntry *entry = isFormat ? &tables_.formats[index]
+                                               : &tables_.components[index - LOG_BINARY_TABLE_SIZE];
+        const char *key = __atomic_load_n(&entry->key, __ATOMIC_ACQUIRE);
+
+        if (key == NULL || key == LOG_BINARY_ENTRY_BUSY ||
+            (isFormat && entry->argCount == LOG_BINARY_TEXT_ONLY)) {
+            continue;
+        }
+        return encodeDefinition(buffer, size,
+                                isFormat ? LOG_BINARY_RECORD_FORMAT_DEF : LOG_BINARY_RECORD_COMPONENT_DEF,
+                                0, entry->id, key);
+    }
+    return 0;
+}
+
+uint16_t logBinaryEncodeText(char *buffer, size_t size, uint32_t tick, LogLevel level,
+                             const char *component, const char *message) {
+    size_t offset = 0;
+    uint16_t componentId = resolveComponent(buffer, size, &offset, tick, component);
+
+    size_t start = offset;
+    if (size - start <= sizeof(LogBinaryRecordHeader)) {
+        return 0;
+    }
+    offset += sizeof(LogBinaryRecordHeader);
+
+    size_t length = strlen(message);
+    if (length > size - offset) {
+        length = size - offset;
+    }
+    memcpy(buffer + offset, message, length);
+    offset += length;
+
+    writeHeader(buffer + start, LOG_BINARY_RECORD_MESSAGE, (uint8_t)level, (uint16_t)(offset - start),
+                tick, LOG_BINARY_TEXT_FORMAT_ID, componentId);
+    return (uint16_t)offset;
+}
+
+/**
+ * @brief Copies the raw arguments of a call into the record payload.
+ *
+ * String arguments are cut to maxString bytes.
+ *
+ * @return Number of payload bytes written, or -1 if they do not fit.
+ */
+static int32_t encodeArguments(char *buffer, size_t size, size_t maxString,
+                               const LogBinaryEntry *entry, va_list args) {
+    size_t offset = 0;
+
+    for (uint8_t i = 0; i < entry->argCount; i++) {
+        switch (entry->argTypes[i]) {
+            case LOG_BINARY_ARG_INT32: {
+                int32_t value = va_arg(args, int);
+                if (offset + sizeof(value) > size) return -1;
+                memcpy(buffer + offset, &value, sizeof(value));
+                offset += sizeof(value);
+                break;
+            }
+            case LOG_BINARY_ARG_INT64: {
+                int64_t value = va_arg(args, long long);
+                if (offset + sizeof(value) > size) return -1;
+                memcpy(buffer + offset, &value, sizeof(value));
+                offset += sizeof(value);
+                break;
+            }
+            case LOG_BINARY_ARG_DOUBLE: {
+                double value = va_arg(args, double);
+                if (offset + sizeof(value) > size) return -1;
+                memcpy(buffer + offset, &value, sizeof(value));
+                offset += sizeof(value);
+                break;
+            }
+            case LOG_BINARY_ARG_POINTER: {
+                uint64_t value = (uint64_t)(uintptr_t)va_arg(args, void *);
+                if (offset + sizeof(value) > size) return -1;
+                memcpy(buffer + offset, &value, sizeof(value));
+                offset += sizeof(value);
+                break;
+            }
+            case LOG_BINARY_ARG_STRING: {
+                const char *value = va_arg(args, const char *);
+                if (value == NULL) {
+                    value = "(null)";
+                }
+                size_t length = strnlen(value, maxString);
+                if (offset + 1 + length > size) return -1;
+                buffer[offset++] = (char)length;
+                memcpy(buffer + offset, value, length);
+                offset += length;
+                break;
+            }
+            default:
+                return -1;
+        }
+    }
+    return (int32_t)offset;
+}
+
+uint16_t logBinaryEncodeMessage(char *buffer, size_t size, uint32_t tick, LogLevel level,
+                                const char *component, const char *format, va_list args) {
+    uint8_t created = 0;
+    LogBinaryEntry *entry = internKey(tables_.formats, format, &tables_.nextFormatId, 1, &created);
+
+    if (entry == NULL || entry->argCount == LOG_BINARY_TEXT_ONLY) {
+        char message[LOG_RECORD_SIZE];
+        vsnprintf(message, sizeof(message), format, args);
+        return logBinaryEncodeText(buffer, size, tick, level, component, message);
+    }
+
+    size_t offset = 0;
+    uint16_t componentId = resolveComponent(buffer, size, &offset, tick, component);
+    if (created) {
+        offset += encodeDefinition(buffer + offset, size - offset,
+                                   LOG_BINARY_RECORD_FORMAT_DEF, tick, entry->id, format);
+    }
+
+    size_t start = offset;
+    if (size - start <= sizeof(LogBinaryRecordHeader)) {
+        return 0;
+    }
+
+    va_list argsCopy;
+    va_copy(argsCopy, args);
+    int32_t payload = encodeArguments(buffer + start + sizeof(LogBinaryRecordHeader),
+                                      size - start - sizeof(LogBinaryRecordHeader),
+                                      LOG_BINARY_MAX_STRING_ARG, entry, argsCopy);
+    va_end(argsCopy);
+    if (payload < 0) {
+        return (uint16_t)start;
+    }
+
+    uint16_t length = (uint16_t)(sizeof(LogBinaryRecordHeader) + (size_t)payload);
+    writeHeader(buffer + start, LOG_BINARY_RECORD_MESSAGE, (uint8_t)level, length,
+                tick, entry->id, componentId);
+    return (uint16_t)(start + length);
+}
+
+int32_t logBinaryEncodeArguments(char *buffer, size_t size, size_t maxString,
+                                 const char *format, va_list args) {
+    LogBinaryEntry entry;
+    parseSignature(format, &entry);
+    if (entry.argCount == LOG_BINARY_TEXT_ONLY) {
+        return -1;
+    }
+
+    va_list argsCopy;
+    va_copy(argsCopy, args);
+    int32_t length = encodeArguments(buffer, size, maxString, &entry, argsCopy);
+    va_end(argsCopy);
+    return length;
+}
+
+/**
+ * @brief Definitions collected for one session while decoding.
+ */
+typedef struct {
+    LogBinarySession info;
+    char **formats;
+    uint32_t formatCount;
+    char **components;
+    uint32_t componentCount;
+} LogDecodeSession;
+
+/**
+ * @brief All sessions of a decoded stream.
+ */
+typedef struct {
+    LogDecodeSession *items;
+    uint32_t count;
+} LogDecodeSessions;
+
+/**
+ * @brief Reads the next record of a binary stream.
+ *
+ * @param input Binary log stream.
+ * @param header Pointer to store the record header.
+ * @param payload Buffer of at least UINT16_MAX bytes for the payload.
+ * @return 1 if a record was read, 0 at the end of the stream or on a corrupt record.
+ */
+static int32_t readRecord(FILE *input, LogBinaryRecordHeader *header, char *payload) {
+    if (fread(header, sizeof(*header), 1, input) != 1) {
+        return 0;
+    }
+    if (header->type == 0 && header->length == 0) {
+        return 0; // Zero-filled tail of an active log segment
+    }
+    if (header->length < sizeof(*header) || header->type < LOG_BINARY_RECORD_SESSION ||
+        header->type > LOG_BINARY_RECORD_MESSAGE) {
+        fprintf(stderr, "Corrupt binary log record at offset %ld\n",
+                ftell(input) - (long)sizeof(*header));
+        return 0;
+    }
+    size_t length = header->length - sizeof(*header);
+    if (length > 0 && fread(payload, 1, length, input) != length) {
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Stores a definition string at the given id, growing the table as needed.
+ */
+static void storeDefinition(char ***table, uint32_t *count, uint16_t id, const char *text, size_t length) {
+    if (id >= *count) {
+        uint32_t newCount = (uint32_t)id + 1;
+        char **grown = realloc(*table, newCount * sizeof(char *));
+        if (grown == NULL) {
+            return;
+        }
+        memset(grown + *count, 0, (newCount - *count) * sizeof(char *));
+        *table = grown;
+        *count = newCount;
+    }
+    free((*table)[id]);
+    (*table)[id] = strndup(text, length);
+}
+
+static void freeSessions(LogDecodeSessions *sessions) {
+    for (uint32_t i = 0; i < sessions->count; i++) {
+        for (uint32_t j = 0; j < sessions->items[i].formatCount; j++) {
+            free(sessions->items[i].formats[j]);
+        }
+        for (uint32_t j = 0; j < sessions->items[i].componentCount; j++) {
+            free(sessions->items[i].components[j]);
+        }
+        free(sessions->items[i].formats);
+        free(sessions->items[i].components);
+    }
+    free(sessions->items);
+}
+
+/**
+ * @brief First decoding pass: collects sessions and their definitions.
+ */
+static RetVal_t collectDefinitions(FILE *input, LogDecodeSessions *sessions, char *payload) {
+    LogBinaryRecordHeader header;
+
+    while (readRecord(input, &header, payload)) {
+        if (header.type == LOG_BINARY_RECORD_SESSION) {
+            LogDecodeSession *grown = realloc(sessions->items, (sessions->count + 1) * sizeof(*grown));
+            if (grown == NULL) {
+                return RET_ERROR;
+            }
+            sessions->items = grown;
+            memset(&sessions->items[sessions->count], 0, sizeof(*grown));
+            memcpy(&sessions->items[sessions->count].info, payload, sizeof(LogBinarySession));
+            sessions->count++;
+            continue;
+        }
+        if (sessions->count == 0) {
+            continue;
+        }
+
+        LogDecodeSession *session = &sessions->items[sessions->count - 1];
+        size_t length = header.length - sizeof(header);
+        if (header.type == LOG_BINARY_RECORD_FORMAT_DEF) {
+            storeDefinition(&session->formats, &session->formatCount, header.formatId, payload, length);
+        } else if (header.type == LOG_BINARY_RECORD_COMPONENT_DEF) {
+            storeDefinition(&session->components, &session->componentCount, header.componentId, payload, length);
+        }
+    }
+    return RET_OK;
+}
+
+/**
+ * @brief Formats one conversion with its decoded argument.
+ *
+ * The length modifier of integer conversions is normalized to the stored width.
+ *
+ * @return Pointer past the consumed payload bytes, or NULL if the payload is exhausted.
+ */
+static const char *formatArgument(char *out, size_t outSize, const char *specStart, const char *specEnd,
+                                  char lengthModifier, uint8_t stars, const char *payload,
+                                  const char *payloadEnd) {
+    int32_t starValues[2] = {0, 0};
+    for (uint8_t i = 0; i < stars; i++) {
+        if (payload + sizeof(int32_t) > payloadEnd) return NULL;
+        memcpy(&starValues[i], payload, sizeof(int32_t));
+        payload += sizeof(int32_t);
+    }
+
+    // Rebuild the conversion without its length modifier
+    char spec[32];
+    size_t prefix = 0;
+    for (const char *p = specStart; p < specEnd && prefix < sizeof(spec) - 4; p++) {
+        if (strchr("hlzjtL", *p) == NULL) {
+            spec[prefix++] = *p;
+        }
+    }
+
+    uint8_t type = conversionArgType(*specEnd, lengthModifier);
+    if (type == LOG_BINARY_ARG_INT64) {
+        spec[prefix++] = 'l';
+        spec[prefix++] = 'l';
+    }
+    spec[prefix++] = *specEnd;
+    spec[prefix] = '\0';
+
+    switch (type) {
+        case LOG_BINARY_ARG_INT32: {
+            int32_t value;
+            if (payload + sizeof(value) > payloadEnd) return NULL;
+            memcpy(&value, payload, sizeof(value));
+            payload += sizeof(value);
+            if (stars == 2) snprintf(out, outSize, spec, starValues[0], starValues[1], value);
+            else if (stars == 1) snprintf(out, outSize, spec, starValues[0], value);
+            else snprintf(out, outSize, spec, value);
+            break;
+        }
+        case LOG_BINARY_ARG_INT64: {
+            int64_t value;
+            if (payload + sizeof(value) > payloadEnd) return NULL;
+            memcpy(&value, payload, sizeof(value));
+            payload += sizeof(value);
+            if (stars == 2) snprintf(out, outSize, spec, starValues[0], starValues[1], (long long)value);
+            else if (stars == 1) snprintf(out, outSize, spec, starValues[0], (long long)value);
+            else snprintf(out, outSize, spec, (long long)value);
+            break;
+        }
+        case LOG_BINARY_ARG_DOUBLE: {
+            double value;
+            if (payload + sizeof(value) > payloadEnd) return NULL;
+            memcpy(&value, payload, sizeof(value));
+            payload += sizeof(value);
+            if (stars == 2) snprintf(out, outSize, spec, starValues[0], starValues[1], value);
+            else if (stars == 1) snprintf(out, outSize, spec, starValues[0], value);
+            else snprintf(out, outSize, spec, value);
+            break;
+        }
+        case LOG_BINARY_ARG_POINTER: {
+            uint64_t value;
+            if (payload + sizeof(value) > payloadEnd) return NULL;
+            memcpy(&value, payload, sizeof(value));
+            payload += sizeof(value);
+            snprintf(out, outSize, spec, (void *)(uintptr_t)value);
+            break;
+        }
+        case LOG_BINARY_ARG_STRING: {
+            if (payload + 1 > payloadEnd) return NULL;
+            uint8_t length = (uint8_t)*payload++;
+            if (payload + length > payloadEnd) return NULL;
+            char value[LOG_BINARY_MAX_STRING_ARG + 1];
+            if (length > LOG_BINARY_MAX_STRING_ARG) length = LOG_BINARY_MAX_STRING_ARG;
+            memcpy(value, payload, length);
+            value[length] = '\0';
+            payload += length;
+            if (stars == 2) snprintf(out, outSize, spec, starValues[0], starValues[1], value);
+            else if (stars == 1) snprintf(out, outSize, spec, starValues[0], value);
+            else snprintf(out, outSize, spec, value);
+            break;
+        }
+        default:
+            return NULL;
+    }
+    return payload;
+}
+
+/**
+ * @brief Rebuilds the message text of a MESSAGE record from its format and payload.
+ */
+static void formatMessage(char *out, size_t outSize, const char *format,
+                          const char *payload, const char *payloadEnd) {
+    size_t used = 0;
+    out[0] = '\0';
+
+    for (const char *p = format; *p != '\0' && used + 1 < outSize; p++) {
+        if (*p != '%' || p[1] == '%') {
+            out[used++] = *p;
+            p += (*p == '%') ? 1 : 0;
+            continue;
+        }
+
+        uint8_t stars = 0;
+        char lengthModifier = '\0';
+        const char *specStart = p;
+        const char *specEnd = skipConversionPrefix(p + 1, &stars, &lengthModifier);
+        if (*specEnd == '\0') {
+            break;
+        }
+
+        char argument[LOG_RECORD_SIZE];
+        payload = formatArgument(argument, sizeof(argument), specStart, specEnd,
+                                 lengthModifier, stars, payload, payloadEnd);
+        if (payload == NULL) {
+            snprintf(argument, sizeof(argument), "<missing>");
+            payload = payloadEnd;
+        }
+        used += (size_t)snprintf(out + used, outSize - used, "%s", argument);
+        if (used >= outSize) {
+            used = outSize - 1;
+        }
+        p = specEnd;
+    }
+    out[used] = '\0';
+}
+
+void logBinaryFormatArguments(char *out, size_t outSize, const char *format,
+                              const char *payload, size_t length) {
+    formatMessage(out, outSize, format, payload, payload + length);
+}
+
+static const char *levelToString(uint8_t level) {
+    switch (level) {
+        case LOG_LEVEL_DEBUG: return "DEBUG";
+        case LOG_LEVEL_INFO: return "INFO";
+        case LOG_LEVEL_WARN: return "WARN";
+        case LOG_LEVEL_ERROR: return "ERROR";
+        default: return "UNKNOWN";
+    }
+}
+
+/**
+ * @brief Second decoding pass: prints the MESSAGE records as text lines.
+ */
+static void printMessages(FILE *input, FILE *output, LogLevel level,
+                          const LogDecodeSessions *sessions, char *payload) {
+    LogBinaryRecordHeader header;
+    int64_t sessionIndex = -1;
+
+    while (readRecord(input, &header, payload)) {
+        if (header.type == LOG_BINARY_RECORD_SESSION) {
+            sessionIndex++;
+            continue;
+        }
+        if (header.type != LOG_BINARY_RECORD_MESSAGE || sessionIndex < 0 || header.level < level) {
+            continue;
+        }
+
+        const LogDecodeSession *session = &sessions->items[sessionIndex];
+        size_t length = header.length - sizeof(header);
+
+        uint16_t tickRate = session->info.tickRateHz ? session->info.tickRateHz : 1;
+        LogTimestamp when = {
+            session->info.startEpoch + header.tick / tickRate,
+            (uint32_t)((uint64_t)(header.tick % tickRate) * 1000000000ull / tickRate)
+        };
+        char timestamp[LOG_TIMESTAMP_TEXT_SIZE];
+        logTimestampFormat(&when, timestamp, sizeof(timestamp));
+
+        const char *component = (header.componentId < session->componentCount &&
+                                 session->components[header.componentId] != NULL)
+                                ? session->components[header.componentId] : "unknown";
+
+        char message[LOG_RECORD_SIZE];
+        if (header.formatId == LOG_BINARY_TEXT_FORMAT_ID) {
+            snprintf(message, sizeof(message), "%.*s", (int)length, payload);
+        } else if (header.formatId < session->formatCount && session->formats[header.formatId] != NULL) {
+            formatMessage(message, sizeof(message), session->formats[header.formatId],
+                          payload, payload + length);
+        } else {
+            snprintf(message, sizeof(message), "<unknown format %u>", header.formatId);
+        }
+
+        fprintf(output, "[%s] [%s] [%s] %s\n", timestamp, levelToString(header.level), component, message);
+    }
+}
+
+RetVal_t logBinaryDecode(FILE *input, FILE *output, LogLevel level) {
+    LogDecodeSessions sessions = {NULL, 0};
+    char *payload = malloc(UINT16_MAX);
+    if (payload == NULL) {
+        return RET_ERROR;
+    }
+
+    RetVal_t ret = collectDefinitions(input, &sessions, payload);
+    if (ret == RET_OK) {
+        if (fseek(input, 0, SEEK_SET) != 0) {
+            ret = RET_ERROR;
+        } else {
+            printMessages(input, output, level, &sessions, payload);
+        }
+    }
+
+    freeSessions(&sessions);
+    free(payload);
+    return ret;
+}
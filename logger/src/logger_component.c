@@ -0,0 +1,219 @@
+#include <string.h>
+#include "logger_component.h"
+#include "logger_cfg.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/**
+ * @file logger_component.c
+ * @brief Implements the log component registry.
+ *
+ * Registration is rare (once per component), so it is serialized with a
+ * critical section once the scheduler runs. Everything on the logging path
+ * (name cache, level and name lookups) only reads published entries.
+ *
+ * The name cache is keyed by a hash of the name and every hit is confirmed by
+ * comparing the registered name, so a caller may pass the name in any buffer.
+ * Every registered name is cached when it is registered, and the cache has
+ * room for twice the registry, so it never fills up.
+ */
+
+#if (LOG_COMPONENT_CACHE_SIZE & (LOG_COMPONENT_CACHE_SIZE - 1)) != 0
+#error "LOG_COMPONENT_CACHE_SIZE must be a power of two"
+#endif
+
+#if LOG_COMPONENT_MAX > LOG_COMPONENT_UNREGISTERED
+#error "LOG_COMPONENT_MAX must fit a LogComponentId"
+#endif
+
+#if LOG_COMPONENT_CACHE_SIZE < 2 * LOG_COMPONENT_MAX
+#error "LOG_COMPONENT_CACHE_SIZE must be at least twice LOG_COMPONENT_MAX"
+#endif
+
+#define LOG_COMPONENT_CACHE_MASK (LOG_COMPONENT_CACHE_SIZE - 1)
+
+/**
+ * @brief Entry of the name cache.
+ *
+ * - hash: Hash of the name (see hashName()), 0 when free.
+ * - id: Component id of the name.
+ */
+typedef struct {
+    uint32_t hash;
+    LogComponentId id;
+} LogComponentCacheEntry;
+
+/**
+ * @brief State of the registry.
+ *
+ * - names: Registered names, indexed by id.
+ * - levels: Effective minimum level of each component, indexed by id.
+ * - overridden: 1 for the components with a level of their own.
+ * - count: Number of registered components.
+ * - defaultLevel: Global level, used by the components without a level of their own.
+ * - cache: Name to id cache of logComponentLookup().
+ */
+typedef struct {
+    char names[LOG_COMPONENT_MAX][LOG_COMPONENT_NAME_SIZE];
+    uint8_t levels[LOG_COMPONENT_MAX];
+    uint8_t overridden[LOG_COMPONENT_MAX];
+    uint32_t count;
+    uint8_t defaultLevel;
+    LogComponentCacheEntry cache[LOG_COMPONENT_CACHE_SIZE];
+} LogComponentRegistry;
+
+static LogComponentRegistry registry_ = {
+    .names = {"Other"},
+    .levels = {LOG_DEFAULT_LEVEL},
+    .count = 1,
+    .defaultLevel = LOG_DEFAULT_LEVEL,
+};
+
+static void lockRegistry(void) {
+    if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+        taskENTER_CRITICAL();
+    }
+}
+
+static void unlockRegistry(void) {
+    if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+        taskEXIT_CRITICAL();
+    }
+}
+
+/**
+ * @brief Hashes the part of a name the registry keeps (FNV-1a).
+ *
+ * @return Hash of the name, never 0.
+ */
+static uint32_t hashName(const char *name) {
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < LOG_COMPONENT_NAME_SIZE - 1 && name[i] != '\0'; i++) {
+        hash = (hash ^ (uint8_t)name[i]) * 16777619u;
+    }
+    return (hash != 0) ? hash : 1;
+}
+
+static uint8_t sameName(LogComponentId id, const char *name) {
+    return strncmp(registry_.names[id], name, LOG_COMPONENT_NAME_SIZE - 1) == 0;
+}
+
+/**
+ * @brief Returns the cached id of a name.
+ *
+ * @return The id, or LOG_COMPONENT_UNREGISTERED if the name is not cached.
+ */
+static LogComponentId findCached(const char *name, uint32_t hash) {
+    uint32_t slot = hash & LOG_COMPONENT_CACHE_MASK;
+    for (uint32_t probe = 0; probe < LOG_COMPONENT_CACHE_SIZE; probe++) {
+        LogComponentCacheEntry *entry = &registry_.cache[(slot + probe) & LOG_COMPONENT_CACHE_MASK];
+        uint32_t key = __atomic_load_n(&entry->hash, __ATOMIC_ACQUIRE);
+        if (key == 0) {
+            break;
+        }
+        if (key == hash && sameName(entry->id, name)) {
+            return entry->id;
+        }
+    }
+    return LOG_COMPONENT_UNREGISTERED;
+}
+
+/**
+ * @brief Adds a registered name to the cache unless it is there already.
+ *
+ * Must be called with the registry locked.
+ */
+static void cacheLocked(const char *name, LogComponentId id) {
+    uint32_t hash = hashName(name);
+    uint32_t slot = hash & LOG_COMPONENT_CACHE_MASK;
+    for (uint32_t probe = 0; probe < LOG_COMPONENT_CACHE_SIZE; probe++) {
+        LogComponentCacheEntry *entry = &registry_.cache[(slot + probe) & LOG_COMPONENT_CACHE_MASK];
+        if (entry->hash == hash && entry->id == id) {
+            return;
+        }
+        if (entry->hash == 0) {
+            entry->id = id;
+            __atomic_store_n(&entry->hash, hash, __ATOMIC_RELEASE);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Returns the id of a name, adding it to the table if needed.
+ *
+ * Must be called with the registry locked.
+ */
+static LogComponentId registerLocked(const char *name) {
+    uint32_t count = registry_.count;
+    for (uint32_t id = 0; id < count; id++) {
+        if (sameName((LogComponentId)id, name)) {
+            cacheLocked(name, (LogComponentId)id);
+            return (LogComponentId)id;
+        }
+    }
+    if (count == LOG_COMPONENT_MAX) {
+        return LOG_COMPONENT_OTHER;
+    }
+
+    strncpy(registry_.names[count], name, LOG_COMPONENT_NAME_SIZE - 1);
+    registry_.levels[count] = registry_.defaultLevel;
+    __atomic_store_n(&registry_.count, count + 1, __ATOMIC_RELEASE);
+    cacheLocked(name, (LogComponentId)count);
+    return (LogComponentId)count;
+}
+
+LogComponentId logComponentRegister(const char *name) {
+    lockRegistry();
+    LogComponentId id = registerLocked(name);
+    unlockRegistry();
+    return id;
+}
+
+LogComponentId logComponentLookup(const char *name) {
+    LogComponentId id = findCached(name, hashName(name));
+    if (id != LOG_COMPONENT_UNREGISTERED) {
+        return id;
+    }
+    // Every registered name is cached, so a miss on a full table is a name that never gets an id
+    if (__atomic_load_n(&registry_.count, __ATOMIC_ACQUIRE) == LOG_COMPONENT_MAX) {
+        return LOG_COMPONENT_OTHER;
+    }
+    return logComponentRegister(name);
+}
+
+const char *logComponentName(LogComponentId id) {
+    if (id >= __atomic_load_n(&registry_.count, __ATOMIC_ACQUIRE)) {
+        id = LOG_COMPONENT_OTHER;
+    }
+    return registry_.names[id];
+}
+
+LogLevel logComponentLevel(LogComponentId id) {
+    return (LogLevel)__atomic_load_n(&registry_.levels[id], __ATOMIC_RELAXED);
+}
+
+void logComponentSetDefaultLevel(LogLevel level) {
+    lockRegistry();
+    registry_.defaultLevel = (uint8_t)level;
+    for (uint32_t id = 0; id < registry_.count; id++) {
+        if (!registry_.overridden[id]) {
+            __atomic_store_n(&registry_.levels[id], (uint8_t)level, __ATOMIC_RELAXED);
+        }
+    }
+    unlockRegistry();
+}
+
+void logComponentSetLevel(LogComponentId id, LogLevel level) {
+    lockRegistry();
+    registry_.overridden[id] = 1;
+    __atomic_store_n(&registry_.levels[id], (uint8_t)level, __ATOMIC_RELAXED);
+    unlockRegistry();
+}
+
+void logComponentResetLevel(LogComponentId id) {
+    lockRegistry();
+    registry_.overridden[id] = 0;
+    __atomic_store_n(&registry_.levels[id], registry_.defaultLevel, __ATOMIC_RELAXED);
+    unlockRegistry();
+}
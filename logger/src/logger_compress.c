@@ -0,0 +1,357 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "logger_compress.h"
+#include "logger_lz.h"
+#include "logger_index.h"
+#include "logger_segment.h"
+#include "logger_cfg.h"
+
+/**
+ * @file logger_compress.c
+ * @brief Implements the compressed log segments.
+ */
+
+#define LOG_COMPRESS_PATH_SIZE 256
+
+/**
+ * @brief Decoding states of a frame (LogCompressReader.frameStates).
+ */
+enum {
+    FRAME_PENDING,
+    FRAME_DECODING,
+    FRAME_DECODED,
+    FRAME_FAILED
+};
+
+/**
+ * @brief Growable frame table of a segment being compressed.
+ */
+typedef struct {
+    LogCompressFrame *items;
+    uint32_t count;
+    uint32_t capacity;
+} LogCompressFrames;
+
+static RetVal_t addFrame(LogCompressFrames *frames, uint32_t rawOffset, uint32_t rawLength) {
+    if (frames->count == frames->capacity) {
+        uint32_t capacity = (frames->capacity == 0) ? 64 : frames->capacity * 2;
+        LogCompressFrame *grown = realloc(frames->items, capacity * sizeof(*grown));
+        if (grown == NULL) {
+            return RET_ERROR;
+        }
+        frames->items = grown;
+        frames->capacity = capacity;
+    }
+    frames->items[frames->count++] = (LogCompressFrame){rawOffset, rawLength, 0, 0};
+    return RET_OK;
+}
+
+/**
+ * @brief Adds frames of at most LOG_INDEX_BLOCK_SIZE bytes covering a range not described by the index.
+ */
+static RetVal_t addGapFrames(LogCompressFrames *frames, uint32_t start, uint32_t end) {
+    while (start < end) {
+        uint32_t length = (end - start < LOG_INDEX_BLOCK_SIZE) ? end - start : LOG_INDEX_BLOCK_SIZE;
+        if (addFrame(frames, start, length) != RET_OK) {
+            return RET_ERROR;
+        }
+        start += length;
+    }
+    return RET_OK;
+}
+
+/**
+ * @brief Splits a segment into frames that follow the blocks of its index.
+ */
+static RetVal_t buildFrames(uint32_t sequence, uint32_t size, LogCompressFrames *frames) {
+    LogIndexBlock *blocks = NULL;
+    uint32_t blockCount = logIndexLoad(sequence, size, &blocks);
+    uint32_t covered = 0;
+    RetVal_t ret = RET_OK;
+
+    for (uint32_t i = 0; i < blockCount && ret == RET_OK; i++) {
+        if (blocks[i].offset < covered || blocks[i].length == 0) {
+            continue;
+        }
+        ret = addGapFrames(frames, covered, blocks[i].offset);
+        if (ret == RET_OK) {
+            ret = addFrame(frames, blocks[i].offset, blocks[i].length);
+        }
+        covered = blocks[i].offset + blocks[i].length;
+    }
+    if (ret == RET_OK) {
+        ret = addGapFrames(frames, covered, size);
+    }
+    free(blocks);
+    return ret;
+}
+
+static RetVal_t writeAll(int fd, const void *data, size_t length, off_t offset) {
+    const char *bytes = (const char *)data;
+    while (length > 0) {
+        ssize_t written = pwrite(fd, bytes, length, offset);
+        if (written <= 0) {
+            return RET_ERROR;
+        }
+        bytes += written;
+        length -= (size_t)written;
+        offset += written;
+    }
+    return RET_OK;
+}
+
+static RetVal_t readAll(int fd, void *data, size_t length, off_t offset) {
+    char *bytes = (char *)data;
+    while (length > 0) {
+        ssize_t got = pread(fd, bytes, length, offset);
+        if (got <= 0) {
+            return RET_ERROR;
+        }
+        bytes += got;
+        length -= (size_t)got;
+        offset += got;
+    }
+    return RET_OK;
+}
+
+/**
+ * @brief Compresses the frames of a segment and writes the compressed file.
+ */
+static RetVal_t writeCompressed(int fd, uint32_t sequence, const char *data, uint32_t size,
+                                LogCompressFrames *frames) {
+    uint32_t largest = 0;
+    for (uint32_t i = 0; i < frames->count; i++) {
+        if (frames->items[i].rawLength > largest) {
+            largest = frames->items[i].rawLength;
+        }
+    }
+
+    LogLzState *state = malloc(sizeof(*state));
+    char *buffer = malloc((largest != 0) ? largest : 1);
+    RetVal_t ret = (state != NULL && buffer != NULL) ? RET_OK : RET_ERROR;
+
+    off_t offset = (off_t)(sizeof(LogCompressHeader) + frames->count * sizeof(LogCompressFrame));
+    for (uint32_t i = 0; i < frames->count && ret == RET_OK; i++) {
+        LogCompressFrame *frame = &frames->items[i];
+        const char *raw = data + frame->rawOffset;
+
+        // Frames that do not shrink are stored as they are
+        size_t length = logLzCompress(state, raw, frame->rawLength, buffer, frame->rawLength - 1u);
+        frame->offset = (uint32_t)offset;
+        frame->length = (length != 0) ? (uint32_t)length : frame->rawLength;
+        ret = writeAll(fd, (length != 0) ? buffer : raw, frame->length, offset);
+        offset += frame->length;
+    }
+
+    LogCompressHeader header = {LOG_COMPRESS_MAGIC, LOG_COMPRESS_VERSION, 0, sequence, frames->count, size};
+    if (ret == RET_OK) {
+        ret = writeAll(fd, &header, sizeof(header), 0);
+    }
+    if (ret == RET_OK) {
+        ret = writeAll(fd, frames->items, frames->count * sizeof(LogCompressFrame), sizeof(header));
+    }
+    if (ret == RET_OK && fdatasync(fd) != 0) {
+        ret = RET_ERROR;
+    }
+    free(buffer);
+    free(state);
+    return ret;
+}
+
+RetVal_t logCompressSegment(uint32_t sequence) {
+    char path[LOG_COMPRESS_PATH_SIZE];
+    char compressedPath[LOG_COMPRESS_PATH_SIZE];
+    char temporaryPath[LOG_COMPRESS_PATH_SIZE + 4];
+    logSegmentPath(path, sizeof(path), sequence);
+    logSegmentCompressedPath(compressedPath, sizeof(compressedPath), sequence);
+    snprintf(temporaryPath, sizeof(temporaryPath), "%s.tmp", compressedPath);
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return RET_ERROR;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size > UINT32_MAX) {
+        close(fd);
+        return RET_ERROR;
+    }
+    uint32_t size = (uint32_t)status.st_size;
+    char *data = NULL;
+    if (size != 0 && (data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED) {
+        close(fd);
+        return RET_ERROR;
+    }
+    close(fd);
+
+    LogCompressFrames frames = {NULL, 0, 0};
+    RetVal_t ret = buildFrames(sequence, size, &frames);
+    if (ret == RET_OK) {
+        int output = open(temporaryPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        ret = (output >= 0) ? writeCompressed(output, sequence, data, size, &frames) : RET_ERROR;
+        if (output >= 0) {
+            close(output);
+        }
+    }
+
+    // Readers that already opened the segment keep their mapping after the unlink
+    if (ret == RET_OK && rename(temporaryPath, compressedPath) == 0) {
+        unlink(path);
+    } else {
+        unlink(temporaryPath);
+        ret = RET_ERROR;
+    }
+
+    free(frames.items);
+    if (data != NULL) {
+        munmap(data, size);
+    }
+    return ret;
+}
+
+uint32_t logCompressSealedSegments(void) {
+    uint32_t first = 0;
+    uint32_t last = 0;
+    uint32_t compressed = 0;
+    if (logSegmentFind(&first, &last) != RET_OK) {
+        return 0;
+    }
+
+    for (uint32_t sequence = first; sequence < last; sequence++) {
+        char path[LOG_COMPRESS_PATH_SIZE];
+        logSegmentPath(path, sizeof(path), sequence);
+        if (access(path, F_OK) == 0 && logCompressSegment(sequence) == RET_OK) {
+            compressed++;
+        }
+    }
+    return compressed;
+}
+
+/**
+ * @brief Checks that the frames are sorted, do not overlap and stay within the segment and the file.
+ */
+static RetVal_t validateFrames(const LogCompressReader *reader, off_t fileSize) {
+    uint64_t previous = 0;
+    for (uint32_t i = 0; i < reader->frameCount; i++) {
+        const LogCompressFrame *frame = &reader->frames[i];
+        if (frame->rawOffset < previous || (uint64_t)frame->rawOffset + frame->rawLength > reader->size ||
+            frame->length > frame->rawLength || (off_t)frame->offset + frame->length > fileSize) {
+            return RET_ERROR;
+        }
+        previous = (uint64_t)frame->rawOffset + frame->rawLength;
+    }
+    return RET_OK;
+}
+
+RetVal_t logCompressOpen(uint32_t sequence, LogCompressReader *reader) {
+    char path[LOG_COMPRESS_PATH_SIZE];
+    logSegmentCompressedPath(path, sizeof(path), sequence);
+    memset(reader, 0, sizeof(*reader));
+    reader->fd = open(path, O_RDONLY);
+    if (reader->fd < 0) {
+        return RET_ERROR;
+    }
+
+    LogCompressHeader header;
+    struct stat status;
+    if (fstat(reader->fd, &status) != 0 || readAll(reader->fd, &header, sizeof(header), 0) != RET_OK ||
+        header.magic != LOG_COMPRESS_MAGIC || header.version != LOG_COMPRESS_VERSION ||
+        header.sequence != sequence || header.rawSize == 0 || header.rawSize > UINT32_MAX) {
+        logCompressClose(reader);
+        return RET_ERROR;
+    }
+
+    reader->size = (size_t)header.rawSize;
+    reader->frameCount = header.frameCount;
+    reader->frames = malloc((size_t)header.frameCount * sizeof(LogCompressFrame));
+    reader->frameStates = calloc(header.frameCount, 1);
+    if (reader->frames == NULL || reader->frameStates == NULL ||
+        readAll(reader->fd, reader->frames, (size_t)header.frameCount * sizeof(LogCompressFrame),
+                sizeof(header)) != RET_OK ||
+        validateFrames(reader, status.st_size) != RET_OK) {
+        logCompressClose(reader);
+        return RET_ERROR;
+    }
+
+    // Pages of frames that are never decoded are never backed by memory
+    void *data = mmap(NULL, reader->size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (data == MAP_FAILED) {
+        logCompressClose(reader);
+        return RET_ERROR;
+    }
+    reader->data = data;
+    return RET_OK;
+}
+
+static RetVal_t decodeFrame(const LogCompressReader *reader, const LogCompressFrame *frame) {
+    char *destination = reader->data + frame->rawOffset;
+    if (frame->length == frame->rawLength) {
+        return readAll(reader->fd, destination, frame->length, frame->offset);
+    }
+
+    char *buffer = malloc(frame->length);
+    RetVal_t ret = (buffer != NULL) ? readAll(reader->fd, buffer, frame->length, frame->offset) : RET_ERROR;
+    if (ret == RET_OK) {
+        ret = logLzDecompress(buffer, frame->length, destination, frame->rawLength);
+    }
+    free(buffer);
+    return ret;
+}
+
+/**
+ * @brief Decodes one frame once; concurrent callers wait for the thread decoding it.
+ */
+static RetVal_t loadFrame(LogCompressReader *reader, uint32_t index) {
+    uint8_t *state = &reader->frameStates[index];
+    uint8_t expected = FRAME_PENDING;
+    if (__atomic_compare_exchange_n(state, &expected, FRAME_DECODING, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        expected = (decodeFrame(reader, &reader->frames[index]) == RET_OK) ? FRAME_DECODED : FRAME_FAILED;
+        __atomic_store_n(state, expected, __ATOMIC_RELEASE);
+    }
+    while (expected == FRAME_DECODING) {
+        sched_yield();
+        expected = __atomic_load_n(state, __ATOMIC_ACQUIRE);
+    }
+    return (expected == FRAME_DECODED) ? RET_OK : RET_ERROR;
+}
+
+RetVal_t logCompressRead(LogCompressReader *reader, size_t start, size_t end) {
+    // First frame ending after start
+    uint32_t low = 0;
+    uint32_t high = reader->frameCount;
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        if ((size_t)reader->frames[middle].rawOffset + reader->frames[middle].rawLength <= start) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    RetVal_t ret = RET_OK;
+    for (uint32_t i = low; i < reader->frameCount && reader->frames[i].rawOffset < end; i++) {
+        if (loadFrame(reader, i) != RET_OK) {
+            ret = RET_ERROR;
+        }
+    }
+    return ret;
+}
+
+void logCompressClose(LogCompressReader *reader) {
+    if (reader->data != NULL) {
+        munmap(reader->data, reader->size);
+    }
+    if (reader->fd >= 0) {
+        close(reader->fd);
+    }
+    free(reader->frames);
+    free(reader->frameStates);
+    memset(reader, 0, sizeof(*reader));
+    reader->fd = -1;
+}
@@ -0,0 +1,256 @@
+#include <stdio.h>
+#include <string.h>
+#include "logger_flight.h"
+#include "logger_binary.h"
+#include "logger_component.h"
+#include "logger_cfg.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/**
+ * @file logger_flight.c
+ * @brief Implements the per-task flight recorder.
+ *
+ * The buffer of the calling task is cached in a thread-local pointer: in the
+ * POSIX port every task runs in its own thread, so the lookup on the recording
+ * path is a single load. A deleted and re-created task starts in a new thread
+ * and finds its buffer again by name.
+ */
+
+#if (LOG_FLIGHT_EVENTS & (LOG_FLIGHT_EVENTS - 1)) != 0
+#error "LOG_FLIGHT_EVENTS must be a power of two"
+#endif
+
+#if LOG_FLIGHT_ENABLED
+
+#define LOG_FLIGHT_EVENT_MASK (LOG_FLIGHT_EVENTS - 1)
+
+/**
+ * @brief Number of payload bytes of an event.
+ */
+#define LOG_FLIGHT_PAYLOAD_SIZE (LOG_FLIGHT_EVENT_SIZE - 8 - sizeof(const char *))
+
+/**
+ * @brief Event flags.
+ */
+#define LOG_FLIGHT_EVENT_TEXT    0x01 ///< The payload holds message text instead of arguments.
+#define LOG_FLIGHT_EVENT_NO_ARGS 0x02 ///< The arguments could not be stored.
+
+/**
+ * @brief Buffer states.
+ */
+#define LOG_FLIGHT_BUFFER_FREE  0
+#define LOG_FLIGHT_BUFFER_BUSY  1
+#define LOG_FLIGHT_BUFFER_READY 2
+
+/**
+ * @brief One recorded log call.
+ *
+ * - tick: Tick count of the call.
+ * - level: LogLevel.
+ * - flags: LOG_FLIGHT_EVENT_* flags.
+ * - length: Number of payload bytes used.
+ * - componentId: Registered id of the component.
+ * - format: Format string (NULL for text events).
+ * - payload: Encoded arguments (see logBinaryEncodeArguments()) or message text.
+ */
+typedef struct {
+    uint32_t tick;
+    uint8_t level;
+    uint8_t flags;
+    uint8_t length;
+    uint8_t componentId;
+    const char *format;
+    char payload[LOG_FLIGHT_PAYLOAD_SIZE];
+} LogFlightEvent;
+
+/**
+ * @brief Event history of one task.
+ *
+ * - state: LOG_FLIGHT_BUFFER_* state.
+ * - name: Name of the owning task.
+ * - head: Number of events recorded so far (the next event goes to head & mask).
+ * - events: Circular event buffer.
+ */
+typedef struct {
+    uint8_t state;
+    char name[configMAX_TASK_NAME_LEN];
+    uint32_t head;
+    LogFlightEvent events[LOG_FLIGHT_EVENTS];
+} LogFlightBuffer;
+
+/**
+ * @brief Marker of a task that found no free buffer.
+ */
+#define LOG_FLIGHT_NO_BUFFER ((LogFlightBuffer *)1)
+
+static LogFlightBuffer buffers_[LOG_FLIGHT_TASKS];
+static __thread LogFlightBuffer *taskBuffer_ = NULL;
+static uint8_t dumping_ = 0;
+
+static const char *levelName(uint8_t level) {
+    static const char *names[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+    return (level < sizeof(names) / sizeof(names[0])) ? names[level] : "UNKNOWN";
+}
+
+/**
+ * @brief Finds the buffer of a task name, or claims a free one.
+ *
+ * @return The buffer, or LOG_FLIGHT_NO_BUFFER if all buffers are taken.
+ */
+static LogFlightBuffer *claimBuffer(const char *name) {
+    for (uint32_t i = 0; i < LOG_FLIGHT_TASKS; i++) {
+        if (__atomic_load_n(&buffers_[i].state, __ATOMIC_ACQUIRE) == LOG_FLIGHT_BUFFER_READY &&
+            strncmp(buffers_[i].name, name, sizeof(buffers_[i].name)) == 0) {
+            return &buffers_[i];
+        }
+    }
+
+    for (uint32_t i = 0; i < LOG_FLIGHT_TASKS; i++) {
+        uint8_t expected = LOG_FLIGHT_BUFFER_FREE;
+        if (__atomic_compare_exchange_n(&buffers_[i].state, &expected, LOG_FLIGHT_BUFFER_BUSY, 0,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            strncpy(buffers_[i].name, name, sizeof(buffers_[i].name) - 1);
+            __atomic_store_n(&buffers_[i].state, LOG_FLIGHT_BUFFER_READY, __ATOMIC_RELEASE);
+            return &buffers_[i];
+        }
+    }
+    return LOG_FLIGHT_NO_BUFFER;
+}
+
+/**
+ * @brief Returns the next event slot of the calling task, or NULL if it has no buffer.
+ */
+static LogFlightEvent *beginEvent(LogLevel level, LogComponentId component) {
+    if ((int)level < LOG_FLIGHT_LEVEL) {
+        return NULL;
+    }
+
+    LogFlightBuffer *buffer = taskBuffer_;
+    if (buffer == NULL) {
+        const char *name = (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) ? "Main" : pcTaskGetName(NULL);
+        buffer = claimBuffer(name);
+        taskBuffer_ = buffer;
+    }
+    if (buffer == LOG_FLIGHT_NO_BUFFER) {
+        return NULL;
+    }
+
+    LogFlightEvent *event = &buffer->events[buffer->head & LOG_FLIGHT_EVENT_MASK];
+    event->tick = (uint32_t)xTaskGetTickCount();
+    event->level = (uint8_t)level;
+    event->componentId = component;
+    return event;
+}
+
+/**
+ * @brief Publishes the event filled after beginEvent().
+ */
+static void commitEvent(void) {
+    LogFlightBuffer *buffer = taskBuffer_;
+    __atomic_store_n(&buffer->head, buffer->head + 1, __ATOMIC_RELEASE);
+}
+
+void logFlightRecordText(LogLevel level, LogComponentId component, const char *message) {
+    LogFlightEvent *event = beginEvent(level, component);
+    if (event == NULL) {
+        return;
+    }
+
+    size_t length = strnlen(message, sizeof(event->payload));
+    memcpy(event->payload, message, length);
+    event->format = NULL;
+    event->flags = LOG_FLIGHT_EVENT_TEXT;
+    event->length = (uint8_t)length;
+    commitEvent();
+}
+
+void logFlightRecordFormatted(LogLevel level, LogComponentId component, const char *format, va_list args) {
+    LogFlightEvent *event = beginEvent(level, component);
+    if (event == NULL) {
+        return;
+    }
+
+    int32_t length = logBinaryEncodeArguments(event->payload, sizeof(event->payload),
+                                              LOG_FLIGHT_MAX_STRING_ARG, format, args);
+    event->format = format;
+    event->flags = (length < 0) ? LOG_FLIGHT_EVENT_NO_ARGS : 0;
+    event->length = (length < 0) ? 0 : (uint8_t)length;
+    commitEvent();
+}
+
+/**
+ * @brief Writes one event as a text line.
+ */
+static void printEvent(FILE *file, const LogFlightEvent *event) {
+    char message[LOG_RECORD_SIZE];
+
+    if (event->flags & LOG_FLIGHT_EVENT_TEXT) {
+        snprintf(message, sizeof(message), "%.*s", (int)event->length, event->payload);
+    } else if (event->flags & LOG_FLIGHT_EVENT_NO_ARGS) {
+        snprintf(message, sizeof(message), "%s (arguments not recorded)", event->format);
+    } else {
+        logBinaryFormatArguments(message, sizeof(message), event->format, event->payload, event->length);
+    }
+    fprintf(file, "[tick %10u] [%s] [%s] %s\n", (unsigned)event->tick, levelName(event->level),
+            logComponentName(event->componentId), message);
+}
+
+/**
+ * @brief Writes the events of one task buffer that were not overwritten during the dump.
+ */
+static void dumpBuffer(FILE *file, const LogFlightBuffer *buffer) {
+    static LogFlightEvent events[LOG_FLIGHT_EVENTS];
+
+    uint32_t head = __atomic_load_n(&buffer->head, __ATOMIC_ACQUIRE);
+    uint32_t first = (head > LOG_FLIGHT_EVENTS) ? head - LOG_FLIGHT_EVENTS : 0;
+    for (uint32_t i = first; i < head; i++) {
+        events[i & LOG_FLIGHT_EVENT_MASK] = buffer->events[i & LOG_FLIGHT_EVENT_MASK];
+    }
+
+    // The owner may have overwritten the oldest copied events meanwhile; the
+    // slot of the event it is writing now is not valid either
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    uint32_t headAfter = __atomic_load_n(&buffer->head, __ATOMIC_RELAXED);
+    if (headAfter + 1 > first + LOG_FLIGHT_EVENTS) {
+        first = headAfter + 1 - LOG_FLIGHT_EVENTS;
+    }
+
+    fprintf(file, "--- Task %s: %u events ---\n", buffer->name, (unsigned)((head > first) ? head - first : 0));
+    for (uint32_t i = first; i < head; i++) {
+        printEvent(file, &events[i & LOG_FLIGHT_EVENT_MASK]);
+    }
+}
+
+RetVal_t logFlightDump(const char *reason) {
+    if (__atomic_exchange_n(&dumping_, 1, __ATOMIC_ACQUIRE)) {
+        return RET_ERROR;
+    }
+
+    FILE *file = fopen(LOG_FLIGHT_FILE, "a");
+    if (file == NULL) {
+        perror("Failed to open flight recorder file");
+        __atomic_store_n(&dumping_, 0, __ATOMIC_RELEASE);
+        return RET_ERROR;
+    }
+
+    fprintf(file, "=== Flight recorder dump at tick %u: %s ===\n", (unsigned)xTaskGetTickCount(), reason);
+    for (uint32_t i = 0; i < LOG_FLIGHT_TASKS; i++) {
+        if (__atomic_load_n(&buffers_[i].state, __ATOMIC_ACQUIRE) == LOG_FLIGHT_BUFFER_READY) {
+            dumpBuffer(file, &buffers_[i]);
+        }
+    }
+    fclose(file);
+
+    __atomic_store_n(&dumping_, 0, __ATOMIC_RELEASE);
+    return RET_OK;
+}
+
+#else
+
+RetVal_t logFlightDump(const char *reason) {
+    (void)reason;
+    return RET_ERROR;
+}
+
+#endif
@@ -0,0 +1,135 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "logger_index.h"
+#include "logger_cfg.h"
+
+/**
+ * @file logger_index.c
+ * @brief Implements the log segment index.
+ */
+
+/**
+ * @brief State of the index being written.
+ *
+ * - file: Index file of the current segment (NULL if none is open).
+ * - sequence: Sequence number of the current segment (UINT32_MAX before the first record).
+ * - block: Block being filled.
+ * - end: Offset just past the last record of the block being filled.
+ */
+typedef struct {
+    FILE *file;
+    uint32_t sequence;
+    LogIndexBlock block;
+    uint32_t end;
+} LogIndexState;
+
+static LogIndexState index_ = {NULL, UINT32_MAX, {0}, 0};
+
+uint8_t logIndexComponentBit(const char *component) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (const char *c = component; *c != '\0'; c++) {
+        hash ^= (uint8_t)*c;
+        hash *= 16777619u;
+    }
+    return (uint8_t)(hash & 63);
+}
+
+/**
+ * @brief Appends the block being filled to the index file.
+ */
+static void writeBlock(void) {
+    if (index_.block.records == 0) {
+        return;
+    }
+    if (index_.file != NULL) {
+        index_.block.length = index_.end - index_.block.offset;
+        fwrite(&index_.block, sizeof(index_.block), 1, index_.file);
+        fflush(index_.file);
+    }
+    memset(&index_.block, 0, sizeof(index_.block));
+}
+
+/**
+ * @brief Completes the index of the current segment and starts the index of a new one.
+ */
+static void openIndex(uint32_t sequence) {
+    writeBlock();
+    if (index_.file != NULL) {
+        fclose(index_.file);
+    }
+
+    char path[256];
+    logSegmentIndexPath(path, sizeof(path), sequence);
+    index_.file = fopen(path, "wb");
+    index_.sequence = sequence;
+    if (index_.file == NULL) {
+        perror("Failed to create log index");
+        return;
+    }
+
+    LogIndexHeader header = {LOG_INDEX_MAGIC, LOG_INDEX_VERSION, 0, sequence};
+    fwrite(&header, sizeof(header), 1, index_.file);
+}
+
+void logIndexAdd(const LogSegmentLocation *location, uint16_t length, const LogRecordInfo *info) {
+    if (location->sequence != index_.sequence) {
+        openIndex(location->sequence);
+    }
+
+    LogIndexBlock *block = &index_.block;
+    if (block->records == 0) {
+        block->offset = location->offset;
+        block->minTime = info->timestamp;
+        block->maxTime = info->timestamp;
+    } else {
+        if (info->timestamp < block->minTime) {
+            block->minTime = info->timestamp;
+        }
+        if (info->timestamp > block->maxTime) {
+            block->maxTime = info->timestamp;
+        }
+    }
+    block->records++;
+    block->levelMask |= (uint8_t)(1u << info->level);
+    block->componentMask |= 1ull << info->componentBit;
+    index_.end = location->offset + length;
+
+    if (index_.end - block->offset >= LOG_INDEX_BLOCK_SIZE) {
+        writeBlock();
+    }
+}
+
+uint32_t logIndexLoad(uint32_t sequence, size_t segmentSize, LogIndexBlock **blocks) {
+    *blocks = NULL;
+    char path[256];
+    logSegmentIndexPath(path, sizeof(path), sequence);
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return 0;
+    }
+
+    LogIndexHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != LOG_INDEX_MAGIC ||
+        header.version != LOG_INDEX_VERSION || header.sequence != sequence) {
+        fclose(file);
+        return 0;
+    }
+
+    uint32_t count = 0;
+    LogIndexBlock block;
+    while (fread(&block, sizeof(block), 1, file) == 1) {
+        if ((size_t)block.offset + block.length > segmentSize) {
+            break;
+        }
+        LogIndexBlock *grown = realloc(*blocks, (count + 1) * sizeof(block));
+        if (grown == NULL) {
+            break;
+        }
+        *blocks = grown;
+        (*blocks)[count++] = block;
+    }
+    fclose(file);
+    return count;
+}
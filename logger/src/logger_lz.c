@@ -0,0 +1,184 @@
+#include <string.h>
+#include "logger_lz.h"
+
+/**
+ * @file logger_lz.c
+ * @brief Implements the LZ77 block compressor.
+ */
+
+#define LOG_LZ_MIN_MATCH  4u
+#define LOG_LZ_MAX_OFFSET 65535u
+#define LOG_LZ_NIBBLE_MAX 15u
+
+static uint32_t read32(const uint8_t *data) {
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static uint32_t hashSequence(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - LOG_LZ_HASH_BITS);
+}
+
+/**
+ * @brief Writes the extra bytes of a length whose nibble is 15.
+ *
+ * @return The new output position, or NULL if the output is full.
+ */
+static uint8_t *writeLength(uint8_t *out, const uint8_t *outEnd, size_t length) {
+    for (; length >= 255u; length -= 255u) {
+        if (out == outEnd) {
+            return NULL;
+        }
+        *out++ = 255u;
+    }
+    if (out == outEnd) {
+        return NULL;
+    }
+    *out++ = (uint8_t)length;
+    return out;
+}
+
+/**
+ * @brief Writes one sequence (a match length of 0 writes the final literals only).
+ *
+ * @return The new output position, or NULL if the output is full.
+ */
+static uint8_t *writeSequence(uint8_t *out, const uint8_t *outEnd, const uint8_t *literals, size_t literalCount,
+                              uint32_t offset, size_t matchLength) {
+    if (out == outEnd) {
+        return NULL;
+    }
+    uint8_t *token = out++;
+    size_t matchCode = (matchLength == 0) ? 0 : matchLength - LOG_LZ_MIN_MATCH;
+    *token = (uint8_t)(((literalCount < LOG_LZ_NIBBLE_MAX) ? literalCount : LOG_LZ_NIBBLE_MAX) << 4);
+    *token |= (uint8_t)((matchCode < LOG_LZ_NIBBLE_MAX) ? matchCode : LOG_LZ_NIBBLE_MAX);
+
+    if (literalCount >= LOG_LZ_NIBBLE_MAX &&
+        (out = writeLength(out, outEnd, literalCount - LOG_LZ_NIBBLE_MAX)) == NULL) {
+        return NULL;
+    }
+    if ((size_t)(outEnd - out) < literalCount) {
+        return NULL;
+    }
+    memcpy(out, literals, literalCount);
+    out += literalCount;
+
+    if (matchLength == 0) {
+        return out;
+    }
+    if (outEnd - out < 2) {
+        return NULL;
+    }
+    *out++ = (uint8_t)offset;
+    *out++ = (uint8_t)(offset >> 8);
+    if (matchCode >= LOG_LZ_NIBBLE_MAX) {
+        out = writeLength(out, outEnd, matchCode - LOG_LZ_NIBBLE_MAX);
+    }
+    return out;
+}
+
+size_t logLzCompress(LogLzState *state, const char *source, size_t size, char *destination, size_t capacity) {
+    const uint8_t *in = (const uint8_t *)source;
+    uint8_t *out = (uint8_t *)destination;
+    const uint8_t *outEnd = out + capacity;
+    size_t anchor = 0;
+    size_t position = 0;
+
+    memset(state->table, 0, sizeof(state->table));
+    while (position + LOG_LZ_MIN_MATCH <= size) {
+        uint32_t sequence = read32(in + position);
+        uint32_t *slot = &state->table[hashSequence(sequence)];
+        size_t candidate = *slot;
+        *slot = (uint32_t)position;
+
+        if (candidate >= position || position - candidate > LOG_LZ_MAX_OFFSET || read32(in + candidate) != sequence) {
+            // Step faster through data that does not compress
+            position += 1 + ((position - anchor) >> 6);
+            continue;
+        }
+
+        size_t length = LOG_LZ_MIN_MATCH;
+        while (position + length < size && in[candidate + length] == in[position + length]) {
+            length++;
+        }
+        out = writeSequence(out, outEnd, in + anchor, position - anchor, (uint32_t)(position - candidate), length);
+        if (out == NULL) {
+            return 0;
+        }
+        position += length;
+        anchor = position;
+    }
+
+    out = writeSequence(out, outEnd, in + anchor, size - anchor, 0, 0);
+    return (out == NULL) ? 0 : (size_t)(out - (uint8_t *)destination);
+}
+
+/**
+ * @brief Reads the extra bytes of a length whose nibble is 15.
+ *
+ * @return RET_OK on success, RET_ERROR if the input ends first.
+ */
+static RetVal_t readLength(const uint8_t **in, const uint8_t *inEnd, size_t *length) {
+    uint8_t byte;
+    do {
+        if (*in == inEnd) {
+            return RET_ERROR;
+        }
+        byte = *(*in)++;
+        *length += byte;
+    } while (byte == 255u);
+    return RET_OK;
+}
+
+RetVal_t logLzDecompress(const char *source, size_t size, char *destination, size_t expected) {
+    const uint8_t *in = (const uint8_t *)source;
+    const uint8_t *inEnd = in + size;
+    uint8_t *out = (uint8_t *)destination;
+    uint8_t *outEnd = out + expected;
+
+    while (in < inEnd) {
+        uint8_t token = *in++;
+
+        size_t literalCount = token >> 4;
+        if (literalCount == LOG_LZ_NIBBLE_MAX && readLength(&in, inEnd, &literalCount) != RET_OK) {
+            return RET_ERROR;
+        }
+        if ((size_t)(inEnd - in) < literalCount || (size_t)(outEnd - out) < literalCount) {
+            return RET_ERROR;
+        }
+        memcpy(out, in, literalCount);
+        in += literalCount;
+        out += literalCount;
+
+        if (in == inEnd) {
+            break; // Final literals
+        }
+        if (inEnd - in < 2) {
+            return RET_ERROR;
+        }
+        size_t offset = (size_t)in[0] | ((size_t)in[1] << 8);
+        in += 2;
+        size_t matchLength = token & LOG_LZ_NIBBLE_MAX;
+        if (matchLength == LOG_LZ_NIBBLE_MAX && readLength(&in, inEnd, &matchLength) != RET_OK) {
+            return RET_ERROR;
+        }
+        matchLength += LOG_LZ_MIN_MATCH;
+        if (offset == 0 || offset > (size_t)(out - (uint8_t *)destination) ||
+            (size_t)(outEnd - out) < matchLength) {
+            return RET_ERROR;
+        }
+
+        // Overlapping matches repeat the bytes just written, so copy forward one byte at a time
+        const uint8_t *match = out - offset;
+        if (offset >= matchLength) {
+            memcpy(out, match, matchLength);
+            out += matchLength;
+        } else {
+            for (size_t i = 0; i < matchLength; i++) {
+                *out++ = *match++;
+            }
+        }
+    }
+    return (out == outEnd) ? RET_OK : RET_ERROR;
+}
@@ -0,0 +1,542 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "logger_query.h"
+#include "logger_index.h"
+#include "logger_segment.h"
+#include "logger_compress.h"
+#include "logger_cfg.h"
+
+/**
+ * @file logger_query.c
+ * @brief Implements indexed queries over the text log segments.
+ */
+
+#define LOG_QUERY_MAX_THREADS 64
+#define LOG_QUERY_FOLLOW_BUFFER_SIZE (64 * 1024)
+
+/**
+ * @brief Fields of a parsed "[time] [LEVEL] [component] message" line.
+ */
+typedef struct {
+    const char *timestamp;
+    size_t timestampLength;
+    LogLevel level;
+    const char *component;
+    size_t componentLength;
+} LogLineFields;
+
+/**
+ * @brief One loaded segment.
+ *
+ * - data: Segment contents (read-only mapping, a copy for the active segment, or
+ *   the lazily decompressed contents of a compressed segment).
+ * - size: Number of bytes holding records.
+ * - mappingSize: Size of the mapping (0 if data is a heap copy).
+ * - compressed: Reader of a compressed segment (NULL otherwise).
+ * - blocks: Index entries of the segment.
+ * - blockCount: Number of index entries.
+ */
+typedef struct {
+    char *data;
+    size_t size;
+    size_t mappingSize;
+    LogCompressReader *compressed;
+    LogIndexBlock *blocks;
+    uint32_t blockCount;
+} LogQuerySegment;
+
+/**
+ * @brief Byte range of a segment to scan.
+ *
+ * - data: Segment contents.
+ * - start: First byte of the range.
+ * - end: Byte past the range.
+ * - checkTime: Set if the range may hold records outside the time range.
+ * - compressed: Reader that has to decompress the range before it is scanned (NULL if none).
+ */
+typedef struct {
+    const char *data;
+    size_t start;
+    size_t end;
+    uint8_t checkTime;
+    LogCompressReader *compressed;
+} LogQueryRange;
+
+/**
+ * @brief Work of one scanning thread.
+ */
+typedef struct {
+    const LogQuery *query;
+    const LogQueryRange *ranges;
+    uint32_t count;
+    char *output;
+    size_t outputSize;
+} LogQueryWorker;
+
+static const char *levelNames_[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+
+/**
+ * @brief Splits a log line into its fields.
+ *
+ * @return RET_OK if the line has the logger's layout.
+ */
+static RetVal_t parseLine(const char *line, size_t length, LogLineFields *fields) {
+    const char *end = line + length;
+    if (length == 0 || line[0] != '[') {
+        return RET_ERROR;
+    }
+
+    const char *timestampEnd = memchr(line + 1, ']', length - 1);
+    if (timestampEnd == NULL || end - timestampEnd < 3 || timestampEnd[1] != ' ' || timestampEnd[2] != '[') {
+        return RET_ERROR;
+    }
+    fields->timestamp = line + 1;
+    fields->timestampLength = (size_t)(timestampEnd - fields->timestamp);
+
+    const char *levelStart = timestampEnd + 3;
+    const char *levelEnd = memchr(levelStart, ']', (size_t)(end - levelStart));
+    if (levelEnd == NULL || end - levelEnd < 3 || levelEnd[1] != ' ' || levelEnd[2] != '[') {
+        return RET_ERROR;
+    }
+    size_t levelLength = (size_t)(levelEnd - levelStart);
+    uint32_t level = 0;
+    while (level < sizeof(levelNames_) / sizeof(levelNames_[0]) &&
+           (strlen(levelNames_[level]) != levelLength || memcmp(levelNames_[level], levelStart, levelLength) != 0)) {
+        level++;
+    }
+    if (level == sizeof(levelNames_) / sizeof(levelNames_[0])) {
+        return RET_ERROR;
+    }
+    fields->level = (LogLevel)level;
+
+    fields->component = levelEnd + 3;
+    const char *componentEnd = memchr(fields->component, ']', (size_t)(end - fields->component));
+    if (componentEnd == NULL) {
+        return RET_ERROR;
+    }
+    fields->componentLength = (size_t)(componentEnd - fields->component);
+    return RET_OK;
+}
+
+/**
+ * @brief Converts a line timestamp to seconds since the epoch.
+ *
+ * @return The time, or -1 if the timestamp cannot be parsed.
+ */
+static int64_t parseTimestamp(const char *text, size_t length) {
+    char buffer[40];
+    if (length >= sizeof(buffer)) {
+        return -1;
+    }
+    memcpy(buffer, text, length);
+    buffer[length] = '\0';
+
+    // Current layout (logger_timestamp.h), then the ctime() layout of older logs
+    struct tm local;
+    memset(&local, 0, sizeof(local));
+    if (strptime(buffer, "%Y-%m-%d %H:%M:%S", &local) == NULL) {
+        memset(&local, 0, sizeof(local));
+        if (strptime(buffer, "%a %b %e %H:%M:%S %Y", &local) == NULL) {
+            return -1;
+        }
+    }
+    local.tm_isdst = -1;
+    return (int64_t)mktime(&local);
+}
+
+/**
+ * @brief Checks one line against the query.
+ *
+ * Lines without the logger's layout are treated as DEBUG records without a
+ * component or time, as printLogMessages() always did.
+ */
+static uint8_t matchLine(const LogQuery *query, const char *line, size_t length, uint8_t checkTime) {
+    LogLineFields fields;
+    if (parseLine(line, length, &fields) != RET_OK) {
+        return query->level == LOG_LEVEL_DEBUG && query->component == NULL && !checkTime;
+    }
+    if (fields.level < query->level) {
+        return 0;
+    }
+    if (query->component != NULL &&
+        (strlen(query->component) != fields.componentLength ||
+         memcmp(query->component, fields.component, fields.componentLength) != 0)) {
+        return 0;
+    }
+    if (checkTime) {
+        int64_t timestamp = parseTimestamp(fields.timestamp, fields.timestampLength);
+        if ((query->from != 0 && timestamp < query->from) || (query->until != 0 && timestamp > query->until)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Prints the matching lines of a range.
+ *
+ * @return Number of bytes of complete lines in the range.
+ */
+static size_t scanRange(const LogQuery *query, const LogQueryRange *range, FILE *output) {
+    if (range->compressed != NULL && logCompressRead(range->compressed, range->start, range->end) != RET_OK) {
+        fprintf(stderr, "Skipping a corrupted block of a compressed log segment\n");
+        return 0;
+    }
+
+    const char *line = range->data + range->start;
+    const char *end = range->data + range->end;
+
+    while (line < end && *line != '\0') {
+        const char *newline = memchr(line, '\n', (size_t)(end - line));
+        if (newline == NULL) {
+            break; // Incomplete line at the end of the active segment
+        }
+        size_t length = (size_t)(newline - line) + 1;
+        if (matchLine(query, line, length, range->checkTime)) {
+            fwrite(line, 1, length, output);
+        }
+        line += length;
+    }
+    return (size_t)(line - (range->data + range->start));
+}
+
+/**
+ * @brief Checks whether an indexed block can hold matching records.
+ *
+ * @param checkTime Set if the records of the block must be checked against the time range.
+ */
+static uint8_t blockSelected(const LogQuery *query, const LogIndexBlock *block, uint8_t *checkTime) {
+    if ((block->levelMask >> query->level) == 0) {
+        return 0;
+    }
+    if (query->component != NULL &&
+        (block->componentMask & (1ull << logIndexComponentBit(query->component))) == 0) {
+        return 0;
+    }
+    if ((query->from != 0 && block->maxTime < query->from) ||
+        (query->until != 0 && block->minTime > query->until)) {
+        return 0;
+    }
+    *checkTime = (query->from != 0 && block->minTime < query->from) ||
+                 (query->until != 0 && block->maxTime > query->until);
+    return 1;
+}
+
+/**
+ * @brief Opens the compressed form of a segment; its blocks are decompressed when scanned.
+ */
+static RetVal_t loadCompressedSegment(uint32_t sequence, LogQuerySegment *segment) {
+    segment->compressed = malloc(sizeof(*segment->compressed));
+    if (segment->compressed == NULL || logCompressOpen(sequence, segment->compressed) != RET_OK) {
+        free(segment->compressed);
+        segment->compressed = NULL;
+        return RET_ERROR;
+    }
+    segment->data = segment->compressed->data;
+    segment->size = segment->compressed->size;
+    segment->blockCount = logIndexLoad(sequence, segment->size, &segment->blocks);
+    return RET_OK;
+}
+
+/**
+ * @brief Loads a segment and its index.
+ *
+ * Sealed segments are mapped read-only. The active segment is copied instead,
+ * since it is truncated when it is sealed and a mapping would fault past the
+ * new end. Segments that have been compressed are opened for random access.
+ */
+static RetVal_t loadSegment(uint32_t sequence, uint8_t active, LogQuerySegment *segment) {
+    char path[256];
+    logSegmentPath(path, sizeof(path), sequence);
+    memset(segment, 0, sizeof(*segment));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return loadCompressedSegment(sequence, segment);
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size == 0) {
+        close(fd);
+        return RET_ERROR;
+    }
+    size_t size = (size_t)status.st_size;
+
+    if (!active) {
+        char *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            return RET_ERROR;
+        }
+        madvise(data, size, MADV_SEQUENTIAL);
+        segment->data = data;
+        segment->mappingSize = size;
+        segment->size = size;
+    } else {
+        segment->data = malloc(size);
+        ssize_t length = (segment->data != NULL) ? pread(fd, segment->data, size, 0) : -1;
+        if (length <= 0) {
+            free(segment->data);
+            close(fd);
+            return RET_ERROR;
+        }
+        const char *zero = memchr(segment->data, '\0', (size_t)length);
+        segment->size = (zero != NULL) ? (size_t)(zero - segment->data) : (size_t)length;
+    }
+    close(fd);
+
+    segment->blockCount = logIndexLoad(sequence, segment->size, &segment->blocks);
+    return RET_OK;
+}
+
+static void unloadSegment(LogQuerySegment *segment) {
+    if (segment->compressed != NULL) {
+        logCompressClose(segment->compressed);
+        free(segment->compressed);
+    } else if (segment->mappingSize != 0) {
+        munmap(segment->data, segment->mappingSize);
+    } else {
+        free(segment->data);
+    }
+    free(segment->blocks);
+}
+
+/**
+ * @brief Appends a range to the scan list.
+ */
+static RetVal_t addRange(LogQueryRange **ranges, uint32_t *count, const LogQuerySegment *segment,
+                         size_t start, size_t end, uint8_t checkTime) {
+    if (start >= end) {
+        return RET_OK;
+    }
+    LogQueryRange *grown = realloc(*ranges, (*count + 1) * sizeof(**ranges));
+    if (grown == NULL) {
+        return RET_ERROR;
+    }
+    *ranges = grown;
+    (*ranges)[(*count)++] = (LogQueryRange){segment->data, start, end, checkTime, segment->compressed};
+    return RET_OK;
+}
+
+/**
+ * @brief Lists the ranges of a segment that have to be scanned.
+ *
+ * Selected blocks are added as they are; bytes not covered by the index (the
+ * block being filled, or gaps) are always scanned.
+ */
+static RetVal_t selectRanges(const LogQuery *query, const LogQuerySegment *segment,
+                             LogQueryRange **ranges, uint32_t *count) {
+    uint8_t fullCheck = (query->from != 0 || query->until != 0);
+    size_t covered = 0;
+
+    for (uint32_t i = 0; i < segment->blockCount; i++) {
+        const LogIndexBlock *block = &segment->blocks[i];
+        if (block->offset < covered) {
+            continue;
+        }
+        if (addRange(ranges, count, segment, covered, block->offset, fullCheck) != RET_OK) {
+            return RET_ERROR;
+        }
+
+        uint8_t checkTime = 0;
+        if (blockSelected(query, block, &checkTime) &&
+            addRange(ranges, count, segment, block->offset,
+                     (size_t)block->offset + block->length, checkTime) != RET_OK) {
+            return RET_ERROR;
+        }
+        covered = (size_t)block->offset + block->length;
+    }
+    return addRange(ranges, count, segment, covered, segment->size, fullCheck);
+}
+
+static void *scanWorker(void *args) {
+    LogQueryWorker *worker = (LogQueryWorker *)args;
+    FILE *output = open_memstream(&worker->output, &worker->outputSize);
+    if (output == NULL) {
+        return NULL;
+    }
+    for (uint32_t i = 0; i < worker->count; i++) {
+        scanRange(worker->query, &worker->ranges[i], output);
+    }
+    fclose(output);
+    return NULL;
+}
+
+/**
+ * @brief Scans the ranges and prints the matches in order.
+ *
+ * With several threads the ranges are split into contiguous groups; every
+ * thread collects its matches in memory and the groups are printed in order.
+ */
+static void scanRanges(const LogQuery *query, const LogQueryRange *ranges, uint32_t count,
+                       uint32_t threads, FILE *output) {
+    if (threads > LOG_QUERY_MAX_THREADS) {
+        threads = LOG_QUERY_MAX_THREADS;
+    }
+    if (threads > count) {
+        threads = count;
+    }
+    if (threads <= 1) {
+        for (uint32_t i = 0; i < count; i++) {
+            scanRange(query, &ranges[i], output);
+        }
+        return;
+    }
+
+    LogQueryWorker workers[LOG_QUERY_MAX_THREADS];
+    pthread_t handles[LOG_QUERY_MAX_THREADS];
+    uint8_t started[LOG_QUERY_MAX_THREADS];
+
+    for (uint32_t i = 0; i < threads; i++) {
+        uint32_t first = (uint32_t)((uint64_t)count * i / threads);
+        uint32_t last = (uint32_t)((uint64_t)count * (i + 1) / threads);
+        workers[i] = (LogQueryWorker){query, &ranges[first], last - first, NULL, 0};
+        started[i] = (pthread_create(&handles[i], NULL, scanWorker, &workers[i]) == 0);
+        if (!started[i]) {
+            scanWorker(&workers[i]);
+        }
+    }
+
+    for (uint32_t i = 0; i < threads; i++) {
+        if (started[i]) {
+            pthread_join(handles[i], NULL);
+        }
+        if (workers[i].output != NULL) {
+            fwrite(workers[i].output, 1, workers[i].outputSize, output);
+            free(workers[i].output);
+        }
+    }
+}
+
+RetVal_t logQueryRun(const LogQuery *query, uint32_t threads, FILE *output) {
+#if LOG_BINARY_ENABLED
+    (void)query;
+    (void)threads;
+    (void)output;
+    fprintf(stderr, "Log queries need text log segments; decode binary segments with log_decoder\n");
+    return RET_ERROR;
+#else
+    uint32_t first = 0;
+    uint32_t last = 0;
+    if (logSegmentFind(&first, &last) != RET_OK) {
+        fprintf(stderr, "No log segments found\n");
+        return RET_ERROR;
+    }
+
+    uint32_t segmentCount = last - first + 1;
+    LogQuerySegment *segments = calloc(segmentCount, sizeof(*segments));
+    if (segments == NULL) {
+        return RET_ERROR;
+    }
+
+    LogQueryRange *ranges = NULL;
+    uint32_t rangeCount = 0;
+    RetVal_t ret = RET_OK;
+    for (uint32_t i = 0; i < segmentCount && ret == RET_OK; i++) {
+        if (loadSegment(first + i, (first + i) == last, &segments[i]) == RET_OK) {
+            ret = selectRanges(query, &segments[i], &ranges, &rangeCount);
+        }
+    }
+
+    if (ret == RET_OK) {
+        scanRanges(query, ranges, rangeCount, threads, output);
+    }
+
+    free(ranges);
+    for (uint32_t i = 0; i < segmentCount; i++) {
+        unloadSegment(&segments[i]);
+    }
+    free(segments);
+    return ret;
+#endif
+}
+
+/**
+ * @brief Reads the complete lines written after an offset of a segment.
+ *
+ * @param print Set to print the matching lines; clear to only skip them.
+ * @return Number of bytes consumed.
+ */
+static size_t followRead(const LogQuery *query, int fd, off_t offset, char *buffer, uint8_t print, FILE *output) {
+    ssize_t length = pread(fd, buffer, LOG_QUERY_FOLLOW_BUFFER_SIZE, offset);
+    if (length <= 0) {
+        return 0;
+    }
+
+    LogQueryRange range = {buffer, 0, (size_t)length, 0, NULL};
+    if (!print) {
+        const char *zero = memchr(buffer, '\0', (size_t)length);
+        const char *end = (zero != NULL) ? zero : buffer + length;
+        const char *newline = memrchr(buffer, '\n', (size_t)(end - buffer));
+        return (newline != NULL) ? (size_t)(newline - buffer) + 1 : 0;
+    }
+    return scanRange(query, &range, output);
+}
+
+RetVal_t logQueryFollow(const LogQuery *query, FILE *output) {
+    LogQuery follow = *query;
+    follow.from = 0;
+    follow.until = 0;
+
+    uint32_t first = 0;
+    uint32_t last = 0;
+    if (logSegmentFind(&first, &last) != RET_OK) {
+        fprintf(stderr, "No log segments found\n");
+        return RET_ERROR;
+    }
+
+    char *buffer = malloc(LOG_QUERY_FOLLOW_BUFFER_SIZE);
+    if (buffer == NULL) {
+        return RET_ERROR;
+    }
+
+    uint32_t sequence = last;
+    uint8_t print = 0;
+    uint8_t newerSegment = 0;
+    off_t offset = 0;
+    int fd = -1;
+
+    while (1) {
+        if (fd < 0) {
+            char path[256];
+            logSegmentPath(path, sizeof(path), sequence);
+            fd = open(path, O_RDONLY);
+        }
+
+        size_t consumed = (fd >= 0) ? followRead(&follow, fd, offset, buffer, print, output) : 0;
+        if (consumed > 0) {
+            offset += (off_t)consumed;
+            continue;
+        }
+        print = 1; // Everything written before the query started has been skipped
+
+        if (newerSegment) {
+            // The segment has been sealed and drained; continue with the next one
+            if (fd >= 0) {
+                close(fd);
+                fd = -1;
+            }
+            sequence = (first > sequence + 1) ? first : sequence + 1;
+            offset = 0;
+            newerSegment = 0;
+            continue;
+        }
+        if (logSegmentFind(&first, &last) == RET_OK && last > sequence) {
+            newerSegment = 1; // Drain the rest of the current segment once more first
+            continue;
+        }
+
+        fflush(output);
+        usleep(LOG_QUERY_FOLLOW_POLL_MS * 1000);
+    }
+
+    free(buffer);
+    return RET_ERROR;
+}
@@ -0,0 +1,39 @@
+#include "logger.h"
+#include "logger_cfg.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/**
+ * @file logger_rate.c
+ * @brief Implements the per-call-site rate limiting and sampling of LOG_MSG_LIMITED,
+ *        LOG_FMT_LIMITED and LOG_FMT_SAMPLED.
+ *
+ * Every call site owns its counters, so counting a call is one atomic
+ * operation and never takes a lock.
+ */
+
+uint8_t logRateLimitAllow(LogRateLimit *site, uint32_t limit, LogLevel level,
+                          const char *component, const char *text) {
+    uint32_t now = (uint32_t)xTaskGetTickCount();
+    uint32_t windowStart = __atomic_load_n(&site->windowStart, __ATOMIC_RELAXED);
+
+    // Only the caller that moves the window on reports the previous one
+    if (now - windowStart >= pdMS_TO_TICKS(LOG_RATE_LIMIT_WINDOW_MS) &&
+        __atomic_compare_exchange_n(&site->windowStart, &windowStart, now, 0,
+                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        uint32_t calls = __atomic_exchange_n(&site->count, 0, __ATOMIC_RELAXED);
+        if (calls > limit) {
+            logMessageFormatted(level, component, "Suppressed %u records (limit %u per %u ms): %s",
+                                (unsigned)(calls - limit), (unsigned)limit,
+                                (unsigned)LOG_RATE_LIMIT_WINDOW_MS, text);
+        }
+    }
+    return __atomic_add_fetch(&site->count, 1, __ATOMIC_RELAXED) <= limit;
+}
+
+uint8_t logSampleAllow(uint32_t *counter, uint32_t every) {
+    if (every <= 1) {
+        return 1;
+    }
+    return (__atomic_fetch_add(counter, 1, __ATOMIC_RELAXED) % every) == 0;
+}
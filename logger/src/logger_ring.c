@@ -0,0 +1,154 @@
+#include <stdint.h>
+#include "logger_ring.h"
+#include "logger_cfg.h"
+
+/**
+ * @file logger_ring.c
+ * @brief Implements the lock-free log record ring buffer.
+ *
+ * Every slot carries a sequence number. A producer claims the slot at the
+ * current head position with a compare-and-swap on the head index, fills it and
+ * publishes it by advancing the slot sequence. The consumer only reads slots whose
+ * sequence shows a published record, so producers never wait on each other or on
+ * the consumer.
+ */
+
+#if (LOG_RING_SIZE & (LOG_RING_SIZE - 1)) != 0
+#error "LOG_RING_SIZE must be a power of two"
+#endif
+
+#define LOG_RING_MASK (LOG_RING_SIZE - 1)
+
+/**
+ * @brief One record slot of the ring.
+ *
+ * - sequence: Publication state of the slot.
+ * - length: Number of valid payload bytes.
+ * - info: Record metadata.
+ * - data: Record payload.
+ */
+typedef struct {
+    uint32_t sequence;
+    uint16_t length;
+    LogRecordInfo info;
+    char data[LOG_RECORD_SIZE];
+} LogRingSlot;
+
+/**
+ * @brief Ring storage and indexes.
+ *
+ * - head: Next position to be claimed by a producer.
+ * - tail: Next position to be read by the consumer.
+ * - dropped: Records dropped since the last logRingTakeDropped() call.
+ * - droppedTotal: Records dropped since start-up.
+ */
+typedef struct {
+    LogRingSlot slots[LOG_RING_SIZE];
+    uint32_t head;
+    uint32_t tail;
+    uint32_t dropped;
+    uint32_t droppedTotal;
+} LogRing;
+
+static LogRing logRing_;
+
+/**
+ * @brief Initializes the slot sequences of the ring.
+ */
+void logRingInit(void) {
+    for (uint32_t i = 0; i < LOG_RING_SIZE; i++) {
+        logRing_.slots[i].sequence = i;
+    }
+    logRing_.head = 0;
+    logRing_.tail = 0;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Reserves a free slot for a new record.
+ *
+ * @param ticket Pointer to store the reservation.
+ * @return RET_OK if a slot was reserved, RET_ERROR if the ring is full.
+ */
+RetVal_t logRingReserve(LogRingTicket *ticket) {
+    uint32_t position = __atomic_load_n(&logRing_.head, __ATOMIC_RELAXED);
+    while (1) {
+        LogRingSlot *slot = &logRing_.slots[position & LOG_RING_MASK];
+        uint32_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        int32_t diff = (int32_t)(sequence - position);
+
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&logRing_.head, &position, position + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                ticket->data = slot->data;
+                ticket->info = &slot->info;
+                ticket->position = position;
+                return RET_OK;
+            }
+        } else if (diff < 0) {
+            __atomic_add_fetch(&logRing_.dropped, 1, __ATOMIC_RELAXED);
+            __atomic_add_fetch(&logRing_.droppedTotal, 1, __ATOMIC_RELAXED);
+            return RET_ERROR;
+        } else {
+            position = __atomic_load_n(&logRing_.head, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+/**
+ * @brief Publishes a previously reserved slot to the consumer.
+ *
+ * @param ticket Reservation returned by logRingReserve().
+ * @param length Number of valid bytes written into the slot.
+ */
+void logRingCommit(const LogRingTicket *ticket, uint16_t length) {
+    LogRingSlot *slot = &logRing_.slots[ticket->position & LOG_RING_MASK];
+    slot->length = length;
+    __atomic_store_n(&slot->sequence, ticket->position + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Returns the oldest committed record without removing it.
+ *
+ * @param data Pointer to store the record payload.
+ * @param length Pointer to store the record length in bytes.
+ * @param info Pointer to store the record metadata.
+ * @return RET_OK if a record is available, RET_ERROR if the ring is empty.
+ */
+RetVal_t logRingFront(const char **data, uint16_t *length, const LogRecordInfo **info) {
+    LogRingSlot *slot = &logRing_.slots[logRing_.tail & LOG_RING_MASK];
+    if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != logRing_.tail + 1) {
+        return RET_ERROR;
+    }
+    *data = slot->data;
+    *length = slot->length;
+    *info = &slot->info;
+    return RET_OK;
+}
+
+/**
+ * @brief Releases the record returned by logRingFront().
+ */
+void logRingPop(void) {
+    LogRingSlot *slot = &logRing_.slots[logRing_.tail & LOG_RING_MASK];
+    __atomic_store_n(&slot->sequence, logRing_.tail + LOG_RING_SIZE, __ATOMIC_RELEASE);
+    logRing_.tail++;
+}
+
+/**
+ * @brief Returns and clears the number of records dropped since the last call.
+ *
+ * @return Number of dropped records.
+ */
+uint32_t logRingTakeDropped(void) {
+    return __atomic_exchange_n(&logRing_.dropped, 0, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Returns the total number of records dropped since start-up.
+ *
+ * @return Total number of dropped records.
+ */
+uint32_t logRingDroppedTotal(void) {
+    return __atomic_load_n(&logRing_.droppedTotal, __ATOMIC_RELAXED);
+}
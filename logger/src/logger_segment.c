@@ -0,0 +1,297 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include "logger_segment.h"
+#include "logger_binary.h"
+#include "logger_timestamp.h"
+#include "logger_cfg.h"
+
+/**
+ * @file logger_segment.c
+ * @brief Implements the memory-mapped log segments.
+ */
+
+#if LOG_BINARY_ENABLED
+#define LOG_SEGMENT_EXTENSION ".bin"
+#else
+#define LOG_SEGMENT_EXTENSION ".txt"
+#endif
+
+#define LOG_SEGMENT_INDEX_EXTENSION ".idx"
+#define LOG_SEGMENT_COMPRESSED_EXTENSION LOG_SEGMENT_EXTENSION ".lz"
+
+#define LOG_SEGMENT_PATH_SIZE 256
+
+/**
+ * @brief State of the active segment.
+ *
+ * - base: Mapping of the segment file (NULL when no segment is open).
+ * - fd: File descriptor of the segment file.
+ * - sequence: Sequence number of the segment.
+ * - length: Number of bytes written; published with release ordering.
+ * - openedAt: Wall-clock time the segment was opened.
+ * - openHook: Hook called after a segment is opened.
+ */
+typedef struct {
+    char *base;
+    int fd;
+    uint32_t sequence;
+    uint32_t length;
+    time_t openedAt;
+    LogSegmentOpenHook openHook;
+} LogSegmentState;
+
+static LogSegmentState segment_ = {NULL, -1, 0, 0, 0, NULL};
+
+void logSegmentPath(char *path, size_t size, uint32_t sequence) {
+    snprintf(path, size, "%s/%s.%06u%s", LOG_SEGMENT_DIR, LOG_SEGMENT_PREFIX,
+             (unsigned)sequence, LOG_SEGMENT_EXTENSION);
+}
+
+void logSegmentCompressedPath(char *path, size_t size, uint32_t sequence) {
+    snprintf(path, size, "%s/%s.%06u%s", LOG_SEGMENT_DIR, LOG_SEGMENT_PREFIX,
+             (unsigned)sequence, LOG_SEGMENT_COMPRESSED_EXTENSION);
+}
+
+void logSegmentIndexPath(char *path, size_t size, uint32_t sequence) {
+    snprintf(path, size, "%s/%s.%06u%s", LOG_SEGMENT_DIR, LOG_SEGMENT_PREFIX,
+             (unsigned)sequence, LOG_SEGMENT_INDEX_EXTENSION);
+}
+
+/**
+ * @brief Extracts the sequence number from a segment file name.
+ *
+ * @return RET_OK if the name is a segment of this configuration (compressed or not).
+ */
+static RetVal_t parseSegmentName(const char *name, uint32_t *sequence) {
+    size_t prefixLength = strlen(LOG_SEGMENT_PREFIX);
+    if (strncmp(name, LOG_SEGMENT_PREFIX, prefixLength) != 0 || name[prefixLength] != '.') {
+        return RET_ERROR;
+    }
+
+    char *end = NULL;
+    const char *digits = name + prefixLength + 1;
+    unsigned long value = strtoul(digits, &end, 10);
+    if (end == digits ||
+        (strcmp(end, LOG_SEGMENT_EXTENSION) != 0 && strcmp(end, LOG_SEGMENT_COMPRESSED_EXTENSION) != 0)) {
+        return RET_ERROR;
+    }
+    *sequence = (uint32_t)value;
+    return RET_OK;
+}
+
+RetVal_t logSegmentFind(uint32_t *first, uint32_t *last) {
+    DIR *dir = opendir(LOG_SEGMENT_DIR);
+    if (dir == NULL) {
+        return RET_ERROR;
+    }
+
+    RetVal_t found = RET_ERROR;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        uint32_t sequence;
+        if (parseSegmentName(entry->d_name, &sequence) != RET_OK) {
+            continue;
+        }
+        if (found != RET_OK || sequence < *first) {
+            *first = sequence;
+        }
+        if (found != RET_OK || sequence > *last) {
+            *last = sequence;
+        }
+        found = RET_OK;
+    }
+    closedir(dir);
+    return found;
+}
+
+/**
+ * @brief Returns the number of bytes holding complete records.
+ *
+ * Text records end with a newline; binary records are walked by their header
+ * length until the zero-filled tail.
+ */
+static uint32_t usedLength(const char *base, uint32_t size) {
+#if LOG_BINARY_ENABLED
+    uint32_t offset = 0;
+    while (offset + sizeof(LogBinaryRecordHeader) <= size) {
+        LogBinaryRecordHeader header;
+        memcpy(&header, base + offset, sizeof(header));
+        if (header.type == 0 || header.length < sizeof(header) || offset + header.length > size) {
+            break;
+        }
+        offset += header.length;
+    }
+    return offset;
+#else
+    uint32_t length = size;
+    while (length > 0 && base[length - 1] != '\n') {
+        length--;
+    }
+    return length;
+#endif
+}
+
+/**
+ * @brief Truncates a segment left by a previous run to its used length.
+ */
+static void trimSegment(uint32_t sequence) {
+    char path[LOG_SEGMENT_PATH_SIZE];
+    logSegmentPath(path, sizeof(path), sequence);
+
+    int fd = open(path, O_RDWR);
+    if (fd < 0) {
+        return;
+    }
+    off_t size = lseek(fd, 0, SEEK_END);
+    if (size > 0) {
+        char *base = mmap(NULL, (size_t)size, PROT_READ, MAP_SHARED, fd, 0);
+        if (base != MAP_FAILED) {
+            uint32_t length = usedLength(base, (uint32_t)size);
+            munmap(base, (size_t)size);
+            if (ftruncate(fd, length) != 0) {
+                perror("Failed to trim log segment");
+            }
+        }
+    }
+    close(fd);
+}
+
+/**
+ * @brief Deletes the segments (compressed or not, and their indexes) that fall out of the retention window.
+ */
+static void removeExpiredSegments(uint32_t newest) {
+    uint32_t first = 0;
+    uint32_t last = 0;
+    if (logSegmentFind(&first, &last) != RET_OK) {
+        return;
+    }
+
+    for (uint32_t sequence = first; sequence + LOG_SEGMENT_MAX_COUNT <= newest; sequence++) {
+        char path[LOG_SEGMENT_PATH_SIZE];
+        logSegmentPath(path, sizeof(path), sequence);
+        unlink(path);
+        logSegmentCompressedPath(path, sizeof(path), sequence);
+        unlink(path);
+        logSegmentIndexPath(path, sizeof(path), sequence);
+        unlink(path);
+    }
+}
+
+/**
+ * @brief Unmaps the active segment and truncates it to its used length.
+ */
+static void sealSegment(void) {
+    if (segment_.base == NULL) {
+        return;
+    }
+    munmap(segment_.base, LOG_SEGMENT_SIZE);
+    if (ftruncate(segment_.fd, segment_.length) != 0) {
+        perror("Failed to seal log segment");
+    }
+    close(segment_.fd);
+    segment_.base = NULL;
+    segment_.fd = -1;
+}
+
+/**
+ * @brief Creates, preallocates and maps a new segment.
+ */
+static RetVal_t openSegment(uint32_t sequence) {
+    char path[LOG_SEGMENT_PATH_SIZE];
+    logSegmentPath(path, sizeof(path), sequence);
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        perror("Failed to create log segment");
+        return RET_ERROR;
+    }
+    // Reserve the blocks up front so a full disk cannot fault a later write into the mapping
+    if (posix_fallocate(fd, 0, LOG_SEGMENT_SIZE) != 0 && ftruncate(fd, LOG_SEGMENT_SIZE) != 0) {
+        perror("Failed to preallocate log segment");
+        close(fd);
+        return RET_ERROR;
+    }
+
+    char *base = mmap(NULL, LOG_SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        perror("Failed to map log segment");
+        close(fd);
+        return RET_ERROR;
+    }
+
+    segment_.base = base;
+    segment_.fd = fd;
+    segment_.sequence = sequence;
+    segment_.openedAt = (time_t)logTimestampNow().seconds;
+    __atomic_store_n(&segment_.length, 0, __ATOMIC_RELEASE);
+
+    removeExpiredSegments(sequence);
+    if (segment_.openHook != NULL) {
+        segment_.openHook();
+    }
+    return RET_OK;
+}
+
+/**
+ * @brief Seals the active segment and opens the next one.
+ */
+static RetVal_t rotateSegment(void) {
+    uint32_t next = segment_.sequence + 1;
+    sealSegment();
+    return openSegment(next);
+}
+
+RetVal_t logSegmentInit(LogSegmentOpenHook openHook) {
+    uint32_t first = 0;
+    uint32_t last = 0;
+    uint32_t next = 0;
+
+    sealSegment();
+    if (logSegmentFind(&first, &last) == RET_OK) {
+        trimSegment(last);
+        next = last + 1;
+    }
+    segment_.openHook = openHook;
+    return openSegment(next);
+}
+
+RetVal_t logSegmentWrite(const char *data, uint16_t length, LogSegmentLocation *location) {
+    if (segment_.base == NULL) {
+        return RET_ERROR;
+    }
+
+    uint32_t offset = segment_.length;
+    if (offset + length > LOG_SEGMENT_SIZE) {
+        if (rotateSegment() != RET_OK) {
+            return RET_ERROR;
+        }
+        offset = segment_.length;
+        if (offset + length > LOG_SEGMENT_SIZE) {
+            return RET_ERROR;
+        }
+    }
+
+    memcpy(segment_.base + offset, data, length);
+    __atomic_store_n(&segment_.length, offset + length, __ATOMIC_RELEASE);
+
+    if (location != NULL) {
+        location->sequence = segment_.sequence;
+        location->offset = offset;
+    }
+    return RET_OK;
+}
+
+void logSegmentRotateIfExpired(void) {
+    if (segment_.base == NULL || segment_.length == 0) {
+        return;
+    }
+    if ((time_t)logTimestampNow().seconds - segment_.openedAt >= LOG_SEGMENT_MAX_AGE_S) {
+        rotateSegment();
+    }
+}
@@ -0,0 +1,231 @@
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "logger_status.h"
+#include "logger_timestamp.h"
+#include "logger_cfg.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/**
+ * @file logger_status.c
+ * @brief Implements the writer side of the shared-memory status page.
+ *
+ * The slot of the calling task is cached in a thread-local pointer, as in the
+ * flight recorder: in the POSIX port every task runs in its own thread, so a
+ * heartbeat is one load, one clock read and one cache line written. A deleted
+ * and re-created task starts in a new thread and finds its slot again by name.
+ */
+
+#if LOG_STATUS_ENABLED
+
+/**
+ * @brief Slot states, kept in process memory.
+ */
+#define LOG_STATUS_SLOT_FREE  0
+#define LOG_STATUS_SLOT_BUSY  1
+#define LOG_STATUS_SLOT_READY 2
+
+/**
+ * @brief Marker of a task that found no free slot.
+ */
+#define LOG_STATUS_NO_SLOT ((LogStatusTask *)1)
+
+static LogStatusPage *page_ = NULL;
+static uint8_t slotState_[LOG_STATUS_TASKS];
+static __thread LogStatusTask *taskSlot_ = NULL;
+
+/**
+ * @brief Opens the write section guarded by a sequence lock.
+ */
+static void beginWrite(uint32_t *sequence) {
+    __atomic_store_n(sequence, *sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Closes the write section guarded by a sequence lock.
+ */
+static void endWrite(uint32_t *sequence) {
+    __atomic_store_n(sequence, *sequence + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Stores a field of a section; readers may copy it concurrently.
+ */
+static void storeField(uint32_t *field, uint32_t value) {
+    __atomic_store_n(field, value, __ATOMIC_RELAXED);
+}
+
+static void storeTime(uint64_t *field, uint64_t value) {
+    __atomic_store_n(field, value, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Updates a state section; shared by the master and the slave sections.
+ *
+ * @param sequence Sequence lock of the section.
+ * @param current State field of the section.
+ * @param transitions Transition counter of the section.
+ * @param counts First entry of the [from][to] counters of the section.
+ * @param enteredNs Entry time field of the section.
+ * @param stateCount Number of valid states; a current state of stateCount means none yet.
+ * @param state New state.
+ */
+static void publishState(uint32_t *sequence, uint32_t *current, uint32_t *transitions, uint32_t *counts,
+                         uint64_t *enteredNs, uint32_t stateCount, uint32_t state) {
+    uint32_t previous = *current;
+    if (previous == state || state >= stateCount) {
+        return;
+    }
+
+    beginWrite(sequence);
+    if (previous < stateCount) {
+        storeField(&counts[previous * stateCount + state], counts[previous * stateCount + state] + 1);
+        storeField(transitions, *transitions + 1);
+    }
+    storeField(current, state);
+    storeTime(enteredNs, logTimestampMonotonicNs());
+    endWrite(sequence);
+}
+
+/**
+ * @brief Finds the slot of a task name, or claims a free one.
+ *
+ * Either way the start count of the slot is incremented.
+ *
+ * @return The slot, or LOG_STATUS_NO_SLOT if all slots are taken.
+ */
+static LogStatusTask *claimSlot(LogStatusPage *page, const char *name) {
+    LogStatusTask *slot = LOG_STATUS_NO_SLOT;
+
+    for (uint32_t i = 0; i < LOG_STATUS_TASKS && slot == LOG_STATUS_NO_SLOT; i++) {
+        if (__atomic_load_n(&slotState_[i], __ATOMIC_ACQUIRE) == LOG_STATUS_SLOT_READY &&
+            strncmp(page->tasks[i].name, name, LOG_STATUS_TASK_NAME_SIZE - 1) == 0) {
+            slot = &page->tasks[i];
+        }
+    }
+
+    for (uint32_t i = 0; i < LOG_STATUS_TASKS && slot == LOG_STATUS_NO_SLOT; i++) {
+        uint8_t expected = LOG_STATUS_SLOT_FREE;
+        if (__atomic_compare_exchange_n(&slotState_[i], &expected, LOG_STATUS_SLOT_BUSY, 0,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            slot = &page->tasks[i];
+            beginWrite(&slot->sequence);
+            strncpy(slot->name, name, LOG_STATUS_TASK_NAME_SIZE - 1);
+            endWrite(&slot->sequence);
+            __atomic_store_n(&slotState_[i], LOG_STATUS_SLOT_READY, __ATOMIC_RELEASE);
+        }
+    }
+
+    if (slot != LOG_STATUS_NO_SLOT) {
+        beginWrite(&slot->sequence);
+        storeField(&slot->starts, slot->starts + 1);
+        endWrite(&slot->sequence);
+    }
+    return slot;
+}
+
+RetVal_t logStatusInit(const char *path) {
+    if (page_ != NULL) {
+        return RET_OK;
+    }
+
+    // Monitors keep their mapping of a previous page; they see it no longer changes
+    (void)unlink(path);
+    int fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        perror("Failed to create status page");
+        return RET_ERROR;
+    }
+    if (ftruncate(fd, sizeof(LogStatusPage)) != 0) {
+        perror("Failed to size status page");
+        close(fd);
+        (void)unlink(path);
+        return RET_ERROR;
+    }
+    void *base = mmap(NULL, sizeof(LogStatusPage), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        perror("Failed to map status page");
+        (void)unlink(path);
+        return RET_ERROR;
+    }
+
+    // The file starts zeroed; only the fields that are not 0 initially need a value
+    LogStatusPage *page = (LogStatusPage *)base;
+    page->header.version = LOG_STATUS_VERSION;
+    page->header.pid = (uint32_t)getpid();
+    page->header.taskSlots = LOG_STATUS_TASKS;
+    page->header.startNs = logTimestampMonotonicNs();
+    page->master.state = MASTESR_STATE_MAX;
+    page->slave.state = SLAVE_STATE_MAX;
+    __atomic_store_n(&page->header.magic, LOG_STATUS_MAGIC, __ATOMIC_RELEASE);
+
+    __atomic_store_n(&page_, page, __ATOMIC_RELEASE);
+    return RET_OK;
+}
+
+void logStatusSetMasterState(MasterStates state) {
+    LogStatusPage *page = __atomic_load_n(&page_, __ATOMIC_ACQUIRE);
+    if (page == NULL) {
+        return;
+    }
+    LogStatusMaster *master = &page->master;
+    publishState(&master->sequence, &master->state, &master->transitions, &master->counts[0][0],
+                 &master->enteredNs, MASTESR_STATE_MAX, (uint32_t)state);
+}
+
+void logStatusSetSlaveState(SlaveStates state) {
+    LogStatusPage *page = __atomic_load_n(&page_, __ATOMIC_ACQUIRE);
+    if (page == NULL) {
+        return;
+    }
+    LogStatusSlave *slave = &page->slave;
+    publishState(&slave->sequence, &slave->state, &slave->transitions, &slave->counts[0][0],
+                 &slave->enteredNs, SLAVE_STATE_MAX, (uint32_t)state);
+}
+
+void logStatusHeartbeat(void) {
+    LogStatusPage *page = __atomic_load_n(&page_, __ATOMIC_ACQUIRE);
+    if (page == NULL) {
+        return;
+    }
+
+    LogStatusTask *slot = taskSlot_;
+    if (slot == NULL) {
+        const char *name = (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) ? "Main" : pcTaskGetName(NULL);
+        slot = claimSlot(page, name);
+        taskSlot_ = slot;
+    }
+    if (slot == LOG_STATUS_NO_SLOT) {
+        return;
+    }
+
+    beginWrite(&slot->sequence);
+    storeField(&slot->heartbeats, slot->heartbeats + 1);
+    storeTime(&slot->lastHeartbeatNs, logTimestampMonotonicNs());
+    endWrite(&slot->sequence);
+}
+
+#else
+
+RetVal_t logStatusInit(const char *path) {
+    (void)path;
+    return RET_ERROR;
+}
+
+void logStatusSetMasterState(MasterStates state) {
+    (void)state;
+}
+
+void logStatusSetSlaveState(SlaveStates state) {
+    (void)state;
+}
+
+void logStatusHeartbeat(void) {
+}
+
+#endif
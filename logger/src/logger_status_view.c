@@ -0,0 +1,96 @@
+#include <sched.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "logger_status.h"
+#include "logger_cfg.h"
+
+/**
+ * @file logger_status_view.c
+ * @brief Implements the reader side of the shared-memory status page.
+ *
+ * A snapshot is plain loads from the mapping. The reader only yields the CPU
+ * when it finds a section in the middle of an update, which happens when the
+ * writing task was preempted inside its write section.
+ */
+
+/**
+ * @brief Copies one section consistently.
+ *
+ * Every section starts with its sequence lock.
+ *
+ * @return RET_OK on success, RET_ERROR if the section kept changing.
+ */
+static RetVal_t readSection(const void *section, void *copy, size_t size) {
+    const uint32_t *sequence = (const uint32_t *)section;
+
+    for (uint32_t attempt = 0; attempt < LOG_STATUS_READ_RETRIES; attempt++) {
+        uint32_t begin = __atomic_load_n(sequence, __ATOMIC_ACQUIRE);
+        if ((begin & 1u) == 0) {
+            memcpy(copy, section, size);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(sequence, __ATOMIC_RELAXED) == begin) {
+                return RET_OK;
+            }
+        }
+        (void)sched_yield();
+    }
+    return RET_ERROR;
+}
+
+RetVal_t logStatusOpenView(const char *path, const LogStatusPage **page) {
+    struct stat info;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return RET_ERROR;
+    }
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(LogStatusPage)) {
+        close(fd);
+        return RET_ERROR;
+    }
+    void *base = mmap(NULL, sizeof(LogStatusPage), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return RET_ERROR;
+    }
+
+    const LogStatusPage *mapped = (const LogStatusPage *)base;
+    if (__atomic_load_n(&mapped->header.magic, __ATOMIC_ACQUIRE) != LOG_STATUS_MAGIC ||
+        mapped->header.version != LOG_STATUS_VERSION || mapped->header.taskSlots != LOG_STATUS_TASKS) {
+        munmap(base, sizeof(LogStatusPage));
+        return RET_ERROR;
+    }
+    *page = mapped;
+    return RET_OK;
+}
+
+void logStatusCloseView(const LogStatusPage *page) {
+    if (page != NULL) {
+        munmap((void *)page, sizeof(LogStatusPage));
+    }
+}
+
+RetVal_t logStatusRead(const LogStatusPage *page, LogStatusSnapshot *snapshot) {
+    LogStatusTask task;
+
+    snapshot->pid = page->header.pid;
+    if (readSection(&page->master, &snapshot->master, sizeof(snapshot->master)) != RET_OK ||
+        readSection(&page->slave, &snapshot->slave, sizeof(snapshot->slave)) != RET_OK) {
+        return RET_ERROR;
+    }
+
+    snapshot->taskCount = 0;
+    for (uint32_t i = 0; i < LOG_STATUS_TASKS; i++) {
+        if (readSection(&page->tasks[i], &task, sizeof(task)) != RET_OK) {
+            return RET_ERROR;
+        }
+        if (task.sequence != 0) {
+            task.name[LOG_STATUS_TASK_NAME_SIZE - 1] = '\0';
+            snapshot->tasks[snapshot->taskCount++] = task;
+        }
+    }
+    return RET_OK;
+}
@@ -0,0 +1,231 @@
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include "logger_stream.h"
+#include "logger_timestamp.h"
+#include "logger_cfg.h"
+
+/**
+ * @file logger_stream.c
+ * @brief Implements the collector socket stream.
+ *
+ * The queue is a circular array of record slots. A batch is sent with one iovec
+ * per record, starting inside the first slot when the previous send was partial.
+ */
+
+#if (LOG_STREAM_QUEUE_SIZE & (LOG_STREAM_QUEUE_SIZE - 1)) != 0
+#error "LOG_STREAM_QUEUE_SIZE must be a power of two"
+#endif
+
+#define LOG_STREAM_QUEUE_MASK (LOG_STREAM_QUEUE_SIZE - 1)
+#define NS_PER_MS 1000000ull
+
+/**
+ * @brief One queued record.
+ */
+typedef struct {
+    uint16_t length;
+    char data[LOG_RECORD_SIZE];
+} LogStreamSlot;
+
+/**
+ * @brief State of the stream.
+ *
+ * - fd: Connected socket, or -1.
+ * - head: Index of the oldest queued record (free-running).
+ * - tail: Index of the next free slot (free-running).
+ * - sentOffset: Bytes of the oldest record already sent.
+ * - resync: Set when records were dropped; the connect hook runs again once the queue is empty.
+ * - nextConnectNs: Monotonic time of the next connection attempt.
+ * - dropped: Records dropped since the last logStreamTakeDropped().
+ * - droppedTotal: Records dropped since start-up.
+ * - connectHook: Hook called after each connection.
+ * - slots: Queued records.
+ */
+typedef struct {
+    int fd;
+    uint32_t head;
+    uint32_t tail;
+    uint16_t sentOffset;
+    uint8_t resync;
+    uint64_t nextConnectNs;
+    uint32_t dropped;
+    uint32_t droppedTotal;
+    LogStreamConnectHook connectHook;
+    LogStreamSlot slots[LOG_STREAM_QUEUE_SIZE];
+} LogStreamState;
+
+static LogStreamState stream_ = {.fd = -1};
+
+static void countDropped(uint32_t count) {
+    if (count == 0) {
+        return;
+    }
+    stream_.dropped += count;
+    __atomic_add_fetch(&stream_.droppedTotal, count, __ATOMIC_RELAXED);
+    stream_.resync = 1;
+}
+
+/**
+ * @brief Runs the connect hook in front of an empty queue.
+ */
+static void sendPreamble(void) {
+    stream_.resync = 0;
+    if (stream_.connectHook != NULL) {
+        stream_.connectHook();
+    }
+}
+
+static void disconnect(void) {
+    if (stream_.fd >= 0) {
+        close(stream_.fd);
+        stream_.fd = -1;
+    }
+
+    // Queued records are lost with the connection, a partially sent one included
+    countDropped(stream_.tail - stream_.head);
+    stream_.head = stream_.tail;
+    stream_.sentOffset = 0;
+    stream_.nextConnectNs = logTimestampMonotonicNs() + LOG_STREAM_RECONNECT_MS * NS_PER_MS;
+}
+
+/**
+ * @brief Connects to the collector if the reconnect interval has elapsed.
+ */
+static void connectIfDue(void) {
+    uint64_t now = logTimestampMonotonicNs();
+    if (now < stream_.nextConnectNs) {
+        return;
+    }
+    stream_.nextConnectNs = now + LOG_STREAM_RECONNECT_MS * NS_PER_MS;
+
+    // Non-blocking from the start, so an absent or busy collector never stalls the flush task
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd < 0) {
+        return;
+    }
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, LOG_STREAM_SOCKET_PATH, sizeof(address.sun_path) - 1);
+
+    // No collector (ENOENT, ECONNREFUSED), a full backlog (EAGAIN) or a connection
+    // still in progress (EINPROGRESS): the collector is not available, retry later
+    if (connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0) {
+        close(fd);
+        return;
+    }
+
+    int sendBuffer = LOG_STREAM_SOCKET_BUFFER_SIZE;
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sendBuffer, sizeof(sendBuffer));
+
+    stream_.fd = fd;
+    sendPreamble();
+}
+
+void logStreamInit(LogStreamConnectHook connectHook) {
+    stream_.connectHook = connectHook;
+    stream_.nextConnectNs = 0;
+    connectIfDue();
+}
+
+void logStreamAppend(const char *data, uint16_t length) {
+    if (stream_.fd < 0 || length == 0) {
+        return;
+    }
+    if (stream_.tail - stream_.head == LOG_STREAM_QUEUE_SIZE) {
+        countDropped(1);
+        return;
+    }
+
+    LogStreamSlot *slot = &stream_.slots[stream_.tail & LOG_STREAM_QUEUE_MASK];
+    slot->length = (length > LOG_RECORD_SIZE) ? LOG_RECORD_SIZE : length;
+    memcpy(slot->data, data, slot->length);
+    stream_.tail++;
+}
+
+/**
+ * @brief Sends one batch of queued records.
+ *
+ * @return 1 if the whole batch was accepted (more may follow), 0 otherwise.
+ */
+static uint8_t sendBatch(void) {
+    struct iovec iov[LOG_STREAM_BATCH_RECORDS];
+    uint32_t count = stream_.tail - stream_.head;
+    if (count > LOG_STREAM_BATCH_RECORDS) {
+        count = LOG_STREAM_BATCH_RECORDS;
+    }
+
+    size_t total = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        LogStreamSlot *slot = &stream_.slots[(stream_.head + i) & LOG_STREAM_QUEUE_MASK];
+        uint16_t skip = (i == 0) ? stream_.sentOffset : 0;
+        iov[i].iov_base = slot->data + skip;
+        iov[i].iov_len = slot->length - skip;
+        total += iov[i].iov_len;
+    }
+
+    // sendmsg() is writev() with flags: no SIGPIPE when the collector has gone away
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = iov;
+    message.msg_iovlen = count;
+    ssize_t sent = sendmsg(stream_.fd, &message, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (sent < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            disconnect();
+        }
+        return 0;
+    }
+
+    // Release the records sent completely; remember how far the last one got
+    size_t remaining = (size_t)sent;
+    for (uint32_t i = 0; i < count && remaining >= iov[i].iov_len; i++) {
+        remaining -= iov[i].iov_len;
+        stream_.head++;
+        stream_.sentOffset = 0;
+    }
+    stream_.sentOffset += (uint16_t)remaining;
+    return (size_t)sent == total;
+}
+
+void logStreamFlush(void) {
+    if (stream_.fd < 0) {
+        connectIfDue();
+        if (stream_.fd < 0) {
+            return;
+        }
+    }
+
+    while (stream_.tail != stream_.head && sendBatch()) {
+    }
+
+    if (stream_.fd >= 0 && stream_.resync && stream_.tail == stream_.head) {
+        sendPreamble();
+        while (stream_.tail != stream_.head && sendBatch()) {
+        }
+    }
+}
+
+uint32_t logStreamTakeDropped(void) {
+    uint32_t dropped = stream_.dropped;
+    stream_.dropped = 0;
+    return dropped;
+}
+
+uint32_t logStreamDroppedTotal(void) {
+    return __atomic_load_n(&stream_.droppedTotal, __ATOMIC_RELAXED);
+}
+
+void logStreamClose(void) {
+    if (stream_.fd >= 0) {
+        close(stream_.fd);
+        stream_.fd = -1;
+    }
+    stream_.head = stream_.tail;
+    stream_.sentOffset = 0;
+}
@@ -0,0 +1,79 @@
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include "logger_timestamp.h"
+
+/**
+ * @file logger_timestamp.c
+ * @brief Implements the timestamp service.
+ */
+
+#define NS_PER_SECOND 1000000000ull
+
+/**
+ * @brief Length of the cached "YYYY-MM-DD HH:MM:SS" text.
+ */
+#define LOG_TIMESTAMP_SECOND_LENGTH 19
+
+/**
+ * @brief Wall-clock and monotonic times sampled together at start-up.
+ */
+typedef struct {
+    struct timespec realtime;
+    uint64_t monotonicNs;
+} LogTimestampBase;
+
+static LogTimestampBase base_;
+static pthread_once_t baseOnce_ = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Text of the last formatted second, per thread (no locking needed).
+ */
+static __thread int64_t cachedSecond_ = INT64_MIN;
+static __thread char cachedText_[LOG_TIMESTAMP_SECOND_LENGTH + 1];
+
+uint64_t logTimestampMonotonicNs(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * NS_PER_SECOND + (uint64_t)now.tv_nsec;
+}
+
+static void sampleBase(void) {
+    clock_gettime(CLOCK_REALTIME, &base_.realtime);
+    base_.monotonicNs = logTimestampMonotonicNs();
+}
+
+LogTimestamp logTimestampNow(void) {
+    pthread_once(&baseOnce_, sampleBase);
+
+    uint64_t elapsed = logTimestampMonotonicNs() - base_.monotonicNs + (uint64_t)base_.realtime.tv_nsec;
+    LogTimestamp timestamp = {
+        (int64_t)base_.realtime.tv_sec + (int64_t)(elapsed / NS_PER_SECOND),
+        (uint32_t)(elapsed % NS_PER_SECOND)
+    };
+    return timestamp;
+}
+
+size_t logTimestampFormat(const LogTimestamp *timestamp, char *buffer, size_t size) {
+    if (size < LOG_TIMESTAMP_TEXT_SIZE) {
+        return 0;
+    }
+
+    if (timestamp->seconds != cachedSecond_) {
+        time_t seconds = (time_t)timestamp->seconds;
+        struct tm local;
+        localtime_r(&seconds, &local);
+        strftime(cachedText_, sizeof(cachedText_), "%Y-%m-%d %H:%M:%S", &local);
+        cachedSecond_ = timestamp->seconds;
+    }
+
+    memcpy(buffer, cachedText_, LOG_TIMESTAMP_SECOND_LENGTH);
+    buffer[LOG_TIMESTAMP_SECOND_LENGTH] = '.';
+    uint32_t micros = timestamp->nanoseconds / 1000u;
+    for (int32_t digit = 6; digit >= 1; digit--) {
+        buffer[LOG_TIMESTAMP_SECOND_LENGTH + digit] = (char)('0' + micros % 10u);
+        micros /= 10u;
+    }
+    buffer[LOG_TIMESTAMP_TEXT_SIZE - 1] = '\0';
+    return LOG_TIMESTAMP_TEXT_SIZE - 1;
+}
@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "logger_trace.h"
+#include "logger_timestamp.h"
+#include "logger_cfg.h"
+
+/**
+ * @file logger_trace.c
+ * @brief Implements the writer side of the end-to-end traces.
+ *
+ * Recording a span is one atomic increment to claim a slot, one clock read
+ * and one slot written under its sequence lock. Two writers share a slot only
+ * if LOG_TRACE_SPANS spans are recorded while one of them is writing; a
+ * reader then sees the sequence change and skips the slot.
+ */
+
+#if LOG_TRACE_ENABLED
+
+#if (LOG_TRACE_SPANS & (LOG_TRACE_SPANS - 1)) != 0
+#error "LOG_TRACE_SPANS must be a power of two"
+#endif
+
+static LogTracePage *page_ = NULL;
+static uint32_t nextTraceId_ = 0;
+static __thread uint32_t currentTrace_ = 0;
+
+/**
+ * @brief Writes a span into the next slot of the ring.
+ */
+static void recordSpan(LogTracePage *page, uint32_t traceId, LogTraceHop hop, uint32_t value) {
+    uint32_t index = __atomic_fetch_add(&page->header.head, 1, __ATOMIC_RELAXED) & (LOG_TRACE_SPANS - 1);
+    LogTraceSpan *span = &page->spans[index];
+
+    __atomic_fetch_add(&span->sequence, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&span->traceId, traceId, __ATOMIC_RELAXED);
+    __atomic_store_n(&span->timeNs, logTimestampMonotonicNs(), __ATOMIC_RELAXED);
+    __atomic_store_n(&span->hop, (uint32_t)hop, __ATOMIC_RELAXED);
+    __atomic_store_n(&span->value, value, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&span->sequence, 1, __ATOMIC_RELEASE);
+}
+
+RetVal_t logTraceInit(const char *path) {
+    if (page_ != NULL) {
+        return RET_OK;
+    }
+
+    (void)unlink(path);
+    int fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        perror("Failed to create trace file");
+        return RET_ERROR;
+    }
+    if (ftruncate(fd, sizeof(LogTracePage)) != 0) {
+        perror("Failed to size trace file");
+        close(fd);
+        (void)unlink(path);
+        return RET_ERROR;
+    }
+    void *base = mmap(NULL, sizeof(LogTracePage), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        perror("Failed to map trace file");
+        (void)unlink(path);
+        return RET_ERROR;
+    }
+
+    // The file starts zeroed, so every slot starts unused
+    LogTracePage *page = (LogTracePage *)base;
+    page->header.version = LOG_TRACE_VERSION;
+    page->header.pid = (uint32_t)getpid();
+    page->header.spanSlots = LOG_TRACE_SPANS;
+    __atomic_store_n(&page->header.magic, LOG_TRACE_MAGIC, __ATOMIC_RELEASE);
+
+    __atomic_store_n(&page_, page, __ATOMIC_RELEASE);
+    return RET_OK;
+}
+
+uint32_t logTraceBegin(LogTraceHop hop, uint32_t value) {
+    LogTracePage *page = __atomic_load_n(&page_, __ATOMIC_ACQUIRE);
+    if (page == NULL) {
+        return 0;
+    }
+
+    uint32_t traceId = __atomic_add_fetch(&nextTraceId_, 1, __ATOMIC_RELAXED);
+    if (traceId == 0) {
+        // 0 means untraced; skip it when the ids wrap around
+        traceId = __atomic_add_fetch(&nextTraceId_, 1, __ATOMIC_RELAXED);
+    }
+    recordSpan(page, traceId, hop, value);
+    return traceId;
+}
+
+void logTraceSpan(uint32_t traceId, LogTraceHop hop, uint32_t value) {
+    LogTracePage *page = __atomic_load_n(&page_, __ATOMIC_ACQUIRE);
+    if (page == NULL || traceId == 0 || hop >= LOG_TRACE_HOP_MAX) {
+        return;
+    }
+    recordSpan(page, traceId, hop, value);
+}
+
+void logTraceSetCurrent(uint32_t traceId) {
+    currentTrace_ = traceId;
+}
+
+uint32_t logTraceCurrent(void) {
+    return currentTrace_;
+}
+
+#else
+
+RetVal_t logTraceInit(const char *path) {
+    (void)path;
+    return RET_ERROR;
+}
+
+uint32_t logTraceBegin(LogTraceHop hop, uint32_t value) {
+    (void)hop;
+    (void)value;
+    return 0;
+}
+
+void logTraceSpan(uint32_t traceId, LogTraceHop hop, uint32_t value) {
+    (void)traceId;
+    (void)hop;
+    (void)value;
+}
+
+void logTraceSetCurrent(uint32_t traceId) {
+    (void)traceId;
+}
+
+uint32_t logTraceCurrent(void) {
+    return 0;
+}
+
+#endif
@@ -0,0 +1,65 @@
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "logger_trace.h"
+#include "logger_cfg.h"
+
+/**
+ * @file logger_trace_view.c
+ * @brief Implements the reader side of the end-to-end traces.
+ *
+ * A span slot is read once: a slot that is being written, or was rewritten
+ * while it was copied, is skipped instead of retried, because by then it
+ * holds a newer span that the next read picks up.
+ */
+
+RetVal_t logTraceOpenView(const char *path, const LogTracePage **page) {
+    struct stat info;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return RET_ERROR;
+    }
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(LogTracePage)) {
+        close(fd);
+        return RET_ERROR;
+    }
+    void *base = mmap(NULL, sizeof(LogTracePage), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return RET_ERROR;
+    }
+
+    const LogTracePage *mapped = (const LogTracePage *)base;
+    if (__atomic_load_n(&mapped->header.magic, __ATOMIC_ACQUIRE) != LOG_TRACE_MAGIC ||
+        mapped->header.version != LOG_TRACE_VERSION || mapped->header.spanSlots != LOG_TRACE_SPANS) {
+        munmap(base, sizeof(LogTracePage));
+        return RET_ERROR;
+    }
+    *page = mapped;
+    return RET_OK;
+}
+
+void logTraceCloseView(const LogTracePage *page) {
+    if (page != NULL) {
+        munmap((void *)page, sizeof(LogTracePage));
+    }
+}
+
+void logTraceRead(const LogTracePage *page, LogTraceSpan *spans, uint32_t capacity, uint32_t *count) {
+    *count = 0;
+    for (uint32_t i = 0; i < LOG_TRACE_SPANS && *count < capacity; i++) {
+        const LogTraceSpan *slot = &page->spans[i];
+        uint32_t begin = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        if (begin == 0 || (begin & 1u) != 0) {
+            continue;
+        }
+        memcpy(&spans[*count], slot, sizeof(*slot));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) == begin && spans[*count].hop < LOG_TRACE_HOP_MAX) {
+            (*count)++;
+        }
+    }
+}
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include <cstdarg>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+extern "C" {
+    #include "logger_binary.h"
+    #include "logger_cfg.h"
+}
+
+// Session start used by the tests: 2026-10-17 05:18:36 UTC
+#define TEST_START_EPOCH 1792214316
+#define TEST_TICK_RATE_HZ 1000
+
+// ==========================
+// Test Fixture
+// ==========================
+// Encodes records into a binary stream and decodes the stream back into text lines
+class LoggerBinaryTest : public ::testing::Test {
+protected:
+    std::vector<char> stream_;
+
+    void SetUp() override {
+        setenv("TZ", "UTC", 1);
+        tzset();
+        logBinaryInit();
+        stream_.clear();
+    }
+
+    void appendSession() {
+        char buffer[LOG_RECORD_SIZE];
+        uint16_t length = logBinaryEncodeSession(buffer, sizeof(buffer), TEST_TICK_RATE_HZ, TEST_START_EPOCH);
+        ASSERT_NE(length, 0u);
+        stream_.insert(stream_.end(), buffer, buffer + length);
+    }
+
+    // Encodes one log call and appends its records to the stream; returns the number of bytes written
+    uint16_t appendMessage(uint32_t tick, LogLevel level, const char* component, const char* format, ...) {
+        char buffer[LOG_RECORD_SIZE];
+        va_list args;
+        va_start(args, format);
+        uint16_t length = logBinaryEncodeMessage(buffer, sizeof(buffer), tick, level, component, format, args);
+        va_end(args);
+        stream_.insert(stream_.end(), buffer, buffer + length);
+        return length;
+    }
+
+    void appendText(uint32_t tick, LogLevel level, const char* component, const char* message) {
+        char buffer[LOG_RECORD_SIZE];
+        uint16_t length = logBinaryEncodeText(buffer, sizeof(buffer), tick, level, component, message);
+        ASSERT_NE(length, 0u);
+        stream_.insert(stream_.end(), buffer, buffer + length);
+    }
+
+    // Repeats all known definitions, as a new log segment does
+    void appendDefinitions() {
+        char buffer[LOG_RECORD_SIZE];
+        uint32_t cursor = 0;
+        uint16_t length;
+        while ((length = logBinaryEncodeNextDefinition(buffer, sizeof(buffer), &cursor)) != 0) {
+            stream_.insert(stream_.end(), buffer, buffer + length);
+        }
+    }
+
+    std::string decode(LogLevel level) {
+        FILE* input = tmpfile();
+        EXPECT_NE(input, nullptr);
+        fwrite(stream_.data(), 1, stream_.size(), input);
+        rewind(input);
+
+        char* text = nullptr;
+        size_t size = 0;
+        FILE* output = open_memstream(&text, &size);
+        EXPECT_EQ(logBinaryDecode(input, output, level), RET_OK);
+        fclose(output);
+        fclose(input);
+
+        std::string lines(text, size);
+        free(text);
+        return lines;
+    }
+
+    // Encodes the arguments alone and formats them back with the same format string
+    static std::string formatArguments(size_t maxString, const char* format, ...) {
+        char payload[LOG_RECORD_SIZE];
+        va_list args;
+        va_start(args, format);
+        int32_t length = logBinaryEncodeArguments(payload, sizeof(payload), maxString, format, args);
+        va_end(args);
+        if (length < 0) {
+            return "<unsupported>";
+        }
+        char out[LOG_RECORD_SIZE];
+        logBinaryFormatArguments(out, sizeof(out), format, payload, (size_t)length);
+        return out;
+    }
+};
+
+// ==========================
+// Unit Tests
+// ==========================
+// Test that a message with each argument type decodes to the line the text logger would write
+TEST_F(LoggerBinaryTest, EncodeMessage_Decode_RoundTrip) {
+    appendSession();
+    appendMessage(1500, LOG_LEVEL_INFO, "Master", "state %d -> %s, uptime %llu ms, load %.2f",
+                  3, "RUNNING", 123456789012ull, 0.75);
+    appendMessage(2000, LOG_LEVEL_WARN, "Slave", "retry %u of %u", 2u, 5u);
+
+    EXPECT_EQ(decode(LOG_LEVEL_DEBUG),
+              "[2026-10-17 05:18:37.500000] [INFO] [Master] state 3 -> RUNNING, uptime 123456789012 ms, load 0.75\n"
+              "[2026-10-17 05:18:38.000000] [WARN] [Slave] retry 2 of 5\n");
+}
+
+// Test that format and component definitions are written only with their first use
+TEST_F(LoggerBinaryTest, EncodeMessage_RepeatedFormat_DefinesOnce) {
+    appendSession();
+    uint16_t first = appendMessage(0, LOG_LEVEL_INFO, "Master", "value %d", 1);
+    uint16_t second = appendMessage(1, LOG_LEVEL_INFO, "Master", "value %d", 2);
+    EXPECT_EQ(second, sizeof(LogBinaryRecordHeader) + sizeof(int32_t));
+    EXPECT_GT(first, second);
+
+    EXPECT_EQ(decode(LOG_LEVEL_DEBUG),
+              "[2026-10-17 05:18:36.000000] [INFO] [Master] value 1\n"
+              "[2026-10-17 05:18:36.001000] [INFO] [Master] value 2\n");
+}
+
+// Test that pre-formatted text and formats that cannot be deferred are stored as text
+TEST_F(LoggerBinaryTest, EncodeText_AndTextOnlyFormat_Decode) {
+    appendSession();
+    appendText(0, LOG_LEVEL_ERROR, "Comm", "link lost");
+    appendMessage(0, LOG_LEVEL_INFO, "Comm", "long double %Lf", (long double)1.5);
+
+    EXPECT_EQ(decode(LOG_LEVEL_DEBUG),
+              "[2026-10-17 05:18:36.000000] [ERROR] [Comm] link lost\n"
+              "[2026-10-17 05:18:36.000000] [INFO] [Comm] long double 1.500000\n");
+}
+
+// Test that messages below the requested level are not printed
+TEST_F(LoggerBinaryTest, Decode_BelowLevel_Skipped) {
+    appendSession();
+    appendMessage(0, LOG_LEVEL_DEBUG, "Master", "debug %d", 1);
+    appendMessage(0, LOG_LEVEL_ERROR, "Master", "error %d", 2);
+
+    EXPECT_EQ(decode(LOG_LEVEL_WARN), "[2026-10-17 05:18:36.000000] [ERROR] [Master] error 2\n");
+}
+
+// Test that a new session repeating the known definitions decodes without the first use of a format
+TEST_F(LoggerBinaryTest, NewSession_RepeatedDefinitions_Decode) {
+    appendSession();
+    appendMessage(0, LOG_LEVEL_INFO, "Master", "count %d", 1);
+    stream_.clear();
+
+    appendSession();
+    appendDefinitions();
+    appendMessage(0, LOG_LEVEL_INFO, "Master", "count %d", 2);
+
+    EXPECT_EQ(decode(LOG_LEVEL_DEBUG), "[2026-10-17 05:18:36.000000] [INFO] [Master] count 2\n");
+}
+
+// Test that encoded arguments format back to the same text, with long strings cut to the limit
+TEST_F(LoggerBinaryTest, EncodeArguments_FormatArguments_RoundTrip) {
+    EXPECT_EQ(formatArguments(64, "%d %5.1f %s %c %lx", -7, 2.25, "slave", 'A', 0xABCDEFl),
+              "-7   2.2 slave A abcdef");
+    EXPECT_EQ(formatArguments(64, "%*d|%-4s|", 4, 42, "ab"), "  42|ab  |");
+    EXPECT_EQ(formatArguments(3, "%s", "truncated"), "tru");
+    EXPECT_EQ(formatArguments(64, "%Lf", (long double)1.0), "<unsupported>");
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
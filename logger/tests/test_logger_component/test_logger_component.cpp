@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+
+extern "C" {
+    #include "logger_component.h"
+    #include "logger_cfg.h"
+    #include "FreeRTOS.h"
+    #include "task.h"
+}
+
+// ==========================
+// C Function Redirection
+// ==========================
+// The registry only locks once the scheduler runs; the tests run without one
+extern "C" {
+    BaseType_t xTaskGetSchedulerState(void) {
+        return taskSCHEDULER_NOT_STARTED;
+    }
+
+    void vPortEnterCritical(void) {
+    }
+
+    void vPortExitCritical(void) {
+    }
+}
+
+// ==========================
+// Unit Tests
+// ==========================
+// The registry is process-wide, so every test uses names of its own
+
+// Test that a name passed in a reused buffer gets the id of its content, not of the buffer
+TEST(LoggerComponentTest, Lookup_ReusedBuffer_ReturnsIdOfContent) {
+    char buffer[LOG_COMPONENT_NAME_SIZE];
+    strcpy(buffer, "ReusedFirst");
+    LogComponentId first = logComponentLookup(buffer);
+    strcpy(buffer, "ReusedSecond");
+    LogComponentId second = logComponentLookup(buffer);
+
+    EXPECT_NE(first, second);
+    EXPECT_STREQ(logComponentName(first), "ReusedFirst");
+    EXPECT_STREQ(logComponentName(second), "ReusedSecond");
+    EXPECT_EQ(logComponentLookup("ReusedFirst"), first);
+    strcpy(buffer, "ReusedFirst");
+    EXPECT_EQ(logComponentLookup(buffer), first);
+}
+
+// Test that a lookup and a registration of the same name agree
+TEST(LoggerComponentTest, LookupAndRegister_SameName_SameId) {
+    LogComponentId registered = logComponentRegister("RegisteredFirst");
+    std::string copy = "RegisteredFirst";
+    EXPECT_EQ(logComponentLookup(copy.c_str()), registered);
+    EXPECT_EQ(logComponentLookup("Other"), (LogComponentId)LOG_COMPONENT_OTHER);
+}
+
+// Test that a component level applies to its own id only and can be reset
+TEST(LoggerComponentTest, SetLevel_OverridesOneComponent) {
+    LogComponentId noisy = logComponentLookup("LevelNoisy");
+    LogComponentId quiet = logComponentLookup("LevelQuiet");
+    logComponentSetLevel(noisy, LOG_LEVEL_DEBUG);
+    logComponentSetDefaultLevel(LOG_LEVEL_ERROR);
+    EXPECT_EQ(logComponentLevel(noisy), LOG_LEVEL_DEBUG);
+    EXPECT_EQ(logComponentLevel(quiet), LOG_LEVEL_ERROR);
+
+    logComponentResetLevel(noisy);
+    EXPECT_EQ(logComponentLevel(noisy), LOG_LEVEL_ERROR);
+    logComponentSetDefaultLevel((LogLevel)LOG_DEFAULT_LEVEL);
+}
+
+// Test that names past a full table share LOG_COMPONENT_OTHER and the registered ones keep their ids
+TEST(LoggerComponentTest, Lookup_FullTable_ReturnsOther) {
+    LogComponentId known = logComponentLookup("FullKnown");
+    for (uint32_t i = 0; i < LOG_COMPONENT_MAX; i++) {
+        (void)logComponentLookup(("FullFiller" + std::to_string(i)).c_str());
+    }
+    EXPECT_EQ(logComponentLookup("FullLate"), (LogComponentId)LOG_COMPONENT_OTHER);
+    EXPECT_EQ(logComponentRegister("FullLate"), (LogComponentId)LOG_COMPONENT_OTHER);
+    EXPECT_EQ(logComponentLookup("FullKnown"), known);
+    EXPECT_STREQ(logComponentName(known), "FullKnown");
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
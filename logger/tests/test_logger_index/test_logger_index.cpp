@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+extern "C" {
+    #include "logger.h"
+    #include "logger_index.h"
+    #include "logger_cfg.h"
+}
+
+// Records added by the tests: full-size text records
+#define TEST_RECORD_LENGTH LOG_RECORD_SIZE
+#define TEST_RECORDS_PER_BLOCK ((LOG_INDEX_BLOCK_SIZE + TEST_RECORD_LENGTH - 1) / TEST_RECORD_LENGTH)
+#define TEST_START_TIME 1792214316
+
+// ==========================
+// Test Fixture
+// ==========================
+// Each test runs in its own temporary directory (LOG_SEGMENT_DIR is ".") and indexes its own segment
+// sequence, because the index writer keeps its state between tests
+class LoggerIndexTest : public ::testing::Test {
+protected:
+    static uint32_t nextSequence_;
+    std::filesystem::path previousDir_;
+    std::filesystem::path dir_;
+    uint32_t sequence_ = 0;
+
+    void SetUp() override {
+        char pattern[] = "/tmp/test_logger_index_XXXXXX";
+        ASSERT_NE(mkdtemp(pattern), nullptr);
+        dir_ = pattern;
+        previousDir_ = std::filesystem::current_path();
+        std::filesystem::current_path(dir_);
+        sequence_ = nextSequence_;
+        nextSequence_ += 2;
+    }
+
+    void TearDown() override {
+        std::filesystem::current_path(previousDir_);
+        std::filesystem::remove_all(dir_);
+    }
+
+    // Adds the record at index 'record' of a segment, one second after the previous one
+    static void addRecord(uint32_t sequence, uint32_t record, LogLevel level, const char* component) {
+        LogSegmentLocation location = {sequence, record * TEST_RECORD_LENGTH};
+        LogRecordInfo info = {};
+        info.timestamp = TEST_START_TIME + record;
+        info.level = (uint8_t)level;
+        info.componentBit = logIndexComponentBit(component);
+        logIndexAdd(&location, TEST_RECORD_LENGTH, &info);
+    }
+
+    static void writeIndex(uint32_t sequence, const LogIndexHeader& header, const LogIndexBlock& block) {
+        char path[256];
+        logSegmentIndexPath(path, sizeof(path), sequence);
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(&block), sizeof(block));
+    }
+};
+
+uint32_t LoggerIndexTest::nextSequence_ = 0;
+
+// ==========================
+// Unit Tests
+// ==========================
+// Test that complete blocks are written with their position, time range, levels and components
+TEST_F(LoggerIndexTest, Add_CompleteBlocks_AreWrittenToSidecar) {
+    for (uint32_t record = 0; record < 2 * TEST_RECORDS_PER_BLOCK; record++) {
+        addRecord(sequence_, record, record == 0 ? LOG_LEVEL_ERROR : LOG_LEVEL_INFO,
+                  record < TEST_RECORDS_PER_BLOCK ? "Master" : "Slave");
+    }
+    // Records of the block being filled are not indexed yet
+    addRecord(sequence_, 2 * TEST_RECORDS_PER_BLOCK, LOG_LEVEL_WARN, "Slave");
+
+    LogIndexBlock* blocks = nullptr;
+    ASSERT_EQ(logIndexLoad(sequence_, 3 * LOG_INDEX_BLOCK_SIZE, &blocks), 2u);
+    EXPECT_EQ(blocks[0].offset, 0u);
+    EXPECT_EQ(blocks[0].length, TEST_RECORDS_PER_BLOCK * TEST_RECORD_LENGTH);
+    EXPECT_EQ(blocks[0].records, (uint32_t)TEST_RECORDS_PER_BLOCK);
+    EXPECT_EQ(blocks[0].minTime, TEST_START_TIME);
+    EXPECT_EQ(blocks[0].maxTime, TEST_START_TIME + TEST_RECORDS_PER_BLOCK - 1);
+    EXPECT_EQ(blocks[0].levelMask, (1u << LOG_LEVEL_ERROR) | (1u << LOG_LEVEL_INFO));
+    EXPECT_EQ(blocks[0].componentMask, 1ull << logIndexComponentBit("Master"));
+
+    EXPECT_EQ(blocks[1].offset, blocks[0].length);
+    EXPECT_EQ(blocks[1].minTime, TEST_START_TIME + TEST_RECORDS_PER_BLOCK);
+    EXPECT_EQ(blocks[1].levelMask, 1u << LOG_LEVEL_INFO);
+    EXPECT_EQ(blocks[1].componentMask, 1ull << logIndexComponentBit("Slave"));
+    free(blocks);
+}
+
+// Test that a record in the next segment completes the index of the previous one
+TEST_F(LoggerIndexTest, Add_NextSegment_CompletesPreviousIndex) {
+    addRecord(sequence_, 0, LOG_LEVEL_INFO, "Master");
+    addRecord(sequence_, 1, LOG_LEVEL_DEBUG, "Master");
+    addRecord(sequence_ + 1, 0, LOG_LEVEL_INFO, "Master");
+
+    LogIndexBlock* blocks = nullptr;
+    ASSERT_EQ(logIndexLoad(sequence_, 2 * TEST_RECORD_LENGTH, &blocks), 1u);
+    EXPECT_EQ(blocks[0].offset, 0u);
+    EXPECT_EQ(blocks[0].length, 2u * TEST_RECORD_LENGTH);
+    EXPECT_EQ(blocks[0].records, 2u);
+    EXPECT_EQ(blocks[0].levelMask, (1u << LOG_LEVEL_INFO) | (1u << LOG_LEVEL_DEBUG));
+    free(blocks);
+}
+
+// Test that entries pointing past the segment data are dropped
+TEST_F(LoggerIndexTest, Load_EntryPastSegmentData_IsDropped) {
+    for (uint32_t record = 0; record < 2 * TEST_RECORDS_PER_BLOCK; record++) {
+        addRecord(sequence_, record, LOG_LEVEL_INFO, "Master");
+    }
+    addRecord(sequence_ + 1, 0, LOG_LEVEL_INFO, "Master");
+
+    LogIndexBlock* blocks = nullptr;
+    EXPECT_EQ(logIndexLoad(sequence_, 2 * TEST_RECORDS_PER_BLOCK * TEST_RECORD_LENGTH - 1, &blocks), 1u);
+    free(blocks);
+}
+
+// Test that a missing index or one of another version or segment yields no entries
+TEST_F(LoggerIndexTest, Load_MissingOrInvalidIndex_NoEntries) {
+    LogIndexBlock block = {0, TEST_RECORD_LENGTH, TEST_START_TIME, TEST_START_TIME, 1, 1u << LOG_LEVEL_INFO, {0}, 1};
+    LogIndexBlock* blocks = nullptr;
+    EXPECT_EQ(logIndexLoad(sequence_, LOG_SEGMENT_SIZE, &blocks), 0u);
+    EXPECT_EQ(blocks, nullptr);
+
+    writeIndex(sequence_, {LOG_INDEX_MAGIC, LOG_INDEX_VERSION, 0, sequence_}, block);
+    ASSERT_EQ(logIndexLoad(sequence_, LOG_SEGMENT_SIZE, &blocks), 1u);
+    free(blocks);
+
+    writeIndex(sequence_, {LOG_INDEX_MAGIC, LOG_INDEX_VERSION + 1, 0, sequence_}, block);
+    EXPECT_EQ(logIndexLoad(sequence_, LOG_SEGMENT_SIZE, &blocks), 0u);
+    writeIndex(sequence_, {LOG_INDEX_MAGIC, LOG_INDEX_VERSION, 0, sequence_ + 1}, block);
+    EXPECT_EQ(logIndexLoad(sequence_, LOG_SEGMENT_SIZE, &blocks), 0u);
+    EXPECT_EQ(blocks, nullptr);
+}
+
+// Test that a component always maps to the same filter bit
+TEST_F(LoggerIndexTest, ComponentBit_IsStableAndInRange) {
+    EXPECT_EQ(logIndexComponentBit("Master"), logIndexComponentBit("Master"));
+    EXPECT_LT(logIndexComponentBit("Master"), 64u);
+    EXPECT_LT(logIndexComponentBit(""), 64u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
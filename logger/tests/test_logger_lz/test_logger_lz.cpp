@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+extern "C" {
+    #include "logger_lz.h"
+    #include "logger_cfg.h"
+}
+
+// ==========================
+// Test Fixture
+// ==========================
+// Compresses blocks with a shared state and checks that they decompress to the same bytes
+class LoggerLzTest : public ::testing::Test {
+protected:
+    LogLzState state_;
+
+    // Log-like text: the same line shape with a changing counter
+    static std::vector<char> logText(size_t size) {
+        std::vector<char> data;
+        data.reserve(size);
+        for (uint32_t line = 0; data.size() < size; line++) {
+            std::string text = "[2026-10-17 05:18:36.869913] [INFO] [SlaveStateMachine] New state is " +
+                               std::to_string(line % 4) + "\n";
+            for (char c : text) {
+                if (data.size() == size) {
+                    break;
+                }
+                data.push_back(c);
+            }
+        }
+        return data;
+    }
+
+    // Pseudo-random bytes (xorshift32), which leave no match to find
+    static std::vector<char> randomBytes(size_t size) {
+        std::vector<char> data(size);
+        uint32_t seed = 0x12345678u;
+        for (size_t i = 0; i < size; i++) {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            data[i] = (char)(seed & 0xFFu);
+        }
+        return data;
+    }
+
+    // Compresses into a buffer of the worst-case size and returns the compressed block
+    std::vector<char> compress(const std::vector<char>& data) {
+        std::vector<char> block(LOG_LZ_BOUND(data.size()));
+        size_t length = logLzCompress(&state_, data.data(), data.size(), block.data(), block.size());
+        EXPECT_NE(length, 0u);
+        block.resize(length);
+        return block;
+    }
+
+    void expectRoundTrip(const std::vector<char>& data, const std::vector<char>& block) {
+        std::vector<char> decoded(data.size() + 1, 0);
+        ASSERT_EQ(logLzDecompress(block.data(), block.size(), decoded.data(), data.size()), RET_OK);
+        decoded.resize(data.size());
+        EXPECT_EQ(decoded, data);
+    }
+};
+
+// ==========================
+// Unit Tests
+// ==========================
+// Test that repetitive log text shrinks and decompresses to the same bytes
+TEST_F(LoggerLzTest, Compress_CompressibleText_RoundTrips) {
+    std::vector<char> data = logText(4096);
+    std::vector<char> block = compress(data);
+    EXPECT_LT(block.size(), data.size() / 4);
+    expectRoundTrip(data, block);
+}
+
+// Test that data without matches grows by no more than LOG_LZ_BOUND and still round-trips
+TEST_F(LoggerLzTest, Compress_IncompressibleData_StaysWithinBound) {
+    std::vector<char> data = randomBytes(4096);
+    std::vector<char> block = compress(data);
+    EXPECT_GE(block.size(), data.size());
+    EXPECT_LE(block.size(), LOG_LZ_BOUND(data.size()));
+    expectRoundTrip(data, block);
+}
+
+// Test that an empty block compresses to a token alone and decompresses to nothing
+TEST_F(LoggerLzTest, Compress_EmptyBlock_RoundTrips) {
+    std::vector<char> data;
+    std::vector<char> block = compress(data);
+    EXPECT_EQ(block.size(), 1u);
+    expectRoundTrip(data, block);
+}
+
+// Test the largest frame of a compressed segment, compressible and not
+TEST_F(LoggerLzTest, Compress_MaxSizeBlock_RoundTrips) {
+    std::vector<char> text = logText(LOG_INDEX_BLOCK_SIZE);
+    std::vector<char> textBlock = compress(text);
+    EXPECT_LT(textBlock.size(), text.size());
+    expectRoundTrip(text, textBlock);
+
+    std::vector<char> random = randomBytes(LOG_INDEX_BLOCK_SIZE);
+    std::vector<char> randomBlock = compress(random);
+    EXPECT_LE(randomBlock.size(), LOG_LZ_BOUND(random.size()));
+    expectRoundTrip(random, randomBlock);
+}
+
+// Test that a destination buffer too small for the block is reported instead of overrun
+TEST_F(LoggerLzTest, Compress_DestinationTooSmall_ReturnsZero) {
+    std::vector<char> data = randomBytes(1024);
+    std::vector<char> block(data.size() / 2);
+    EXPECT_EQ(logLzCompress(&state_, data.data(), data.size(), block.data(), block.size()), 0u);
+}
+
+// Test that a truncated block or a wrong expected size fails to decompress
+TEST_F(LoggerLzTest, Decompress_CorruptedBlock_ReturnsRET_ERROR) {
+    std::vector<char> data = logText(1024);
+    std::vector<char> block = compress(data);
+    std::vector<char> decoded(data.size());
+    EXPECT_EQ(logLzDecompress(block.data(), block.size() / 2, decoded.data(), data.size()), RET_ERROR);
+    EXPECT_EQ(logLzDecompress(block.data(), block.size(), decoded.data(), data.size() - 1), RET_ERROR);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
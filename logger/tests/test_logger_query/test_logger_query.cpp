@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+extern "C" {
+    #include "logger.h"
+    #include "logger_query.h"
+    #include "logger_index.h"
+    #include "logger_segment.h"
+    #include "logger_timestamp.h"
+    #include "logger_cfg.h"
+}
+
+// Log written by the tests: one record per second, spread over a sealed and an active segment
+#define TEST_START_TIME 1792214316
+#define TEST_RECORD_COUNT 3000
+#define TEST_SEALED_RECORDS 2000
+
+static const char* testLevels[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+static const char* testComponents[] = {"Master", "Slave", "Comm"};
+
+// ==========================
+// Test Fixture
+// ==========================
+// The log is written once, the way the logger writes it, and every test runs queries over it
+class LoggerQueryTest : public ::testing::Test {
+protected:
+    struct Record {
+        int64_t timestamp;
+        LogLevel level;
+        std::string component;
+        std::string line;
+    };
+
+    static std::filesystem::path previousDir_;
+    static std::filesystem::path dir_;
+    static std::vector<Record> records_;
+
+    static void SetUpTestSuite() {
+        setenv("TZ", "UTC", 1);
+        tzset();
+        char pattern[] = "/tmp/test_logger_query_XXXXXX";
+        ASSERT_NE(mkdtemp(pattern), nullptr);
+        dir_ = pattern;
+        previousDir_ = std::filesystem::current_path();
+        std::filesystem::current_path(dir_);
+
+        ASSERT_EQ(logSegmentInit(NULL), RET_OK);
+        for (uint32_t i = 0; i < TEST_RECORD_COUNT; i++) {
+            // Sealing the first segment leaves the rest of the log in an active, zero-filled one
+            if (i == TEST_SEALED_RECORDS) {
+                ASSERT_EQ(logSegmentInit(NULL), RET_OK);
+            }
+            writeRecord(TEST_START_TIME + i, (LogLevel)(i % 4), testComponents[i % 3], i);
+        }
+    }
+
+    static void TearDownTestSuite() {
+        std::filesystem::current_path(previousDir_);
+        std::filesystem::remove_all(dir_);
+    }
+
+    static void writeRecord(int64_t timestamp, LogLevel level, const char* component, uint32_t number) {
+        LogTimestamp when = {timestamp, 0};
+        char text[LOG_TIMESTAMP_TEXT_SIZE];
+        logTimestampFormat(&when, text, sizeof(text));
+        std::string line = "[" + std::string(text) + "] [" + testLevels[level] + "] [" + component +
+                           "] record " + std::to_string(number) + "\n";
+
+        LogSegmentLocation location;
+        ASSERT_EQ(logSegmentWrite(line.data(), (uint16_t)line.size(), &location), RET_OK);
+        LogRecordInfo info = {};
+        info.timestamp = timestamp;
+        info.level = (uint8_t)level;
+        info.componentBit = logIndexComponentBit(component);
+        logIndexAdd(&location, (uint16_t)line.size(), &info);
+        records_.push_back({timestamp, level, component, line});
+    }
+
+    // Lines the query must print, in log order
+    static std::string expected(const LogQuery& query) {
+        std::string lines;
+        for (const Record& record : records_) {
+            if (record.level >= query.level &&
+                (query.component == NULL || record.component == query.component) &&
+                (query.from == 0 || record.timestamp >= query.from) &&
+                (query.until == 0 || record.timestamp <= query.until)) {
+                lines += record.line;
+            }
+        }
+        return lines;
+    }
+
+    static std::string run(const LogQuery& query, uint32_t threads) {
+        char* text = nullptr;
+        size_t size = 0;
+        FILE* output = open_memstream(&text, &size);
+        EXPECT_EQ(logQueryRun(&query, threads, output), RET_OK);
+        fclose(output);
+        std::string lines(text, size);
+        free(text);
+        return lines;
+    }
+};
+
+std::filesystem::path LoggerQueryTest::previousDir_;
+std::filesystem::path LoggerQueryTest::dir_;
+std::vector<LoggerQueryTest::Record> LoggerQueryTest::records_;
+
+// ==========================
+// Unit Tests
+// ==========================
+// Test that a query without filters prints the whole log in order
+TEST_F(LoggerQueryTest, Run_NoFilter_PrintsAllRecords) {
+    LogQuery query = {LOG_LEVEL_DEBUG, NULL, 0, 0};
+    std::string lines = run(query, 1);
+    EXPECT_EQ(lines, expected(query));
+    EXPECT_EQ(std::count(lines.begin(), lines.end(), '\n'), TEST_RECORD_COUNT);
+}
+
+// Test that the level and component filters select only matching records
+TEST_F(LoggerQueryTest, Run_LevelAndComponent_PrintsMatchingRecords) {
+    LogQuery query = {LOG_LEVEL_WARN, "Slave", 0, 0};
+    std::string lines = run(query, 1);
+    EXPECT_FALSE(lines.empty());
+    EXPECT_EQ(lines, expected(query));
+}
+
+// Test that a time range across both segments, including records past the last index block, is honoured
+TEST_F(LoggerQueryTest, Run_TimeRange_PrintsRecordsInRange) {
+    LogQuery query = {LOG_LEVEL_INFO, NULL, TEST_START_TIME + 1500, TEST_START_TIME + TEST_RECORD_COUNT - 10};
+    EXPECT_EQ(run(query, 1), expected(query));
+}
+
+// Test that scanning with several threads keeps the log order
+TEST_F(LoggerQueryTest, Run_SeveralThreads_KeepsLogOrder) {
+    LogQuery query = {LOG_LEVEL_DEBUG, "Master", TEST_START_TIME + 100, 0};
+    EXPECT_EQ(run(query, 4), expected(query));
+}
+
+// Test that a query without log segments fails
+TEST_F(LoggerQueryTest, Run_NoSegments_ReturnsRET_ERROR) {
+    char pattern[] = "/tmp/test_logger_query_empty_XXXXXX";
+    ASSERT_NE(mkdtemp(pattern), nullptr);
+    std::filesystem::current_path(pattern);
+    LogQuery query = {LOG_LEVEL_DEBUG, NULL, 0, 0};
+    EXPECT_EQ(logQueryRun(&query, 1, stdout), RET_ERROR);
+    std::filesystem::current_path(dir_);
+    std::filesystem::remove(pattern);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+extern "C" {
+    #include "logger.h"
+    #include "logger_cfg.h"
+    #include "FreeRTOS.h"
+    #include "task.h"
+}
+
+// ==========================
+// C Function Redirection
+// ==========================
+// The tick count is moved by hand and the summary records are captured as text
+TickType_t fakeTicks = 0;
+std::vector<std::string> loggedMessages;
+
+extern "C" {
+    TickType_t xTaskGetTickCount(void) {
+        return fakeTicks;
+    }
+
+    void logMessageFormatted(LogLevel level, const char* component, const char* format, ...) {
+        char message[LOG_RECORD_SIZE];
+        va_list args;
+        va_start(args, format);
+        vsnprintf(message, sizeof(message), format, args);
+        va_end(args);
+        loggedMessages.push_back(std::string(component) + ": " + message);
+    }
+}
+
+#define TEST_WINDOW_TICKS pdMS_TO_TICKS(LOG_RATE_LIMIT_WINDOW_MS)
+
+// ==========================
+// Test Fixture
+// ==========================
+class LoggerRateTest : public ::testing::Test {
+protected:
+    LogRateLimit site_ = {0, 0};
+
+    void SetUp() override {
+        fakeTicks = 0;
+        loggedMessages.clear();
+    }
+
+    // Makes `calls` calls of the call site and returns how many of them were allowed
+    uint32_t call(uint32_t calls, uint32_t limit) {
+        uint32_t allowed = 0;
+        for (uint32_t i = 0; i < calls; i++) {
+            allowed += logRateLimitAllow(&site_, limit, LOG_LEVEL_WARN, "Comm", "Queue full");
+        }
+        return allowed;
+    }
+};
+
+// ==========================
+// Unit Tests
+// ==========================
+// Test that a call site is allowed `limit` records per window and the rest are suppressed
+TEST_F(LoggerRateTest, RateLimit_OverLimit_SuppressesRest) {
+    EXPECT_EQ(call(10, 3), 3u);
+    fakeTicks = TEST_WINDOW_TICKS - 1;
+    EXPECT_EQ(call(5, 3), 0u);
+    EXPECT_TRUE(loggedMessages.empty());
+}
+
+// Test that the first call of the next window reports the suppressed records once and is allowed
+TEST_F(LoggerRateTest, RateLimit_NextWindow_ReportsSuppressed) {
+    EXPECT_EQ(call(10, 3), 3u);
+    fakeTicks = TEST_WINDOW_TICKS;
+    EXPECT_EQ(call(2, 3), 2u);
+
+    ASSERT_EQ(loggedMessages.size(), 1u);
+    EXPECT_EQ(loggedMessages[0], "Comm: Suppressed 7 records (limit 3 per " +
+                                 std::to_string(LOG_RATE_LIMIT_WINDOW_MS) + " ms): Queue full");
+}
+
+// Test that no summary is logged for a window that stayed within the limit
+TEST_F(LoggerRateTest, RateLimit_WithinLimit_NoSummary) {
+    EXPECT_EQ(call(3, 3), 3u);
+    fakeTicks = 5 * TEST_WINDOW_TICKS;
+    EXPECT_EQ(call(3, 3), 3u);
+    EXPECT_TRUE(loggedMessages.empty());
+}
+
+// Test that the window keeps working when the tick count wraps around
+TEST_F(LoggerRateTest, RateLimit_TickWrap_StartsNewWindow) {
+    fakeTicks = (TickType_t)0 - TEST_WINDOW_TICKS;
+    site_.windowStart = (uint32_t)fakeTicks;
+    EXPECT_EQ(call(4, 1), 1u);
+    fakeTicks = 0;
+    EXPECT_EQ(call(1, 1), 1u);
+    EXPECT_EQ(loggedMessages.size(), 1u);
+}
+
+// Test that sampling allows the first call and then one call out of every `every`
+TEST_F(LoggerRateTest, Sample_AllowsOneOfEvery) {
+    uint32_t counter = 0;
+    std::string pattern;
+    for (int i = 0; i < 7; i++) {
+        pattern += logSampleAllow(&counter, 3) ? 'x' : '.';
+    }
+    EXPECT_EQ(pattern, "x..x..x");
+
+    uint32_t every = 0;
+    EXPECT_EQ(logSampleAllow(&every, 1), 1u);
+    EXPECT_EQ(logSampleAllow(&every, 0), 1u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
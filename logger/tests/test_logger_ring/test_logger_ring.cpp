@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+
+extern "C" {
+    #include "logger_ring.h"
+    #include "logger_cfg.h"
+}
+
+// ==========================
+// Test Fixture
+// ==========================
+// Produces and consumes numbered records on the shared ring
+class LoggerRingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        logRingInit();
+        (void)logRingTakeDropped();
+    }
+
+    static std::string recordText(uint32_t number) {
+        return "record " + std::to_string(number);
+    }
+
+    // Reserves a slot and writes the record text into it, without committing it
+    static LogRingTicket reserve(uint32_t number) {
+        LogRingTicket ticket = {};
+        EXPECT_EQ(logRingReserve(&ticket), RET_OK);
+        std::string text = recordText(number);
+        memcpy(ticket.data, text.data(), text.size());
+        ticket.info->level = (uint8_t)(number % 4);
+        return ticket;
+    }
+
+    static void produce(uint32_t number) {
+        LogRingTicket ticket = reserve(number);
+        logRingCommit(&ticket, (uint16_t)recordText(number).size());
+    }
+
+    // Reads the oldest record, checks that it is the expected one and releases it
+    static void expectConsume(uint32_t number) {
+        const char* data = nullptr;
+        const LogRecordInfo* info = nullptr;
+        uint16_t length = 0;
+        ASSERT_EQ(logRingFront(&data, &length, &info), RET_OK);
+        EXPECT_EQ(std::string(data, length), recordText(number));
+        EXPECT_EQ(info->level, number % 4);
+        logRingPop();
+    }
+
+    static bool empty() {
+        const char* data = nullptr;
+        const LogRecordInfo* info = nullptr;
+        uint16_t length = 0;
+        return logRingFront(&data, &length, &info) == RET_ERROR;
+    }
+};
+
+// ==========================
+// Unit Tests
+// ==========================
+// Test that records keep their order while the positions wrap around the ring several times
+TEST_F(LoggerRingTest, ProduceConsume_WrapAround_KeepsOrder) {
+    uint32_t produced = 0;
+    uint32_t consumed = 0;
+    for (uint32_t round = 0; round < 4; round++) {
+        // Uneven batches, so the head and tail cross the end of the ring at different points
+        uint32_t batch = (round % 2) ? LOG_RING_SIZE : LOG_RING_SIZE / 2 + 3;
+        for (uint32_t i = 0; i < batch; i++) {
+            produce(produced++);
+        }
+        while (consumed < produced) {
+            expectConsume(consumed++);
+        }
+        EXPECT_TRUE(empty());
+    }
+    EXPECT_EQ(logRingTakeDropped(), 0u);
+}
+
+// Test that a full ring drops and counts new records instead of overwriting, and accepts them again once read
+TEST_F(LoggerRingTest, Reserve_FullRing_DropsAndCounts) {
+    LogRingTicket ticket;
+    uint32_t droppedBefore = logRingDroppedTotal();
+    for (uint32_t i = 0; i < LOG_RING_SIZE; i++) {
+        produce(i);
+    }
+    EXPECT_EQ(logRingReserve(&ticket), RET_ERROR);
+    EXPECT_EQ(logRingReserve(&ticket), RET_ERROR);
+    EXPECT_EQ(logRingTakeDropped(), 2u);
+    EXPECT_EQ(logRingTakeDropped(), 0u);
+    EXPECT_EQ(logRingDroppedTotal(), droppedBefore + 2);
+
+    expectConsume(0);
+    produce(LOG_RING_SIZE);
+    for (uint32_t i = 1; i <= LOG_RING_SIZE; i++) {
+        expectConsume(i);
+    }
+    EXPECT_TRUE(empty());
+}
+
+// Test that a reserved slot that is not committed holds back the records behind it.
+// A producer deleted inside that window would stall the ring for good, which is why
+// the logger commits with the scheduler suspended.
+TEST_F(LoggerRingTest, Front_UncommittedSlot_HoldsBackLaterRecords) {
+    produce(0);
+    LogRingTicket pending = reserve(1);
+    produce(2);
+
+    expectConsume(0);
+    EXPECT_TRUE(empty());
+    EXPECT_TRUE(empty());
+
+    logRingCommit(&pending, (uint16_t)recordText(1).size());
+    expectConsume(1);
+    expectConsume(2);
+    EXPECT_TRUE(empty());
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include <climits>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+extern "C" {
+    #include "logger_segment.h"
+    #include "logger_timestamp.h"
+    #include "logger_cfg.h"
+}
+
+// ==========================
+// Fake Clock
+// ==========================
+// Segment age is measured with logTimestampNow(), so the tests move the clock by hand
+int64_t fakeSeconds = 0;
+
+extern "C" {
+    LogTimestamp logTimestampNow(void) {
+        LogTimestamp now = {fakeSeconds, 0};
+        return now;
+    }
+}
+
+// Records written by the open hook of the tests
+#define TEST_SEGMENT_HEADER "header\n"
+
+int openHookCalls = 0;
+
+void writeHeaderHook(void) {
+    openHookCalls++;
+    logSegmentWrite(TEST_SEGMENT_HEADER, sizeof(TEST_SEGMENT_HEADER) - 1, NULL);
+}
+
+// ==========================
+// Test Fixture
+// ==========================
+// Each test runs in its own temporary directory, which holds the segments (LOG_SEGMENT_DIR is ".")
+class LoggerSegmentTest : public ::testing::Test {
+protected:
+    std::filesystem::path previousDir_;
+    std::filesystem::path dir_;
+
+    void SetUp() override {
+        char pattern[] = "/tmp/test_logger_segment_XXXXXX";
+        ASSERT_NE(mkdtemp(pattern), nullptr);
+        dir_ = pattern;
+        previousDir_ = std::filesystem::current_path();
+        std::filesystem::current_path(dir_);
+        fakeSeconds = 1000;
+        openHookCalls = 0;
+    }
+
+    void TearDown() override {
+        std::filesystem::current_path(previousDir_);
+        std::filesystem::remove_all(dir_);
+    }
+
+    static std::string segmentPath(uint32_t sequence) {
+        char path[PATH_MAX];
+        logSegmentPath(path, sizeof(path), sequence);
+        return path;
+    }
+
+    static std::string readFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    static void writeFile(const std::string& path, const std::string& content) {
+        std::ofstream file(path, std::ios::binary);
+        file << content;
+    }
+
+    // A full-size text record: one repeated character followed by a newline
+    static std::string record(char digit) {
+        return std::string(LOG_RECORD_SIZE - 1, digit) + "\n";
+    }
+};
+
+// ==========================
+// Unit Tests
+// ==========================
+// Test that the first segment is preallocated and records are appended one after the other
+TEST_F(LoggerSegmentTest, Init_EmptyDir_WritesToPreallocatedSegment) {
+    LogSegmentLocation location = {UINT32_MAX, UINT32_MAX};
+    ASSERT_EQ(logSegmentInit(NULL), RET_OK);
+    EXPECT_EQ(std::filesystem::file_size(segmentPath(0)), (uintmax_t)LOG_SEGMENT_SIZE);
+
+    EXPECT_EQ(logSegmentWrite("first\n", 6, &location), RET_OK);
+    EXPECT_EQ(location.sequence, 0u);
+    EXPECT_EQ(location.offset, 0u);
+    EXPECT_EQ(logSegmentWrite("second\n", 7, &location), RET_OK);
+    EXPECT_EQ(location.offset, 6u);
+
+    std::string content = readFile(segmentPath(0));
+    EXPECT_EQ(content.substr(0, 13), "first\nsecond\n");
+    EXPECT_EQ(content[13], '\0');
+}
+
+// Test that a record that does not fit seals the segment and starts the next one with the hook records
+TEST_F(LoggerSegmentTest, Write_SegmentFull_RollsToNextSegment) {
+    const uint32_t headerLength = sizeof(TEST_SEGMENT_HEADER) - 1;
+    const uint32_t recordsPerSegment = (LOG_SEGMENT_SIZE - headerLength) / LOG_RECORD_SIZE;
+    LogSegmentLocation location = {0, 0};
+    std::string full = record('1');
+
+    ASSERT_EQ(logSegmentInit(writeHeaderHook), RET_OK);
+    EXPECT_EQ(openHookCalls, 1);
+    for (uint32_t i = 0; i < recordsPerSegment; i++) {
+        ASSERT_EQ(logSegmentWrite(full.data(), (uint16_t)full.size(), &location), RET_OK);
+        ASSERT_EQ(location.sequence, 0u);
+    }
+
+    std::string next = record('2');
+    ASSERT_EQ(logSegmentWrite(next.data(), (uint16_t)next.size(), &location), RET_OK);
+    EXPECT_EQ(openHookCalls, 2);
+    EXPECT_EQ(location.sequence, 1u);
+    EXPECT_EQ(location.offset, headerLength);
+
+    // The sealed segment keeps only its records
+    EXPECT_EQ(std::filesystem::file_size(segmentPath(0)),
+              (uintmax_t)(headerLength + recordsPerSegment * LOG_RECORD_SIZE));
+    std::string rolled = readFile(segmentPath(1));
+    EXPECT_EQ(rolled.substr(0, headerLength + next.size()), TEST_SEGMENT_HEADER + next);
+}
+
+// Test that a restart trims the newest segment of the previous run and deletes segments beyond the retention limit
+TEST_F(LoggerSegmentTest, Init_ExistingSegments_TrimsNewestAndRemovesExpired) {
+    const uint32_t newest = LOG_SEGMENT_MAX_COUNT + 1;
+    for (uint32_t sequence = 0; sequence < newest; sequence++) {
+        writeFile(segmentPath(sequence), "old\n");
+    }
+    writeFile(segmentPath(newest), std::string("kept\nkept\npartial") + std::string(64, '\0'));
+    char path[PATH_MAX];
+    logSegmentIndexPath(path, sizeof(path), 0);
+    writeFile(path, "index");
+    logSegmentCompressedPath(path, sizeof(path), 1);
+    writeFile(path, "compressed");
+    std::filesystem::remove(segmentPath(1));
+
+    ASSERT_EQ(logSegmentInit(NULL), RET_OK);
+
+    EXPECT_EQ(readFile(segmentPath(newest)), "kept\nkept\n");
+    EXPECT_TRUE(std::filesystem::exists(segmentPath(newest + 1)));
+    uint32_t first = 0;
+    uint32_t last = 0;
+    ASSERT_EQ(logSegmentFind(&first, &last), RET_OK);
+    EXPECT_EQ(first, newest + 1 - LOG_SEGMENT_MAX_COUNT + 1);
+    EXPECT_EQ(last, newest + 1);
+    logSegmentIndexPath(path, sizeof(path), 0);
+    EXPECT_FALSE(std::filesystem::exists(path));
+    logSegmentCompressedPath(path, sizeof(path), 1);
+    EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+// Test that only a non-empty segment that reached the maximum age is rotated
+TEST_F(LoggerSegmentTest, RotateIfExpired_RotatesOnlyOldNonEmptySegment) {
+    LogSegmentLocation location = {0, 0};
+    ASSERT_EQ(logSegmentInit(NULL), RET_OK);
+    ASSERT_EQ(logSegmentWrite("line\n", 5, &location), RET_OK);
+
+    fakeSeconds += LOG_SEGMENT_MAX_AGE_S - 1;
+    logSegmentRotateIfExpired();
+    EXPECT_FALSE(std::filesystem::exists(segmentPath(1)));
+
+    fakeSeconds++;
+    logSegmentRotateIfExpired();
+    EXPECT_TRUE(std::filesystem::exists(segmentPath(1)));
+    EXPECT_EQ(readFile(segmentPath(0)), "line\n");
+
+    // The new segment is still empty, so it is kept however old it gets
+    fakeSeconds += 2 * LOG_SEGMENT_MAX_AGE_S;
+    logSegmentRotateIfExpired();
+    EXPECT_FALSE(std::filesystem::exists(segmentPath(2)));
+    ASSERT_EQ(logSegmentWrite("next\n", 5, &location), RET_OK);
+    EXPECT_EQ(location.sequence, 1u);
+    EXPECT_EQ(location.offset, 0u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+
+extern "C" {
+    #include "logger_status.h"
+    #include "logger_cfg.h"
+    #include "FreeRTOS.h"
+    #include "task.h"
+}
+
+// ==========================
+// C Function Redirection
+// ==========================
+// Each std::thread stands for a FreeRTOS task; the task name is taken from the thread
+thread_local const char* taskName = nullptr;
+
+extern "C" {
+    BaseType_t xTaskGetSchedulerState(void) {
+        return (taskName == nullptr) ? taskSCHEDULER_NOT_STARTED : taskSCHEDULER_RUNNING;
+    }
+
+    char* pcTaskGetName(TaskHandle_t task) {
+        return const_cast<char*>(taskName);
+    }
+}
+
+// ==========================
+// Test Fixture
+// ==========================
+// The writer maps one status page per process, so the page is created once and the tests check
+// changes relative to a snapshot taken at their start
+class LoggerStatusTest : public ::testing::Test {
+protected:
+    static std::string path_;
+    const LogStatusPage* view_ = nullptr;
+
+    static void SetUpTestSuite() {
+        char pattern[] = "/tmp/test_logger_status_XXXXXX";
+        int fd = mkstemp(pattern);
+        ASSERT_GE(fd, 0);
+        close(fd);
+        path_ = pattern;
+        ASSERT_EQ(logStatusInit(path_.c_str()), RET_OK);
+    }
+
+    static void TearDownTestSuite() {
+        unlink(path_.c_str());
+    }
+
+    void SetUp() override {
+        ASSERT_EQ(logStatusOpenView(path_.c_str(), &view_), RET_OK);
+    }
+
+    void TearDown() override {
+        logStatusCloseView(view_);
+    }
+
+    LogStatusSnapshot read() {
+        LogStatusSnapshot snapshot;
+        EXPECT_EQ(logStatusRead(view_, &snapshot), RET_OK);
+        return snapshot;
+    }
+
+    static const LogStatusTask* findTask(const LogStatusSnapshot& snapshot, const char* name) {
+        for (uint32_t i = 0; i < snapshot.taskCount; i++) {
+            if (strcmp(snapshot.tasks[i].name, name) == 0) {
+                return &snapshot.tasks[i];
+            }
+        }
+        return nullptr;
+    }
+
+    // Runs a heartbeat in a new thread, as a task of the given name would
+    static void heartbeatFromTask(const char* name, int count) {
+        std::thread task([name, count]() {
+            taskName = name;
+            for (int i = 0; i < count; i++) {
+                logStatusHeartbeat();
+            }
+        });
+        task.join();
+    }
+};
+
+std::string LoggerStatusTest::path_;
+
+// ==========================
+// Unit Tests
+// ==========================
+// Test that the page is published with its header and the states of no running state machine
+TEST_F(LoggerStatusTest, OpenView_NewPage_HasHeader) {
+    EXPECT_EQ(view_->header.pid, (uint32_t)getpid());
+    EXPECT_EQ(view_->header.taskSlots, (uint32_t)LOG_STATUS_TASKS);
+    EXPECT_EQ(read().pid, (uint32_t)getpid());
+}
+
+// Test that state changes are counted per state pair and repeated states are not
+TEST_F(LoggerStatusTest, SetState_Changes_AreCounted) {
+    logStatusSetSlaveState(SLAVE_STATE_SLEEP);
+    LogStatusSnapshot before = read();
+    EXPECT_EQ(before.slave.state, (uint32_t)SLAVE_STATE_SLEEP);
+
+    logStatusSetSlaveState(SLAVE_STATE_ACTIVE);
+    logStatusSetSlaveState(SLAVE_STATE_ACTIVE);
+    logStatusSetSlaveState(SLAVE_STATE_FAULT);
+    logStatusSetSlaveState(SLAVE_STATE_MAX);
+    LogStatusSnapshot after = read();
+
+    EXPECT_EQ(after.slave.state, (uint32_t)SLAVE_STATE_FAULT);
+    EXPECT_EQ(after.slave.transitions - before.slave.transitions, 2u);
+    EXPECT_EQ(after.slave.counts[SLAVE_STATE_SLEEP][SLAVE_STATE_ACTIVE] -
+              before.slave.counts[SLAVE_STATE_SLEEP][SLAVE_STATE_ACTIVE], 1u);
+    EXPECT_EQ(after.slave.counts[SLAVE_STATE_ACTIVE][SLAVE_STATE_FAULT] -
+              before.slave.counts[SLAVE_STATE_ACTIVE][SLAVE_STATE_FAULT], 1u);
+    EXPECT_GE(after.slave.enteredNs, before.slave.enteredNs);
+    EXPECT_EQ(after.slave.sequence % 2, 0u);
+}
+
+// Test that heartbeats are counted per task name and a restarted task takes over its slot
+TEST_F(LoggerStatusTest, Heartbeat_PerTaskSlot_CountsStarts) {
+    heartbeatFromTask("StatusWorker", 3);
+    const LogStatusTask* worker = findTask(read(), "StatusWorker");
+    ASSERT_NE(worker, nullptr);
+    EXPECT_EQ(worker->starts, 1u);
+    EXPECT_EQ(worker->heartbeats, 3u);
+
+    heartbeatFromTask("StatusWorker", 2);
+    LogStatusSnapshot snapshot = read();
+    worker = findTask(snapshot, "StatusWorker");
+    ASSERT_NE(worker, nullptr);
+    EXPECT_EQ(worker->starts, 2u);
+    EXPECT_EQ(worker->heartbeats, 5u);
+    EXPECT_GT(worker->lastHeartbeatNs, 0u);
+
+    // Before the scheduler starts, heartbeats go to the slot of the main thread
+    logStatusHeartbeat();
+    EXPECT_NE(findTask(read(), "Main"), nullptr);
+}
+
+// Test that a section whose writer was interrupted mid-update is not returned
+TEST_F(LoggerStatusTest, Read_SectionBeingWritten_ReturnsRET_ERROR) {
+    int fd = open(path_.c_str(), O_RDWR);
+    ASSERT_GE(fd, 0);
+    LogStatusPage* writable = static_cast<LogStatusPage*>(
+        mmap(nullptr, sizeof(LogStatusPage), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    close(fd);
+    ASSERT_NE(writable, MAP_FAILED);
+
+    writable->master.sequence++;
+    LogStatusSnapshot snapshot;
+    EXPECT_EQ(logStatusRead(view_, &snapshot), RET_ERROR);
+    writable->master.sequence++;
+    EXPECT_EQ(logStatusRead(view_, &snapshot), RET_OK);
+    munmap(writable, sizeof(LogStatusPage));
+}
+
+// Test that snapshots taken while the writer changes states are always consistent
+TEST_F(LoggerStatusTest, Read_ConcurrentWriter_SnapshotsAreConsistent) {
+    std::atomic<bool> done(false);
+    logStatusSetMasterState(MASTESR_STATE_IDLE);
+    std::thread writer([&done]() {
+        for (int i = 0; i < 200000; i++) {
+            logStatusSetMasterState((i % 2) ? MASTESR_STATE_IDLE : MASTESR_STATE_PROCESSING);
+        }
+        done = true;
+    });
+
+    uint32_t reads = 0;
+    while (!done || reads == 0) {
+        LogStatusSnapshot snapshot;
+        if (logStatusRead(view_, &snapshot) != RET_OK) {
+            continue;
+        }
+        reads++;
+        uint32_t total = 0;
+        for (uint32_t from = 0; from < MASTESR_STATE_MAX; from++) {
+            for (uint32_t to = 0; to < MASTESR_STATE_MAX; to++) {
+                total += snapshot.master.counts[from][to];
+            }
+        }
+        ASSERT_EQ(total, snapshot.master.transitions);
+        ASSERT_EQ(snapshot.master.state,
+                  (snapshot.master.transitions % 2) ? (uint32_t)MASTESR_STATE_PROCESSING : (uint32_t)MASTESR_STATE_IDLE);
+    }
+    writer.join();
+    EXPECT_GT(reads, 0u);
+}
+
+// Test that a missing or uninitialized page cannot be opened
+TEST_F(LoggerStatusTest, OpenView_MissingOrUninitialized_ReturnsRET_ERROR) {
+    const LogStatusPage* page = nullptr;
+    EXPECT_EQ(logStatusOpenView("/tmp/test_logger_status_missing", &page), RET_ERROR);
+
+    char pattern[] = "/tmp/test_logger_status_empty_XXXXXX";
+    int fd = mkstemp(pattern);
+    ASSERT_GE(fd, 0);
+    EXPECT_EQ(logStatusOpenView(pattern, &page), RET_ERROR);
+    ASSERT_EQ(ftruncate(fd, sizeof(LogStatusPage)), 0);
+    EXPECT_EQ(logStatusOpenView(pattern, &page), RET_ERROR);
+    close(fd);
+    unlink(pattern);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <thread>
+
+extern "C" {
+    #include "logger_timestamp.h"
+}
+
+// 2026-10-17 05:18:36 UTC
+#define TEST_SECONDS 1792214316
+
+// ==========================
+// Test Fixture
+// ==========================
+// Formats in UTC, so the expected text does not depend on the local time zone
+class LoggerTimestampTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        setenv("TZ", "UTC", 1);
+        tzset();
+    }
+
+    static std::string format(int64_t seconds, uint32_t nanoseconds) {
+        LogTimestamp timestamp = {seconds, nanoseconds};
+        char text[LOG_TIMESTAMP_TEXT_SIZE];
+        EXPECT_EQ(logTimestampFormat(&timestamp, text, sizeof(text)), (size_t)LOG_TIMESTAMP_TEXT_SIZE - 1);
+        return text;
+    }
+};
+
+// ==========================
+// Unit Tests
+// ==========================
+// Test that a timestamp is formatted with microseconds, truncated rather than rounded
+TEST_F(LoggerTimestampTest, Format_WritesMicroseconds) {
+    EXPECT_EQ(format(TEST_SECONDS, 0), "2026-10-17 05:18:36.000000");
+    EXPECT_EQ(format(TEST_SECONDS, 869913999), "2026-10-17 05:18:36.869913");
+    EXPECT_EQ(format(TEST_SECONDS, 999999999), "2026-10-17 05:18:36.999999");
+}
+
+// Test that the cached text of a second is replaced when the second changes, in both directions
+TEST_F(LoggerTimestampTest, Format_SecondChanges_UpdatesCachedText) {
+    EXPECT_EQ(format(TEST_SECONDS, 1000), "2026-10-17 05:18:36.000001");
+    EXPECT_EQ(format(TEST_SECONDS + 1, 0), "2026-10-17 05:18:37.000000");
+    EXPECT_EQ(format(TEST_SECONDS + 86400, 0), "2026-10-18 05:18:36.000000");
+    EXPECT_EQ(format(TEST_SECONDS, 2000), "2026-10-17 05:18:36.000002");
+}
+
+// Test that a buffer too small for the whole text is left untouched
+TEST_F(LoggerTimestampTest, Format_SmallBuffer_ReturnsZero) {
+    LogTimestamp timestamp = {TEST_SECONDS, 0};
+    char text[LOG_TIMESTAMP_TEXT_SIZE - 1] = "unchanged";
+    EXPECT_EQ(logTimestampFormat(&timestamp, text, sizeof(text)), 0u);
+    EXPECT_STREQ(text, "unchanged");
+}
+
+// Test that the cache is per thread, so threads formatting different seconds do not mix them up
+TEST_F(LoggerTimestampTest, Format_OtherThread_HasOwnCache) {
+    EXPECT_EQ(format(TEST_SECONDS, 0), "2026-10-17 05:18:36.000000");
+    std::thread other([]() {
+        for (int i = 0; i < 1000; i++) {
+            EXPECT_EQ(format(TEST_SECONDS + 60, 0), "2026-10-17 05:19:36.000000");
+        }
+    });
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_EQ(format(TEST_SECONDS, 0), "2026-10-17 05:18:36.000000");
+    }
+    other.join();
+}
+
+// Test that the current time follows the wall clock and never goes backwards
+TEST_F(LoggerTimestampTest, Now_IsWallClockAndMonotonic) {
+    LogTimestamp previous = logTimestampNow();
+    EXPECT_LE(std::llabs(previous.seconds - (int64_t)time(NULL)), 1);
+    for (int i = 0; i < 10000; i++) {
+        LogTimestamp now = logTimestampNow();
+        ASSERT_LT(now.nanoseconds, 1000000000u);
+        ASSERT_TRUE(now.seconds > previous.seconds ||
+                    (now.seconds == previous.seconds && now.nanoseconds >= previous.nanoseconds));
+        previous = now;
+    }
+    uint64_t first = logTimestampMonotonicNs();
+    EXPECT_GE(logTimestampMonotonicNs(), first);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+extern "C" {
+    #include "logger_trace.h"
+    #include "logger_cfg.h"
+}
+
+// ==========================
+// Test Fixture
+// ==========================
+// The writer maps one trace file per process, so the file is created once and every test
+// only looks at the spans of the traces it started
+class LoggerTraceTest : public ::testing::Test {
+protected:
+    static std::string path_;
+    const LogTracePage* view_ = nullptr;
+
+    static void SetUpTestSuite() {
+        // Nothing is traced until the file exists
+        EXPECT_EQ(logTraceBegin(LOG_TRACE_HOP_TCP_RECEIVED, 0), 0u);
+
+        char pattern[] = "/tmp/test_logger_trace_XXXXXX";
+        int fd = mkstemp(pattern);
+        ASSERT_GE(fd, 0);
+        close(fd);
+        path_ = pattern;
+        ASSERT_EQ(logTraceInit(path_.c_str()), RET_OK);
+    }
+
+    static void TearDownTestSuite() {
+        unlink(path_.c_str());
+    }
+
+    void SetUp() override {
+        ASSERT_EQ(logTraceOpenView(path_.c_str(), &view_), RET_OK);
+    }
+
+    void TearDown() override {
+        logTraceCloseView(view_);
+    }
+
+    // Spans of one trace, in the order they were recorded
+    std::vector<LogTraceSpan> spansOf(uint32_t traceId) {
+        std::vector<LogTraceSpan> spans(LOG_TRACE_SPANS);
+        uint32_t count = 0;
+        logTraceRead(view_, spans.data(), LOG_TRACE_SPANS, &count);
+        std::vector<LogTraceSpan> trace;
+        for (uint32_t i = 0; i < count; i++) {
+            if (spans[i].traceId == traceId) {
+                trace.push_back(spans[i]);
+            }
+        }
+        std::sort(trace.begin(), trace.end(), [](const LogTraceSpan& a, const LogTraceSpan& b) {
+            return a.timeNs < b.timeNs || (a.timeNs == b.timeNs && a.hop < b.hop);
+        });
+        return trace;
+    }
+};
+
+std::string LoggerTraceTest::path_;
+
+// ==========================
+// Unit Tests
+// ==========================
+// Test that the spans of a trace are recorded with their hop, value and time
+TEST_F(LoggerTraceTest, BeginAndSpan_RecordsTraceHops) {
+    uint32_t traceId = logTraceBegin(LOG_TRACE_HOP_TCP_RECEIVED, 12);
+    ASSERT_NE(traceId, 0u);
+    logTraceSpan(traceId, LOG_TRACE_HOP_SLAVE_RECEIVED, 5);
+    logTraceSpan(traceId, LOG_TRACE_HOP_MASTER_TRANSITION, 1);
+
+    std::vector<LogTraceSpan> trace = spansOf(traceId);
+    ASSERT_EQ(trace.size(), 3u);
+    EXPECT_EQ(trace[0].hop, (uint32_t)LOG_TRACE_HOP_TCP_RECEIVED);
+    EXPECT_EQ(trace[0].value, 12u);
+    EXPECT_EQ(trace[1].hop, (uint32_t)LOG_TRACE_HOP_SLAVE_RECEIVED);
+    EXPECT_EQ(trace[1].value, 5u);
+    EXPECT_EQ(trace[2].hop, (uint32_t)LOG_TRACE_HOP_MASTER_TRANSITION);
+    EXPECT_GE(trace[2].timeNs, trace[0].timeNs);
+    EXPECT_EQ(view_->header.pid, (uint32_t)getpid());
+}
+
+// Test that every trace gets a new id
+TEST_F(LoggerTraceTest, Begin_ReturnsNewIds) {
+    uint32_t first = logTraceBegin(LOG_TRACE_HOP_TCP_RECEIVED, 0);
+    uint32_t second = logTraceBegin(LOG_TRACE_HOP_TCP_RECEIVED, 0);
+    EXPECT_NE(first, 0u);
+    EXPECT_NE(second, 0u);
+    EXPECT_NE(first, second);
+}
+
+// Test that spans of untraced inputs and of unknown hops are not recorded
+TEST_F(LoggerTraceTest, Span_UntracedOrUnknownHop_NotRecorded) {
+    uint32_t head = view_->header.head;
+    logTraceSpan(0, LOG_TRACE_HOP_SLAVE_RECEIVED, 1);
+    logTraceSpan(1, LOG_TRACE_HOP_MAX, 1);
+    EXPECT_EQ(view_->header.head, head);
+}
+
+// Test that the current trace is kept per task
+TEST_F(LoggerTraceTest, SetCurrent_IsPerThread) {
+    logTraceSetCurrent(42);
+    std::thread other([]() {
+        EXPECT_EQ(logTraceCurrent(), 0u);
+        logTraceSetCurrent(7);
+        EXPECT_EQ(logTraceCurrent(), 7u);
+    });
+    other.join();
+    EXPECT_EQ(logTraceCurrent(), 42u);
+    logTraceSetCurrent(0);
+}
+
+// Test that the ring keeps the newest spans and a reader copies no more than it has room for
+TEST_F(LoggerTraceTest, Span_RingFull_OverwritesOldestSpans) {
+    uint32_t old = logTraceBegin(LOG_TRACE_HOP_TCP_RECEIVED, 0);
+    uint32_t traceId = logTraceBegin(LOG_TRACE_HOP_TCP_RECEIVED, 0);
+    for (uint32_t i = 1; i < LOG_TRACE_SPANS; i++) {
+        logTraceSpan(traceId, LOG_TRACE_HOP_SLAVE_SENT, i);
+    }
+
+    EXPECT_TRUE(spansOf(old).empty());
+    EXPECT_EQ(spansOf(traceId).size(), (size_t)LOG_TRACE_SPANS);
+
+    LogTraceSpan spans[4];
+    uint32_t count = 0;
+    logTraceRead(view_, spans, 4, &count);
+    EXPECT_EQ(count, 4u);
+}
+
+// Test that spans read while several tasks record are never torn
+TEST_F(LoggerTraceTest, Read_ConcurrentWriters_SpansAreConsistent) {
+    std::atomic<bool> done(false);
+    std::vector<std::thread> writers;
+    for (int w = 0; w < 4; w++) {
+        writers.emplace_back([]() {
+            for (int i = 0; i < 20000; i++) {
+                uint32_t traceId = logTraceBegin(LOG_TRACE_HOP_TCP_RECEIVED, 0);
+                // The value is derived from the id, so a span mixing two writes is detected
+                logTraceSpan(traceId, LOG_TRACE_HOP_SLAVE_RECEIVED, traceId * 2654435761u);
+            }
+        });
+    }
+    std::thread stopper([&writers, &done]() {
+        for (std::thread& writer : writers) {
+            writer.join();
+        }
+        done = true;
+    });
+
+    std::vector<LogTraceSpan> spans(LOG_TRACE_SPANS);
+    uint32_t torn = 0;
+    do {
+        uint32_t count = 0;
+        logTraceRead(view_, spans.data(), LOG_TRACE_SPANS, &count);
+        for (uint32_t i = 0; i < count; i++) {
+            if (spans[i].hop == LOG_TRACE_HOP_SLAVE_RECEIVED && spans[i].value != spans[i].traceId * 2654435761u) {
+                torn++;
+            }
+        }
+    } while (!done);
+    stopper.join();
+    EXPECT_EQ(torn, 0u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
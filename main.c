@@ -18,8 +18,16 @@
 #include "slave_restart_threads.h"
 #include "slave_state_machine.h"
 #include "slave_comm.h"
+#include "comm_pipeline.h"
+#include "comm_ring.h"
+#include "comm_transport.h"
 #include "types.h"
 #include "logger.h"
+#include "logger_flight.h"
+#include "logger_status.h"
+#include "logger_trace.h"
+#include "logger_cfg.h"
+#include "comm_cfg.h"
 #include "thread_handler_cfg.h"
 
 /**
@@ -28,50 +36,281 @@
  *
  * This file sets up communication queues, initializes components,
  * and creates master and slave tasks before starting the FreeRTOS scheduler.
+ *
+ * Command line options:
+ * - -t queue|unix|shm: transport of the master-slave link (default COMM_TRANSPORT_DEFAULT).
+ * - -r all|master|slave: side run by this process (default all). A process
+ *   running one side only needs the unix or shm transport.
  */
 
 /* Define the maximum number of messages and the maximum message size */
 #define MAX_MESSAGES 10
-#define MAX_MSG_SIZE sizeof(uint8_t)
+#define MAX_MSG_SIZE sizeof(CommMessage)
+
+#if COMM_STATE_RING && COMM_STATE_MAILBOX
+#error "The ring channels are FIFO; set COMM_STATE_MAILBOX to 0 to use COMM_STATE_RING"
+#endif
+
+/* The slave channel is a fan-in queue set member, a ring or a transport, none of which can drop
+   its oldest message. The overflow policies are enum values, which #if cannot compare */
+_Static_assert(COMM_OVERFLOW_POLICY_SLAVE != COMM_OVERFLOW_DROP_OLDEST,
+               "COMM_OVERFLOW_POLICY_SLAVE cannot be COMM_OVERFLOW_DROP_OLDEST");
+
+/* A mailbox channel holds only the newest state; the state sync then sends snapshots */
+#if COMM_STATE_MAILBOX
+#define STATE_CHANNEL_LENGTH 1
+#else
+#define STATE_CHANNEL_LENGTH MAX_MESSAGES
+#endif
 
 /**
- * @brief Queue handles for communication and reset tasks.
+ * @brief Queue handles for the directional state channels and the reset task.
  */
-static QueueHandle_t xQueue = NULL;
+static QueueHandle_t masterToSlaveQueue = NULL;
+static QueueHandle_t slaveToMasterQueue = NULL;
 static QueueHandle_t resetQueueHandler = NULL;
 
+/**
+ * @brief Pipeline carrying the TCP client payloads to the slave and master payload handlers.
+ */
+static CommPipeline tcpPipeline;
+
+#if COMM_STATE_RING
+/**
+ * @brief Ring channels used for the state channels instead of the queues.
+ */
+static CommRing masterToSlaveRing;
+static CommRing slaveToMasterRing;
+#endif
+
+/**
+ * @brief Side of the system run by this process.
+ */
+typedef enum {
+    MAIN_ROLE_ALL,    ///< Master and slave.
+    MAIN_ROLE_MASTER, ///< Master only.
+    MAIN_ROLE_SLAVE   ///< Slave only.
+} MainRole;
+
+/**
+ * @brief Startup options, set from the command line.
+ */
+static MainRole role = MAIN_ROLE_ALL;
+static CommTransportKind transportKind = COMM_TRANSPORT_DEFAULT;
+
+/**
+ * @brief Master and slave ends of the link when it is a Unix socket or shared memory.
+ */
+static CommTransport masterTransport;
+static CommTransport slaveTransport;
+
+/**
+ * @brief Called by configASSERT() when an assertion fails.
+ *
+ * Writes the failure and the queued log records, dumps the flight recorder so
+ * the events leading to the failure are kept, then stops the program.
+ *
+ * @param pcFileName Source file of the failed assertion.
+ * @param ulLine Line of the failed assertion.
+ */
+void vAssertCalled(const char * const pcFileName, unsigned long ulLine) {
+    char reason[128];
+    snprintf(reason, sizeof(reason), "configASSERT failed at %s:%lu", pcFileName, ulLine);
+    // The flush task will not run again; write the log before the flight recorder
+    logMessageFatal("Main", reason);
+    logFlightDump(reason);
+    abort();
+}
+
+/**
+ * @brief Parses the command line options.
+ *
+ * @return RET_OK on success, RET_ERROR on an unknown option or value.
+ */
+static RetVal_t parseOptions(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            if (commTransportParse(argv[++i], &transportKind) != RET_OK) {
+                return RET_ERROR;
+            }
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "all") == 0) {
+                role = MAIN_ROLE_ALL;
+            } else if (strcmp(argv[i], "master") == 0) {
+                role = MAIN_ROLE_MASTER;
+            } else if (strcmp(argv[i], "slave") == 0) {
+                role = MAIN_ROLE_SLAVE;
+            } else {
+                return RET_ERROR;
+            }
+        } else {
+            return RET_ERROR;
+        }
+    }
+    // In-process channels cannot reach another process
+    if (transportKind == COMM_TRANSPORT_QUEUE && role != MAIN_ROLE_ALL) {
+        return RET_ERROR;
+    }
+    return RET_OK;
+}
+
+/**
+ * @brief Connects the master and the slave over the in-process state channels.
+ *
+ * @return RET_OK on success, RET_ERROR on failure.
+ */
+static RetVal_t initLocalLink() {
+#if COMM_STATE_RING
+    commRingInit(&masterToSlaveRing);
+    commRingInit(&slaveToMasterRing);
+
+    if(initMasterCommRing(&masterToSlaveRing, &slaveToMasterRing) != RET_OK){
+        logMessage(LOG_LEVEL_ERROR, "Main", "Init Master Comm failed");
+        return RET_ERROR;
+    }
+
+    if(initSlaveCommRing(&slaveToMasterRing, &masterToSlaveRing) != RET_OK){
+        logMessage(LOG_LEVEL_ERROR, "Main", "Init Slave Comm failed");
+        return RET_ERROR;
+    }
+#else
+    masterToSlaveQueue = xQueueCreate(STATE_CHANNEL_LENGTH, MAX_MSG_SIZE);
+    slaveToMasterQueue = xQueueCreate(STATE_CHANNEL_LENGTH, MAX_MSG_SIZE);
+    if (masterToSlaveQueue == NULL || slaveToMasterQueue == NULL) {
+        logMessage(LOG_LEVEL_ERROR, "Main", "Failed to create queue");
+        return RET_ERROR;
+    }
+
+    // The master waits on its slave channels through a queue set; more slaves add channels to the array
+    if(initMasterCommFanIn(masterToSlaveQueue, &slaveToMasterQueue, 1) != RET_OK){
+        logMessage(LOG_LEVEL_ERROR, "Main", "Init Master Comm failed");
+        return RET_ERROR;
+    }
+
+    if(initSlaveComm(slaveToMasterQueue, masterToSlaveQueue) != RET_OK ||
+       setSendQueueInSetSlave() != RET_OK){
+        logMessage(LOG_LEVEL_ERROR, "Main", "Init Slave Comm failed");
+        return RET_ERROR;
+    }
+#endif
+    return RET_OK;
+}
+
+/**
+ * @brief Opens the ends of a Unix socket or shared-memory link run by this process.
+ *
+ * @param side End of the link to open.
+ * @param transport Transport end to set up.
+ * @return RET_OK on success, RET_ERROR on failure.
+ */
+static RetVal_t openTransport(CommLinkSide side, CommTransport *transport) {
+    if (transportKind == COMM_TRANSPORT_UNIX) {
+        return commTransportOpenUnix(transport, COMM_TRANSPORT_UNIX_PATH, side);
+    }
+    return commTransportOpenShm(transport, COMM_TRANSPORT_SHM_PATH, side);
+}
+
+/**
+ * @brief Connects the sides run by this process to the master-slave link.
+ *
+ * @return RET_OK on success, RET_ERROR on failure.
+ */
+static RetVal_t initLink() {
+    if (transportKind == COMM_TRANSPORT_QUEUE) {
+        return initLocalLink();
+    }
+
+    // The master end owns the socket path or the shared-memory file, so it is opened first
+    if (role != MAIN_ROLE_SLAVE) {
+        if (openTransport(COMM_LINK_MASTER, &masterTransport) != RET_OK ||
+            initMasterCommTransport(&masterTransport) != RET_OK) {
+            logMessage(LOG_LEVEL_ERROR, "Main", "Init Master Comm failed");
+            return RET_ERROR;
+        }
+    }
+    if (role != MAIN_ROLE_MASTER) {
+        if (openTransport(COMM_LINK_SLAVE, &slaveTransport) != RET_OK ||
+            initSlaveCommTransport(&slaveTransport) != RET_OK) {
+            logMessage(LOG_LEVEL_ERROR, "Main", "Init Slave Comm failed");
+            return RET_ERROR;
+        }
+    }
+    logMessage(LOG_LEVEL_INFO, "Main", (transportKind == COMM_TRANSPORT_UNIX) ? "Link uses the Unix socket transport"
+                                                                            : "Link uses the shared-memory transport");
+    return RET_OK;
+}
+
 /**
  * @brief Initializes essential components such as queues and state machines.
  *
+ * Only the components of the sides run by this process are set up. The
+ * payload pipeline is in-process, so the master reads it only when both sides
+ * run here.
+ *
  * @return RET_OK on success, RET_ERROR on failure.
  */
 static RetVal_t initComponents() {
-    xQueue = xQueueCreate(MAX_MESSAGES, MAX_MSG_SIZE);
+    if (initLogger() != RET_OK) {
+        logMessage(LOG_LEVEL_ERROR, "Main", "Init Logger failed");
+        return RET_ERROR;
+    }
+
+#if LOG_STATUS_ENABLED
+    // Monitoring is optional; the system runs without the status page. Indexed by MainRole
+    static const char *statusFiles[] = {LOG_STATUS_FILE, LOG_STATUS_FILE ".master", LOG_STATUS_FILE ".slave"};
+    if (logStatusInit(statusFiles[role]) != RET_OK) {
+        logMessage(LOG_LEVEL_WARN, "Main", "Status page not available");
+    }
+#endif
+
+#if LOG_TRACE_ENABLED
+    // Like the status page, tracing is optional. Indexed by MainRole
+    static const char *traceFiles[] = {LOG_TRACE_FILE, LOG_TRACE_FILE ".master", LOG_TRACE_FILE ".slave"};
+    if (logTraceInit(traceFiles[role]) != RET_OK) {
+        logMessage(LOG_LEVEL_WARN, "Main", "Tracing not available");
+    }
+#endif
+
     resetQueueHandler = xQueueCreate(MAX_MESSAGES, sizeof(uint8_t));
 
-    if (xQueue == NULL) {
+    if (resetQueueHandler == NULL) {
         logMessage(LOG_LEVEL_ERROR, "Main", "Failed to create queue");
         return RET_ERROR;
     }
     logMessage(LOG_LEVEL_INFO, "Main", "Queue created successfully");
 
-    if (initStateSemaphoreMaster() != RET_OK) {
+    if (role != MAIN_ROLE_SLAVE && initStateSemaphoreMaster() != RET_OK) {
         logMessage(LOG_LEVEL_ERROR, "Main", "Init State Semaphore Master failed");
         return RET_ERROR;
     }
 
-    if (initStateMachineSlave(resetQueueHandler) != RET_OK) {
+    if (role != MAIN_ROLE_MASTER && initStateMachineSlave(resetQueueHandler) != RET_OK) {
         logMessage(LOG_LEVEL_ERROR, "Main", "Init State Machine Slave failed");
         return RET_ERROR;
     }
 
-    if(initMasterComm(xQueue) != RET_OK){
-        logMessage(LOG_LEVEL_ERROR, "Main", "Init Master Comm failed");
+    if (initLink() != RET_OK) {
         return RET_ERROR;
     }
 
-    if(initSlaveComm(xQueue) != RET_OK){
-        logMessage(LOG_LEVEL_ERROR, "Main", "Init Slave Comm failed");
+    if ((role != MAIN_ROLE_SLAVE &&
+         setOverflowPolicyMaster(COMM_OVERFLOW_POLICY_MASTER, COMM_OVERFLOW_DEADLINE_MS) != RET_OK) ||
+        (role != MAIN_ROLE_MASTER &&
+         setOverflowPolicySlave(COMM_OVERFLOW_POLICY_SLAVE, COMM_OVERFLOW_DEADLINE_MS) != RET_OK)) {
+        logMessage(LOG_LEVEL_ERROR, "Main", "Init Comm overflow policy failed");
+        return RET_ERROR;
+    }
+
+    if (role == MAIN_ROLE_MASTER) {
+        return RET_OK;
+    }
+
+    // The master consumes the payloads only when it runs in this process
+    if (commPipelineInit(&tcpPipeline, (role == MAIN_ROLE_ALL) ? COMM_PAYLOAD_CONSUMER_MAX : 1) != RET_OK ||
+        initPayloadPipelineSlave(&tcpPipeline) != RET_OK ||
+        (role == MAIN_ROLE_ALL && initPayloadPipelineMaster(&tcpPipeline) != RET_OK)) {
+        logMessage(LOG_LEVEL_ERROR, "Main", "Init Payload Pipeline failed");
         return RET_ERROR;
     }
 
@@ -98,6 +337,17 @@ static RetVal_t creatMasterTasks() {
     }
     logMessage(LOG_LEVEL_INFO, "Main", "MasterStatusCheckHandler created successfully");
 
+    // TCP payloads come from the slave over the in-process pipeline
+    if (role != MAIN_ROLE_ALL) {
+        return RET_OK;
+    }
+    if (xTaskCreate(vMasterTelemetryHandler, "MasterTelemetryHandler", configMINIMAL_STACK_SIZE * 4, NULL,
+                    TASTK_PRIO_MASTER_TELEMETRY_HANDLER, NULL) != pdPASS) {
+        logMessage(LOG_LEVEL_ERROR, "Main", "Failed to create MasterTelemetryHandler");
+        return RET_ERROR;
+    }
+    logMessage(LOG_LEVEL_INFO, "Main", "MasterTelemetryHandler created successfully");
+
     return RET_OK;
 }
 
@@ -123,6 +373,22 @@ static RetVal_t creatSlaveTasks() {
     }
     logMessage(LOG_LEVEL_INFO, "Main", "vTCPCommHandler created successfully");
 
+    // Not restarted with the other slave tasks: it holds the master state the slave has
+    if (xTaskCreate(vSlaveMasterStateHandler, "SlaveMasterStateHandler", configMINIMAL_STACK_SIZE * 4, NULL,
+                    TASTK_PRIO_SLAVE_MASTER_STATE_HANDLER, NULL) != pdPASS) {
+        logMessage(LOG_LEVEL_ERROR, "Main", "Failed to create vSlaveMasterStateHandler");
+        return RET_ERROR;
+    }
+    logMessage(LOG_LEVEL_INFO, "Main", "vSlaveMasterStateHandler created successfully");
+
+    // Not restarted with the other slave tasks: it holds no connection state
+    if (xTaskCreate(vSlavePayloadHandler, "SlavePayloadHandler", configMINIMAL_STACK_SIZE * 4, NULL,
+                    TASTK_PRIO_SLAVE_PAYLOAD_HANDLER, NULL) != pdPASS) {
+        logMessage(LOG_LEVEL_ERROR, "Main", "Failed to create vSlavePayloadHandler");
+        return RET_ERROR;
+    }
+    logMessage(LOG_LEVEL_INFO, "Main", "vSlavePayloadHandler created successfully");
+
     if (xTaskCreate(vRestartHandler, "RestartSlave", configMINIMAL_STACK_SIZE * 16, resetQueueHandler,
                     TASTK_PRIO_SLAVE_RESTAT_STATUS, NULL) != pdPASS) {
         logMessage(LOG_LEVEL_ERROR, "Main", "Failed to create vRestartHandler");
@@ -134,13 +400,44 @@ static RetVal_t creatSlaveTasks() {
     return RET_OK;
 }
 
+/**
+ * @brief Creates the logger flush task and, with compressed segments, the compress task.
+ *
+ * @return RET_OK on success, RET_ERROR on failure.
+ */
+static RetVal_t creatLoggerTasks() {
+    if (xTaskCreate(vLoggerFlushHandler, "LoggerFlush", configMINIMAL_STACK_SIZE * 4, NULL,
+                    TASTK_PRIO_LOGGER_FLUSH_HANDLER, NULL) != pdPASS) {
+        logMessage(LOG_LEVEL_ERROR, "Main", "Failed to create LoggerFlush");
+        return RET_ERROR;
+    }
+    logMessage(LOG_LEVEL_INFO, "Main", "LoggerFlush created successfully");
+
+#if LOG_SEGMENT_ENABLED && LOG_COMPRESS_ENABLED && !LOG_BINARY_ENABLED
+    if (xTaskCreate(vLoggerCompressHandler, "LoggerCompress", configMINIMAL_STACK_SIZE * 4, NULL,
+                    TASTK_PRIO_LOGGER_COMPRESS_HANDLER, NULL) != pdPASS) {
+        logMessage(LOG_LEVEL_ERROR, "Main", "Failed to create LoggerCompress");
+        return RET_ERROR;
+    }
+    logMessage(LOG_LEVEL_INFO, "Main", "LoggerCompress created successfully");
+#endif
+
+    return RET_OK;
+}
+
 /**
  * @brief Main entry point of the program.
  *
- * Initializes components, creates tasks, and starts the FreeRTOS scheduler.
+ * Parses the startup options, initializes components, creates the tasks of
+ * the sides run by this process, and starts the FreeRTOS scheduler.
  */
-int main(void) {
-    
+int main(int argc, char **argv) {
+    if (parseOptions(argc, argv) != RET_OK) {
+        fprintf(stderr, "Usage: %s [-t queue|unix|shm] [-r all|master|slave]\n"
+                        "  -r master and -r slave need the unix or shm transport\n", argv[0]);
+        return 1;
+    }
+
     printf("Slave->Master state Machine system is run...");
 
     if (initComponents() != RET_OK) {
@@ -148,16 +445,21 @@ int main(void) {
         return 1;
     }
 
-    if (creatSlaveTasks() != RET_OK) {
+    if (role != MAIN_ROLE_MASTER && creatSlaveTasks() != RET_OK) {
         logMessage(LOG_LEVEL_ERROR, "Main", "Create Slave Tasks failed");
         return 1;
     }
 
-    if (creatMasterTasks() != RET_OK) {
+    if (role != MAIN_ROLE_SLAVE && creatMasterTasks() != RET_OK) {
         logMessage(LOG_LEVEL_ERROR, "Main", "Create Master Tasks failed");
         return 1;
     }
 
+    if (creatLoggerTasks() != RET_OK) {
+        logMessage(LOG_LEVEL_ERROR, "Main", "Create Logger Tasks failed");
+        return 1;
+    }
+
     vTaskStartScheduler();
     return 0;
 }
@@ -1,9 +1,10 @@
-#ifndef SLAVE_COMM_H
-#define SLAVE_COMM_H
+#ifndef MASTER_COMM_H
+#define MASTER_COMM_H
 
 
 
 #include "types.h"
+#include "comm_types.h"
 #include "FreeRTOS.h"
 #include "queue.h"
 
@@ -12,8 +13,8 @@ extern "C" {
 #endif
 
 /**
- * @file slave_comm.h
- * @brief Header file for Slave Communication module.
+ * @file master_comm.h
+ * @brief Header file for Master Communication module.
  *
  * This file declares functions for initializing communication queues,
  * sending messages to, and receiving messages from the slave system.
@@ -22,35 +23,225 @@ extern "C" {
 /**
  * @brief Initializes the master communication module.
  *
- * Sets up the communication queue for master-slave interactions.
+ * Sets up the two directional channels for master-slave interactions. A
+ * master-to-slave channel of length 1 is used as a latest-value mailbox.
  *
- * @param stateQueueHandle_ Queue handle for state communication.
+ * @param sendQueueHandle Queue handle of the master-to-slave channel.
+ * @param receiveQueueHandle Queue handle of the slave-to-master channel.
  */
-RetVal_t initMasterComm(QueueHandle_t stateQueueHandle_);
+RetVal_t initMasterComm(QueueHandle_t sendQueueHandle, QueueHandle_t receiveQueueHandle);
+
+/**
+ * @brief Initializes the master communication module with ring channels.
+ *
+ * Alternative to initMasterComm() that connects the master to the slave with
+ * two lock-free single-producer, single-consumer rings (comm_ring.h).
+ *
+ * @param sendRing Ring of the master-to-slave channel, initialized with commRingInit().
+ * @param receiveRing Ring of the slave-to-master channel, initialized with commRingInit().
+ * @return RET_OK if successful, RET_ERROR otherwise.
+ */
+RetVal_t initMasterCommRing(CommRing *sendRing, CommRing *receiveRing);
+
+/**
+ * @brief Initializes the master communication module with a transport.
+ *
+ * Alternative to initMasterComm() that sends and receives through the master end
+ * of a master-slave link (comm_transport.h): in-process queues, a Unix domain
+ * socket or shared memory, so the slave may run in another process.
+ *
+ * @param transport Master end of the link, opened with a commTransportOpen function.
+ * @return RET_OK if successful, RET_ERROR otherwise.
+ */
+RetVal_t initMasterCommTransport(CommTransport *transport);
+
+/**
+ * @brief Initializes the master communication module with fan-in channels.
+ *
+ * Alternative to initMasterComm() for a master that supervises several slaves,
+ * each with its own slave-to-master channel. The channels are added to one
+ * queue set, so reciveMsgMaster(), reciveMsgBatchMaster() and
+ * reciveMsgFanInMaster() wait on all of them at once and serve the ready
+ * channels round-robin. The channels must be empty and not in another set.
+ *
+ * @param sendQueueHandle Queue handle of the master-to-slave channel.
+ * @param receiveQueueHandles Queue handles of the slave-to-master channels.
+ * @param channelCount Number of slave-to-master channels (at most COMM_FANIN_MAX_CHANNELS).
+ * @return RET_OK if successful, RET_ERROR otherwise.
+ */
+RetVal_t initMasterCommFanIn(QueueHandle_t sendQueueHandle, const QueueHandle_t *receiveQueueHandles,
+                             uint32_t channelCount);
 
 /**
  * @brief Sends a message to the slave queue.
  *
  * Wraps the internal queue send mechanism to ensure proper delivery of messages
- * to the slave system.
+ * to the slave system. The source id and the sequence number of the envelope
+ * are filled in by this function. The pacing delay (see setSendPacingMaster())
+ * is applied after sending.
  *
- * @param data Pointer to the data to send.
+ * @param message Message to send (type and payload set by the caller).
  * @return RET_OK if the message was successfully sent, RET_ERROR otherwise.
  */
-RetVal_t sendMsgMaster(const void *data);
+RetVal_t sendMsgMaster(const CommMessage *message);
+
+/**
+ * @brief Sends several messages to the slave queue in one call.
+ *
+ * Sends the messages back to back without pacing between them; the pacing
+ * delay is applied once after the batch. Stops at the first failed send.
+ *
+ * @param messages Messages to send (type and payload set by the caller).
+ * @param count Number of messages.
+ * @param sentCount Pointer to store the number of messages sent, may be NULL.
+ * @return RET_OK if all messages were sent, RET_ERROR otherwise.
+ */
+RetVal_t sendMsgBatchMaster(const CommMessage *messages, uint32_t count, uint32_t *sentCount);
+
+/**
+ * @brief Sends the master state changes the slave does not have.
+ *
+ * Sets the master state in the master's sync holder (comm_sync.h) and sends,
+ * as one batch, the sync requests the master owes the slaves (at start-up and
+ * after a lost slave state) and the master state changes after the version
+ * the slave has. Nothing is sent while the state is unchanged and no request
+ * is owed, except a message held back by COMM_OVERFLOW_COALESCE, which is
+ * sent first. Must be called by one task only.
+ *
+ * @param state Current master state (MasterStates value).
+ * @param traceId Trace of the state, 0 if untraced.
+ * @param sentCount Pointer to store the number of messages sent, may be NULL.
+ * @return RET_OK if everything owed was sent, RET_ERROR otherwise.
+ */
+RetVal_t syncStateMaster(int32_t state, uint32_t traceId, uint32_t *sentCount);
 
 /**
  * @brief Receives a message from the slave queue.
  *
- * Waits for and retrieves a message from the communication queue.
+ * Waits for and retrieves a message from the slave-to-master channel. The
+ * state sync consumes the sync requests of the slave and the slave states the
+ * master already has; for them RET_ERROR is returned.
+ *
+ * @param message Pointer to store the received message.
+ * @return RET_OK if a message from the slave was received, RET_ERROR otherwise.
+ */
+RetVal_t reciveMsgMaster(CommMessage *message);
+
+/**
+ * @brief Receives several messages from the slave queue in one call.
+ *
+ * Blocks until a message is available, then drains the already queued
+ * messages without blocking, up to capacity. Messages consumed by the state
+ * sync are left out, so only slave state changes the master does not have
+ * are returned.
+ *
+ * @param messages Array to store the received messages.
+ * @param capacity Size of the array.
+ * @param receivedCount Pointer to store the number of messages received.
+ * @return RET_OK if at least one message from the slave was received, RET_ERROR otherwise.
+ */
+RetVal_t reciveMsgBatchMaster(CommMessage *messages, uint32_t capacity, uint32_t *receivedCount);
+
+/**
+ * @brief Receives several messages from the slave channels with their channel ids.
+ *
+ * Same as reciveMsgBatchMaster(), and also reports the channel of each message:
+ * its index in the array given to initMasterCommFanIn(), or 0 without fan-in.
+ *
+ * @param messages Array to store the received messages.
+ * @param channels Array to store the channel id of each message.
+ * @param capacity Size of the arrays.
+ * @param receivedCount Pointer to store the number of messages received.
+ * @return RET_OK if at least one message from a slave was received, RET_ERROR otherwise.
+ */
+RetVal_t reciveMsgFanInMaster(CommMessage *messages, uint32_t *channels, uint32_t capacity, uint32_t *receivedCount);
+
+/**
+ * @brief Sets the send pacing policy.
+ *
+ * Defaults to DELAY_SEND_MS.
+ *
+ * @param delayMs Delay after each send call (in ms), 0 to disable pacing.
+ */
+void setSendPacingMaster(uint32_t delayMs);
+
+/**
+ * @brief Sets the overflow policy of the master-to-slave channel.
+ *
+ * Applies when a FIFO channel is full; a mailbox channel is always overwritten.
+ * Every init function restores COMM_OVERFLOW_BLOCK with a TICK_TO_WAIT_SEND_MS
+ * deadline. With COMM_OVERFLOW_COALESCE the held back message is sent by the
+ * next send or sync call, before the new message. COMM_OVERFLOW_DROP_OLDEST is
+ * refused on a ring channel or a transport.
+ *
+ * @param policy Policy applied when the channel is full.
+ * @param deadlineMs Maximum wait of COMM_OVERFLOW_BLOCK (in ms), unused by the others.
+ * @return RET_OK if the policy was set, RET_ERROR otherwise.
+ */
+RetVal_t setOverflowPolicyMaster(CommOverflowPolicy policy, uint32_t deadlineMs);
+
+/**
+ * @brief Returns how often each overflow policy fired since start-up.
+ *
+ * @param stats Pointer to store the counters.
+ */
+void getOverflowStatsMaster(CommOverflowStats *stats);
+
+/**
+ * @brief Initializes the slave-to-master block channel.
+ *
+ * The channel carries CommBlock pointers from the message block pool
+ * (comm_pool.h), so large payloads reach the master without being copied.
+ *
+ * @param blockQueueHandle Queue handle of the channel, with items of sizeof(CommBlock *).
+ * @return RET_OK if successful, RET_ERROR otherwise.
+ */
+RetVal_t initBlockChannelMaster(QueueHandle_t blockQueueHandle);
+
+/**
+ * @brief Receives a message block from the slave.
+ *
+ * Blocks until a block is available. The caller owns the reference that came
+ * with the block and must drop it with commBlockRelease().
+ *
+ * @param block Pointer to store the received block.
+ * @return RET_OK if a block was received, RET_ERROR otherwise.
+ */
+RetVal_t reciveBlockMaster(CommBlock **block);
+
+/**
+ * @brief Connects the master to the payload pipeline of the TCP server.
+ *
+ * @param pipeline Initialized pipeline with a COMM_PAYLOAD_CONSUMER_MASTER consumer (comm_pipeline.h).
+ * @return RET_OK if successful, RET_ERROR otherwise.
+ */
+RetVal_t initPayloadPipelineMaster(CommPipeline *pipeline);
+
+/**
+ * @brief Receives the next payload forwarded by the slave.
+ *
+ * Blocks until a payload is available and copies it, with its original
+ * length, into the caller's buffer.
+ *
+ * @param payload Buffer to store the payload.
+ * @param capacity Size of payload, at least COMM_PIPELINE_MAX_PAYLOAD bytes.
+ * @param length Pointer to store the payload length.
+ * @return RET_OK if a payload was received, RET_ERROR otherwise.
+ */
+RetVal_t recivePayloadMaster(void *payload, uint32_t capacity, uint32_t *length);
+
+/**
+ * @brief Returns the number of slave messages that were never received.
+ *
+ * Computed from the gaps in the sequence numbers. With mailbox channels
+ * these are the stale states skipped by the reader.
  *
- * @param data Pointer to store the received data.
- * @return RET_OK if a message was successfully received, RET_ERROR otherwise.
+ * @return Total number of skipped messages since start-up.
  */
-RetVal_t reciveMsgMaster(void *data);
+uint32_t getSkippedMsgMaster(void);
 
 #ifdef __cplusplus
 }
 #endif
 
-#endif // SLAVE_COMM_H
+#endif // MASTER_COMM_H
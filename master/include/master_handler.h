@@ -30,13 +30,23 @@ void vMasterReciverHandler(void *args);
 /**
  * @brief Handles master status check tasks.
  *
- * This task periodically retrieves the current state of the master system
- * and sends updates to the slave system.
+ * This task sends the master state changes to the slave system as they
+ * happen, with a periodic heartbeat as a fallback.
  *
  * @param args Pointer to task arguments (if any).
  */
 void vMasterSenderHandler(void *args);
 
+/**
+ * @brief Handles telemetry payloads forwarded by the slave.
+ *
+ * This task receives the TCP client payloads from the payload pipeline and
+ * consumes them.
+ *
+ * @param args Pointer to task arguments (if any).
+ */
+void vMasterTelemetryHandler(void *args);
+
 #ifdef __cplusplus
 }
 #endif
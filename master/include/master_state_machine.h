@@ -5,6 +5,7 @@
 #include "FreeRTOS.h"
 #include "queue.h"
 #include "semphr.h"
+#include "event_groups.h"
 
 #include "state_mashine_types.h"
 
@@ -17,10 +18,12 @@ extern "C" {
  *
  * - currentState: Tracks the current state.
  * - stateSemaphore: Mutex for ensuring thread-safe state transitions.
+ * - stateEvents: Event group signalling state changes to waitStateChangeMaster().
  */
 typedef struct {
     MasterStates currentState; ///< Current state of the master system.
     SemaphoreHandle_t stateSemaphore; ///< Semaphore for state synchronization.
+    EventGroupHandle_t stateEvents; ///< Event group signalling state changes.
 } MasterStatesConditionHandler;
 
 /**
@@ -35,7 +38,7 @@ typedef struct {
  * @brief Initializes the state semaphore for master state synchronization.
  *
  * This function sets up the semaphore required for thread-safe state transitions
- * in the master state machine.
+ * in the master state machine, and the event group that signals state changes.
  *
  * @return RET_OK if the semaphore was successfully initialized, RET_ERROR otherwise.
  */
@@ -63,6 +66,18 @@ RetVal_t stateDispatcher(SlaveStates data);
  */
 RetVal_t getCurrentState(MasterStates* currentState);
 
+/**
+ * @brief Waits until the master state changes.
+ *
+ * Returns as soon as the state changed since the previous call, so a task
+ * that propagates the state wakes on the change instead of polling. The
+ * change is consumed by the call, so one task waits on it.
+ *
+ * @param ticksToWait Maximum time to wait, the period of the caller's heartbeat.
+ * @return RET_OK if the state changed, RET_ERROR if the wait timed out.
+ */
+RetVal_t waitStateChangeMaster(TickType_t ticksToWait);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,10 +1,16 @@
 #include <stdio.h>
+#include <string.h>
 #include "FreeRTOS.h"
 #include "logger.h"
 #include "queue.h"
 #include "master_comm.h"
 #include "task.h"
 #include "comm_cfg.h"
+#include "comm_ring.h"
+#include "comm_transport.h"
+#include "comm_pipeline.h"
+#include "comm_sync.h"
+#include "logger_cfg.h"
 
 /**
  * @file master_comm.c
@@ -12,95 +18,933 @@
  *
  * This file defines functions for initializing communication queues,
  * sending messages, and receiving messages between the master and slave systems.
+ * The master sends on the master-to-slave channel and receives on the
+ * slave-to-master channel only, so it never consumes its own messages.
+ *
+ * The receive functions take part in the state sync (comm_sync.h): they
+ * consume the sync requests of the slave and drop the slave states the
+ * master already has, and flag a request when slave states were lost.
+ * syncStateMaster() sends the flagged requests and the master state changes.
+ * The receiving task and the sending task share only the request flags and
+ * versions, through atomics.
+ */
+
+/**
+ * @brief Queue handle of the master-to-slave channel.
+ */
+static QueueHandle_t sendQueueHandle_ = NULL;
+
+/**
+ * @brief Queue handle of the slave-to-master channel.
+ */
+static QueueHandle_t receiveQueueHandle_ = NULL;
+
+/**
+ * @brief Ring of the master-to-slave channel, or NULL if the channel is a queue.
+ */
+static CommRing *sendRing_ = NULL;
+
+/**
+ * @brief Ring of the slave-to-master channel, or NULL if the channel is a queue.
+ */
+static CommRing *receiveRing_ = NULL;
+
+/**
+ * @brief Transport end of the link to the slave, or NULL if the channels are local.
+ */
+static CommTransport *transport_ = NULL;
+
+/**
+ * @brief Queue set over the slave-to-master channels, or NULL without fan-in.
+ */
+static QueueSetHandle_t fanInSet_ = NULL;
+
+/**
+ * @brief Slave-to-master channels of the fan-in, indexed by channel id.
+ */
+static QueueHandle_t fanInQueues_[COMM_FANIN_MAX_CHANNELS];
+
+/**
+ * @brief Messages selected from the set but not yet received, per channel.
+ */
+static uint32_t fanInPending_[COMM_FANIN_MAX_CHANNELS];
+
+/**
+ * @brief Number of fan-in channels.
+ */
+static uint32_t fanInChannels_ = 0;
+
+/**
+ * @brief Sum of fanInPending_.
+ */
+static uint32_t fanInReady_ = 0;
+
+/**
+ * @brief Channel the next round-robin pass starts from.
+ */
+static uint32_t fanInNext_ = 0;
+
+/**
+ * @brief Queue handle of the slave-to-master block channel (CommBlock pointers).
+ */
+static QueueHandle_t blockQueueHandle_ = NULL;
+
+/**
+ * @brief Pipeline carrying the TCP payloads, read as COMM_PAYLOAD_CONSUMER_MASTER.
+ */
+static CommPipeline *payloadPipeline_ = NULL;
+
+/**
+ * @brief Sequence number (version) of the next message sent.
+ */
+static uint16_t sendSequence_ = 0;
+
+/**
+ * @brief Sequence number expected for the next message received, per channel.
+ */
+static uint16_t receiveSequence_[COMM_FANIN_MAX_CHANNELS];
+
+/**
+ * @brief Number of messages of the peer that were never received.
+ */
+static uint32_t skippedMessages_ = 0;
+
+/**
+ * @brief Set if the master-to-slave channel is a latest-value mailbox.
+ */
+static uint8_t sendMailbox_ = 0;
+
+/**
+ * @brief Pacing delay after each send call (in ms), 0 if pacing is off.
+ */
+static uint32_t sendPacingMs_ = DELAY_SEND_MS;
+
+/**
+ * @brief Overflow policy of the master-to-slave channel.
+ */
+static CommOverflowPolicy overflowPolicy_ = COMM_OVERFLOW_BLOCK;
+
+/**
+ * @brief Deadline of the blocking policy (in ticks).
+ */
+static TickType_t overflowDeadline_ = pdMS_TO_TICKS(TICK_TO_WAIT_SEND_MS);
+
+/**
+ * @brief Message held back by the coalescing policy, valid if pendingValid_ is set.
+ */
+static CommMessage pending_;
+
+/**
+ * @brief Set while pending_ holds a message.
+ */
+static uint8_t pendingValid_ = 0;
+
+/**
+ * @brief Number of times each overflow policy fired.
+ */
+static CommOverflowStats overflowStats_ = {0, 0, 0};
+
+/**
+ * @brief Sync holder of the master state.
+ */
+static CommSyncHolder stateHolder_;
+
+/**
+ * @brief Version of each slave's holder the master has every change of, per channel.
+ */
+static uint32_t syncVersion_[COMM_FANIN_MAX_CHANNELS];
+
+/**
+ * @brief Set per channel while the master owes the slave a sync request.
+ */
+static uint8_t syncPending_[COMM_FANIN_MAX_CHANNELS];
+
+/**
+ * @brief Number of slave channels taking part in the sync.
+ */
+static uint32_t syncChannels_ = 0;
+
+/**
+ * @brief Version of the last sync request of the slave, valid once syncRequested_ is set.
  */
+static uint32_t syncRequestVersion_ = 0;
 
 /**
- * @brief Queue handle for state signals.
+ * @brief Set when the slave asked for the master state changes since the last syncStateMaster().
  */
-static QueueHandle_t stateQueueHandle_ = NULL;
+static uint8_t syncRequested_ = 0;
 
 /**
  * @brief Internal function to send data to the queue.
  *
- * Ensures that data is properly sent to the queue with a timeout.
+ * Ensures that data is properly sent to the queue with a timeout. A mailbox
+ * channel is overwritten without waiting. A ring channel is used instead of
+ * the queue when one is set.
  *
  * @param data Pointer to the data to send.
- * @param ticks_to_wait Maximum time to wait for space.
+ * @param ticks_to_wait Maximum time to wait for space (unused for a mailbox).
  * @return pdPASS if successful, pdFAIL otherwise.
  */
 static BaseType_t queueSend(const void *data, TickType_t ticks_to_wait) {
-    if (stateQueueHandle_ == NULL) {
-        logMessage(LOG_LEVEL_ERROR, "MasterComm", "Queue handle is not initialized in queueSend");
+    if (transport_ != NULL) {
+        return (commTransportSend(transport_, data, ticks_to_wait) == RET_OK) ? pdPASS : pdFAIL;
+    }
+    if (sendRing_ != NULL) {
+        return (commRingSend(sendRing_, data, ticks_to_wait) == RET_OK) ? pdPASS : pdFAIL;
+    }
+    if (sendQueueHandle_ == NULL) {
+        LOG_MSG(LOG_LEVEL_ERROR, "MasterComm", "Queue handle is not initialized in queueSend");
         return pdFAIL;
     }
-    return xQueueSend(stateQueueHandle_, data, ticks_to_wait);
+    if (sendMailbox_) {
+        // A mailbox holds only the newest message; overwrite it instead of waiting for space
+        return xQueueOverwrite(sendQueueHandle_, data);
+    }
+    return xQueueSend(sendQueueHandle_, data, ticks_to_wait);
+}
+
+/**
+ * @brief Records a set member selected from the fan-in queue set.
+ *
+ * @param member Queue handle returned by xQueueSelectFromSet().
+ */
+static void fanInCollect(QueueSetMemberHandle_t member) {
+    for (uint32_t i = 0; i < fanInChannels_; i++) {
+        if (fanInQueues_[i] == (QueueHandle_t)member) {
+            fanInPending_[i]++;
+            fanInReady_++;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Receives the next message over the fan-in channels.
+ *
+ * When no selected message is left, waits on the queue set and then collects
+ * every other member already in the set without blocking, so one wake-up
+ * covers all the channels that are ready. The ready channels are served
+ * round-robin, one message per channel per pass, so a busy slave cannot starve
+ * the others. Each member is received from only after it was selected from the
+ * set, as FreeRTOS requires.
+ *
+ * @param data Pointer to store received data.
+ * @param channel Pointer to store the channel id the data came from.
+ * @param ticks_to_wait Maximum time to wait for data.
+ * @return pdPASS if successful, pdFAIL otherwise.
+ */
+static BaseType_t fanInReceive(void *data, uint32_t *channel, TickType_t ticks_to_wait) {
+    if (fanInReady_ == 0) {
+        QueueSetMemberHandle_t member = xQueueSelectFromSet(fanInSet_, ticks_to_wait);
+        while (member != NULL) {
+            fanInCollect(member);
+            member = xQueueSelectFromSet(fanInSet_, 0);
+        }
+        if (fanInReady_ == 0) {
+            return pdFAIL;
+        }
+    }
+
+    for (uint32_t i = 0; i < fanInChannels_; i++) {
+        uint32_t index = (fanInNext_ + i) % fanInChannels_;
+        if (fanInPending_[index] != 0) {
+            fanInPending_[index]--;
+            fanInReady_--;
+            fanInNext_ = (index + 1) % fanInChannels_;
+            *channel = index;
+            return xQueueReceive(fanInQueues_[index], data, 0);
+        }
+    }
+    return pdFAIL;
 }
 
 /**
  * @brief Internal function to receive data from the queue.
  *
- * Ensures that data is properly received from the queue with a timeout.
+ * Ensures that data is properly received from the queue with a timeout. A ring
+ * channel, or the fan-in queue set, is used instead of the queue when one is
+ * set.
  *
  * @param data Pointer to store received data.
+ * @param channel Pointer to store the channel id the data came from (0 without fan-in).
  * @param ticks_to_wait Maximum time to wait for data.
  * @return pdPASS if successful, pdFAIL otherwise.
  */
-static BaseType_t queueReceive(void *data, TickType_t ticks_to_wait) {
-    if (stateQueueHandle_ == NULL) {
-        logMessage(LOG_LEVEL_ERROR, "MasterComm", "Queue handle is not initialized in queueReceive");
+static BaseType_t queueReceive(void *data, uint32_t *channel, TickType_t ticks_to_wait) {
+    *channel = 0;
+    if (fanInSet_ != NULL) {
+        return fanInReceive(data, channel, ticks_to_wait);
+    }
+    if (transport_ != NULL) {
+        return (commTransportReceive(transport_, data, ticks_to_wait) == RET_OK) ? pdPASS : pdFAIL;
+    }
+    if (receiveRing_ != NULL) {
+        return (commRingReceive(receiveRing_, data, ticks_to_wait) == RET_OK) ? pdPASS : pdFAIL;
+    }
+    if (receiveQueueHandle_ == NULL) {
+        LOG_MSG(LOG_LEVEL_ERROR, "MasterComm", "Queue handle is not initialized in queueReceive");
         return pdFAIL;
     }
-    return xQueueReceive(stateQueueHandle_, data, ticks_to_wait);
+    return xQueueReceive(receiveQueueHandle_, data, ticks_to_wait);
+}
+
+/**
+ * @brief Sends the message held back by the coalescing policy, if the channel has room.
+ */
+static void flushPending(void) {
+    if (pendingValid_ && queueSend(&pending_, 0) == pdPASS) {
+        pendingValid_ = 0;
+    }
+}
+
+/**
+ * @brief Sends a stamped envelope according to the overflow policy of the channel.
+ *
+ * A mailbox is overwritten whatever the policy. A message held back by the
+ * coalescing policy is sent first, so it is never overtaken by a newer one.
+ *
+ * @param envelope Envelope to send.
+ * @return pdPASS if the envelope was sent or held back, pdFAIL otherwise.
+ */
+static BaseType_t channelSend(const CommMessage *envelope) {
+    CommMessage oldest;
+
+    if (sendMailbox_) {
+        return queueSend(envelope, 0);
+    }
+    flushPending();
+
+    switch (overflowPolicy_) {
+    case COMM_OVERFLOW_COALESCE:
+        if (!pendingValid_ && queueSend(envelope, 0) == pdPASS) {
+            return pdPASS;
+        }
+        pending_ = *envelope;
+        pendingValid_ = 1;
+        overflowStats_.coalesced++;
+        return pdPASS;
+    case COMM_OVERFLOW_DROP_OLDEST:
+        if (queueSend(envelope, 0) == pdPASS) {
+            return pdPASS;
+        }
+        if (xQueueReceive(sendQueueHandle_, &oldest, 0) == pdPASS) {
+            overflowStats_.droppedOldest++;
+        }
+        return queueSend(envelope, 0);
+    default:
+        if (queueSend(envelope, overflowDeadline_) == pdPASS) {
+            return pdPASS;
+        }
+        overflowStats_.deadlineExpired++;
+        return pdFAIL;
+    }
+}
+
+/**
+ * @brief Stamps a copy of the envelope and sends it on the master-to-slave channel.
+ *
+ * @param message Message to send (type and payload set by the caller).
+ * @return pdPASS if successful, pdFAIL otherwise.
+ */
+static BaseType_t sendEnvelope(const CommMessage *message) {
+    CommMessage envelope = *message;
+    envelope.sourceId = COMM_SOURCE_MASTER;
+    envelope.sequence = sendSequence_;
+
+    if (channelSend(&envelope) != pdPASS) {
+        return pdFAIL;
+    }
+    sendSequence_++;
+    return pdPASS;
+}
+
+/**
+ * @brief Applies a received slave state to the sync version of its channel.
+ *
+ * @param message Slave state taken from a slave-to-master channel.
+ * @param channel Channel id the message came from.
+ * @return RET_OK if the state is a change the master does not have, RET_ERROR otherwise.
+ */
+static RetVal_t syncAccept(const CommMessage *message, uint32_t channel) {
+    uint32_t version = syncVersion_[channel];
+    CommSyncResult result = commSyncAccept(&version, message);
+
+    __atomic_store_n(&syncVersion_[channel], version, __ATOMIC_RELAXED);
+    if (result == COMM_SYNC_GAP) {
+        // Ask again from the version the master has; the sender task sends the request
+        __atomic_store_n(&syncPending_[channel], 1, __ATOMIC_RELEASE);
+        LOG_MSG_LIMITED(LOG_LEVEL_WARN, "MasterComm", LOG_RATE_LIMIT_HOT_PATH, "Slave state changes lost, resyncing");
+    }
+    return (result == COMM_SYNC_APPLY) ? RET_OK : RET_ERROR;
+}
+
+/**
+ * @brief Checks a received message and accounts for skipped sequence numbers.
+ *
+ * Each channel carries the sequence numbers of its own slave. Sync requests
+ * are recorded for syncStateMaster() and slave states are checked against the
+ * sync version of the channel; neither is passed on when it is consumed.
+ *
+ * @param message Message taken from a slave-to-master channel.
+ * @param channel Channel id the message came from.
+ * @return RET_OK if the message was sent by the slave and is for the caller, RET_ERROR otherwise.
+ */
+static RetVal_t acceptMessage(const CommMessage *message, uint32_t channel) {
+    if (message->sourceId != COMM_SOURCE_SLAVE || message->type >= COMM_MSG_MAX) {
+        LOG_MSG(LOG_LEVEL_ERROR, "MasterComm", "Rejected a message not sent by the slave");
+        return RET_ERROR;
+    }
+    skippedMessages_ += (uint16_t)(message->sequence - receiveSequence_[channel]);
+    receiveSequence_[channel] = (uint16_t)(message->sequence + 1);
+
+    if (message->type == COMM_MSG_SYNC_REQUEST) {
+        __atomic_store_n(&syncRequestVersion_, message->version, __ATOMIC_RELAXED);
+        __atomic_store_n(&syncRequested_, 1, __ATOMIC_RELEASE);
+        return RET_ERROR;
+    }
+    if (message->type == COMM_MSG_SLAVE_STATE) {
+        return syncAccept(message, channel);
+    }
+    return RET_OK;
+}
+
+/**
+ * @brief Receives up to capacity messages, blocking for the first one only.
+ *
+ * Messages consumed by the state sync do not count as the first one, so the
+ * wait goes on after a sync request or a state the master already has.
+ *
+ * @param messages Array to store the received messages.
+ * @param channels Array to store the channel id of each message, may be NULL.
+ * @param capacity Size of the arrays.
+ * @return Number of messages from the slaves received.
+ */
+static uint32_t receiveBatch(CommMessage *messages, uint32_t *channels, uint32_t capacity) {
+    uint32_t received = 0;
+    uint32_t channel = 0;
+    TickType_t ticksToWait = portMAX_DELAY;
+
+    while (received < capacity && queueReceive(&messages[received], &channel, ticksToWait) == pdPASS) {
+        // A slave message that is not returned was consumed by the sync
+        uint8_t sync = (messages[received].sourceId == COMM_SOURCE_SLAVE);
+        if (acceptMessage(&messages[received], channel) == RET_OK) {
+            if (channels != NULL) {
+                channels[received] = channel;
+            }
+            received++;
+        }
+        if (received != 0 || !sync) {
+            ticksToWait = 0;
+        }
+    }
+    return received;
+}
+
+/**
+ * @brief Applies the send pacing policy.
+ */
+static void pace(void) {
+    if (sendPacingMs_ != 0) {
+        vTaskDelay(pdMS_TO_TICKS(sendPacingMs_));
+    }
+}
+
+/**
+ * @brief Restores the default overflow policy and drops any held back message.
+ */
+static void resetOverflow(void) {
+    overflowPolicy_ = COMM_OVERFLOW_BLOCK;
+    overflowDeadline_ = pdMS_TO_TICKS(TICK_TO_WAIT_SEND_MS);
+    pendingValid_ = 0;
+}
+
+/**
+ * @brief Expects sequence number 0 next on every slave channel.
+ *
+ * Called by every init function, so sequences of channels used before do not
+ * count as skipped messages on the new ones.
+ */
+static void resetReceiveSequences(void) {
+    for (uint32_t i = 0; i < COMM_FANIN_MAX_CHANNELS; i++) {
+        receiveSequence_[i] = 0;
+    }
+}
+
+/**
+ * @brief Starts the state sync over with no state known on either side.
+ *
+ * The master owes every slave a request for all of its states.
+ *
+ * @param channelCount Number of slave channels.
+ */
+static void resetSync(uint32_t channelCount) {
+    commSyncInit(&stateHolder_);
+    for (uint32_t i = 0; i < channelCount; i++) {
+        syncVersion_[i] = 0;
+        syncPending_[i] = 1;
+    }
+    syncChannels_ = channelCount;
+    syncRequested_ = 0;
 }
 
 /**
  * @brief Initializes the master communication module.
  *
- * Sets up the communication queue for master-slave interactions.
+ * Sets up the two directional channels for master-slave interactions. A
+ * master-to-slave channel of length 1 is used as a latest-value mailbox.
  *
- * @param stateQueueHandle Queue handle for state communication.
+ * @param sendQueueHandle Queue handle of the master-to-slave channel.
+ * @param receiveQueueHandle Queue handle of the slave-to-master channel.
  */
-RetVal_t initMasterComm(QueueHandle_t stateQueueHandle) {
-    if(stateQueueHandle == NULL) {
-        logMessage(LOG_LEVEL_ERROR, "MasterComm", "Queue handle is NULL");
+RetVal_t initMasterComm(QueueHandle_t sendQueueHandle, QueueHandle_t receiveQueueHandle) {
+    if(sendQueueHandle == NULL || receiveQueueHandle == NULL) {
+        LOG_MSG(LOG_LEVEL_ERROR, "MasterComm", "Queue handle is NULL");
         return RET_ERROR;
     }
 
-    stateQueueHandle_ = stateQueueHandle;
+    sendQueueHandle_ = sendQueueHandle;
+    receiveQueueHandle_ = receiveQueueHandle;
+    sendRing_ = NULL;
+    receiveRing_ = NULL;
+    transport_ = NULL;
+    fanInSet_ = NULL;
+    // The channel is empty here, so its free space is its length; xQueueOverwrite() needs a length of 1
+    sendMailbox_ = (uxQueueSpacesAvailable(sendQueueHandle) == 1);
+    resetOverflow();
+    resetReceiveSequences();
+    resetSync(1);
+    return RET_OK;
+}
+
+/**
+ * @brief Initializes the master communication module with ring channels.
+ *
+ * Uses two lock-free rings instead of FreeRTOS queues. The master sender task
+ * must be the only producer of the send ring and the master receiver task the
+ * only consumer of the receive ring.
+ *
+ * @param sendRing Ring of the master-to-slave channel, initialized with commRingInit().
+ * @param receiveRing Ring of the slave-to-master channel, initialized with commRingInit().
+ * @return RET_OK if successful, RET_ERROR otherwise.
+ */
+RetVal_t initMasterCommRing(CommRing *sendRing, CommRing *receiveRing) {
+    if (sendRing == NULL || receiveRing == NULL) {
+        LOG_MSG(LOG_LEVEL_ERROR, "MasterComm", "Ring is NULL");
+        return RET_ERROR;
+    }
+
+    sendRing_ = sendRing;
+    receiveRing_ = receiveRing;
+    transport_ = NULL;
+    sendQueueHandle_ = NULL;
+    receiveQueueHandle_ = NULL;
+    sendMailbox_ = 0;
+    resetOverflow();
+    resetReceiveSequences();
+    resetSync(1);
+    fanInSet_ = NULL;
+    return RET_OK;
+}
+
+/**
+ * @brief Initializes the master communication module with fan-in channels.
+ *
+ * Adds every slave-to-master channel to one queue set, sized for all of their
+ * items, so a single receiver task waits on all the slaves at once. The
+ * channels must be empty and must not belong to another set. Meant to be
+ * called once at start-up.
+ *
+ * @param sendQueueHandle Queue handle of the master-to-slave channel.
+ * @param receiveQueueHandles Queue handles of the slave-to-master channels.
+ * @param channelCount Number of slave-to-master channels.
+ * @return RET_OK if successful, RET_ERROR otherwise.
+ */
+RetVal_t initMasterCommFanIn(QueueHandle_t sendQueueHandle, const QueueHandle_t *receiveQueueHandles,
+                             uint32_t channelCount) {
+    UBaseType_t setLength = 0;
+
+    if (sendQueueHandle == NULL || receiveQueueHandles == NULL || channelCount == 0 ||
+        channelCount > COMM_FANIN_MAX_CHANNELS) {
+        LOG_MSG(LOG_LEVEL_ERROR, "MasterComm", "Invalid fan-in channels");
+        return RET_ERROR;
+    }
+    for (uint32_t i = 0; i < channelCount; i++) {
+        if (receiveQueueHandles[i] == NULL) {
+            LOG_MSG(LOG_LEVEL_ERROR, "MasterComm", "Queue handle is NULL");
+            return RET_ERROR;
+        }
+        // The channels are empty here, so their free space is their length
+        setLength += uxQueueSpacesAvailable(receiveQueueHandles[i]);
+    }
+
+    QueueSetHandle_t set = xQueueCreateSet(setLength);
+    if (set == NULL) {
+        LOG_MSG(LOG_LEVEL_ERROR, "MasterComm", "Failed to create the fan-in queue set");
+        return RET_ERROR;
+    }
+    for (uint32_t i = 0; i < channelCount; i++) {
+        if (xQueueAddToSet(receiveQueueHandles[i], set) != pdPASS) {
+            LOG_MSG(LOG_LEVEL_ERROR, "MasterComm", "Failed to add a channel to the fan-in queue set");
+            return RET_ERROR;
+        }
+        fanInQueues_[i] = receiveQueueHandles[i];
+        fanInPending_[i] = 0;
+    }
+
+    sendQueueHandle_ = sendQueueHandle;
+    receiveQueueHandle_ = NULL;
+    sendRing_ = NULL;
+    receiveRing_ = NULL;
+    transport_ = NULL;
+    sendMailbox_ = (uxQueueSpacesAvailable(sendQueueHandle) == 1);
+    resetOverflow();
+    resetReceiveSequences();
+    resetSync(channelCount);
+    fanInChannels_ = channelCount;
+    fanInReady_ = 0;
+    fanInNext_ = 0;
+    fanInSet_ = set;
+    return RET_OK;
+}
+
+/**
+ * @brief Initializes the master communication module with a transport.
+ *
+ * Sends and receives through one end of a master-slave link (comm_transport.h)
+ * instead of local channels, so the slave may run in another process. The
+ * transport is FIFO and never a mailbox.
+ *
+ * @param transport Master end of the link, opened with a commTransportOpen function.
+ * @return RET_OK if successful, RET_ERROR otherwise.
+ */
+RetVal_t initMasterCommTransport(CommTransport *transport) {
+    if (transport == NULL) {
+        LOG_MSG(LOG_LEVEL_ERROR, "MasterComm", "Transport is NULL");
+        return RET_ERROR;
+    }
+
+    transport_ = transport;
+    sendQueueHandle_ = NULL;
+    receiveQueueHandle_ = NULL;
+    sendRing_ = NULL;
+    receiveRing_ = NULL;
+    sendMailbox_ = 0;
+    fanInSet_ = NULL;
+    resetOverflow();
+    resetReceiveSequences();
+    resetSync(1);
     return RET_OK;
 }
 
 /**
  * @brief Sends a message to the slave queue.
  *
- * Wraps the internal queueSend function to ensure proper message delivery.
+ * Stamps the source id and the sequence number into a copy of the envelope and
+ * sends it on the master-to-slave channel, then applies the pacing policy.
  *
- * @param data Pointer to the data to send.
+ * @param message Message to send (type and payload set by the caller).
  * @return RET_OK if successful, RET_ERROR otherwise.
  */
-RetVal_t sendMsgMaster(const void *data) {
-    if (queueSend(data, pdMS_TO_TICKS(TICK_TO_WAIT_SEND_MS)) != pdPASS) {
-        logMessage(LOG_LEVEL_ERROR, "MasterComm", "Failed to send message to the queue");
+RetVal_t sendMsgMaster(const CommMessage *message) {
+    if (sendEnvelope(message) != pdPASS) {
+        LOG_MSG(LOG_LEVEL_ERROR, "MasterComm", "Failed to send message to the queue");
+        return RET_ERROR;
+    }
+    LOG_MSG_LIMITED(LOG_LEVEL_DEBUG, "MasterComm", LOG_RATE_LIMIT_HOT_PATH, "Message sent successfully");
+    pace();
+    return RET_OK;
+}
+
+/**
+ * @brief Sends several messages to the slave queue in one call.
+ *
+ * The messages are stamped and sent back to back; the pacing policy is applied
+ * once, after the whole batch. Stops at the first message that cannot be sent.
+ *
+ * @param messages Messages to send (type and payload set by the caller).
+ * @param count Number of messages.
+ * @param sentCount Pointer to store the number of messages sent, may be NULL.
+ * @return RET_OK if all messages were sent, RET_ERROR otherwise.
+ */
+RetVal_t sendMsgBatchMaster(const CommMessage *messages, uint32_t count, uint32_t *sentCount) {
+    uint32_t sent = 0;
+    while (sent < count && sendEnvelope(&messages[sent]) == pdPASS) {
+        sent++;
+    }
+    if (sentCount != NULL) {
+        *sentCount = sent;
+    }
+    if (sent != count) {
+        LOG_MSG(LOG_LEVEL_ERROR, "MasterComm", "Failed to send a message batch to the queue");
+        return RET_ERROR;
+    }
+    LOG_MSG_LIMITED(LOG_LEVEL_DEBUG, "MasterComm", LOG_RATE_LIMIT_HOT_PATH, "Message batch sent successfully");
+    pace();
+    return RET_OK;
+}
+
+/**
+ * @brief Sends the master state changes and the sync requests the master owes.
+ *
+ * The requests go first, then the changes after the version the slave has,
+ * back to back as one batch with the pacing applied once. A request that
+ * could not be sent stays owed; changes that could not be sent are sent by
+ * the next call. Over a mailbox channel, which keeps only the newest message,
+ * no request is sent and every call sends the master state as a snapshot.
+ *
+ * @param state Current master state (MasterStates value).
+ * @param traceId Trace of the state, 0 if untraced.
+ * @param sentCount Pointer to store the number of messages sent, may be NULL.
+ * @return RET_OK if everything owed was sent, RET_ERROR otherwise.
+ */
+RetVal_t syncStateMaster(int32_t state, uint32_t traceId, uint32_t *sentCount) {
+    static CommMessage batch[COMM_FANIN_MAX_CHANNELS + COMM_SYNC_MAX_ENTRIES];
+    uint32_t requests = 0;
+    uint32_t sent = 0;
+
+    // A mailbox may overwrite a request or a change, so it carries the whole state instead
+    if (!sendMailbox_) {
+        // The sender may have no change to send for a long time; do not leave a held back change behind
+        flushPending();
+        for (uint32_t i = 0; i < syncChannels_; i++) {
+            if (__atomic_exchange_n(&syncPending_[i], 0, __ATOMIC_ACQUIRE)) {
+                CommMessage *request = &batch[requests++];
+                memset(request, 0, sizeof(*request));
+                request->type = COMM_MSG_SYNC_REQUEST;
+                request->slaveId = i;
+                request->version = __atomic_load_n(&syncVersion_[i], __ATOMIC_RELAXED);
+            }
+        }
+        if (__atomic_exchange_n(&syncRequested_, 0, __ATOMIC_ACQUIRE)) {
+            commSyncRequest(&stateHolder_, __atomic_load_n(&syncRequestVersion_, __ATOMIC_RELAXED));
+        }
+    }
+    // The holder has only the master state, so it is never full
+    (void)commSyncSet(&stateHolder_, 0, state, traceId);
+    uint32_t count = requests;
+    if (sendMailbox_) {
+        count += commSyncCollectSnapshot(&stateHolder_, COMM_MSG_MASTER_STATE, &batch[requests],
+                                         COMM_SYNC_MAX_ENTRIES);
+    } else {
+        count += commSyncCollect(&stateHolder_, COMM_MSG_MASTER_STATE, &batch[requests], COMM_SYNC_MAX_ENTRIES);
+    }
+
+    while (sent < count && sendEnvelope(&batch[sent]) == pdPASS) {
+        sent++;
+    }
+    for (uint32_t i = sent; i < requests; i++) {
+        __atomic_store_n(&syncPending_[batch[i].slaveId], 1, __ATOMIC_RELEASE);
+    }
+    if (sent > requests) {
+        commSyncSent(&stateHolder_, &batch[requests], sent - requests);
+    }
+    if (sentCount != NULL) {
+        *sentCount = sent;
+    }
+    if (sent != count) {
+        LOG_MSG(LOG_LEVEL_ERROR, "MasterComm", "Failed to send the master state changes");
         return RET_ERROR;
     }
-    logMessage(LOG_LEVEL_DEBUG, "MasterComm", "Message sent successfully");
-    vTaskDelay(pdMS_TO_TICKS(DELAY_SEND_MS));
+    if (count != 0) {
+        LOG_MSG_LIMITED(LOG_LEVEL_DEBUG, "MasterComm", LOG_RATE_LIMIT_HOT_PATH, "State changes sent successfully");
+        pace();
+    }
     return RET_OK;
 }
 
 /**
  * @brief Receives a message from the slave queue.
  *
- * Waits for and retrieves a message from the communication queue.
+ * Waits for and retrieves a message from the slave-to-master channel. Messages
+ * that were not sent by the slave are rejected, and messages consumed by the
+ * state sync are not returned.
  *
- * @param data Pointer to store the received data.
+ * @param message Pointer to store the received message.
  * @return RET_OK if successful, RET_ERROR otherwise.
  */
-RetVal_t reciveMsgMaster(void *data) {
-    if (queueReceive(data, portMAX_DELAY) == pdPASS) {
-        logMessage(LOG_LEVEL_DEBUG, "MasterComm", "Message received successfully");
+RetVal_t reciveMsgMaster(CommMessage *message) {
+    uint32_t channel = 0;
+
+    if (queueReceive(message, &channel, portMAX_DELAY) == pdPASS) {
+        if (acceptMessage(message, channel) != RET_OK) {
+            return RET_ERROR;
+        }
+        LOG_MSG_LIMITED(LOG_LEVEL_DEBUG, "MasterComm", LOG_RATE_LIMIT_HOT_PATH, "Message received successfully");
         return RET_OK;
     }
-    logMessage(LOG_LEVEL_ERROR, "MasterComm", "Failed to receive message from the queue");
+    LOG_MSG(LOG_LEVEL_ERROR, "MasterComm", "Failed to receive message from the queue");
     return RET_ERROR;
 }
+
+/**
+ * @brief Receives several messages from the slave queue in one call.
+ *
+ * Waits for the first message, then drains the messages already queued without
+ * blocking, up to capacity. Messages that were not sent by the slave, and
+ * messages consumed by the state sync, are dropped.
+ *
+ * @param messages Array to store the received messages.
+ * @param capacity Size of the array.
+ * @param receivedCount Pointer to store the number of messages received.
+ * @return RET_OK if at least one message from the slave was received, RET_ERROR otherwise.
+ */
+RetVal_t reciveMsgBatchMaster(CommMessage *messages, uint32_t capacity, uint32_t *receivedCount) {
+    *receivedCount = receiveBatch(messages, NULL, capacity);
+    if (*receivedCount == 0) {
+        LOG_MSG(LOG_LEVEL_ERROR, "MasterComm", "Failed to receive a message batch from the queue");
+        return RET_ERROR;
+    }
+    LOG_MSG_LIMITED(LOG_LEVEL_DEBUG, "MasterComm", LOG_RATE_LIMIT_HOT_PATH, "Message batch received successfully");
+    return RET_OK;
+}
+
+/**
+ * @brief Receives several messages with the channel id of each one.
+ *
+ * Same as reciveMsgBatchMaster(); channels[i] is the index, in the array given
+ * to initMasterCommFanIn(), of the channel messages[i] came from. Without
+ * fan-in every message comes from channel 0.
+ *
+ * @param messages Array to store the received messages.
+ * @param channels Array to store the channel ids.
+ * @param capacity Size of the arrays.
+ * @param receivedCount Pointer to store the number of messages received.
+ * @return RET_OK if at least one message from a slave was received, RET_ERROR otherwise.
+ */
+RetVal_t reciveMsgFanInMaster(CommMessage *messages, uint32_t *channels, uint32_t capacity, uint32_t *receivedCount) {
+    *receivedCount = receiveBatch(messages, channels, capacity);
+    if (*receivedCount == 0) {
+        LOG_MSG(LOG_LEVEL_ERROR, "MasterComm", "Failed to receive a message batch from the fan-in channels");
+        return RET_ERROR;
+    }
+    LOG_MSG_LIMITED(LOG_LEVEL_DEBUG, "MasterComm", LOG_RATE_LIMIT_HOT_PATH, "Fan-in batch received successfully");
+    return RET_OK;
+}
+
+/**
+ * @brief Sets the overflow policy of the master-to-slave channel.
+ *
+ * Switching the policy drops a message held back by the coalescing policy.
+ * Dropping the oldest message needs a local queue channel, so it is refused
+ * on a ring channel or a transport.
+ *
+ * @param policy Policy applied when the channel is full.
+ * @param deadlineMs Maximum wait of COMM_OVERFLOW_BLOCK (in ms), unused by the others.
+ * @return RET_OK if the policy was set, RET_ERROR otherwise.
+ */
+RetVal_t setOverflowPolicyMaster(CommOverflowPolicy policy, uint32_t deadlineMs) {
+    if (policy >= COMM_OVERFLOW_MAX || (policy == COMM_OVERFLOW_DROP_OLDEST && sendQueueHandle_ == NULL)) {
+        LOG_MSG(LOG_LEVEL_ERROR, "MasterComm", "Overflow policy not supported by the channel");
+        return RET_ERROR;
+    }
+    overflowPolicy_ = policy;
+    overflowDeadline_ = pdMS_TO_TICKS(deadlineMs);
+    pendingValid_ = 0;
+    return RET_OK;
+}
+
+/**
+ * @brief Copies the overflow policy counters.
+ *
+ * @param stats Pointer to store the counters.
+ */
+void getOverflowStatsMaster(CommOverflowStats *stats) {
+    *stats = overflowStats_;
+}
+
+/**
+ * @brief Sets the pacing policy of the send functions.
+ *
+ * @param delayMs Delay after each sendMsgMaster() or sendMsgBatchMaster() call
+ *                (in ms), 0 to send without pacing.
+ */
+void setSendPacingMaster(uint32_t delayMs) {
+    sendPacingMs_ = delayMs;
+}
+
+/**
+ * @brief Initializes the slave-to-master block channel.
+ *
+ * @param blockQueueHandle Queue handle of the channel, with items of sizeof(CommBlock *).
+ * @return RET_OK if successful, RET_ERROR otherwise.
+ */
+RetVal_t initBlockChannelMaster(QueueHandle_t blockQueueHandle) {
+    if (blockQueueHandle == NULL) {
+        LOG_MSG(LOG_LEVEL_ERROR, "MasterComm", "Block queue handle is NULL");
+        return RET_ERROR;
+    }
+    blockQueueHandle_ = blockQueueHandle;
+    return RET_OK;
+}
+
+/**
+ * @brief Receives a message block from the slave.
+ *
+ * Only the block pointer is taken from the queue; the payload is not copied.
+ * The caller owns the reference that came with it and must drop it with
+ * commBlockRelease().
+ *
+ * @param block Pointer to store the received block.
+ * @return RET_OK if successful, RET_ERROR otherwise.
+ */
+RetVal_t reciveBlockMaster(CommBlock **block) {
+    if (blockQueueHandle_ == NULL) {
+        LOG_MSG(LOG_LEVEL_ERROR, "MasterComm", "Block queue handle is not initialized");
+        return RET_ERROR;
+    }
+    if (xQueueReceive(blockQueueHandle_, block, portMAX_DELAY) != pdPASS) {
+        LOG_MSG(LOG_LEVEL_ERROR, "MasterComm", "Failed to receive a block from the queue");
+        return RET_ERROR;
+    }
+    return RET_OK;
+}
+
+/**
+ * @brief Connects the master to the payload pipeline.
+ *
+ * @param pipeline Initialized pipeline with a COMM_PAYLOAD_CONSUMER_MASTER consumer.
+ * @return RET_OK if successful, RET_ERROR otherwise.
+ */
+RetVal_t initPayloadPipelineMaster(CommPipeline *pipeline) {
+    if (pipeline == NULL || pipeline->consumerCount <= COMM_PAYLOAD_CONSUMER_MASTER) {
+        LOG_MSG(LOG_LEVEL_ERROR, "MasterComm", "Payload pipeline has no master consumer");
+        return RET_ERROR;
+    }
+    payloadPipeline_ = pipeline;
+    return RET_OK;
+}
+
+/**
+ * @brief Receives the next payload forwarded by the slave.
+ *
+ * Blocks until a payload is available and copies it into the caller's buffer.
+ *
+ * @param payload Buffer to store the payload.
+ * @param capacity Size of payload, at least COMM_PIPELINE_MAX_PAYLOAD bytes.
+ * @param length Pointer to store the payload length.
+ * @return RET_OK if successful, RET_ERROR otherwise.
+ */
+RetVal_t recivePayloadMaster(void *payload, uint32_t capacity, uint32_t *length) {
+    if (payloadPipeline_ == NULL) {
+        LOG_MSG(LOG_LEVEL_ERROR, "MasterComm", "Payload pipeline is not initialized");
+        return RET_ERROR;
+    }
+    if (commPipelineReceive(payloadPipeline_, COMM_PAYLOAD_CONSUMER_MASTER, payload, capacity, length,
+                            portMAX_DELAY) != RET_OK) {
+        LOG_MSG(LOG_LEVEL_ERROR, "MasterComm", "Failed to receive a payload from the pipeline");
+        return RET_ERROR;
+    }
+    return RET_OK;
+}
+
+/**
+ * @brief Returns the number of slave messages that were never received.
+ *
+ * With mailbox channels these are the intermediate states overwritten by a
+ * newer one before they were read.
+ *
+ * @return Total number of skipped messages since start-up.
+ */
+uint32_t getSkippedMsgMaster(void) {
+    return skippedMessages_;
+}
@@ -6,7 +6,10 @@
 #include "master_comm.h"
 #include "master_state_machine.h"
 #include "logger.h"
+#include "logger_status.h"
+#include "logger_trace.h"
 #include "thread_handler_cfg.h"
+#include "comm_cfg.h"
 
 /**
  * @file master_handler.c
@@ -22,27 +25,41 @@
  *
  * This task listens for incoming messages from the slave system, processes them,
  * and dispatches the appropriate state handlers based on the received data.
+ * Each wake-up takes up to COMM_RECEIVE_BATCH_SIZE messages, so with fan-in
+ * channels every ready slave is served before the task sleeps again. It
+ * sleeps only in the blocking receive, so a message is dispatched as soon as
+ * it arrives. The trace carried by a message is the current trace while it
+ * is dispatched.
  *
  * @param args Pointer to task arguments (unused in this implementation).
  */
 void vMasterReciverHandler(void *args) {
-    SlaveStates data = SLAVE_STATE_MAX;
+    CommMessage messages[COMM_RECEIVE_BATCH_SIZE];
+    uint32_t received = 0;
     MasterStates curentData = MASTESR_STATE_MAX;
 
 #ifndef UNIT_TEST
     while(1){
 #endif
-        if (reciveMsgMaster(&data) != RET_OK) {
+        if (reciveMsgBatchMaster(messages, COMM_RECEIVE_BATCH_SIZE, &received) != RET_OK) {
             logMessage(LOG_LEVEL_ERROR, "MasterHandler", "Failed to receive message");
+            received = 0;
         }
-
-        if(data != curentData){
-            if (stateDispatcher(data) != RET_OK) {
-                logMessage(LOG_LEVEL_DEBUG, "MasterHandler", "Failed to handle status");
+        for (uint32_t i = 0; i < received; i++) {
+            if (messages[i].type != COMM_MSG_SLAVE_STATE) {
+                logMessage(LOG_LEVEL_ERROR, "MasterHandler", "Unexpected message type");
+                continue;
+            }
+            SlaveStates data = (SlaveStates)messages[i].payload;
+            logTraceSpan(messages[i].traceId, LOG_TRACE_HOP_MASTER_RECEIVED, (uint32_t)data);
+            if(data != curentData){
+                logTraceSetCurrent(messages[i].traceId);
+                if (stateDispatcher(data) != RET_OK) {
+                    logMessage(LOG_LEVEL_DEBUG, "MasterHandler", "Failed to handle status");
+                }
+                logTraceSetCurrent(0);
             }
         }
-
-        vTaskDelay(pdMS_TO_TICKS(TASTK_TIME_MASTER_COMM_HANDLER));
 #ifndef UNIT_TEST
     }
 #endif
@@ -51,8 +68,12 @@ void vMasterReciverHandler(void *args) {
 /**
  * @brief Handles master status check tasks.
  *
- * This task periodically retrieves the current state of the master system
- * and sends it to the slave system via the communication channel.
+ * This task retrieves the current state of the master system and syncs it to
+ * the slave system via the communication channel. Only a changed state, or
+ * one the slave asked for again, is sent, so nothing is sent while the state
+ * stays the same. It sleeps until the master state changes, so a change is
+ * sent right away, and wakes every TASTK_TIME_MASTER_STATUS_CHECK_HANDLER as
+ * a heartbeat that also answers sync requests and retries failed sends.
  *
  * @param args Pointer to task arguments (unused in this implementation).
  */
@@ -64,10 +85,38 @@ void vMasterSenderHandler(void *args) {
 #endif
         (void)getCurrentState(&currentState);
 
-        if (sendMsgMaster(&currentState) != RET_OK) {
+        if (syncStateMaster((int32_t)currentState, 0, NULL) != RET_OK) {
             logMessage(LOG_LEVEL_ERROR, "MasterHandler", "Failed to send message");
         }
-        vTaskDelay(pdMS_TO_TICKS(TASTK_TIME_MASTER_STATUS_CHECK_HANDLER));
+        logStatusHeartbeat();
+
+        // Sleep until the state changes, or until the heartbeat is due
+        (void)waitStateChangeMaster(pdMS_TO_TICKS(TASTK_TIME_MASTER_STATUS_CHECK_HANDLER));
+#ifndef UNIT_TEST
+    }
+#endif
+}
+
+/**
+ * @brief Handles telemetry payloads forwarded by the slave.
+ *
+ * This task blocks on its consumer of the payload pipeline. Each payload is
+ * copied into a task-local buffer, so nothing has to be released afterwards.
+ *
+ * @param args Pointer to task arguments (unused in this implementation).
+ */
+void vMasterTelemetryHandler(void *args) {
+    static uint8_t payload[COMM_PIPELINE_MAX_PAYLOAD];
+    uint32_t length = 0;
+
+#ifndef UNIT_TEST
+    while(1){
+#endif
+        if (recivePayloadMaster(payload, sizeof(payload), &length) != RET_OK) {
+            logMessage(LOG_LEVEL_ERROR, "MasterHandler", "Failed to receive telemetry payload");
+        } else {
+            logMessage(LOG_LEVEL_DEBUG, "MasterHandler", "Telemetry payload received");
+        }
 #ifndef UNIT_TEST
     }
 #endif
@@ -1,8 +1,12 @@
 #include <stdio.h>
 #include "master_state_machine.h"
+#include "task.h"
 #include "master_comm.h"
 #include "types.h"
 #include "logger.h"
+#include "logger_cfg.h"
+#include "logger_status.h"
+#include "logger_trace.h"
 
 /**
  * @file master_state_machine.c
@@ -10,11 +14,17 @@
  *
  * This file defines the logic for managing and transitioning between different
  * operational states of a master system. The state transitions are thread-safe
- * and logged for clarity and debugging.
+ * and logged for clarity and debugging. Every transition sets
+ * MASTER_STATE_EVENT_CHANGED, which wakes the task propagating the state.
  */
 
 #define SEMAPHOR_TICKS 10
 
+/**
+ * @brief Event bit set on every master state change.
+ */
+#define MASTER_STATE_EVENT_CHANGED ((EventBits_t)1 << 0)
+
 /**
  * @brief Maps slave states to corresponding master states.
  *
@@ -32,9 +42,9 @@ SlaveToMasterMap slaveToMasterMap[] = {
 };
 
 #ifdef UNIT_TEST
-MasterStatesConditionHandler masterStateMachineCondition = {MASTESR_STATE_IDLE, NULL};
+MasterStatesConditionHandler masterStateMachineCondition = {MASTESR_STATE_IDLE, NULL, NULL};
 #else
-static MasterStatesConditionHandler masterStateMachineCondition = {MASTESR_STATE_IDLE, NULL};
+static MasterStatesConditionHandler masterStateMachineCondition = {MASTESR_STATE_IDLE, NULL, NULL};
 #endif
 
 // Forward declarations for state handler functions
@@ -63,6 +73,8 @@ MasterStateMachine masterFSM[] = {
  * @brief Sets a new state for the master state machine.
  *
  * Ensures thread safety using a semaphore before transitioning to a new state.
+ * A state change ends the current trace of the calling task and wakes the
+ * task waiting in waitStateChangeMaster().
  *
  * @param state The new state to transition to.
  * @return RET_OK on success, RET_ERROR on failure.
@@ -76,6 +88,11 @@ static RetVal_t setNewState(MasterStates state) {
         } else {
             if (masterStateMachineCondition.currentState != state) {
                 masterStateMachineCondition.currentState = state;
+                logTraceSpan(logTraceCurrent(), LOG_TRACE_HOP_MASTER_TRANSITION, (uint32_t)state);
+                logStatusSetMasterState(state);
+                if (masterStateMachineCondition.stateEvents != NULL) {
+                    (void)xEventGroupSetBits(masterStateMachineCondition.stateEvents, MASTER_STATE_EVENT_CHANGED);
+                }
                 logMessageFormatted(LOG_LEVEL_INFO, "MasterStateMachine", "New status is %d", 
                                     masterStateMachineCondition.currentState);
             }
@@ -130,7 +147,9 @@ static RetVal_t handleErrorState() {
 /**
  * @brief Initializes the semaphore used for state synchronization.
  *
- * Creates a binary semaphore to ensure thread safety during state transitions.
+ * Creates a binary semaphore to ensure thread safety during state transitions
+ * and the event group signalling them, and publishes the initial state on the
+ * status page.
  *
  * @return RET_OK if initialization succeeded, RET_ERROR otherwise.
  */
@@ -144,6 +163,12 @@ RetVal_t initStateSemaphoreMaster() {
         logMessage(LOG_LEVEL_ERROR, "MasterStateMachine", "Failed to give state semaphore");
         return RET_ERROR;
     }
+    masterStateMachineCondition.stateEvents = xEventGroupCreate();
+    if (masterStateMachineCondition.stateEvents == NULL) {
+        logMessage(LOG_LEVEL_ERROR, "MasterStateMachine", "Failed to create state event group");
+        return RET_ERROR;
+    }
+    logStatusSetMasterState(masterStateMachineCondition.currentState);
     return RET_OK;
 }
 
@@ -160,7 +185,7 @@ RetVal_t stateDispatcher(SlaveStates data) {
     if (data >= SLAVE_STATE_MAX) {
         return RET_ERROR;
     }
-    logMessageFormatted(LOG_LEVEL_DEBUG, "MasterStateMachine", "Dispatching state %d", data);
+    LOG_FMT_LIMITED(LOG_LEVEL_DEBUG, "MasterStateMachine", LOG_RATE_LIMIT_HOT_PATH, "Dispatching state %d", data);
 
     MasterStates state = slaveToMasterMap[data].masterState;
     if(state != masterStateMachineCondition.currentState){
@@ -180,3 +205,22 @@ RetVal_t getCurrentState(MasterStates* currentState) {
     *currentState = masterStateMachineCondition.currentState;
     return RET_OK;
 }
+
+/**
+ * @brief Waits until the master state changes.
+ *
+ * Without the event group (before initStateSemaphoreMaster()) it only waits,
+ * so the caller keeps its heartbeat.
+ *
+ * @param ticksToWait Maximum time to wait.
+ * @return RET_OK if the state changed, RET_ERROR if the wait timed out.
+ */
+RetVal_t waitStateChangeMaster(TickType_t ticksToWait) {
+    if (masterStateMachineCondition.stateEvents == NULL) {
+        vTaskDelay(ticksToWait);
+        return RET_ERROR;
+    }
+    EventBits_t bits = xEventGroupWaitBits(masterStateMachineCondition.stateEvents, MASTER_STATE_EVENT_CHANGED,
+                                           pdTRUE, pdFALSE, ticksToWait);
+    return ((bits & MASTER_STATE_EVENT_CHANGED) != 0) ? RET_OK : RET_ERROR;
+}
@@ -1,11 +1,15 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include "master_comm.h"
+#include "comm_pipeline.h"
 #include "FreeRTOS.h"
 #include "queue.h"
 #include "task.h"
 #include "logger.h"
+#include "state_mashine_types.h"
+#include "comm_cfg.h"
 #include <iostream>
+#include <vector>
 
 // ==========================
 // Handle Macro Conflicts
@@ -25,6 +29,9 @@
 #define TICK_TO_WAIT_SEND_MS 100
 #endif
 
+// The fixture channels have a length of 1 (mailbox), which is overwritten without waiting
+#define SEND_WAIT_TICKS 0
+
 // ==========================
 // Mock Class for FreeRTOS and Logger
 // ==========================
@@ -35,12 +42,23 @@ public:
     MOCK_METHOD(BaseType_t, xQueueReceive, (QueueHandle_t, void*, TickType_t));
     MOCK_METHOD(void, logMessage, (LogLevel, const char*, const char*));
     MOCK_METHOD(void, vTaskDelay, (TickType_t xTicksToDelay));
+    MOCK_METHOD(QueueSetHandle_t, xQueueCreateSet, (UBaseType_t));
+    MOCK_METHOD(BaseType_t, xQueueAddToSet, (QueueSetMemberHandle_t, QueueSetHandle_t));
+    MOCK_METHOD(QueueSetMemberHandle_t, xQueueSelectFromSet, (QueueSetHandle_t, TickType_t));
+    MOCK_METHOD(RetVal_t, commRingSend, (CommRing*, const CommMessage*, TickType_t));
+    MOCK_METHOD(RetVal_t, commTransportSend, (CommTransport*, const CommMessage*, TickType_t));
+    MOCK_METHOD(RetVal_t, commTransportReceive, (CommTransport*, CommMessage*, TickType_t));
+    MOCK_METHOD(RetVal_t, commRingReceive, (CommRing*, CommMessage*, TickType_t));
+    MOCK_METHOD(RetVal_t, commPipelineReceive, (CommPipeline*, uint32_t, void*, uint32_t, uint32_t*, TickType_t));
 };
 
 // Global Mock Object
 // A global pointer to the mock object to facilitate redirection from C functions
 FreeRTOSMock* freeRTOSMock = nullptr;
 
+// Free space reported for the channels; it is their length when initMasterComm() runs
+UBaseType_t channelSpaces = 1;
+
 // ==========================
 // C Function Redirection
 // ==========================
@@ -87,6 +105,67 @@ extern "C" {
         return pdPASS;
     }
 
+    __attribute__((weak)) UBaseType_t uxQueueSpacesAvailable(const QueueHandle_t queue) {
+        return channelSpaces;
+    }
+
+    __attribute__((weak)) QueueSetHandle_t xQueueCreateSet(UBaseType_t length) {
+        if (freeRTOSMock == nullptr) {
+            abort();
+        }
+        return freeRTOSMock->xQueueCreateSet(length);
+    }
+
+    __attribute__((weak)) BaseType_t xQueueAddToSet(QueueSetMemberHandle_t member, QueueSetHandle_t set) {
+        if (freeRTOSMock == nullptr) {
+            abort();
+        }
+        return freeRTOSMock->xQueueAddToSet(member, set);
+    }
+
+    __attribute__((weak)) QueueSetMemberHandle_t xQueueSelectFromSet(QueueSetHandle_t set, TickType_t wait) {
+        if (freeRTOSMock == nullptr) {
+            abort();
+        }
+        return freeRTOSMock->xQueueSelectFromSet(set, wait);
+    }
+
+    __attribute__((weak)) RetVal_t commTransportSend(CommTransport* transport, const CommMessage* message, TickType_t wait) {
+        if (freeRTOSMock == nullptr) {
+            abort();
+        }
+        return freeRTOSMock->commTransportSend(transport, message, wait);
+    }
+
+    __attribute__((weak)) RetVal_t commTransportReceive(CommTransport* transport, CommMessage* message, TickType_t wait) {
+        if (freeRTOSMock == nullptr) {
+            abort();
+        }
+        return freeRTOSMock->commTransportReceive(transport, message, wait);
+    }
+
+    __attribute__((weak)) RetVal_t commPipelineReceive(CommPipeline* pipeline, uint32_t consumer, void* payload,
+                                                       uint32_t capacity, uint32_t* length, TickType_t wait) {
+        if (freeRTOSMock == nullptr) {
+            abort();
+        }
+        return freeRTOSMock->commPipelineReceive(pipeline, consumer, payload, capacity, length, wait);
+    }
+
+    __attribute__((weak)) RetVal_t commRingSend(CommRing* ring, const CommMessage* message, TickType_t wait) {
+        if (freeRTOSMock == nullptr) {
+            abort();
+        }
+        return freeRTOSMock->commRingSend(ring, message, wait);
+    }
+
+    __attribute__((weak)) RetVal_t commRingReceive(CommRing* ring, CommMessage* message, TickType_t wait) {
+        if (freeRTOSMock == nullptr) {
+            abort();
+        }
+        return freeRTOSMock->commRingReceive(ring, message, wait);
+    }
+
     __attribute__((weak)) void vTaskDelay(TickType_t xTicksToDelay) {
         if (freeRTOSMock == nullptr) {
             abort();
@@ -100,6 +179,15 @@ extern "C" {
         }
         freeRTOSMock->logMessage(level, module, message);
     }
+
+    uint8_t logComponentLevelEnabled(LogComponentId* site, const char* component, LogLevel level) {
+        return 1;
+    }
+
+    uint8_t logRateLimitAllow(LogRateLimit* site, uint32_t limit, LogLevel level,
+                              const char* component, const char* text) {
+        return 1;
+    }
 }
 
 // ==========================
@@ -108,15 +196,18 @@ extern "C" {
 // Provides a consistent test environment for MasterComm
 class MasterCommTest : public ::testing::Test {
 protected:
-    QueueHandle_t stateQueueHandle_ = nullptr;
+    QueueHandle_t sendQueueHandle_ = nullptr;
+    QueueHandle_t receiveQueueHandle_ = nullptr;
     void SetUp() override {
         freeRTOSMock = new FreeRTOSMock();
         ASSERT_NE(freeRTOSMock, nullptr);
 
-        stateQueueHandle_ = reinterpret_cast<QueueHandle_t>(0x1234);
+        sendQueueHandle_ = reinterpret_cast<QueueHandle_t>(0x1234);
+        receiveQueueHandle_ = reinterpret_cast<QueueHandle_t>(0x5678);
         EXPECT_CALL(*freeRTOSMock, logMessage(testing::_, testing::_, testing::_))
         .Times(testing::AnyNumber());
-        initMasterComm(stateQueueHandle_);
+        channelSpaces = 1;
+        initMasterComm(sendQueueHandle_, receiveQueueHandle_);
     }
 
     void TearDown() override {
@@ -130,46 +221,524 @@ protected:
 // ==========================
 // Valid QueueHandle Test
 TEST_F(MasterCommTest, InitMasterComm_ValidQueueHandle_ReturnsRET_OK) {
-    ASSERT_NE(stateQueueHandle_, nullptr);
-    EXPECT_EQ(initMasterComm(stateQueueHandle_), RET_OK);
+    ASSERT_NE(sendQueueHandle_, nullptr);
+    EXPECT_EQ(initMasterComm(sendQueueHandle_, receiveQueueHandle_), RET_OK);
 }
 
 // Null QueueHandle Test
 TEST_F(MasterCommTest, InitMasterComm_NullQueueHandle_ReturnsRET_ERROR) {
     ASSERT_NE(freeRTOSMock, nullptr);
-    EXPECT_EQ(initMasterComm(nullptr), RET_ERROR);
+    EXPECT_EQ(initMasterComm(nullptr, receiveQueueHandle_), RET_ERROR);
+    EXPECT_EQ(initMasterComm(sendQueueHandle_, nullptr), RET_ERROR);
 }
 
 // Successful Message Send Test
 TEST_F(MasterCommTest, SendMsgMaster_QueueSendSuccess_ReturnsRET_OK) {
-    uint8_t data = 1;
-    EXPECT_CALL(*freeRTOSMock, xQueueSend(stateQueueHandle_, &data, pdMS_TO_TICKS(TICK_TO_WAIT_SEND_MS)))
+    CommMessage message = {COMM_MSG_MASTER_STATE, 0, 0, MASTESR_STATE_PROCESSING};
+    EXPECT_CALL(*freeRTOSMock, xQueueSend(sendQueueHandle_, testing::_, SEND_WAIT_TICKS))
         .WillOnce(testing::Return(pdPASS));
-    EXPECT_EQ(sendMsgMaster(&data), RET_OK);
+    EXPECT_EQ(sendMsgMaster(&message), RET_OK);
+}
+
+// Sent envelopes carry the master source id and consecutive sequence numbers
+TEST_F(MasterCommTest, SendMsgMaster_StampsSourceAndSequence) {
+    CommMessage message = {COMM_MSG_MASTER_STATE, COMM_SOURCE_SLAVE, 0, MASTESR_STATE_ERROR};
+    CommMessage sent[2];
+    int count = 0;
+    EXPECT_CALL(*freeRTOSMock, xQueueSend(sendQueueHandle_, testing::_, testing::_))
+        .Times(2)
+        .WillRepeatedly(testing::Invoke([&](QueueHandle_t, const void* item, TickType_t) {
+            sent[count++] = *static_cast<const CommMessage*>(item);
+            return pdPASS;
+        }));
+    EXPECT_EQ(sendMsgMaster(&message), RET_OK);
+    EXPECT_EQ(sendMsgMaster(&message), RET_OK);
+
+    EXPECT_EQ(sent[0].sourceId, COMM_SOURCE_MASTER);
+    EXPECT_EQ(sent[0].type, COMM_MSG_MASTER_STATE);
+    EXPECT_EQ(sent[0].payload, MASTESR_STATE_ERROR);
+    EXPECT_EQ((uint16_t)(sent[1].sequence - sent[0].sequence), 1);
 }
 
 // Failed Message Send Test
 TEST_F(MasterCommTest, SendMsgMaster_QueueSendFailure_ReturnsRET_ERROR) {
-    uint8_t data = 1;
-    EXPECT_CALL(*freeRTOSMock, xQueueSend(stateQueueHandle_, testing::_, pdMS_TO_TICKS(TICK_TO_WAIT_SEND_MS)))
+    CommMessage message = {COMM_MSG_MASTER_STATE, 0, 0, MASTESR_STATE_PROCESSING};
+    EXPECT_CALL(*freeRTOSMock, xQueueSend(sendQueueHandle_, testing::_, SEND_WAIT_TICKS))
         .WillOnce(testing::Return(pdFAIL));
-    EXPECT_EQ(sendMsgMaster(&data), RET_ERROR);
+    EXPECT_EQ(sendMsgMaster(&message), RET_ERROR);
 }
 
 // Successful Message Receive Test
 TEST_F(MasterCommTest, ReciveMsgMaster_QueueReceiveSuccess_ReturnsRET_OK) {
-    uint8_t data = 1;
-    EXPECT_CALL(*freeRTOSMock, xQueueReceive(stateQueueHandle_, testing::_, portMAX_DELAY))
-        .WillOnce(testing::Return(pdPASS));
-    EXPECT_EQ(reciveMsgMaster(&data), RET_OK);
+    CommMessage message;
+    EXPECT_CALL(*freeRTOSMock, xQueueReceive(receiveQueueHandle_, testing::_, portMAX_DELAY))
+        .WillOnce(testing::Invoke([](QueueHandle_t, void* item, TickType_t) {
+            *static_cast<CommMessage*>(item) = {COMM_MSG_SLAVE_STATE, COMM_SOURCE_SLAVE, 7, SLAVE_STATE_FAULT};
+            return pdPASS;
+        }));
+    EXPECT_EQ(reciveMsgMaster(&message), RET_OK);
+    EXPECT_EQ(message.payload, SLAVE_STATE_FAULT);
+}
+
+// A message sent by the master itself is rejected
+TEST_F(MasterCommTest, ReciveMsgMaster_OwnMessage_ReturnsRET_ERROR) {
+    CommMessage message;
+    EXPECT_CALL(*freeRTOSMock, xQueueReceive(receiveQueueHandle_, testing::_, portMAX_DELAY))
+        .WillOnce(testing::Invoke([](QueueHandle_t, void* item, TickType_t) {
+            *static_cast<CommMessage*>(item) = {COMM_MSG_MASTER_STATE, COMM_SOURCE_MASTER, 0, MASTESR_STATE_IDLE};
+            return pdPASS;
+        }));
+    EXPECT_EQ(reciveMsgMaster(&message), RET_ERROR);
+}
+
+// Gaps in the sequence numbers are counted as skipped slave messages
+TEST_F(MasterCommTest, ReciveMsgMaster_SequenceGap_CountsSkipped) {
+    CommMessage message;
+    uint16_t sequences[2] = {100, 104};
+    int count = 0;
+    EXPECT_CALL(*freeRTOSMock, xQueueReceive(receiveQueueHandle_, testing::_, portMAX_DELAY))
+        .Times(2)
+        .WillRepeatedly(testing::Invoke([&](QueueHandle_t, void* item, TickType_t) {
+            *static_cast<CommMessage*>(item) = {COMM_MSG_SLAVE_STATE, COMM_SOURCE_SLAVE, sequences[count++], 0};
+            return pdPASS;
+        }));
+    EXPECT_EQ(reciveMsgMaster(&message), RET_OK);
+    uint32_t skipped = getSkippedMsgMaster();
+    EXPECT_EQ(reciveMsgMaster(&message), RET_OK);
+    EXPECT_EQ(getSkippedMsgMaster() - skipped, 3u);
+}
+
+// Re-initializing starts the sequence numbers over, so the new channel shows no gap
+TEST_F(MasterCommTest, InitMasterComm_ResetsReceiveSequence) {
+    CommMessage message;
+    uint16_t sequences[2] = {100, 0};
+    int count = 0;
+    EXPECT_CALL(*freeRTOSMock, xQueueReceive(receiveQueueHandle_, testing::_, portMAX_DELAY))
+        .Times(2)
+        .WillRepeatedly(testing::Invoke([&](QueueHandle_t, void* item, TickType_t) {
+            *static_cast<CommMessage*>(item) = {COMM_MSG_SLAVE_STATE, COMM_SOURCE_SLAVE, sequences[count++], 0};
+            return pdPASS;
+        }));
+    EXPECT_EQ(reciveMsgMaster(&message), RET_OK);
+    ASSERT_EQ(initMasterComm(sendQueueHandle_, receiveQueueHandle_), RET_OK);
+    uint32_t skipped = getSkippedMsgMaster();
+    EXPECT_EQ(reciveMsgMaster(&message), RET_OK);
+    EXPECT_EQ(getSkippedMsgMaster(), skipped);
+}
+
+// A batch is sent back to back and paced once
+TEST_F(MasterCommTest, SendMsgBatchMaster_PacesOncePerBatch) {
+    CommMessage messages[3] = {{COMM_MSG_MASTER_STATE, 0, 0, MASTESR_STATE_IDLE},
+                               {COMM_MSG_MASTER_STATE, 0, 0, MASTESR_STATE_PROCESSING},
+                               {COMM_MSG_MASTER_STATE, 0, 0, MASTESR_STATE_ERROR}};
+    uint32_t sent = 0;
+    EXPECT_CALL(*freeRTOSMock, xQueueSend(sendQueueHandle_, testing::_, SEND_WAIT_TICKS))
+        .Times(3)
+        .WillRepeatedly(testing::Return(pdPASS));
+    EXPECT_CALL(*freeRTOSMock, vTaskDelay(pdMS_TO_TICKS(DELAY_SEND_MS))).Times(1);
+    EXPECT_EQ(sendMsgBatchMaster(messages, 3, &sent), RET_OK);
+    EXPECT_EQ(sent, 3u);
+}
+
+// Without pacing, a FIFO channel is sent to with the send timeout and no delay
+TEST_F(MasterCommTest, SendMsgBatchMaster_FifoWithoutPacing_StopsAtFirstFailure) {
+    CommMessage messages[3] = {{COMM_MSG_MASTER_STATE, 0, 0, MASTESR_STATE_IDLE},
+                               {COMM_MSG_MASTER_STATE, 0, 0, MASTESR_STATE_PROCESSING},
+                               {COMM_MSG_MASTER_STATE, 0, 0, MASTESR_STATE_ERROR}};
+    uint32_t sent = 0;
+    channelSpaces = 8;
+    ASSERT_EQ(initMasterComm(sendQueueHandle_, receiveQueueHandle_), RET_OK);
+    setSendPacingMaster(0);
+    EXPECT_CALL(*freeRTOSMock, xQueueSend(sendQueueHandle_, testing::_, pdMS_TO_TICKS(TICK_TO_WAIT_SEND_MS)))
+        .WillOnce(testing::Return(pdPASS))
+        .WillOnce(testing::Return(pdFAIL));
+    EXPECT_CALL(*freeRTOSMock, vTaskDelay(testing::_)).Times(0);
+    EXPECT_EQ(sendMsgBatchMaster(messages, 3, &sent), RET_ERROR);
+    EXPECT_EQ(sent, 1u);
+    setSendPacingMaster(DELAY_SEND_MS);
+}
+
+// Drop-oldest makes room by discarding the oldest queued message
+TEST_F(MasterCommTest, SendMsgMaster_DropOldest_DiscardsOldestQueued) {
+    CommMessage message = {COMM_MSG_MASTER_STATE, 0, 0, MASTESR_STATE_ERROR};
+    CommOverflowStats before, after;
+    channelSpaces = 8;
+    ASSERT_EQ(initMasterComm(sendQueueHandle_, receiveQueueHandle_), RET_OK);
+    ASSERT_EQ(setOverflowPolicyMaster(COMM_OVERFLOW_DROP_OLDEST, 0), RET_OK);
+    getOverflowStatsMaster(&before);
+    testing::InSequence order;
+    EXPECT_CALL(*freeRTOSMock, xQueueSend(sendQueueHandle_, testing::_, 0)).WillOnce(testing::Return(errQUEUE_FULL));
+    EXPECT_CALL(*freeRTOSMock, xQueueReceive(sendQueueHandle_, testing::_, 0)).WillOnce(testing::Return(pdPASS));
+    EXPECT_CALL(*freeRTOSMock, xQueueSend(sendQueueHandle_, testing::_, 0)).WillOnce(testing::Return(pdPASS));
+    EXPECT_CALL(*freeRTOSMock, vTaskDelay(testing::_)).Times(1);
+    EXPECT_EQ(sendMsgMaster(&message), RET_OK);
+    getOverflowStatsMaster(&after);
+    EXPECT_EQ(after.droppedOldest - before.droppedOldest, 1u);
+}
+
+// Block-with-deadline waits for the configured deadline and counts the expiry
+TEST_F(MasterCommTest, SendMsgMaster_BlockDeadline_CountsExpiry) {
+    CommMessage message = {COMM_MSG_MASTER_STATE, 0, 0, MASTESR_STATE_ERROR};
+    CommOverflowStats before, after;
+    channelSpaces = 8;
+    ASSERT_EQ(initMasterComm(sendQueueHandle_, receiveQueueHandle_), RET_OK);
+    EXPECT_EQ(setOverflowPolicyMaster(COMM_OVERFLOW_MAX, 0), RET_ERROR);
+    ASSERT_EQ(setOverflowPolicyMaster(COMM_OVERFLOW_BLOCK, 20), RET_OK);
+    getOverflowStatsMaster(&before);
+    EXPECT_CALL(*freeRTOSMock, xQueueSend(sendQueueHandle_, testing::_, pdMS_TO_TICKS(20)))
+        .WillOnce(testing::Return(errQUEUE_FULL));
+    EXPECT_EQ(sendMsgMaster(&message), RET_ERROR);
+    getOverflowStatsMaster(&after);
+    EXPECT_EQ(after.deadlineExpired - before.deadlineExpired, 1u);
+}
+
+// Coalescing keeps only the newest held back message and sends it before the next one
+TEST_F(MasterCommTest, SendMsgMaster_Coalesce_SendsNewestHeldBackFirst) {
+    CommMessage message = {COMM_MSG_MASTER_STATE, 0, 0, 0};
+    std::vector<CommMessage> sent;
+    int full = 2;
+    CommOverflowStats before, after;
+    channelSpaces = 8;
+    ASSERT_EQ(initMasterComm(sendQueueHandle_, receiveQueueHandle_), RET_OK);
+    ASSERT_EQ(setOverflowPolicyMaster(COMM_OVERFLOW_COALESCE, 0), RET_OK);
+    setSendPacingMaster(0);
+    getOverflowStatsMaster(&before);
+    // The channel stays full for the first two attempts
+    EXPECT_CALL(*freeRTOSMock, xQueueSend(sendQueueHandle_, testing::_, 0))
+        .WillRepeatedly(testing::Invoke([&](QueueHandle_t, const void* item, TickType_t) {
+            if (full > 0) {
+                full--;
+                return errQUEUE_FULL;
+            }
+            sent.push_back(*static_cast<const CommMessage*>(item));
+            return pdPASS;
+        }));
+    for (int32_t payload : {MASTESR_STATE_IDLE, MASTESR_STATE_PROCESSING, MASTESR_STATE_ERROR}) {
+        message.payload = payload;
+        EXPECT_EQ(sendMsgMaster(&message), RET_OK);
+    }
+    getOverflowStatsMaster(&after);
+    setSendPacingMaster(DELAY_SEND_MS);
+
+    ASSERT_EQ(sent.size(), 2u);
+    EXPECT_EQ(sent[0].payload, MASTESR_STATE_PROCESSING);
+    EXPECT_EQ(sent[1].payload, MASTESR_STATE_ERROR);
+    EXPECT_EQ(after.coalesced - before.coalesced, 2u);
+}
+
+// A held back change is sent by the next sync call even when the state did not change again
+TEST_F(MasterCommTest, SyncStateMaster_Coalesce_FlushesHeldBackChange) {
+    std::vector<CommMessage> sent;
+    int full = 1;
+    uint32_t sentCount = 0;
+    channelSpaces = 8;
+    ASSERT_EQ(initMasterComm(sendQueueHandle_, receiveQueueHandle_), RET_OK);
+    ASSERT_EQ(setOverflowPolicyMaster(COMM_OVERFLOW_COALESCE, 0), RET_OK);
+    setSendPacingMaster(0);
+    EXPECT_CALL(*freeRTOSMock, xQueueSend(sendQueueHandle_, testing::_, 0))
+        .WillRepeatedly(testing::Invoke([&](QueueHandle_t, const void* item, TickType_t) {
+            // The channel is full when the state change is sent
+            if (static_cast<const CommMessage*>(item)->type == COMM_MSG_MASTER_STATE && full > 0) {
+                full--;
+                return errQUEUE_FULL;
+            }
+            sent.push_back(*static_cast<const CommMessage*>(item));
+            return pdPASS;
+        }));
+    EXPECT_EQ(syncStateMaster(MASTESR_STATE_ERROR, 0, &sentCount), RET_OK);
+    ASSERT_EQ(sent.size(), 1u);
+    EXPECT_EQ(sent[0].type, COMM_MSG_SYNC_REQUEST);
+
+    // Heartbeat call: no new change, but the held back one goes out
+    EXPECT_EQ(syncStateMaster(MASTESR_STATE_ERROR, 0, &sentCount), RET_OK);
+    EXPECT_EQ(sentCount, 0u);
+    setSendPacingMaster(DELAY_SEND_MS);
+    ASSERT_EQ(sent.size(), 2u);
+    EXPECT_EQ(sent[1].type, COMM_MSG_MASTER_STATE);
+    EXPECT_EQ(sent[1].payload, MASTESR_STATE_ERROR);
+}
+
+// A batch receive blocks for the first message only and drains the rest
+TEST_F(MasterCommTest, ReciveMsgBatchMaster_DrainsQueuedMessages) {
+    CommMessage messages[8];
+    uint32_t received = 0;
+    uint16_t sequence = 20;
+    testing::InSequence order;
+    EXPECT_CALL(*freeRTOSMock, xQueueReceive(receiveQueueHandle_, testing::_, portMAX_DELAY))
+        .WillOnce(testing::Invoke([&](QueueHandle_t, void* item, TickType_t) {
+            *static_cast<CommMessage*>(item) = {COMM_MSG_SLAVE_STATE, COMM_SOURCE_SLAVE, sequence++, SLAVE_STATE_ACTIVE};
+            return pdPASS;
+        }));
+    EXPECT_CALL(*freeRTOSMock, xQueueReceive(receiveQueueHandle_, testing::_, 0))
+        .WillOnce(testing::Invoke([&](QueueHandle_t, void* item, TickType_t) {
+            *static_cast<CommMessage*>(item) = {COMM_MSG_SLAVE_STATE, COMM_SOURCE_SLAVE, sequence++, SLAVE_STATE_SLEEP};
+            return pdPASS;
+        }))
+        .WillOnce(testing::Invoke([&](QueueHandle_t, void* item, TickType_t) {
+            *static_cast<CommMessage*>(item) = {COMM_MSG_MASTER_STATE, COMM_SOURCE_MASTER, 0, MASTESR_STATE_IDLE};
+            return pdPASS;
+        }))
+        .WillOnce(testing::Return(pdFAIL));
+    EXPECT_EQ(reciveMsgBatchMaster(messages, 8, &received), RET_OK);
+    EXPECT_EQ(received, 2u);
+    EXPECT_EQ(messages[0].payload, SLAVE_STATE_ACTIVE);
+    EXPECT_EQ(messages[1].payload, SLAVE_STATE_SLEEP);
+}
+
+// With ring channels the messages bypass the queues
+TEST_F(MasterCommTest, InitMasterCommRing_SendsAndReceivesThroughRings) {
+    CommRing* sendRing = reinterpret_cast<CommRing*>(0x1000);
+    CommRing* receiveRing = reinterpret_cast<CommRing*>(0x2000);
+    CommMessage message = {COMM_MSG_MASTER_STATE, 0, 0, MASTESR_STATE_PROCESSING};
+    EXPECT_EQ(initMasterCommRing(nullptr, receiveRing), RET_ERROR);
+    ASSERT_EQ(initMasterCommRing(sendRing, receiveRing), RET_OK);
+    EXPECT_CALL(*freeRTOSMock, xQueueSend(testing::_, testing::_, testing::_)).Times(0);
+    EXPECT_CALL(*freeRTOSMock, commRingSend(sendRing, testing::_, pdMS_TO_TICKS(TICK_TO_WAIT_SEND_MS)))
+        .WillOnce(testing::Return(RET_OK));
+    EXPECT_CALL(*freeRTOSMock, commRingReceive(receiveRing, testing::_, portMAX_DELAY))
+        .WillOnce(testing::Invoke([](CommRing*, CommMessage* item, TickType_t) {
+            *item = {COMM_MSG_SLAVE_STATE, COMM_SOURCE_SLAVE, 0, SLAVE_STATE_ACTIVE};
+            return RET_OK;
+        }));
+    EXPECT_EQ(sendMsgMaster(&message), RET_OK);
+    EXPECT_EQ(reciveMsgMaster(&message), RET_OK);
+    EXPECT_EQ(message.payload, SLAVE_STATE_ACTIVE);
+}
+
+// The fan-in queue set is sized for every item of every channel
+TEST_F(MasterCommTest, InitMasterCommFanIn_AddsEveryChannelToTheSet) {
+    QueueHandle_t channels[3] = {reinterpret_cast<QueueHandle_t>(0xa000), reinterpret_cast<QueueHandle_t>(0xb000),
+                                 reinterpret_cast<QueueHandle_t>(0xc000)};
+    QueueSetHandle_t set = reinterpret_cast<QueueSetHandle_t>(0xf000);
+    EXPECT_EQ(initMasterCommFanIn(sendQueueHandle_, channels, 0), RET_ERROR);
+    EXPECT_EQ(initMasterCommFanIn(sendQueueHandle_, channels, COMM_FANIN_MAX_CHANNELS + 1), RET_ERROR);
+
+    channelSpaces = 4;
+    EXPECT_CALL(*freeRTOSMock, xQueueCreateSet(12)).WillOnce(testing::Return(set));
+    for (QueueHandle_t channel : channels) {
+        EXPECT_CALL(*freeRTOSMock, xQueueAddToSet(channel, set)).WillOnce(testing::Return(pdPASS));
+    }
+    EXPECT_EQ(initMasterCommFanIn(sendQueueHandle_, channels, 3), RET_OK);
+}
+
+// One wake-up collects every ready channel and serves them round-robin
+TEST_F(MasterCommTest, ReciveMsgFanInMaster_ServesReadyChannelsRoundRobin) {
+    QueueHandle_t channels[3] = {reinterpret_cast<QueueHandle_t>(0xa000), reinterpret_cast<QueueHandle_t>(0xb000),
+                                 reinterpret_cast<QueueHandle_t>(0xc000)};
+    QueueSetHandle_t set = reinterpret_cast<QueueSetHandle_t>(0xf000);
+    CommMessage messages[8];
+    uint32_t ids[8];
+    uint32_t received = 0;
+    uint16_t sequences[3] = {0, 0, 0};
+    EXPECT_CALL(*freeRTOSMock, xQueueCreateSet(3)).WillOnce(testing::Return(set));
+    EXPECT_CALL(*freeRTOSMock, xQueueAddToSet(testing::_, set)).Times(3).WillRepeatedly(testing::Return(pdPASS));
+    ASSERT_EQ(initMasterCommFanIn(sendQueueHandle_, channels, 3), RET_OK);
+
+    // Channel 0 holds two messages, channels 1 and 2 one each
+    EXPECT_CALL(*freeRTOSMock, xQueueSelectFromSet(set, portMAX_DELAY)).WillOnce(testing::Return(channels[0]));
+    EXPECT_CALL(*freeRTOSMock, xQueueSelectFromSet(set, 0))
+        .WillOnce(testing::Return(channels[0]))
+        .WillOnce(testing::Return(channels[2]))
+        .WillOnce(testing::Return(channels[1]))
+        .WillRepeatedly(testing::Return(nullptr));
+    EXPECT_CALL(*freeRTOSMock, xQueueReceive(testing::_, testing::_, 0))
+        .Times(4)
+        .WillRepeatedly(testing::Invoke([&](QueueHandle_t queue, void* item, TickType_t) {
+            int32_t index = (queue == channels[0]) ? 0 : (queue == channels[1]) ? 1 : 2;
+            *static_cast<CommMessage*>(item) = {COMM_MSG_SLAVE_STATE, COMM_SOURCE_SLAVE, sequences[index]++, index};
+            return pdPASS;
+        }));
+    uint32_t skipped = getSkippedMsgMaster();
+    EXPECT_EQ(reciveMsgFanInMaster(messages, ids, 8, &received), RET_OK);
+    ASSERT_EQ(received, 4u);
+    EXPECT_THAT(std::vector<uint32_t>(ids, ids + 4), testing::ElementsAre(0u, 1u, 2u, 0u));
+    EXPECT_EQ(messages[1].payload, 1);
+    EXPECT_EQ(messages[3].sequence, 1);
+    // Each channel has its own sequence numbers, so interleaving them is not a gap
+    EXPECT_EQ(getSkippedMsgMaster(), skipped);
+}
+
+// With a transport the messages bypass the local channels
+TEST_F(MasterCommTest, InitMasterCommTransport_SendsAndReceivesThroughTransport) {
+    CommTransport* transport = reinterpret_cast<CommTransport*>(0x3000);
+    CommMessage message = {COMM_MSG_MASTER_STATE, 0, 0, MASTESR_STATE_PROCESSING};
+    EXPECT_EQ(initMasterCommTransport(nullptr), RET_ERROR);
+    ASSERT_EQ(initMasterCommTransport(transport), RET_OK);
+    EXPECT_CALL(*freeRTOSMock, xQueueSend(testing::_, testing::_, testing::_)).Times(0);
+    EXPECT_CALL(*freeRTOSMock, vTaskDelay(testing::_)).Times(testing::AnyNumber());
+    EXPECT_CALL(*freeRTOSMock, commTransportSend(transport, testing::_, pdMS_TO_TICKS(TICK_TO_WAIT_SEND_MS)))
+        .WillOnce(testing::Return(RET_OK));
+    EXPECT_CALL(*freeRTOSMock, commTransportReceive(transport, testing::_, portMAX_DELAY))
+        .WillOnce(testing::Invoke([](CommTransport*, CommMessage* item, TickType_t) {
+            *item = {COMM_MSG_SLAVE_STATE, COMM_SOURCE_SLAVE, 0, SLAVE_STATE_SLEEP};
+            return RET_OK;
+        }));
+    EXPECT_EQ(sendMsgMaster(&message), RET_OK);
+    EXPECT_EQ(reciveMsgMaster(&message), RET_OK);
+    EXPECT_EQ(message.payload, SLAVE_STATE_SLEEP);
+}
+
+// A block is received as a pointer, without copying its payload
+TEST_F(MasterCommTest, ReciveBlockMaster_ReturnsQueuedPointer) {
+    QueueHandle_t blockQueueHandle = reinterpret_cast<QueueHandle_t>(0x9abc);
+    CommBlock* queued = reinterpret_cast<CommBlock*>(0x4000);
+    CommBlock* block = nullptr;
+    ASSERT_EQ(initBlockChannelMaster(blockQueueHandle), RET_OK);
+    EXPECT_CALL(*freeRTOSMock, xQueueReceive(blockQueueHandle, testing::_, portMAX_DELAY))
+        .WillOnce(testing::Invoke([&](QueueHandle_t, void* item, TickType_t) {
+            *static_cast<CommBlock**>(item) = queued;
+            return pdPASS;
+        }));
+    EXPECT_EQ(reciveBlockMaster(&block), RET_OK);
+    EXPECT_EQ(block, queued);
+}
+
+// A payload is read as the master consumer of the pipeline
+TEST_F(MasterCommTest, RecivePayloadMaster_ReadsMasterConsumer) {
+    CommPipeline pipeline = {};
+    uint8_t payload[COMM_PIPELINE_MAX_PAYLOAD];
+    uint32_t length = 0;
+    EXPECT_CALL(*freeRTOSMock, logMessage(testing::_, testing::_, testing::_)).Times(testing::AnyNumber());
+    pipeline.consumerCount = COMM_PAYLOAD_CONSUMER_MASTER;
+    EXPECT_EQ(initPayloadPipelineMaster(&pipeline), RET_ERROR);
+    pipeline.consumerCount = COMM_PAYLOAD_CONSUMER_MAX;
+    ASSERT_EQ(initPayloadPipelineMaster(&pipeline), RET_OK);
+    EXPECT_CALL(*freeRTOSMock, commPipelineReceive(&pipeline, COMM_PAYLOAD_CONSUMER_MASTER, payload, sizeof(payload),
+                                                   &length, portMAX_DELAY))
+        .WillOnce(testing::DoAll(testing::SetArgPointee<4>(4u), testing::Return(RET_OK)));
+    EXPECT_EQ(recivePayloadMaster(payload, sizeof(payload), &length), RET_OK);
+    EXPECT_EQ(length, 4u);
+}
+
+// The first sync asks the slave for its states and sends the master state; an unchanged state is not sent again
+TEST_F(MasterCommTest, SyncStateMaster_UnchangedState_SendsNothingAfterFirstSync) {
+    CommMessage sent[2];
+    int count = 0;
+    uint32_t sentCount = 0;
+    channelSpaces = 8;
+    ASSERT_EQ(initMasterComm(sendQueueHandle_, receiveQueueHandle_), RET_OK);
+    EXPECT_CALL(*freeRTOSMock, xQueueSend(sendQueueHandle_, testing::_, testing::_))
+        .Times(2)
+        .WillRepeatedly(testing::Invoke([&](QueueHandle_t, const void* item, TickType_t) {
+            sent[count++] = *static_cast<const CommMessage*>(item);
+            return pdPASS;
+        }));
+    EXPECT_CALL(*freeRTOSMock, vTaskDelay(pdMS_TO_TICKS(DELAY_SEND_MS))).Times(1);
+    EXPECT_EQ(syncStateMaster(MASTESR_STATE_PROCESSING, 0, &sentCount), RET_OK);
+    EXPECT_EQ(sentCount, 2u);
+    EXPECT_EQ(syncStateMaster(MASTESR_STATE_PROCESSING, 0, &sentCount), RET_OK);
+    EXPECT_EQ(sentCount, 0u);
+
+    EXPECT_EQ(sent[0].type, COMM_MSG_SYNC_REQUEST);
+    EXPECT_EQ(sent[0].version, 0u);
+    EXPECT_EQ(sent[1].type, COMM_MSG_MASTER_STATE);
+    EXPECT_EQ(sent[1].payload, MASTESR_STATE_PROCESSING);
+    EXPECT_EQ(sent[1].baseVersion, 0u);
+    EXPECT_EQ(sent[1].version, 1u);
+}
+
+// A slave state that does not follow the version the master has is dropped and asked for again
+TEST_F(MasterCommTest, ReciveMsgMaster_SyncGap_RequestsChangesAgain) {
+    CommMessage message;
+    CommMessage received[2] = {{COMM_MSG_SLAVE_STATE, COMM_SOURCE_SLAVE, 0, SLAVE_STATE_ACTIVE, 0, 0, 1, 0},
+                               {COMM_MSG_SLAVE_STATE, COMM_SOURCE_SLAVE, 1, SLAVE_STATE_FAULT, 0, 0, 3, 2}};
+    int count = 0;
+    CommMessage request = {};
+    channelSpaces = 8;
+    ASSERT_EQ(initMasterComm(sendQueueHandle_, receiveQueueHandle_), RET_OK);
+    EXPECT_CALL(*freeRTOSMock, xQueueReceive(receiveQueueHandle_, testing::_, portMAX_DELAY))
+        .Times(2)
+        .WillRepeatedly(testing::Invoke([&](QueueHandle_t, void* item, TickType_t) {
+            *static_cast<CommMessage*>(item) = received[count++];
+            return pdPASS;
+        }));
+    EXPECT_EQ(reciveMsgMaster(&message), RET_OK);
+    EXPECT_EQ(reciveMsgMaster(&message), RET_ERROR);
+
+    // Drop the request owed since start-up, so only the one for the gap is left
+    EXPECT_CALL(*freeRTOSMock, xQueueSend(sendQueueHandle_, testing::_, testing::_))
+        .WillRepeatedly(testing::Invoke([&](QueueHandle_t, const void* item, TickType_t) {
+            const CommMessage* sent = static_cast<const CommMessage*>(item);
+            if (sent->type == COMM_MSG_SYNC_REQUEST) {
+                request = *sent;
+            }
+            return pdPASS;
+        }));
+    EXPECT_CALL(*freeRTOSMock, vTaskDelay(testing::_)).Times(testing::AnyNumber());
+    EXPECT_EQ(syncStateMaster(MASTESR_STATE_IDLE, 0, nullptr), RET_OK);
+    EXPECT_EQ(request.type, COMM_MSG_SYNC_REQUEST);
+    EXPECT_EQ(request.version, 1u);
+}
+
+// A slave state the master already has is dropped
+TEST_F(MasterCommTest, ReciveMsgMaster_SyncStale_DropsState) {
+    CommMessage message;
+    CommMessage received[2] = {{COMM_MSG_SLAVE_STATE, COMM_SOURCE_SLAVE, 0, SLAVE_STATE_ACTIVE, 0, 0, 2, 0},
+                               {COMM_MSG_SLAVE_STATE, COMM_SOURCE_SLAVE, 1, SLAVE_STATE_SLEEP, 0, 0, 2, 1}};
+    int count = 0;
+    EXPECT_CALL(*freeRTOSMock, xQueueReceive(receiveQueueHandle_, testing::_, portMAX_DELAY))
+        .Times(2)
+        .WillRepeatedly(testing::Invoke([&](QueueHandle_t, void* item, TickType_t) {
+            *static_cast<CommMessage*>(item) = received[count++];
+            return pdPASS;
+        }));
+    EXPECT_EQ(reciveMsgMaster(&message), RET_OK);
+    EXPECT_EQ(message.payload, SLAVE_STATE_ACTIVE);
+    EXPECT_EQ(reciveMsgMaster(&message), RET_ERROR);
+}
+
+// A sync request of the slave is consumed and answered with the master state again
+TEST_F(MasterCommTest, ReciveMsgMaster_SyncRequest_ResendsState) {
+    CommMessage message;
+    uint32_t sentCount = 0;
+    channelSpaces = 8;
+    ASSERT_EQ(initMasterComm(sendQueueHandle_, receiveQueueHandle_), RET_OK);
+    EXPECT_CALL(*freeRTOSMock, xQueueSend(sendQueueHandle_, testing::_, testing::_))
+        .WillRepeatedly(testing::Return(pdPASS));
+    EXPECT_CALL(*freeRTOSMock, vTaskDelay(testing::_)).Times(testing::AnyNumber());
+    EXPECT_EQ(syncStateMaster(MASTESR_STATE_ERROR, 0, &sentCount), RET_OK);
+
+    EXPECT_CALL(*freeRTOSMock, xQueueReceive(receiveQueueHandle_, testing::_, portMAX_DELAY))
+        .WillOnce(testing::Invoke([](QueueHandle_t, void* item, TickType_t) {
+            *static_cast<CommMessage*>(item) = {COMM_MSG_SYNC_REQUEST, COMM_SOURCE_SLAVE, 0, 0, 0, 0, 0, 0};
+            return pdPASS;
+        }));
+    EXPECT_EQ(reciveMsgMaster(&message), RET_ERROR);
+    EXPECT_EQ(syncStateMaster(MASTESR_STATE_ERROR, 0, &sentCount), RET_OK);
+    EXPECT_EQ(sentCount, 1u);
+}
+
+// Over a mailbox every sync sends the master state as a snapshot and no request
+TEST_F(MasterCommTest, SyncStateMaster_Mailbox_SendsSnapshotEveryCall) {
+    CommMessage sent[3];
+    int count = 0;
+    EXPECT_CALL(*freeRTOSMock, xQueueSend(sendQueueHandle_, testing::_, SEND_WAIT_TICKS))
+        .Times(3)
+        .WillRepeatedly(testing::Invoke([&](QueueHandle_t, const void* item, TickType_t) {
+            sent[count++] = *static_cast<const CommMessage*>(item);
+            return pdPASS;
+        }));
+    EXPECT_CALL(*freeRTOSMock, vTaskDelay(pdMS_TO_TICKS(DELAY_SEND_MS))).Times(3);
+    EXPECT_EQ(syncStateMaster(MASTESR_STATE_PROCESSING, 0, nullptr), RET_OK);
+    EXPECT_EQ(syncStateMaster(MASTESR_STATE_PROCESSING, 0, nullptr), RET_OK);
+    EXPECT_EQ(syncStateMaster(MASTESR_STATE_ERROR, 0, nullptr), RET_OK);
+
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(sent[i].type, COMM_MSG_MASTER_STATE);
+        EXPECT_EQ(sent[i].baseVersion, 0u);
+    }
+    EXPECT_EQ(sent[1].payload, MASTESR_STATE_PROCESSING);
+    EXPECT_EQ(sent[1].version, 1u);
+    EXPECT_EQ(sent[2].payload, MASTESR_STATE_ERROR);
+    EXPECT_EQ(sent[2].version, 2u);
 }
 
 // Failed Message Receive Test
 TEST_F(MasterCommTest, ReciveMsgMaster_QueueReceiveFailure_ReturnsRET_ERROR) {
-    uint8_t data = 1;
-    EXPECT_CALL(*freeRTOSMock, xQueueReceive(stateQueueHandle_, testing::_, portMAX_DELAY))
+    CommMessage message;
+    EXPECT_CALL(*freeRTOSMock, xQueueReceive(receiveQueueHandle_, testing::_, portMAX_DELAY))
         .WillOnce(testing::Return(pdFAIL));
-    EXPECT_EQ(reciveMsgMaster(&data), RET_ERROR);
+    EXPECT_EQ(reciveMsgMaster(&message), RET_ERROR);
 }
 
 int main(int argc, char **argv) {
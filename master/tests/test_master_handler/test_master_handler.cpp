@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <vector>
 #include "master_handler.h"
 #include "types.h"
 
@@ -7,8 +8,10 @@
 extern "C" {
     #include "master_handler.h"
     #include "master_comm.h"
+    #include "comm_cfg.h"
     #include "master_state_machine.h"
     #include "logger.h"
+    #include "logger_trace.h"
     #include "task.h"
     #include "types.h"
 }
@@ -16,7 +19,6 @@ extern "C" {
 // ==========================
 // Constants Definition
 // ==========================
-#define TASTK_TIME_MASTER_COMM_HANDLER               10 ///< Time interval for Master Communication Handler.
 #define TASTK_TIME_MASTER_STATUS_CHECK_HANDLER       500 ///< Time interval for Master Status Check Handler.
 
 // ==========================
@@ -25,8 +27,10 @@ extern "C" {
 // Mock class for Master Communication
 class MockMasterComm {
 public:
-    MOCK_METHOD(RetVal_t, reciveMsgMaster, (void*), ());
-    MOCK_METHOD(RetVal_t, sendMsgMaster, (const void*), ());
+    MOCK_METHOD(RetVal_t, reciveMsgMaster, (CommMessage*), ());
+    MOCK_METHOD(RetVal_t, reciveMsgBatchMaster, (CommMessage*, uint32_t, uint32_t*), ());
+    MOCK_METHOD(RetVal_t, syncStateMaster, (int32_t, uint32_t, uint32_t*), ());
+    MOCK_METHOD(RetVal_t, recivePayloadMaster, (void*, uint32_t, uint32_t*), ());
 };
 
 // Mock class for Master State Machine
@@ -34,6 +38,7 @@ class MockMasterStateMachine {
 public:
     MOCK_METHOD(RetVal_t, stateDispatcher, (SlaveStates), ());
     MOCK_METHOD(RetVal_t, getCurrentState, (MasterStates*), ());
+    MOCK_METHOD(RetVal_t, waitStateChangeMaster, (TickType_t), ());
 };
 
 // Mock class for Logger
@@ -62,12 +67,20 @@ MockTask* mockTask;
 // ==========================
 // Redirect C function calls to corresponding mock methods
 extern "C" {
-RetVal_t reciveMsgMaster(void* data) {
+RetVal_t reciveMsgMaster(CommMessage* data) {
     return mockMasterComm->reciveMsgMaster(data);
 }
 
-RetVal_t sendMsgMaster(const void* data) {
-    return mockMasterComm->sendMsgMaster(data);
+RetVal_t reciveMsgBatchMaster(CommMessage* messages, uint32_t capacity, uint32_t* receivedCount) {
+    return mockMasterComm->reciveMsgBatchMaster(messages, capacity, receivedCount);
+}
+
+RetVal_t syncStateMaster(int32_t state, uint32_t traceId, uint32_t* sentCount) {
+    return mockMasterComm->syncStateMaster(state, traceId, sentCount);
+}
+
+RetVal_t recivePayloadMaster(void* payload, uint32_t capacity, uint32_t* length) {
+    return mockMasterComm->recivePayloadMaster(payload, capacity, length);
 }
 
 RetVal_t stateDispatcher(SlaveStates data) {
@@ -78,15 +91,42 @@ RetVal_t getCurrentState(MasterStates* data) {
     return mockMasterStateMachine->getCurrentState(data);
 }
 
+RetVal_t waitStateChangeMaster(TickType_t ticksToWait) {
+    return mockMasterStateMachine->waitStateChangeMaster(ticksToWait);
+}
+
 void logMessage(LogLevel level, const char* module, const char* message) {
     mockLogger->logMessage(level, module, message);
 }
 
+void logStatusHeartbeat(void) {
+}
+
+void logTraceSpan(uint32_t traceId, LogTraceHop hop, uint32_t value) {
+}
+
+void logTraceSetCurrent(uint32_t traceId) {
+}
+
 void vTaskDelay(TickType_t ticks) {
     mockTask->vTaskDelay(ticks);
 }
 }
 
+// Fills a received batch with the slave states of the given list
+static auto ReceiveStates(std::vector<SlaveStates> states) {
+    return [states](CommMessage* messages, uint32_t capacity, uint32_t* receivedCount) {
+        uint32_t count = 0;
+        for (SlaveStates state : states) {
+            if (count < capacity) {
+                messages[count++] = {COMM_MSG_SLAVE_STATE, COMM_SOURCE_SLAVE, 0, state};
+            }
+        }
+        *receivedCount = count;
+        return RET_OK;
+    };
+}
+
 // ==========================
 // Test Fixture
 // ==========================
@@ -113,31 +153,45 @@ protected:
 // ==========================
 // Test case when message receiving fails
 TEST_F(MasterHandlerTest, vMasterReciverHandler_ReceiveMessageFails) {
-    EXPECT_CALL(*mockMasterComm, reciveMsgMaster(testing::_))
+    EXPECT_CALL(*mockMasterComm, reciveMsgBatchMaster(testing::_, testing::_, testing::_))
         .WillOnce(testing::Return(RET_ERROR));
-    EXPECT_CALL(*mockTask, vTaskDelay(pdMS_TO_TICKS(TASTK_TIME_MASTER_COMM_HANDLER)));
+    EXPECT_CALL(*mockMasterStateMachine, stateDispatcher(testing::_)).Times(0);
+    EXPECT_CALL(*mockTask, vTaskDelay(testing::_)).Times(0);
 
     vMasterReciverHandler(nullptr);
 }
 
 // Test case when state dispatcher fails
 TEST_F(MasterHandlerTest, vMasterReciverHandler_StateDispatcherFails) {
-    EXPECT_CALL(*mockMasterComm, reciveMsgMaster(testing::_))
-        .WillOnce(testing::Return(RET_OK));
+    EXPECT_CALL(*mockMasterComm, reciveMsgBatchMaster(testing::_, testing::_, testing::_))
+        .WillOnce(testing::Invoke(ReceiveStates({SLAVE_STATE_FAULT})));
     EXPECT_CALL(*mockMasterStateMachine, stateDispatcher(testing::_))
         .WillOnce(testing::Return(RET_ERROR));
-    EXPECT_CALL(*mockTask, vTaskDelay(pdMS_TO_TICKS(TASTK_TIME_MASTER_COMM_HANDLER)));
+    EXPECT_CALL(*mockTask, vTaskDelay(testing::_)).Times(0);
 
     vMasterReciverHandler(nullptr);
 }
 
 // Test case when vMasterReciverHandler executes successfully
 TEST_F(MasterHandlerTest, vMasterReciverHandler_Success) {
-    EXPECT_CALL(*mockMasterComm, reciveMsgMaster(testing::_))
-        .WillOnce(testing::Return(RET_OK));
+    EXPECT_CALL(*mockMasterComm, reciveMsgBatchMaster(testing::_, testing::_, testing::_))
+        .WillOnce(testing::Invoke(ReceiveStates({SLAVE_STATE_ACTIVE})));
     EXPECT_CALL(*mockMasterStateMachine, stateDispatcher(testing::_))
         .WillOnce(testing::Return(RET_OK));
-    EXPECT_CALL(*mockTask, vTaskDelay(pdMS_TO_TICKS(TASTK_TIME_MASTER_COMM_HANDLER)));
+    EXPECT_CALL(*mockTask, vTaskDelay(testing::_)).Times(0);
+
+    vMasterReciverHandler(nullptr);
+}
+
+// Test case when one wake-up dispatches every message of the batch
+TEST_F(MasterHandlerTest, vMasterReciverHandler_DispatchesWholeBatch) {
+    EXPECT_CALL(*mockMasterComm, reciveMsgBatchMaster(testing::_, testing::_, testing::_))
+        .WillOnce(testing::Invoke(ReceiveStates({SLAVE_STATE_ACTIVE, SLAVE_STATE_FAULT, SLAVE_STATE_SLEEP})));
+    testing::InSequence order;
+    EXPECT_CALL(*mockMasterStateMachine, stateDispatcher(SLAVE_STATE_ACTIVE)).WillOnce(testing::Return(RET_OK));
+    EXPECT_CALL(*mockMasterStateMachine, stateDispatcher(SLAVE_STATE_FAULT)).WillOnce(testing::Return(RET_OK));
+    EXPECT_CALL(*mockMasterStateMachine, stateDispatcher(SLAVE_STATE_SLEEP)).WillOnce(testing::Return(RET_OK));
+    EXPECT_CALL(*mockTask, vTaskDelay(testing::_)).Times(0);
 
     vMasterReciverHandler(nullptr);
 }
@@ -149,24 +203,51 @@ TEST_F(MasterHandlerTest, vMasterReciverHandler_Success) {
 TEST_F(MasterHandlerTest, vMasterSenderHandler_SendMessageFails) {
     EXPECT_CALL(*mockMasterStateMachine, getCurrentState(testing::_))
         .WillOnce(testing::Return(RET_OK));
-    EXPECT_CALL(*mockMasterComm, sendMsgMaster(testing::_))
+    EXPECT_CALL(*mockMasterComm, syncStateMaster(testing::_, testing::_, testing::_))
+        .WillOnce(testing::Return(RET_ERROR));
+    EXPECT_CALL(*mockMasterStateMachine, waitStateChangeMaster(pdMS_TO_TICKS(TASTK_TIME_MASTER_STATUS_CHECK_HANDLER)))
         .WillOnce(testing::Return(RET_ERROR));
-    EXPECT_CALL(*mockTask, vTaskDelay(pdMS_TO_TICKS(TASTK_TIME_MASTER_STATUS_CHECK_HANDLER)));
 
     vMasterSenderHandler(nullptr);
 }
 
-// Test case when vMasterSenderHandler executes successfully
+// Test case when vMasterSenderHandler syncs the current state successfully
 TEST_F(MasterHandlerTest, vMasterSenderHandler_Success) {
     EXPECT_CALL(*mockMasterStateMachine, getCurrentState(testing::_))
+        .WillOnce([](MasterStates* state) {
+            *state = MASTESR_STATE_PROCESSING;
+            return RET_OK;
+        });
+    EXPECT_CALL(*mockMasterComm, syncStateMaster(MASTESR_STATE_PROCESSING, testing::_, testing::_))
         .WillOnce(testing::Return(RET_OK));
-    EXPECT_CALL(*mockMasterComm, sendMsgMaster(testing::_))
+    EXPECT_CALL(*mockMasterStateMachine, waitStateChangeMaster(pdMS_TO_TICKS(TASTK_TIME_MASTER_STATUS_CHECK_HANDLER)))
         .WillOnce(testing::Return(RET_OK));
-    EXPECT_CALL(*mockTask, vTaskDelay(pdMS_TO_TICKS(TASTK_TIME_MASTER_STATUS_CHECK_HANDLER)));
 
     vMasterSenderHandler(nullptr);
 }
 
+// ==========================
+// Unit Tests for vMasterTelemetryHandler
+// ==========================
+// Test case when a payload is received into a buffer that fits any payload
+TEST_F(MasterHandlerTest, vMasterTelemetryHandler_ReceivesPayload) {
+    EXPECT_CALL(*mockMasterComm, recivePayloadMaster(testing::NotNull(), COMM_PIPELINE_MAX_PAYLOAD, testing::NotNull()))
+        .WillOnce(testing::DoAll(testing::SetArgPointee<2>(4u), testing::Return(RET_OK)));
+    EXPECT_CALL(*mockLogger, logMessage(LOG_LEVEL_ERROR, testing::_, testing::_)).Times(0);
+    EXPECT_CALL(*mockLogger, logMessage(LOG_LEVEL_DEBUG, testing::_, testing::_)).Times(testing::AnyNumber());
+
+    vMasterTelemetryHandler(nullptr);
+}
+
+// Test case when receiving a payload fails
+TEST_F(MasterHandlerTest, vMasterTelemetryHandler_ReceivePayloadFails) {
+    EXPECT_CALL(*mockMasterComm, recivePayloadMaster(testing::_, testing::_, testing::_))
+        .WillOnce(testing::Return(RET_ERROR));
+    EXPECT_CALL(*mockLogger, logMessage(LOG_LEVEL_ERROR, testing::_, testing::_));
+
+    vMasterTelemetryHandler(nullptr);
+}
+
 // ==========================
 // Main Function
 // ==========================
@@ -3,6 +3,7 @@
 #include <cstdarg> // Include for va_list, va_start, and va_end
 #include "master_state_machine.h"
 #include "types.h"
+#include "comm_types.h"
 
 // ==========================
 // **Include Dependencies**
@@ -11,6 +12,7 @@ extern "C" {
     #include "queue.h"
     #include "semphr.h"
     #include "logger.h"
+    #include "logger_trace.h"
 }
 
 // ==========================
@@ -46,11 +48,21 @@ public:
     MOCK_METHOD(SemaphoreHandle_t, xSemaphoreCreateBinary, (), ());
 };
 
+// Mock class for Event Group operations
+class MockEventGroup {
+public:
+    MOCK_METHOD(EventGroupHandle_t, xEventGroupCreate, (), ());
+    MOCK_METHOD(EventBits_t, xEventGroupSetBits, (EventGroupHandle_t, EventBits_t), ());
+    MOCK_METHOD(EventBits_t, xEventGroupWaitBits, (EventGroupHandle_t, EventBits_t, BaseType_t, BaseType_t, TickType_t), ());
+};
+
 // Mock class for Logger operations
 class MockLogger {
 public:
     MOCK_METHOD(void, logMessage, (LogLevel, const char*, const char*), ());
     MOCK_METHOD(void, logMessageFormattedHelper, (LogLevel, const char*, const char*), ());
+    MOCK_METHOD(void, logStatusSetMasterState, (MasterStates), ());
+    MOCK_METHOD(void, logTraceSpan, (uint32_t, LogTraceHop, uint32_t), ());
     
     void logMessageFormatted(LogLevel level, const char* component, const char* format, ...) {
         va_list args;
@@ -63,16 +75,18 @@ public:
 // Mock class for Master Communication operations
 class MockMasterComm {
 public:
-    MOCK_METHOD(RetVal_t, reciveMsgMaster, (void*), ());
-    MOCK_METHOD(RetVal_t, sendMsgMaster, (const void*), ());
+    MOCK_METHOD(RetVal_t, reciveMsgMaster, (CommMessage*), ());
+    MOCK_METHOD(RetVal_t, sendMsgMaster, (const CommMessage*), ());
 };
 
 // ==========================
 // **Global Mock Objects**
 // ==========================
 MockSemaphore* mockSemaphore;
+MockEventGroup* mockEventGroup;
 MockLogger* mockLogger;
 MockMasterComm* mockMasterComm;
+uint32_t currentTrace = 0;
 
 // ==========================
 // **Fake Implementations for C Functions**
@@ -90,6 +104,22 @@ extern "C" {
         return mockSemaphore->xSemaphoreCreateBinary();
     }
 
+    EventGroupHandle_t xEventGroupCreate(void) {
+        return mockEventGroup->xEventGroupCreate();
+    }
+
+    EventBits_t xEventGroupSetBits(EventGroupHandle_t eventGroup, const EventBits_t bits) {
+        return mockEventGroup->xEventGroupSetBits(eventGroup, bits);
+    }
+
+    EventBits_t xEventGroupWaitBits(EventGroupHandle_t eventGroup, const EventBits_t bits, const BaseType_t clearOnExit,
+                                    const BaseType_t waitForAllBits, TickType_t ticksToWait) {
+        return mockEventGroup->xEventGroupWaitBits(eventGroup, bits, clearOnExit, waitForAllBits, ticksToWait);
+    }
+
+    void vTaskDelay(const TickType_t ticksToDelay) {
+    }
+
     void logMessage(LogLevel level, const char* module, const char* message) {
         mockLogger->logMessage(level, module, message);
     }
@@ -98,11 +128,32 @@ extern "C" {
         mockLogger->logMessageFormatted(level, component, format);
     }
 
-    RetVal_t reciveMsgMaster(void* data) {
+    void logStatusSetMasterState(MasterStates state) {
+        mockLogger->logStatusSetMasterState(state);
+    }
+
+    void logTraceSpan(uint32_t traceId, LogTraceHop hop, uint32_t value) {
+        mockLogger->logTraceSpan(traceId, hop, value);
+    }
+
+    uint32_t logTraceCurrent(void) {
+        return currentTrace;
+    }
+
+    uint8_t logComponentLevelEnabled(LogComponentId* site, const char* component, LogLevel level) {
+        return 1;
+    }
+
+    uint8_t logRateLimitAllow(LogRateLimit* site, uint32_t limit, LogLevel level,
+                              const char* component, const char* text) {
+        return 1;
+    }
+
+    RetVal_t reciveMsgMaster(CommMessage* data) {
         return mockMasterComm->reciveMsgMaster(data);
     }
 
-    RetVal_t sendMsgMaster(const void* data) {
+    RetVal_t sendMsgMaster(const CommMessage* data) {
         return mockMasterComm->sendMsgMaster(data);
     }
 
@@ -127,16 +178,21 @@ protected:
     SemaphoreHandle_t semaphore = nullptr;
     void SetUp() override {
         mockSemaphore = new MockSemaphore();
+        mockEventGroup = new MockEventGroup();
         mockLogger = new MockLogger();
         mockMasterComm = new MockMasterComm();
 
         semaphore = reinterpret_cast<SemaphoreHandle_t>(0x1234);
         masterStateMachineCondition.stateSemaphore = reinterpret_cast<SemaphoreHandle_t>(0x1234);
         masterStateMachineCondition.currentState = MASTESR_STATE_IDLE;
+        masterStateMachineCondition.stateEvents = reinterpret_cast<EventGroupHandle_t>(0x5678);
+        currentTrace = 0;
+        EXPECT_CALL(*mockEventGroup, xEventGroupSetBits(::testing::_, ::testing::_)).Times(::testing::AnyNumber());
     }
 
     void TearDown() override {
         delete mockSemaphore;
+        delete mockEventGroup;
         delete mockLogger;
         delete mockMasterComm;
     }
@@ -175,6 +231,37 @@ TEST_F(MasterStateMachineTest, StateDispatcher_TransitionToErrorState) {
     EXPECT_EQ(state, MASTESR_STATE_ERROR);
 }
 
+// Test that a transition is published on the status page once
+TEST_F(MasterStateMachineTest, StateDispatcher_PublishesTransitionToStatusPage) {
+    EXPECT_CALL(*mockSemaphore, xSemaphoreTake(::testing::_, SEMAPHOR_TICKS))
+        .WillRepeatedly(::testing::Return(pdTRUE));
+    EXPECT_CALL(*mockLogger, logStatusSetMasterState(MASTESR_STATE_PROCESSING)).Times(1);
+
+    EXPECT_EQ(stateDispatcher(SLAVE_STATE_ACTIVE), RET_OK);
+    EXPECT_EQ(stateDispatcher(SLAVE_STATE_ACTIVE), RET_ERROR);
+}
+
+// Test that a transition ends the trace being dispatched
+TEST_F(MasterStateMachineTest, StateDispatcher_RecordsTransitionSpanOfCurrentTrace) {
+    EXPECT_CALL(*mockSemaphore, xSemaphoreTake(::testing::_, SEMAPHOR_TICKS))
+        .WillRepeatedly(::testing::Return(pdTRUE));
+    EXPECT_CALL(*mockLogger, logTraceSpan(7u, LOG_TRACE_HOP_MASTER_TRANSITION, MASTESR_STATE_ERROR)).Times(1);
+
+    currentTrace = 7;
+    EXPECT_EQ(stateDispatcher(SLAVE_STATE_FAULT), RET_OK);
+    EXPECT_EQ(stateDispatcher(SLAVE_STATE_FAULT), RET_ERROR);
+}
+
+// Test that a transition wakes the task waiting for state changes once
+TEST_F(MasterStateMachineTest, StateDispatcher_SignalsStateChange) {
+    EXPECT_CALL(*mockSemaphore, xSemaphoreTake(::testing::_, SEMAPHOR_TICKS))
+        .WillRepeatedly(::testing::Return(pdTRUE));
+    EXPECT_CALL(*mockEventGroup, xEventGroupSetBits(masterStateMachineCondition.stateEvents, ::testing::_)).Times(1);
+
+    EXPECT_EQ(stateDispatcher(SLAVE_STATE_ACTIVE), RET_OK);
+    EXPECT_EQ(stateDispatcher(SLAVE_STATE_ACTIVE), RET_ERROR);
+}
+
 // Test handling of Invalid State
 TEST_F(MasterStateMachineTest, StateDispatcher_InvalidState) {
     EXPECT_EQ(stateDispatcher(SLAVE_STATE_MAX), RET_ERROR);
@@ -187,6 +274,9 @@ TEST_F(MasterStateMachineTest, StateDispatcher_InvalidState) {
 TEST_F(MasterStateMachineTest, InitStateSemaphoreMaster_Success) {
     EXPECT_CALL(*mockSemaphore, xSemaphoreCreateBinary())
         .WillOnce(::testing::Return(reinterpret_cast<SemaphoreHandle_t>(0x1234)));
+    EXPECT_CALL(*mockEventGroup, xEventGroupCreate())
+        .WillOnce(::testing::Return(reinterpret_cast<EventGroupHandle_t>(0x5678)));
+    EXPECT_CALL(*mockLogger, logStatusSetMasterState(MASTESR_STATE_IDLE)).Times(1);
     EXPECT_EQ(initStateSemaphoreMaster(), RET_OK);
 }
 
@@ -197,6 +287,24 @@ TEST_F(MasterStateMachineTest, InitStateSemaphoreMaster_Failure) {
     EXPECT_EQ(initStateSemaphoreMaster(), RET_ERROR);
 }
 
+// ==========================
+// **3. State Change Wait Tests**
+// ==========================
+// Test that a state change ends the wait
+TEST_F(MasterStateMachineTest, WaitStateChangeMaster_StateChanged_ReturnsRET_OK) {
+    EXPECT_CALL(*mockEventGroup, xEventGroupWaitBits(masterStateMachineCondition.stateEvents, ::testing::_, pdTRUE,
+                                                     pdFALSE, 50))
+        .WillOnce(::testing::ReturnArg<1>());
+    EXPECT_EQ(waitStateChangeMaster(50), RET_OK);
+}
+
+// Test that a wait without a state change times out
+TEST_F(MasterStateMachineTest, WaitStateChangeMaster_Timeout_ReturnsRET_ERROR) {
+    EXPECT_CALL(*mockEventGroup, xEventGroupWaitBits(::testing::_, ::testing::_, ::testing::_, ::testing::_, 50))
+        .WillOnce(::testing::Return(0));
+    EXPECT_EQ(waitStateChangeMaster(50), RET_ERROR);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
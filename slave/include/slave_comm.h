@@ -2,6 +2,7 @@
 #define SLAVE_COMM_H
 
 #include "types.h"
+#include "comm_types.h"
 #include "FreeRTOS.h"
 #include "queue.h"
 
@@ -22,36 +23,258 @@ extern "C" {
  * @brief Initialize the slave communication module.
  *
  * Sets up the necessary communication queues for managing inter-task communication.
- * This function ensures proper initialization of state communication channels.
+ * This function ensures proper initialization of both directional state channels.
+ * A slave-to-master channel of length 1 is used as a latest-value mailbox.
  *
- * @param stateQueueHandler Queue handle for state communication.
+ * @param sendQueueHandler Queue handle of the slave-to-master channel.
+ * @param receiveQueueHandler Queue handle of the master-to-slave channel.
  * @return RET_OK if initialization was successful, RET_ERROR otherwise.
  */
-RetVal_t initSlaveComm(QueueHandle_t stateQueueHandler);
+RetVal_t initSlaveComm(QueueHandle_t sendQueueHandler, QueueHandle_t receiveQueueHandler);
 
 /**
- * @brief Send a message through the specified communication channel.
+ * @brief Initialize the slave communication module with ring channels.
  *
- * Sends data over the specified communication channel. The channel identifier
- * determines which queue the message will be sent to.
+ * Alternative to initSlaveComm() that connects the slave to the master with
+ * two lock-free single-producer, single-consumer rings (comm_ring.h).
  *
- * @param channeId Identifier of the communication channel.
- * @param data Pointer to the data to be sent.
+ * @param sendRing Ring of the slave-to-master channel, initialized with commRingInit().
+ * @param receiveRing Ring of the master-to-slave channel, initialized with commRingInit().
+ * @return RET_OK if initialization was successful, RET_ERROR otherwise.
+ */
+RetVal_t initSlaveCommRing(CommRing *sendRing, CommRing *receiveRing);
+
+/**
+ * @brief Initialize the slave communication module with a transport.
+ *
+ * Alternative to initSlaveComm() that sends and receives through the slave end
+ * of a master-slave link (comm_transport.h): in-process queues, a Unix domain
+ * socket or shared memory, so the master may run in another process.
+ *
+ * @param transport Slave end of the link, opened with a commTransportOpen function.
+ * @return RET_OK if successful, RET_ERROR otherwise.
+ */
+RetVal_t initSlaveCommTransport(CommTransport *transport);
+
+/**
+ * @brief Send a message to the master.
+ *
+ * Sends the message over the slave-to-master channel. The source id and the
+ * sequence number of the envelope are filled in by this function. The pacing
+ * delay (see setSendPacingSlave()) is applied after sending.
+ *
+ * @param message Message to send (type and payload set by the caller).
  * @return RET_OK if the message was successfully sent, RET_ERROR otherwise.
  */
-RetVal_t sendMsgSlave(const void *data);
+RetVal_t sendMsgSlave(const CommMessage *message);
+
+/**
+ * @brief Send several messages to the master in one call.
+ *
+ * Sends the messages back to back without pacing between them; the pacing
+ * delay is applied once after the batch. Stops at the first failed send.
+ *
+ * @param messages Messages to send (type and payload set by the caller).
+ * @param count Number of messages.
+ * @param sentCount Pointer to store the number of messages sent, may be NULL.
+ * @return RET_OK if all messages were sent, RET_ERROR otherwise.
+ */
+RetVal_t sendMsgBatchSlave(const CommMessage *messages, uint32_t count, uint32_t *sentCount);
+
+/**
+ * @brief Receive a message from the master.
+ *
+ * Receives a message from the master-to-slave channel. The function blocks
+ * until data is available or a timeout occurs. The state sync consumes the
+ * sync requests of the master and the master states the slave already has;
+ * for them RET_ERROR is returned.
+ *
+ * @param message Pointer to store the received message.
+ * @return RET_OK if a message from the master was received, RET_ERROR otherwise.
+ */
+RetVal_t reciveMsgSlave(CommMessage *message);
+
+/**
+ * @brief Receive several messages from the master in one call.
+ *
+ * Blocks until a message is available, then drains the already queued
+ * messages without blocking, up to capacity. Messages consumed by the state
+ * sync are left out.
+ *
+ * @param messages Array to store the received messages.
+ * @param capacity Size of the array.
+ * @param receivedCount Pointer to store the number of messages received.
+ * @return RET_OK if at least one message from the master was received, RET_ERROR otherwise.
+ */
+RetVal_t reciveMsgBatchSlave(CommMessage *messages, uint32_t capacity, uint32_t *receivedCount);
+
+/**
+ * @brief Send the slave state changes the master does not have.
+ *
+ * Sets the slave state in the slave's sync holder (comm_sync.h) and sends, as
+ * one batch, the sync request the slave owes the master (at start-up, after a
+ * lost master state and after resyncStateSlave()) and the slave state changes
+ * after the version the master has. Nothing is sent while the state is
+ * unchanged and no request is owed, except a message held back by
+ * COMM_OVERFLOW_COALESCE, which is sent first. Must be called by one task only.
+ *
+ * @param slaveId Slave the state belongs to (COMM_SYNC_SLAVE_ID).
+ * @param state Current slave state (SlaveStates value).
+ * @param traceId Trace of the state, 0 if untraced; kept only when the state changes.
+ * @param sentCount Pointer to store the number of messages sent, may be NULL.
+ * @return RET_OK if everything owed was sent, RET_ERROR otherwise.
+ */
+RetVal_t syncStateSlave(uint32_t slaveId, int32_t state, uint32_t traceId, uint32_t *sentCount);
+
+/**
+ * @brief Waits for master state changes and takes the ones already received.
+ *
+ * Blocks up to ticksToWait for the first change, then takes the changes
+ * already received without blocking, up to capacity. Only master state
+ * changes the slave does not have are returned, so with no change on the
+ * master the call returns after ticksToWait with nothing.
+ *
+ * @param messages Array to store the master state changes.
+ * @param capacity Size of the array.
+ * @param receivedCount Pointer to store the number of changes taken, 0 if there are none.
+ * @param ticksToWait Maximum time to wait for the first change (0 to only take the received ones).
+ * @return RET_OK on success, RET_ERROR if the channel is not initialized.
+ */
+RetVal_t reciveStateSyncSlave(CommMessage *messages, uint32_t capacity, uint32_t *receivedCount,
+                              TickType_t ticksToWait);
+
+/**
+ * @brief Forget the master state changes received so far and ask for all of them again.
+ *
+ * Called by a task that starts over without the master state, such as the
+ * slave master state task when it starts; the next syncStateSlave() sends the request.
+ */
+void resyncStateSlave(void);
+
+/**
+ * @brief Remove a task about to be deleted from the channels.
+ *
+ * A task blocked on a ring channel is registered in it; this unregisters the
+ * task, so the master side never notifies it after it is deleted. Call it and
+ * vTaskDelete() with the scheduler suspended (see commRingForget()). Does
+ * nothing for queue channels and transports.
+ *
+ * @param task Task about to be deleted.
+ */
+void releaseTaskSlave(TaskHandle_t task);
+
+/**
+ * @brief Set the send pacing policy.
+ *
+ * Defaults to DELAY_SEND_MS.
+ *
+ * @param delayMs Delay after each send call (in ms), 0 to disable pacing.
+ */
+void setSendPacingSlave(uint32_t delayMs);
+
+/**
+ * @brief Set the overflow policy of the slave-to-master channel.
+ *
+ * Applies when a FIFO channel is full; a mailbox channel is always overwritten.
+ * Every init function restores COMM_OVERFLOW_BLOCK with a TICK_TO_WAIT_SEND_MS
+ * deadline. With COMM_OVERFLOW_COALESCE the held back message is sent by the
+ * next send or sync call, before the new message. COMM_OVERFLOW_DROP_OLDEST is
+ * refused on a ring channel, a transport and a queue marked with
+ * setSendQueueInSetSlave(): taking the oldest message out of a set member
+ * would leave the set out of step with the channel.
+ *
+ * @param policy Policy applied when the channel is full.
+ * @param deadlineMs Maximum wait of COMM_OVERFLOW_BLOCK (in ms), unused by the others.
+ * @return RET_OK if the policy was set, RET_ERROR otherwise.
+ */
+RetVal_t setOverflowPolicySlave(CommOverflowPolicy policy, uint32_t deadlineMs);
+
+/**
+ * @brief Mark the slave-to-master queue as a member of a queue set.
+ *
+ * Must be called after initSlaveComm() when the master waits on the queue
+ * through a fan-in queue set (initMasterCommFanIn()). Only the task that
+ * selected a set member may receive from it, so COMM_OVERFLOW_DROP_OLDEST is
+ * refused from then on. Every init function clears the mark.
+ *
+ * @return RET_OK if marked, RET_ERROR if the channel is not a queue or uses COMM_OVERFLOW_DROP_OLDEST.
+ */
+RetVal_t setSendQueueInSetSlave(void);
+
+/**
+ * @brief Return how often each overflow policy fired since start-up.
+ *
+ * @param stats Pointer to store the counters.
+ */
+void getOverflowStatsSlave(CommOverflowStats *stats);
+
+/**
+ * @brief Initialize the slave-to-master block channel.
+ *
+ * The channel carries CommBlock pointers from the message block pool
+ * (comm_pool.h), so large payloads reach the master without being copied.
+ *
+ * @param blockQueueHandler Queue handle of the channel, with items of sizeof(CommBlock *).
+ * @return RET_OK if initialization was successful, RET_ERROR otherwise.
+ */
+RetVal_t initBlockChannelSlave(QueueHandle_t blockQueueHandler);
+
+/**
+ * @brief Send a message block to the master.
+ *
+ * Queues the block pointer without waiting. On success the caller's reference
+ * passes to the master; on failure (channel full) the caller keeps it.
+ *
+ * @param block Filled block from the pool.
+ * @return RET_OK if the block was queued, RET_ERROR otherwise.
+ */
+RetVal_t sendBlockSlave(CommBlock *block);
+
+/**
+ * @brief Connect the slave to the payload pipeline of the TCP server.
+ *
+ * The pipeline (comm_pipeline.h) carries the full client payloads from the
+ * TCP server to the slave and, when it runs in the same process, the master.
+ *
+ * @param pipeline Initialized pipeline with a COMM_PAYLOAD_CONSUMER_SLAVE consumer.
+ * @return RET_OK if initialization was successful, RET_ERROR otherwise.
+ */
+RetVal_t initPayloadPipelineSlave(CommPipeline *pipeline);
+
+/**
+ * @brief Publish a client payload to every pipeline consumer.
+ *
+ * Consumers whose buffer stays full for COMM_PIPELINE_PUBLISH_WAIT_MS lose
+ * the payload; the others still get it.
+ *
+ * @param payload Payload to copy.
+ * @param length Payload length, 1 to COMM_PIPELINE_MAX_PAYLOAD bytes.
+ * @return RET_OK if every consumer got the payload, RET_ERROR otherwise.
+ */
+RetVal_t sendPayloadSlave(const void *payload, uint32_t length);
+
+/**
+ * @brief Receive the next client payload for the slave.
+ *
+ * Blocks until a payload is available and copies it, with its original
+ * length, into the caller's buffer.
+ *
+ * @param payload Buffer to store the payload.
+ * @param capacity Size of payload, at least COMM_PIPELINE_MAX_PAYLOAD bytes.
+ * @param length Pointer to store the payload length.
+ * @return RET_OK if a payload was received, RET_ERROR otherwise.
+ */
+RetVal_t recivePayloadSlave(void *payload, uint32_t capacity, uint32_t *length);
 
 /**
- * @brief Receive a message from the specified communication channel.
+ * @brief Returns the number of master messages that were never received.
  *
- * Receives data from the specified communication channel. The function blocks
- * until data is available or a timeout occurs.
+ * Computed from the gaps in the sequence numbers. With mailbox channels
+ * these are the stale states skipped by the reader.
  *
- * @param channeId Identifier of the communication channel.
- * @param data Pointer to store the received data.
- * @return RET_OK if a message was successfully received, RET_ERROR otherwise.
+ * @return Total number of skipped messages since start-up.
  */
-RetVal_t reciveMsgSlave(void *data);
+uint32_t getSkippedMsgSlave(void);
 
 #ifdef __cplusplus
 }
@@ -15,7 +15,7 @@ extern "C" {
  *
  * This file contains declarations for task handler functions and structures
  * used to manage various tasks in the slave system, including status observation,
- * task restarting, and TCP communication.
+ * task restarting, TCP communication and client payload handling.
  */
 
 /**
@@ -39,13 +39,23 @@ void setTaskHandlers(TaskHandle_t *taskHandlers);
 /**
  * @brief Status observation handler task function.
  *
- * Monitors and logs the status of the slave system. It listens for status
- * updates and ensures appropriate state transitions when necessary.
+ * Reports the status of the slave system to the master. It wakes on every
+ * slave state change, with a periodic heartbeat as a fallback.
  *
  * @param args Pointer to task arguments (can be used to pass parameters).
  */
 void vSlaveStatusHandler(void *args);
 
+/**
+ * @brief Master state observation handler task function.
+ *
+ * Listens for the master state changes and ensures appropriate state
+ * transitions of the slave when necessary.
+ *
+ * @param args Pointer to task arguments (can be used to pass parameters).
+ */
+void vSlaveMasterStateHandler(void *args);
+
 /**
  * @brief Restart handler task function.
  *
@@ -66,6 +76,16 @@ void vRestartHandler(void *args);
  */
 void vTCPCommHandler(void *args);
 
+/**
+ * @brief Client payload handler task function.
+ *
+ * Receives the TCP client payloads from the payload pipeline, parses them and
+ * passes the received data to the slave state machine.
+ *
+ * @param args Pointer to task arguments (can be used to pass parameters).
+ */
+void vSlavePayloadHandler(void *args);
+
 #ifdef __cplusplus
 }
 #endif
@@ -53,6 +53,40 @@ RetVal_t handelStatus(SlaveInputStates state);
  */
 RetVal_t getState(SlaveStates* currentStatus);
 
+/**
+ * @brief Takes the trace of the client input that caused the current state.
+ *
+ * Returns the trace once and then 0 until the next state change, so only the
+ * first report of a state to the master carries it.
+ *
+ * @return Trace id, or 0 if there is none to report.
+ */
+uint32_t takeStateTraceId(void);
+
+/**
+ * @brief Records the master state last received by the slave.
+ *
+ * While the master reports ERROR, a slave in FAULT is reset: right away if
+ * it is already in FAULT, or as soon as it enters FAULT, without waiting for
+ * the next master state. Each fault is reset once.
+ *
+ * @param state Master state last received.
+ * @return RET_OK if no reset was needed or the reset was handled, RET_ERROR otherwise.
+ */
+RetVal_t setMasterStateSlave(MasterStates state);
+
+/**
+ * @brief Waits until the slave state changes.
+ *
+ * Returns as soon as the state changed since the previous call, so the task
+ * that reports the state to the master wakes on the change instead of
+ * polling. The change is consumed by the call, so one task waits on it.
+ *
+ * @param ticksToWait Maximum time to wait, the period of the caller's heartbeat.
+ * @return RET_OK if the state changed, RET_ERROR if the wait timed out.
+ */
+RetVal_t waitStateChangeSlave(TickType_t ticksToWait);
+
 #ifdef __cplusplus
 }
 #endif
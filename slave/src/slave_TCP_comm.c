@@ -5,9 +5,11 @@
 #include <stdio.h>
 #include <errno.h>
 #include "logger.h"
+#include "logger_trace.h"
 #include "FreeRTOS.h"
 #include "task.h"
-#include "slave_state_machine.h"
+#include "slave_comm.h"
+#include "comm_cfg.h"
 #include "slave_TCP_comm_cfg.h"
 #include "thread_handler_cfg.h"
 
@@ -21,6 +23,10 @@
  * It handles incoming client connections, processes messages, and supports state transitions.
  */
 
+#if TCP_BUFFER_SIZE > COMM_PIPELINE_MAX_PAYLOAD
+#error "TCP_BUFFER_SIZE must not exceed COMM_PIPELINE_MAX_PAYLOAD"
+#endif
+
 #define MAX_RETRIES 5
 #define RETRY_DELAY_MS 2000
 #define VERIFICATION_FLAG "CONNECTED\n"
@@ -51,7 +57,7 @@ static RetVal_t createSocket(int32_t* server_fd, int16_t port){
         if (*server_fd >= 0) {
             return RET_OK;
         }
-        logMessageFormatted(LOG_LEVEL_ERROR, "TCPComm", "Socket creation failed: %s (Attempt %d/%d)",
+        LOG_FMT(LOG_LEVEL_ERROR, "TCPComm", "Socket creation failed: %s (Attempt %d/%d)",
                             strerror(errno), i + 1, MAX_RETRIES);
         vTaskDelay(pdMS_TO_TICKS(RETRY_DELAY_MS));
     }
@@ -72,14 +78,14 @@ static RetVal_t reuseTheAddress(int32_t server_fd, int32_t* opt, int16_t port){
     // Set socket options to reuse the address
     if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, opt, sizeof(*opt)) < 0) {
         perror("setsockopt failed");
-        logMessageFormatted(LOG_LEVEL_ERROR, "TCPComm", "Setsockopt failed for port %d, with error: %s", 
+        LOG_FMT(LOG_LEVEL_ERROR, "TCPComm", "Setsockopt failed for port %d, with error: %s", 
                             port, strerror(errno));
         close(server_fd);
         return RET_ERROR;
     }
 
     if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEPORT, opt, sizeof(*opt)) < 0) {
-        logMessageFormatted(LOG_LEVEL_ERROR, "TCPComm", "Setsockopt SO_REUSEPORT failed for port %d, with error: %s", 
+        LOG_FMT(LOG_LEVEL_ERROR, "TCPComm", "Setsockopt SO_REUSEPORT failed for port %d, with error: %s", 
                             port, strerror(errno));
         close(server_fd);
         return RET_ERROR;
@@ -121,7 +127,7 @@ static RetVal_t bindSocket(int32_t server_fd, struct sockaddr* server_addr, int3
         if (bind(server_fd, server_addr, size) == 0) {
             return RET_OK;
         }
-        logMessageFormatted(LOG_LEVEL_ERROR, "TCPComm", "Bind failed: %s (Attempt %d/%d)", strerror(errno), i + 1, MAX_RETRIES);
+        LOG_FMT(LOG_LEVEL_ERROR, "TCPComm", "Bind failed: %s (Attempt %d/%d)", strerror(errno), i + 1, MAX_RETRIES);
         vTaskDelay(pdMS_TO_TICKS(RETRY_DELAY_MS));
     }
     return RET_ERROR;
@@ -141,7 +147,7 @@ static RetVal_t startListening(int32_t server_fd, int16_t port){
         if (listen(server_fd, CONNECTION_REQUESTS) == 0) {
             return RET_OK;
         }
-        logMessageFormatted(LOG_LEVEL_ERROR, "TCPComm", "Listen failed: %s (Attempt %d/%d)", strerror(errno), i + 1, MAX_RETRIES);
+        LOG_FMT(LOG_LEVEL_ERROR, "TCPComm", "Listen failed: %s (Attempt %d/%d)", strerror(errno), i + 1, MAX_RETRIES);
         vTaskDelay(pdMS_TO_TICKS(RETRY_DELAY_MS));
     }
     return RET_ERROR;
@@ -161,82 +167,62 @@ static RetVal_t startListening(int32_t server_fd, int16_t port){
 static RetVal_t acceptClientConnection(int32_t* client_fd, int32_t server_fd, struct sockaddr_in* client_addr, socklen_t* client_len) {
     *client_fd = accept(server_fd, (struct sockaddr*)client_addr, client_len);
     if (*client_fd < 0) {
-        // logMessageFormatted(LOG_LEVEL_ERROR, "TCPComm", "Accept failed with error: %s", strerror(errno));
+        // LOG_FMT(LOG_LEVEL_ERROR, "TCPComm", "Accept failed with error: %s", strerror(errno));
         return RET_ERROR;
     } else {
-        logMessage(LOG_LEVEL_INFO, "TCPComm", "Client connected!");
+        LOG_MSG(LOG_LEVEL_INFO, "TCPComm", "Client connected!");
 
         // Send verification flag to the client
         ssize_t sent_bytes = send(*client_fd, VERIFICATION_FLAG, strlen(VERIFICATION_FLAG), 0);
         if (sent_bytes < 0) {
-            logMessageFormatted(LOG_LEVEL_ERROR, "TCPComm", "Failed to send verification flag: %s", strerror(errno));
+            LOG_FMT(LOG_LEVEL_ERROR, "TCPComm", "Failed to send verification flag: %s", strerror(errno));
             close(*client_fd); // Close client socket on failure
             return RET_ERROR;
         } else {
-            logMessage(LOG_LEVEL_INFO, "TCPComm", "Verification flag sent to client!");
+            LOG_MSG(LOG_LEVEL_INFO, "TCPComm", "Verification flag sent to client!");
         }
     }
     return RET_OK;
 }
 
-/**
- * @brief Process client message.
- *
- * Parses and handles messages received from the client.
- *
- * @param buffer Pointer to the message buffer.
- * @return RET_OK on success, RET_ERROR on failure.
- */
-static RetVal_t processClientMessage(const char* buffer) {
-    int32_t id = 0;
-    int32_t data = 0;
-
-    if (sscanf(buffer, "ID=%d;DATA=%d", &id, &data) == TCP_MESSAGE_CLIENT_PARCED_INPUTS) {
-        logMessageFormatted(LOG_LEVEL_DEBUG, "TCPComm", "Parsed ID: %d\n", id);
-        logMessageFormatted(LOG_LEVEL_DEBUG, "TCPComm", "Parsed DATA: %d\n", data);
-    } else {
-        logMessageFormatted(LOG_LEVEL_DEBUG, "TCPComm", "Failed to parse buffer: %s\n", buffer);
-    }
-     
-    if(handelStatus(data) != RET_OK){
-        return RET_ERROR;
-    }
-    return RET_OK;
-}
-
 /**
  * @brief Handle communication with a connected client.
  *
- * Manages data exchange with the client.
+ * Manages data exchange with the client. Each message starts a trace and is
+ * echoed back. It is then published on the payload pipeline behind a
+ * CommPayloadHeader carrying the trace id; the slave and master payload
+ * handlers parse and process it.
  *
  * @param client_fd Client socket file descriptor.
- * @param buffer Pointer to message buffer.
+ * @param buffer Pointer to message buffer, the header is stored in its first bytes.
  */
 static void handleClientCommunication(int32_t client_fd, char* buffer) {
+    char *data = buffer + sizeof(CommPayloadHeader);
     ssize_t bytes_received;
 
     while (1) {
         do {
-            bytes_received = recv(client_fd, buffer, TCP_BUFFER_SIZE, 0);
+            bytes_received = recv(client_fd, data, TCP_BUFFER_SIZE - sizeof(CommPayloadHeader), 0);
         } while (bytes_received < 0 && errno == EINTR);
 
         if (bytes_received > 0) {
-            buffer[bytes_received] = '\0';
-            if(processClientMessage(buffer) != RET_OK){
-                logMessage(LOG_LEVEL_ERROR, "TCPComm", "Failed to process client message");
-            }
-            send(client_fd, buffer, bytes_received, 0);
-        } else if (bytes_received == 0) {
-            logMessage(LOG_LEVEL_INFO, "TCPComm", "Client disconnected");
-            break;
+            CommPayloadHeader header = {logTraceBegin(LOG_TRACE_HOP_TCP_RECEIVED, (uint32_t)bytes_received)};
+            memcpy(buffer, &header, sizeof(header));
+            send(client_fd, data, bytes_received, 0);
+            // A consumer that lost the payload is reported by sendPayloadSlave()
+            (void)sendPayloadSlave(buffer, (uint32_t)(sizeof(header) + bytes_received));
         } else {
-            logMessageFormatted(LOG_LEVEL_ERROR, "TCPComm", "Recv failed with error: %s", strerror(errno));
+            if (bytes_received == 0) {
+                LOG_MSG(LOG_LEVEL_INFO, "TCPComm", "Client disconnected");
+            } else {
+                LOG_FMT(LOG_LEVEL_ERROR, "TCPComm", "Recv failed with error: %s", strerror(errno));
+            }
             break;
         }
         vTaskDelay(pdMS_TO_TICKS(TASTK_TIME_ECHO_SERVER_HANDLER)); 
     }
     close(client_fd);
-    logMessage(LOG_LEVEL_INFO, "TCPComm", "Connection closed");
+    LOG_MSG(LOG_LEVEL_INFO, "TCPComm", "Connection closed");
 }
 
 /**
@@ -252,7 +238,7 @@ void tcpEchoServerTask() {
     while(1){
 
         if(createSocket(&server_fd, PORT) != RET_OK){
-            logMessage(LOG_LEVEL_ERROR, "TCPComm", "Failed to create socket after retries. Restarting...");
+            LOG_MSG(LOG_LEVEL_ERROR, "TCPComm", "Failed to create socket after retries. Restarting...");
             vTaskDelay(pdMS_TO_TICKS(RETRY_DELAY_MS));
             continue;
         }
@@ -1,50 +1,190 @@
 #include <stdio.h>
+#include <string.h>
 #include "FreeRTOS.h"
 #include "logger.h"
 #include "queue.h"
 #include "slave_comm.h"
 #include "task.h"
 #include "comm_cfg.h"
+#include "comm_ring.h"
+#include "comm_transport.h"
+#include "comm_pipeline.h"
+#include "comm_sync.h"
+#include "logger_cfg.h"
 
 /**
  * @file slave_comm.c
  * @brief Handles inter-task communication for the slave system using FreeRTOS queues.
  *
  * This file provides functions for sending and receiving messages between tasks
- * using state and restart communication channels.
+ * using state and restart communication channels. The slave receives on the
+ * master-to-slave channel and sends on the slave-to-master channel only.
+ *
+ * The receive functions take part in the state sync (comm_sync.h) the same
+ * way as on the master: they consume the sync requests of the master, drop
+ * the master states the slave already has, and flag a request when master
+ * states were lost. syncStateSlave() sends the flagged request and the slave
+ * state changes.
+ */
+
+/**
+ * @brief Queue handle of the master-to-slave channel.
+ *
+ * Used for receiving the master state.
+ */
+static QueueHandle_t receiveQueueHandler_ = NULL;
+
+/**
+ * @brief Queue handle of the slave-to-master channel.
+ *
+ * Used for sending the slave state.
+ */
+static QueueHandle_t sendQueueHandler_ = NULL;
+
+/**
+ * @brief Ring of the slave-to-master channel, or NULL if the channel is a queue.
+ */
+static CommRing *sendRing_ = NULL;
+
+/**
+ * @brief Ring of the master-to-slave channel, or NULL if the channel is a queue.
+ */
+static CommRing *receiveRing_ = NULL;
+
+/**
+ * @brief Transport end of the link to the master, or NULL if the channels are local.
+ */
+static CommTransport *transport_ = NULL;
+
+/**
+ * @brief Queue handle of the slave-to-master block channel.
+ *
+ * Used for forwarding message blocks by pointer.
+ */
+static QueueHandle_t blockQueueHandler_ = NULL;
+
+/**
+ * @brief Pipeline carrying the TCP payloads; the slave publishes and reads as COMM_PAYLOAD_CONSUMER_SLAVE.
+ */
+static CommPipeline *payloadPipeline_ = NULL;
+
+/**
+ * @brief Sequence number (version) of the next message sent.
+ */
+static uint16_t sendSequence_ = 0;
+
+/**
+ * @brief Sequence number expected for the next message received.
+ */
+static uint16_t receiveSequence_ = 0;
+
+/**
+ * @brief Number of messages of the peer that were never received.
+ */
+static uint32_t skippedMessages_ = 0;
+
+/**
+ * @brief Set if the slave-to-master channel is a latest-value mailbox.
+ */
+static uint8_t sendMailbox_ = 0;
+
+/**
+ * @brief Set if the slave-to-master queue is a member of a queue set.
+ */
+static uint8_t sendQueueInSet_ = 0;
+
+/**
+ * @brief Pacing delay after each send call (in ms), 0 if pacing is off.
+ */
+static uint32_t sendPacingMs_ = DELAY_SEND_MS;
+
+/**
+ * @brief Overflow policy of the slave-to-master channel.
+ */
+static CommOverflowPolicy overflowPolicy_ = COMM_OVERFLOW_BLOCK;
+
+/**
+ * @brief Deadline of the blocking policy (in ticks).
  */
+static TickType_t overflowDeadline_ = pdMS_TO_TICKS(TICK_TO_WAIT_SEND_MS);
 
 /**
- * @brief Queue handle for managing state messages.
- 
- * Used for inter-task communication within the slave system.
+ * @brief Message held back by the coalescing policy, valid if pendingValid_ is set.
  */
-static QueueHandle_t stateQueueHandler_ = NULL;
+static CommMessage pending_;
+
+/**
+ * @brief Set while pending_ holds a message.
+ */
+static uint8_t pendingValid_ = 0;
+
+/**
+ * @brief Number of times each overflow policy fired.
+ */
+static CommOverflowStats overflowStats_ = {0, 0, 0};
+
+/**
+ * @brief Sync holder of the slave state.
+ */
+static CommSyncHolder stateHolder_;
+
+/**
+ * @brief Version of the master's holder the slave has every change of.
+ */
+static uint32_t syncVersion_ = 0;
+
+/**
+ * @brief Set while the slave owes the master a sync request.
+ */
+static uint8_t syncPending_ = 1;
+
+/**
+ * @brief Version of the last sync request of the master, valid once syncRequested_ is set.
+ */
+static uint32_t syncRequestVersion_ = 0;
+
+/**
+ * @brief Set when the master asked for the slave state changes since the last syncStateSlave().
+ */
+static uint8_t syncRequested_ = 0;
 
 /**
  * @brief Internal function to send data to a specified queue.
  *
  * Sends data to the designated queue based on the provided channel identifier.
- * Logs an error if the queue is not initialized.
+ * A mailbox channel is overwritten without waiting, and a ring channel is used
+ * instead of the queue when one is set. Logs an error if the queue is not
+ * initialized.
  *
  * @param channeId Channel identifier (STATE_CHANNEL or REST_CHANNEL).
  * @param data Pointer to the data to send.
- * @param ticks_to_wait Maximum time to wait for space in the queue.
+ * @param ticks_to_wait Maximum time to wait for space in the queue (unused for a mailbox).
  * @return pdPASS if the data was successfully sent, pdFAIL otherwise.
  */
 static BaseType_t queueSend(const void *data, TickType_t ticks_to_wait) {
-    if (stateQueueHandler_ == NULL) {
-        logMessage(LOG_LEVEL_ERROR, "SlaveComm", "Queue handle is not initialized in queueSend (STATE_CHANNEL)");
+    if (transport_ != NULL) {
+        return (commTransportSend(transport_, data, ticks_to_wait) == RET_OK) ? pdPASS : pdFAIL;
+    }
+    if (sendRing_ != NULL) {
+        return (commRingSend(sendRing_, data, ticks_to_wait) == RET_OK) ? pdPASS : pdFAIL;
+    }
+    if (sendQueueHandler_ == NULL) {
+        LOG_MSG(LOG_LEVEL_ERROR, "SlaveComm", "Queue handle is not initialized in queueSend (STATE_CHANNEL)");
         return pdFAIL;
     }
-    return xQueueSend(stateQueueHandler_, data, ticks_to_wait);
+    if (sendMailbox_) {
+        // A mailbox holds only the newest message; overwrite it instead of waiting for space
+        return xQueueOverwrite(sendQueueHandler_, data);
+    }
+    return xQueueSend(sendQueueHandler_, data, ticks_to_wait);
 }
 
 /**
  * @brief Internal function to receive data from a specified queue.
  *
  * Receives data from the designated queue based on the provided channel identifier.
- * Logs an error if the queue is not initialized.
+ * A ring channel is used instead of the queue when one is set. Logs an error if
+ * the queue is not initialized.
  *
  * @param channeId Channel identifier (STATE_CHANNEL or REST_CHANNEL).
  * @param data Pointer to store the received data.
@@ -52,29 +192,252 @@ static BaseType_t queueSend(const void *data, TickType_t ticks_to_wait) {
  * @return pdPASS if data was successfully received, pdFAIL otherwise.
  */
 static BaseType_t queueReceive(void *data, TickType_t ticks_to_wait) {
-    if (stateQueueHandler_ == NULL) {
-        logMessage(LOG_LEVEL_ERROR, "SlaveComm", "Queue handle is not initialized in queueReceive (STATE_CHANNEL)");
+    if (transport_ != NULL) {
+        return (commTransportReceive(transport_, data, ticks_to_wait) == RET_OK) ? pdPASS : pdFAIL;
+    }
+    if (receiveRing_ != NULL) {
+        return (commRingReceive(receiveRing_, data, ticks_to_wait) == RET_OK) ? pdPASS : pdFAIL;
+    }
+    if (receiveQueueHandler_ == NULL) {
+        LOG_MSG(LOG_LEVEL_ERROR, "SlaveComm", "Queue handle is not initialized in queueReceive (STATE_CHANNEL)");
         return pdFAIL;
     }
-    return xQueueReceive(stateQueueHandler_, data, ticks_to_wait);
+    return xQueueReceive(receiveQueueHandler_, data, ticks_to_wait);
 }
 
 /**
- * @brief Initializes the communication queue for the slave system.
+ * @brief Sends the message held back by the coalescing policy, if the channel has room.
+ */
+static void flushPending(void) {
+    if (pendingValid_ && queueSend(&pending_, 0) == pdPASS) {
+        pendingValid_ = 0;
+    }
+}
+
+/**
+ * @brief Sends a stamped envelope according to the overflow policy of the channel.
+ *
+ * A mailbox is overwritten whatever the policy. A message held back by the
+ * coalescing policy is sent first, so it is never overtaken by a newer one.
+ *
+ * @param envelope Envelope to send.
+ * @return pdPASS if the envelope was sent or held back, pdFAIL otherwise.
+ */
+static BaseType_t channelSend(const CommMessage *envelope) {
+    CommMessage oldest;
+
+    if (sendMailbox_) {
+        return queueSend(envelope, 0);
+    }
+    flushPending();
+
+    switch (overflowPolicy_) {
+    case COMM_OVERFLOW_COALESCE:
+        if (!pendingValid_ && queueSend(envelope, 0) == pdPASS) {
+            return pdPASS;
+        }
+        pending_ = *envelope;
+        pendingValid_ = 1;
+        overflowStats_.coalesced++;
+        return pdPASS;
+    case COMM_OVERFLOW_DROP_OLDEST:
+        if (queueSend(envelope, 0) == pdPASS) {
+            return pdPASS;
+        }
+        if (xQueueReceive(sendQueueHandler_, &oldest, 0) == pdPASS) {
+            overflowStats_.droppedOldest++;
+        }
+        return queueSend(envelope, 0);
+    default:
+        if (queueSend(envelope, overflowDeadline_) == pdPASS) {
+            return pdPASS;
+        }
+        overflowStats_.deadlineExpired++;
+        return pdFAIL;
+    }
+}
+
+/**
+ * @brief Stamps a copy of the envelope and sends it on the slave-to-master channel.
  *
- * Sets up the queue for managing state messages between tasks.
+ * @param message Message to send (type and payload set by the caller).
+ * @return pdPASS if the message was successfully sent, pdFAIL otherwise.
+ */
+static BaseType_t sendEnvelope(const CommMessage *message) {
+    CommMessage envelope = *message;
+    envelope.sourceId = COMM_SOURCE_SLAVE;
+    envelope.sequence = sendSequence_;
+
+    if (channelSend(&envelope) != pdPASS) {
+        return pdFAIL;
+    }
+    sendSequence_++;
+    return pdPASS;
+}
+
+/**
+ * @brief Applies a received master state to the sync version.
  *
- * @param stateQueueHandler Handle to the state queue.
+ * @param message Master state taken from the master-to-slave channel.
+ * @return RET_OK if the state is a change the slave does not have, RET_ERROR otherwise.
+ */
+static RetVal_t syncAccept(const CommMessage *message) {
+    uint32_t version = syncVersion_;
+    CommSyncResult result = commSyncAccept(&version, message);
+
+    __atomic_store_n(&syncVersion_, version, __ATOMIC_RELAXED);
+    if (result == COMM_SYNC_GAP) {
+        // Ask again from the version the slave has with the next syncStateSlave()
+        __atomic_store_n(&syncPending_, 1, __ATOMIC_RELEASE);
+        LOG_MSG_LIMITED(LOG_LEVEL_WARN, "SlaveComm", LOG_RATE_LIMIT_HOT_PATH, "Master state changes lost, resyncing");
+    }
+    return (result == COMM_SYNC_APPLY) ? RET_OK : RET_ERROR;
+}
+
+/**
+ * @brief Checks a received message and accounts for skipped sequence numbers.
+ *
+ * Sync requests are recorded for syncStateSlave() and master states are
+ * checked against the sync version; neither is passed on when it is consumed.
+ *
+ * @param message Message taken from the master-to-slave channel.
+ * @return RET_OK if the message was sent by the master and is for the caller, RET_ERROR otherwise.
+ */
+static RetVal_t acceptMessage(const CommMessage *message) {
+    if (message->sourceId != COMM_SOURCE_MASTER || message->type >= COMM_MSG_MAX) {
+        LOG_MSG(LOG_LEVEL_ERROR, "SlaveComm", "Rejected a message not sent by the master");
+        return RET_ERROR;
+    }
+    skippedMessages_ += (uint16_t)(message->sequence - receiveSequence_);
+    receiveSequence_ = (uint16_t)(message->sequence + 1);
+
+    if (message->type == COMM_MSG_SYNC_REQUEST) {
+        __atomic_store_n(&syncRequestVersion_, message->version, __ATOMIC_RELAXED);
+        __atomic_store_n(&syncRequested_, 1, __ATOMIC_RELEASE);
+        return RET_ERROR;
+    }
+    if (message->type == COMM_MSG_MASTER_STATE) {
+        return syncAccept(message);
+    }
+    return RET_OK;
+}
+
+/**
+ * @brief Applies the send pacing policy.
+ */
+static void pace(void) {
+    if (sendPacingMs_ != 0) {
+        vTaskDelay(pdMS_TO_TICKS(sendPacingMs_));
+    }
+}
+
+/**
+ * @brief Restores the default overflow policy and drops any held back message.
+ */
+static void resetOverflow(void) {
+    overflowPolicy_ = COMM_OVERFLOW_BLOCK;
+    overflowDeadline_ = pdMS_TO_TICKS(TICK_TO_WAIT_SEND_MS);
+    pendingValid_ = 0;
+}
+
+/**
+ * @brief Starts the state sync over with no state known on either side.
+ *
+ * The slave owes the master a request for all of its states.
+ */
+static void resetSync(void) {
+    commSyncInit(&stateHolder_);
+    syncVersion_ = 0;
+    syncPending_ = 1;
+    syncRequested_ = 0;
+}
+
+/**
+ * @brief Initializes the communication queues for the slave system.
+ *
+ * Sets up the two directional channels for managing state messages between tasks.
+ * A slave-to-master channel of length 1 is used as a latest-value mailbox.
+ *
+ * @param sendQueueHandler Handle to the slave-to-master queue.
+ * @param receiveQueueHandler Handle to the master-to-slave queue.
+ * @return RET_OK if initialization succeeded, RET_ERROR otherwise.
+ */
+RetVal_t initSlaveComm(QueueHandle_t sendQueueHandler, QueueHandle_t receiveQueueHandler) {
+    if (sendQueueHandler == NULL || receiveQueueHandler == NULL) {
+        LOG_MSG(LOG_LEVEL_ERROR, "SlaveComm", "Failed to initialize state queue handler");
+        return RET_ERROR;
+    }
+
+    sendQueueHandler_ = sendQueueHandler;
+    receiveQueueHandler_ = receiveQueueHandler;
+    sendRing_ = NULL;
+    receiveRing_ = NULL;
+    transport_ = NULL;
+    // The channel is empty here, so its free space is its length; xQueueOverwrite() needs a length of 1
+    sendMailbox_ = (uxQueueSpacesAvailable(sendQueueHandler) == 1);
+    sendQueueInSet_ = 0;
+    resetOverflow();
+    resetSync();
+
+    return RET_OK;
+}
+
+/**
+ * @brief Initializes the slave communication with ring channels.
+ *
+ * Uses two lock-free rings instead of FreeRTOS queues. The slave status task
+ * must be the only producer of the send ring and the slave master state task
+ * the only consumer of the receive ring. A restarted task must be released
+ * with releaseTaskSlave() before it is deleted.
+ *
+ * @param sendRing Ring of the slave-to-master channel, initialized with commRingInit().
+ * @param receiveRing Ring of the master-to-slave channel, initialized with commRingInit().
  * @return RET_OK if initialization succeeded, RET_ERROR otherwise.
  */
-RetVal_t initSlaveComm(QueueHandle_t stateQueueHandler) {
-    if (stateQueueHandler == NULL) {
-        logMessage(LOG_LEVEL_ERROR, "SlaveComm", "Failed to initialize state queue handler");
+RetVal_t initSlaveCommRing(CommRing *sendRing, CommRing *receiveRing) {
+    if (sendRing == NULL || receiveRing == NULL) {
+        LOG_MSG(LOG_LEVEL_ERROR, "SlaveComm", "Failed to initialize state rings");
         return RET_ERROR;
     }
 
-     stateQueueHandler_ = stateQueueHandler;
+    sendRing_ = sendRing;
+    receiveRing_ = receiveRing;
+    transport_ = NULL;
+    sendQueueHandler_ = NULL;
+    receiveQueueHandler_ = NULL;
+    sendMailbox_ = 0;
+    sendQueueInSet_ = 0;
+    resetOverflow();
+    resetSync();
+
+    return RET_OK;
+}
+
+/**
+ * @brief Initializes the slave communication module with a transport.
+ *
+ * Sends and receives through one end of a master-slave link (comm_transport.h)
+ * instead of local channels, so the master may run in another process. The
+ * transport is FIFO and never a mailbox.
+ *
+ * @param transport Slave end of the link, opened with a commTransportOpen function.
+ * @return RET_OK if successful, RET_ERROR otherwise.
+ */
+RetVal_t initSlaveCommTransport(CommTransport *transport) {
+    if (transport == NULL) {
+        LOG_MSG(LOG_LEVEL_ERROR, "SlaveComm", "Transport is NULL");
+        return RET_ERROR;
+    }
 
+    transport_ = transport;
+    sendQueueHandler_ = NULL;
+    receiveQueueHandler_ = NULL;
+    sendRing_ = NULL;
+    receiveRing_ = NULL;
+    sendMailbox_ = 0;
+    sendQueueInSet_ = 0;
+    resetOverflow();
+    resetSync();
     return RET_OK;
 }
 
@@ -82,19 +445,48 @@ RetVal_t initSlaveComm(QueueHandle_t stateQueueHandler) {
  * @brief Sends a message to the specified slave communication queue.
  *
  * Wraps the internal queueSend function and ensures the message is successfully sent.
- * Logs appropriate errors on failure.
+ * The source id and the sequence number are stamped into a copy of the envelope,
+ * and the pacing policy is applied after sending. Logs appropriate errors on failure.
  *
- * @param channeId Channel identifier (STATE_CHANNEL or REST_CHANNEL).
- * @param data Pointer to the data to send.
+ * @param message Message to send (type and payload set by the caller).
  * @return RET_OK if the message was successfully sent, RET_ERROR otherwise.
  */
-RetVal_t sendMsgSlave(const void *data) {
-    if (queueSend(data, pdMS_TO_TICKS(TICK_TO_WAIT_SEND_MS)) != pdPASS) {
-        logMessage(LOG_LEVEL_ERROR, "SlaveComm", "Failed to send message to the queue");
+RetVal_t sendMsgSlave(const CommMessage *message) {
+    if (sendEnvelope(message) != pdPASS) {
+        LOG_MSG(LOG_LEVEL_ERROR, "SlaveComm", "Failed to send message to the queue");
+        return RET_ERROR;
+    } else {
+        LOG_MSG_LIMITED(LOG_LEVEL_DEBUG, "SlaveComm", LOG_RATE_LIMIT_HOT_PATH, "Message sent successfully");
+        pace();
+        return RET_OK;
+    }
+}
+
+/**
+ * @brief Sends several messages to the slave communication queue in one call.
+ *
+ * The messages are stamped and sent back to back; the pacing policy is applied
+ * once, after the whole batch. Stops at the first message that cannot be sent.
+ *
+ * @param messages Messages to send (type and payload set by the caller).
+ * @param count Number of messages.
+ * @param sentCount Pointer to store the number of messages sent, may be NULL.
+ * @return RET_OK if all messages were sent, RET_ERROR otherwise.
+ */
+RetVal_t sendMsgBatchSlave(const CommMessage *messages, uint32_t count, uint32_t *sentCount) {
+    uint32_t sent = 0;
+    while (sent < count && sendEnvelope(&messages[sent]) == pdPASS) {
+        sent++;
+    }
+    if (sentCount != NULL) {
+        *sentCount = sent;
+    }
+    if (sent != count) {
+        LOG_MSG(LOG_LEVEL_ERROR, "SlaveComm", "Failed to send a message batch to the queue");
         return RET_ERROR;
     } else {
-        logMessage(LOG_LEVEL_DEBUG, "SlaveComm", "Message sent successfully");
-        vTaskDelay(pdMS_TO_TICKS(DELAY_SEND_MS));
+        LOG_MSG_LIMITED(LOG_LEVEL_DEBUG, "SlaveComm", LOG_RATE_LIMIT_HOT_PATH, "Message batch sent successfully");
+        pace();
         return RET_OK;
     }
 }
@@ -103,18 +495,348 @@ RetVal_t sendMsgSlave(const void *data) {
  * @brief Receives a message from the specified slave communication queue.
  *
  * Wraps the internal queueReceive function and ensures the message is successfully received.
- * Logs appropriate errors on failure.
+ * Messages that were not sent by the master are rejected. Logs appropriate errors on failure.
  *
- * @param channeId Channel identifier (STATE_CHANNEL or REST_CHANNEL).
- * @param data Pointer to store the received data.
- * @return RET_OK if a message was successfully received, RET_ERROR otherwise.
+ * @param message Pointer to store the received message.
+ * @return RET_OK if a message from the master was received, RET_ERROR otherwise.
  */
-RetVal_t reciveMsgSlave(void *data) {
-    if (queueReceive(data, portMAX_DELAY) == pdPASS) {
-        logMessage(LOG_LEVEL_DEBUG, "SlaveComm", "Message received successfully");
+RetVal_t reciveMsgSlave(CommMessage *message) {
+    if (queueReceive(message, portMAX_DELAY) == pdPASS) {
+        if (acceptMessage(message) != RET_OK) {
+            return RET_ERROR;
+        }
+        LOG_MSG_LIMITED(LOG_LEVEL_DEBUG, "SlaveComm", LOG_RATE_LIMIT_HOT_PATH, "Message received successfully");
         return RET_OK;
     } else {
-        logMessage(LOG_LEVEL_ERROR, "SlaveComm", "Failed to receive message from the queue");
+        LOG_MSG(LOG_LEVEL_ERROR, "SlaveComm", "Failed to receive message from the queue");
+        return RET_ERROR;
+    }
+}
+
+/**
+ * @brief Receives several messages from the slave communication queue in one call.
+ *
+ * Waits for the first message, then drains the messages already queued without
+ * blocking, up to capacity. Messages that were not sent by the master are dropped.
+ * Messages consumed by the state sync are dropped too, without ending the wait.
+ *
+ * @param messages Array to store the received messages.
+ * @param capacity Size of the array.
+ * @param receivedCount Pointer to store the number of messages received.
+ * @return RET_OK if at least one message from the master was received, RET_ERROR otherwise.
+ */
+RetVal_t reciveMsgBatchSlave(CommMessage *messages, uint32_t capacity, uint32_t *receivedCount) {
+    uint32_t received = 0;
+    TickType_t ticksToWait = portMAX_DELAY;
+
+    while (received < capacity && queueReceive(&messages[received], ticksToWait) == pdPASS) {
+        // A master message that is not returned was consumed by the sync
+        uint8_t sync = (messages[received].sourceId == COMM_SOURCE_MASTER);
+        if (acceptMessage(&messages[received]) == RET_OK) {
+            received++;
+        }
+        if (received != 0 || !sync) {
+            ticksToWait = 0;
+        }
+    }
+    *receivedCount = received;
+    if (received == 0) {
+        LOG_MSG(LOG_LEVEL_ERROR, "SlaveComm", "Failed to receive a message batch from the queue");
+        return RET_ERROR;
+    } else {
+        LOG_MSG_LIMITED(LOG_LEVEL_DEBUG, "SlaveComm", LOG_RATE_LIMIT_HOT_PATH, "Message batch received successfully");
+        return RET_OK;
+    }
+}
+
+/**
+ * @brief Sends the slave state changes and the sync request the slave owes.
+ *
+ * The request goes first, then the changes after the version the master has,
+ * back to back as one batch with the pacing applied once. A request that
+ * could not be sent stays owed; changes that could not be sent are sent by
+ * the next call. Over a mailbox channel, which keeps only the newest message,
+ * no request is sent and every call sends the slave state as a snapshot.
+ *
+ * @param slaveId Slave the state belongs to.
+ * @param state Current slave state (SlaveStates value).
+ * @param traceId Trace of the state, 0 if untraced.
+ * @param sentCount Pointer to store the number of messages sent, may be NULL.
+ * @return RET_OK if everything owed was sent, RET_ERROR otherwise.
+ */
+RetVal_t syncStateSlave(uint32_t slaveId, int32_t state, uint32_t traceId, uint32_t *sentCount) {
+    static CommMessage batch[1 + COMM_SYNC_MAX_ENTRIES];
+    uint32_t requests = 0;
+    uint32_t sent = 0;
+
+    // A mailbox may overwrite a request or a change, so it carries the whole state instead
+    if (!sendMailbox_) {
+        // The sender may have no change to send for a long time; do not leave a held back change behind
+        flushPending();
+        if (__atomic_exchange_n(&syncPending_, 0, __ATOMIC_ACQUIRE)) {
+            memset(&batch[0], 0, sizeof(batch[0]));
+            batch[0].type = COMM_MSG_SYNC_REQUEST;
+            batch[0].slaveId = slaveId;
+            batch[0].version = __atomic_load_n(&syncVersion_, __ATOMIC_RELAXED);
+            requests = 1;
+        }
+        if (__atomic_exchange_n(&syncRequested_, 0, __ATOMIC_ACQUIRE)) {
+            commSyncRequest(&stateHolder_, __atomic_load_n(&syncRequestVersion_, __ATOMIC_RELAXED));
+        }
+    }
+    if (commSyncSet(&stateHolder_, slaveId, state, traceId) != RET_OK) {
+        LOG_MSG(LOG_LEVEL_ERROR, "SlaveComm", "Too many slave states to sync");
+    }
+    uint32_t count = requests;
+    if (sendMailbox_) {
+        count += commSyncCollectSnapshot(&stateHolder_, COMM_MSG_SLAVE_STATE, &batch[requests],
+                                         COMM_SYNC_MAX_ENTRIES);
+    } else {
+        count += commSyncCollect(&stateHolder_, COMM_MSG_SLAVE_STATE, &batch[requests], COMM_SYNC_MAX_ENTRIES);
+    }
+
+    while (sent < count && sendEnvelope(&batch[sent]) == pdPASS) {
+        sent++;
+    }
+    if (sent < requests) {
+        __atomic_store_n(&syncPending_, 1, __ATOMIC_RELEASE);
+    }
+    if (sent > requests) {
+        commSyncSent(&stateHolder_, &batch[requests], sent - requests);
+    }
+    if (sentCount != NULL) {
+        *sentCount = sent;
+    }
+    if (sent != count) {
+        LOG_MSG(LOG_LEVEL_ERROR, "SlaveComm", "Failed to send the slave state changes");
+        return RET_ERROR;
+    }
+    if (count != 0) {
+        LOG_MSG_LIMITED(LOG_LEVEL_DEBUG, "SlaveComm", LOG_RATE_LIMIT_HOT_PATH, "State changes sent successfully");
+        pace();
+    }
+    return RET_OK;
+}
+
+/**
+ * @brief Waits for master state changes and takes the ones already received.
+ *
+ * Messages consumed by the state sync do not end the wait, which then starts
+ * over.
+ *
+ * @param messages Array to store the master state changes.
+ * @param capacity Size of the array.
+ * @param receivedCount Pointer to store the number of changes taken, 0 if there are none.
+ * @param ticksToWait Maximum time to wait for the first change.
+ * @return RET_OK on success, RET_ERROR if the channel is not initialized.
+ */
+RetVal_t reciveStateSyncSlave(CommMessage *messages, uint32_t capacity, uint32_t *receivedCount,
+                              TickType_t ticksToWait) {
+    uint32_t received = 0;
+
+    *receivedCount = 0;
+    if (transport_ == NULL && receiveRing_ == NULL && receiveQueueHandler_ == NULL) {
+        LOG_MSG(LOG_LEVEL_ERROR, "SlaveComm", "Channel is not initialized in reciveStateSyncSlave");
         return RET_ERROR;
     }
+    while (received < capacity && queueReceive(&messages[received], ticksToWait) == pdPASS) {
+        // A master message that is not returned was consumed by the sync
+        uint8_t sync = (messages[received].sourceId == COMM_SOURCE_MASTER);
+        if (acceptMessage(&messages[received]) == RET_OK) {
+            received++;
+        }
+        if (received != 0 || !sync) {
+            ticksToWait = 0;
+        }
+    }
+    *receivedCount = received;
+    return RET_OK;
+}
+
+/**
+ * @brief Forgets the master state changes received so far and asks for all of them again.
+ */
+void resyncStateSlave(void) {
+    __atomic_store_n(&syncVersion_, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&syncPending_, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Removes a task about to be deleted from the ring channels.
+ *
+ * @param task Task about to be deleted.
+ */
+void releaseTaskSlave(TaskHandle_t task) {
+    if (sendRing_ != NULL) {
+        commRingForget(sendRing_, task);
+    }
+    if (receiveRing_ != NULL) {
+        commRingForget(receiveRing_, task);
+    }
+}
+
+/**
+ * @brief Marks the slave-to-master queue as a member of a queue set.
+ *
+ * @return RET_OK if marked, RET_ERROR if the channel is not a queue or drops its oldest message.
+ */
+RetVal_t setSendQueueInSetSlave(void) {
+    if (sendQueueHandler_ == NULL || overflowPolicy_ == COMM_OVERFLOW_DROP_OLDEST) {
+        LOG_MSG(LOG_LEVEL_ERROR, "SlaveComm", "Channel cannot be a queue set member");
+        return RET_ERROR;
+    }
+    sendQueueInSet_ = 1;
+    return RET_OK;
+}
+
+/**
+ * @brief Sets the overflow policy of the slave-to-master channel.
+ *
+ * Switching the policy drops a message held back by the coalescing policy.
+ * Dropping the oldest message receives from the channel, so it needs a local
+ * queue channel that is not a queue set member: it is refused on a ring
+ * channel, a transport or a fan-in channel of the master.
+ *
+ * @param policy Policy applied when the channel is full.
+ * @param deadlineMs Maximum wait of COMM_OVERFLOW_BLOCK (in ms), unused by the others.
+ * @return RET_OK if the policy was set, RET_ERROR otherwise.
+ */
+RetVal_t setOverflowPolicySlave(CommOverflowPolicy policy, uint32_t deadlineMs) {
+    if (policy >= COMM_OVERFLOW_MAX ||
+        (policy == COMM_OVERFLOW_DROP_OLDEST && (sendQueueHandler_ == NULL || sendQueueInSet_))) {
+        LOG_MSG(LOG_LEVEL_ERROR, "SlaveComm", "Overflow policy not supported by the channel");
+        return RET_ERROR;
+    }
+    overflowPolicy_ = policy;
+    overflowDeadline_ = pdMS_TO_TICKS(deadlineMs);
+    pendingValid_ = 0;
+    return RET_OK;
+}
+
+/**
+ * @brief Copies the overflow policy counters.
+ *
+ * @param stats Pointer to store the counters.
+ */
+void getOverflowStatsSlave(CommOverflowStats *stats) {
+    *stats = overflowStats_;
+}
+
+/**
+ * @brief Sets the pacing policy of the send functions.
+ *
+ * @param delayMs Delay after each sendMsgSlave() or sendMsgBatchSlave() call
+ *                (in ms), 0 to send without pacing.
+ */
+void setSendPacingSlave(uint32_t delayMs) {
+    sendPacingMs_ = delayMs;
+}
+
+/**
+ * @brief Initializes the slave-to-master block channel.
+ *
+ * @param blockQueueHandler Handle to the block queue, with items of sizeof(CommBlock *).
+ * @return RET_OK if initialization succeeded, RET_ERROR otherwise.
+ */
+RetVal_t initBlockChannelSlave(QueueHandle_t blockQueueHandler) {
+    if (blockQueueHandler == NULL) {
+        LOG_MSG(LOG_LEVEL_ERROR, "SlaveComm", "Failed to initialize block queue handler");
+        return RET_ERROR;
+    }
+    blockQueueHandler_ = blockQueueHandler;
+    return RET_OK;
+}
+
+/**
+ * @brief Sends a message block to the master.
+ *
+ * Only the block pointer is queued. The channel is never waited on: when it is
+ * full the send fails and the caller keeps its reference.
+ *
+ * @param block Filled block; on success the caller's reference passes to the master.
+ * @return RET_OK if the block was queued, RET_ERROR otherwise.
+ */
+RetVal_t sendBlockSlave(CommBlock *block) {
+    if (blockQueueHandler_ == NULL) {
+        LOG_MSG(LOG_LEVEL_ERROR, "SlaveComm", "Block queue handle is not initialized");
+        return RET_ERROR;
+    }
+    if (xQueueSend(blockQueueHandler_, &block, 0) != pdPASS) {
+        LOG_MSG_LIMITED(LOG_LEVEL_WARN, "SlaveComm", LOG_RATE_LIMIT_HOT_PATH, "Block channel is full");
+        return RET_ERROR;
+    } else {
+        return RET_OK;
+    }
+}
+
+/**
+ * @brief Connects the slave to the payload pipeline.
+ *
+ * @param pipeline Initialized pipeline with a COMM_PAYLOAD_CONSUMER_SLAVE consumer.
+ * @return RET_OK if initialization succeeded, RET_ERROR otherwise.
+ */
+RetVal_t initPayloadPipelineSlave(CommPipeline *pipeline) {
+    if (pipeline == NULL || pipeline->consumerCount <= COMM_PAYLOAD_CONSUMER_SLAVE) {
+        LOG_MSG(LOG_LEVEL_ERROR, "SlaveComm", "Payload pipeline has no slave consumer");
+        return RET_ERROR;
+    }
+    payloadPipeline_ = pipeline;
+    return RET_OK;
+}
+
+/**
+ * @brief Publishes a payload to every pipeline consumer.
+ *
+ * Waits at most COMM_PIPELINE_PUBLISH_WAIT_MS for consumers that are full;
+ * they lose the payload, the others still get it.
+ *
+ * @param payload Payload to copy.
+ * @param length Payload length, 1 to COMM_PIPELINE_MAX_PAYLOAD bytes.
+ * @return RET_OK if every consumer got the payload, RET_ERROR otherwise.
+ */
+RetVal_t sendPayloadSlave(const void *payload, uint32_t length) {
+    if (payloadPipeline_ == NULL) {
+        LOG_MSG(LOG_LEVEL_ERROR, "SlaveComm", "Payload pipeline is not initialized");
+        return RET_ERROR;
+    }
+    if (commPipelinePublish(payloadPipeline_, payload, length, pdMS_TO_TICKS(COMM_PIPELINE_PUBLISH_WAIT_MS)) != RET_OK) {
+        LOG_MSG_LIMITED(LOG_LEVEL_WARN, "SlaveComm", LOG_RATE_LIMIT_HOT_PATH, "Payload not delivered to every consumer");
+        return RET_ERROR;
+    }
+    return RET_OK;
+}
+
+/**
+ * @brief Receives the next payload for the slave.
+ *
+ * Blocks until a payload is available and copies it into the caller's buffer.
+ *
+ * @param payload Buffer to store the payload.
+ * @param capacity Size of payload, at least COMM_PIPELINE_MAX_PAYLOAD bytes.
+ * @param length Pointer to store the payload length.
+ * @return RET_OK if a payload was received, RET_ERROR otherwise.
+ */
+RetVal_t recivePayloadSlave(void *payload, uint32_t capacity, uint32_t *length) {
+    if (payloadPipeline_ == NULL) {
+        LOG_MSG(LOG_LEVEL_ERROR, "SlaveComm", "Payload pipeline is not initialized");
+        return RET_ERROR;
+    }
+    if (commPipelineReceive(payloadPipeline_, COMM_PAYLOAD_CONSUMER_SLAVE, payload, capacity, length,
+                            portMAX_DELAY) != RET_OK) {
+        LOG_MSG(LOG_LEVEL_ERROR, "SlaveComm", "Failed to receive a payload from the pipeline");
+        return RET_ERROR;
+    }
+    return RET_OK;
+}
+
+/**
+ * @brief Returns the number of master messages that were never received.
+ *
+ * With mailbox channels these are the intermediate states overwritten by a
+ * newer one before they were read.
+ *
+ * @return Total number of skipped messages since start-up.
+ */
+uint32_t getSkippedMsgSlave(void) {
+    return skippedMessages_;
 }
@@ -1,7 +1,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <ctype.h>
+#include <string.h>
 #include "logger.h"
+#include "logger_status.h"
+#include "logger_trace.h"
 #include "slave_comm.h"
 #include "slave_handler.h"
 #include "slave_TCP_comm.h"
@@ -10,6 +13,8 @@
 #include "queue.h"
 
 #include "thread_handler_cfg.h"
+#include "slave_TCP_comm_cfg.h"
+#include "comm_cfg.h"
 
 /**
  * @file slave_handler.c
@@ -68,42 +73,84 @@ void vRestartHandler(void *args) {
 }
 
 /**
- * @brief Observes and retrieves the slave's status.
+ * @brief Observes and syncs the slave's status.
  *
- * This task listens for messages on the STATE_CHANNEL. Upon receiving a valid message,
- * it retrieves the current slave state and sends an updated status message back via the STATE_CHANNEL.
+ * This task syncs the current slave state to the master; only a changed
+ * state, or one the master asked for again, is sent. It sleeps until the
+ * slave state changes, so a change is sent right away, and wakes every
+ * TASTK_TIME_SLAVE_STATUS_OBSERVATION_HANDLING as a heartbeat that also
+ * retries what could not be sent.
  *
  * @param args Pointer to task arguments (unused in this implementation).
  */
 void vSlaveStatusHandler(void *args) {
-    MasterStates data = MASTESR_STATE_IDLE;
-    SlaveStates sendData = SLAVE_STATE_MAX;
+    SlaveStates state = SLAVE_STATE_MAX;
+    SlaveStates published = SLAVE_STATE_MAX;
 
 #ifndef UNIT_TEST
     while (1) {
 #endif
-        // Receive a message from the STATE_CHANNEL
-        if (reciveMsgSlave(&data) != RET_OK) {
-            logMessage(LOG_LEVEL_ERROR, "SlaveHandler", "Failed to receive message");
-        } else {
-            if (getState(&sendData) != RET_ERROR) {
-                // Check if state has changed
-                if (sendData != data) {
-                    if (sendMsgSlave(&sendData) != RET_OK) {
-                        logMessage(LOG_LEVEL_ERROR, "SlaveHandler", "Failed to send updated status message");
-                    }
-                } else if (data == MASTESR_STATE_ERROR) {
-                    // Handle RESET state if error occurs
-                    handelStatus(SLAVE_INPUT_STATE_ERROR_OR_RESET);
-                    if (sendMsgSlave(&sendData) != RET_OK) {
-                        logMessage(LOG_LEVEL_ERROR, "SlaveHandler", "Failed to send reset status message");
-                    }
-                }
+        if (getState(&state) != RET_ERROR) {
+            uint32_t traceId = 0;
+            if (state != published) {
+                // Only the first report of a state carries the trace that caused it
+                traceId = takeStateTraceId();
+                // Recorded before sending, as the master may receive the state before syncStateSlave() returns
+                logTraceSpan(traceId, LOG_TRACE_HOP_SLAVE_SENT, (uint32_t)state);
+                published = state;
+            }
+            if (syncStateSlave(COMM_SYNC_SLAVE_ID, (int32_t)state, traceId, NULL) != RET_OK) {
+                logMessage(LOG_LEVEL_ERROR, "SlaveHandler", "Failed to send updated status message");
             }
         }
         
-        // Delay to prevent task starvation
-        vTaskDelay(pdMS_TO_TICKS(TASTK_TIME_SLAVE_STATUS_OBSERVATION_HANDLING));
+        logStatusHeartbeat();
+
+        // Sleep until the state changes, or until the heartbeat is due
+        (void)waitStateChangeSlave(pdMS_TO_TICKS(TASTK_TIME_SLAVE_STATUS_OBSERVATION_HANDLING));
+#ifndef UNIT_TEST
+    }
+#endif
+}
+
+/**
+ * @brief Observes the master's state.
+ *
+ * This task blocks on the STATE_CHANNEL for the master state changes and
+ * hands them to the slave state machine, which resets the slave when the
+ * master is in error while the slave is in fault; a slave that faults after
+ * the master error arrived is reset when it enters the fault. The reset
+ * state then wakes vSlaveStatusHandler(). The master state is asked for
+ * again when the task starts, since it starts without it.
+ *
+ * @param args Pointer to task arguments (unused in this implementation).
+ */
+void vSlaveMasterStateHandler(void *args) {
+    CommMessage messages[COMM_RECEIVE_BATCH_SIZE];
+    uint32_t received = 0;
+    MasterStates masterState = MASTESR_STATE_IDLE;
+
+    resyncStateSlave();
+#ifndef UNIT_TEST
+    while (1) {
+#endif
+        if (reciveStateSyncSlave(messages, COMM_RECEIVE_BATCH_SIZE, &received,
+                                 pdMS_TO_TICKS(TASTK_TIME_SLAVE_MASTER_STATE_HANDLER)) != RET_OK) {
+            logMessage(LOG_LEVEL_ERROR, "SlaveHandler", "Failed to receive message");
+            received = 0;
+            vTaskDelay(pdMS_TO_TICKS(TASTK_TIME_SLAVE_MASTER_STATE_HANDLER));
+        }
+        for (uint32_t i = 0; i < received; i++) {
+            if (messages[i].type != COMM_MSG_MASTER_STATE) {
+                logMessage(LOG_LEVEL_ERROR, "SlaveHandler", "Unexpected message type");
+                continue;
+            }
+            masterState = (MasterStates)messages[i].payload;
+        }
+
+        if (received != 0 && setMasterStateSlave(masterState) != RET_OK) {
+            logMessage(LOG_LEVEL_ERROR, "SlaveHandler", "Failed to handle the master state");
+        }
 #ifndef UNIT_TEST
     }
 #endif
@@ -121,3 +168,52 @@ void vTCPCommHandler(void *args) {
     logMessage(LOG_LEVEL_INFO, "SlaveHandler", "vTCPCommHandler started");
     tcpEchoServerTask();
 }
+
+/**
+ * @brief Handles the TCP client payloads.
+ *
+ * This task blocks on its consumer of the payload pipeline, parses each
+ * "ID=<id>;DATA=<data>" payload and feeds DATA to the slave state machine.
+ * A payload that does not parse, or whose DATA is not a slave input state,
+ * is logged and dropped.
+ * Parsing runs here, so the TCP task only receives and forwards. The trace of
+ * the payload is the current trace while the state machine handles it.
+ *
+ * @param args Pointer to task arguments (unused in this implementation).
+ */
+void vSlavePayloadHandler(void *args) {
+    // One byte more than any payload for the terminator
+    static char payload[COMM_PIPELINE_MAX_PAYLOAD + 1];
+    uint32_t length = 0;
+
+#ifndef UNIT_TEST
+    while (1) {
+#endif
+        if (recivePayloadSlave(payload, COMM_PIPELINE_MAX_PAYLOAD, &length) != RET_OK) {
+            logMessage(LOG_LEVEL_ERROR, "SlaveHandler", "Failed to receive client payload");
+        } else if (length < sizeof(CommPayloadHeader)) {
+            logMessage(LOG_LEVEL_ERROR, "SlaveHandler", "Client payload without header");
+        } else {
+            CommPayloadHeader header;
+            int32_t id = 0;
+            int32_t data = 0;
+
+            memcpy(&header, payload, sizeof(header));
+            payload[length] = '\0';
+            if (sscanf(payload + sizeof(header), "ID=%d;DATA=%d", &id, &data) != TCP_MESSAGE_CLIENT_PARCED_INPUTS) {
+                logMessage(LOG_LEVEL_ERROR, "SlaveHandler", "Failed to parse client payload");
+            } else if (data < 0 || data >= SLAVE_INPUT_STATE_MAX) {
+                logMessage(LOG_LEVEL_ERROR, "SlaveHandler", "Client payload DATA out of range");
+            } else {
+                logTraceSpan(header.traceId, LOG_TRACE_HOP_SLAVE_RECEIVED, (uint32_t)data);
+                logTraceSetCurrent(header.traceId);
+                if (handelStatus((SlaveInputStates)data) != RET_OK) {
+                    logMessage(LOG_LEVEL_ERROR, "SlaveHandler", "Failed to process client payload");
+                }
+                logTraceSetCurrent(0);
+            }
+        }
+#ifndef UNIT_TEST
+    }
+#endif
+}
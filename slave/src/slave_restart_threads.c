@@ -2,6 +2,7 @@
 #include "slave_restart_threads.h"
 #include "slave_handler.h"
 #include "slave_state_machine.h"
+#include "slave_comm.h"
 #include "logger.h"
 #include "thread_handler_cfg.h"
 #include "state_mashine_types.h"
@@ -34,13 +35,19 @@ static TaskHandler taskHandlers_[SLAVE_TAKS_HANDLERS_SIZE] = {
  * @brief Deletes all tasks in the task handler array.
  *
  * Iterates through all task handlers and deletes any tasks
- * with non-NULL handles to ensure proper cleanup.
+ * with non-NULL handles to ensure proper cleanup. Each task is first
+ * released from the comm channels, where it may be blocked. The scheduler is
+ * suspended from the release to the delete, so the master side cannot notify
+ * the task in between.
  */
 static void deleteAllTasks() {
     for (uint8_t i = 0; i < SLAVE_TAKS_HANDLERS_SIZE; i++) {
         if (taskHandlers_[i].taskHandler != NULL) {
             logMessageFormatted(LOG_LEVEL_INFO, "SlaveRestartThread", "Deleting task %d", i);
+            vTaskSuspendAll();
+            releaseTaskSlave(taskHandlers_[i].taskHandler);
             vTaskDelete(taskHandlers_[i].taskHandler);
+            (void)xTaskResumeAll();
             taskHandlers_[i].taskHandler = NULL;
         }
     }
@@ -1,7 +1,12 @@
 #include <stdio.h>
 #include "FreeRTOS.h"
 #include "semphr.h"
+#include "task.h"
+#include "event_groups.h"
 #include "logger.h"
+#include "logger_flight.h"
+#include "logger_status.h"
+#include "logger_trace.h"
 #include "slave_comm.h"
 #include "slave_state_machine.h"
 #include "slave_restart_threads.h"
@@ -14,8 +19,17 @@
  *
  * This file provides functionality for managing different operational states
  * of a slave system, ensuring state transitions are thread-safe and logged appropriately.
+ * Every transition sets SLAVE_STATE_EVENT_CHANGED, which wakes the task
+ * reporting the state to the master. A slave in FAULT is reset while the
+ * master reports ERROR, checked both when the fault is entered and when the
+ * master state arrives (setMasterStateSlave()).
  */
 
+/**
+ * @brief Event bit set on every slave state change.
+ */
+#define SLAVE_STATE_EVENT_CHANGED ((EventBits_t)1 << 0)
+
 /**
  * @brief Maximum valid state value for the slave.
  */
@@ -44,24 +58,33 @@ MasterToSlaveMap masterToSlaveMap[] = {
  * - resetQueueHandler: Handle to the reset queue for communication.
  * - currentState: Tracks the current state of the slave.
  * - statusSemaphore: Mutex for ensuring safe access to the current state.
+ * - traceId: Trace that caused the current state and is not reported yet, 0 if none.
+ * - stateEvents: Event group signalling state changes to waitStateChangeSlave().
+ * - masterError: Set while the master reports ERROR.
+ * - faultReset: Set once the current fault was reset, under statusSemaphore.
  */
 typedef struct 
 {
     QueueHandle_t resetQueueHandler;
     SlaveStates currentState;
     SemaphoreHandle_t statusSemaphore;
+    uint32_t traceId;
+    EventGroupHandle_t stateEvents;
+    uint8_t masterError;
+    uint8_t faultReset;
 } StateHandler;
 
 /**
  * @brief Global instance of StateHandler initialized to default values.
  */
-static StateHandler stateHandler = {NULL, SLAVE_STATE_SLEEP, NULL};
+static StateHandler stateHandler = {NULL, SLAVE_STATE_SLEEP, NULL, 0, NULL, 0, 0};
 
 // Forward declarations for state handler functions
 static RetVal_t handleSleepState();
 static RetVal_t handleActiveState();
 static RetVal_t handleFaultState();
 static RetVal_t handleResetState();
+static RetVal_t resetOnMasterError(void);
 
 /**
  * @brief Master state machine mapping states to their handler functions.
@@ -85,6 +108,8 @@ SlaveStateMachine slaveFSM[] = {
  * @brief Changes the current state of the slave.
  *
  * Ensures thread safety using a semaphore while performing state transitions.
+ * A new state remembers the current trace of the calling task as its cause
+ * and wakes the task waiting in waitStateChangeSlave().
  *
  * @param state New state to transition to.
  * @return RET_OK if state change was successful, RET_ERROR otherwise.
@@ -98,7 +123,17 @@ static RetVal_t changeState(SlaveStates state) {
     // Lock semaphore to ensure thread-safe state change
     if (xSemaphoreTake(stateHandler.statusSemaphore, portMAX_DELAY) == pdTRUE) {
         if (stateHandler.currentState != state) {
+            uint32_t traceId = logTraceCurrent();
+            if (state == SLAVE_STATE_FAULT) {
+                stateHandler.faultReset = 0;
+            }
             stateHandler.currentState = state;
+            __atomic_store_n(&stateHandler.traceId, traceId, __ATOMIC_RELAXED);
+            logTraceSpan(traceId, LOG_TRACE_HOP_SLAVE_TRANSITION, (uint32_t)state);
+            logStatusSetSlaveState(state);
+            if (stateHandler.stateEvents != NULL) {
+                (void)xEventGroupSetBits(stateHandler.stateEvents, SLAVE_STATE_EVENT_CHANGED);
+            }
             logMessageFormatted(LOG_LEVEL_INFO, "SlaveStateMachine", "New state is %d", stateHandler.currentState);
         }
         xSemaphoreGive(stateHandler.statusSemaphore);
@@ -115,12 +150,19 @@ static RetVal_t changeState(SlaveStates state) {
  * @return RET_OK if state was successfully handled, RET_ERROR otherwise.
  */
 static RetVal_t handleFaultState() {
+    uint8_t entering = (stateHandler.currentState != SLAVE_STATE_FAULT);
     logMessage(LOG_LEVEL_INFO, "SlaveStateMachine", "Slave: Handling FAULT state");
     if(changeState(SLAVE_STATE_FAULT) != RET_OK){
         logMessage(LOG_LEVEL_ERROR, "SlaveStateMachine", "Failed to change state to FAULT");
         return RET_ERROR;
     }
-    return RET_OK;
+
+    // Keep the history that led to the fault, once per fault
+    if (entering) {
+        logFlightDump("Slave entered FAULT");
+    }
+    // The master may already be in ERROR; do not wait for its next state
+    return resetOnMasterError();
 }
 
 /**
@@ -159,6 +201,10 @@ static RetVal_t handleActiveState() {
 static RetVal_t handleResetState() {
     int8_t signal = 1;
     logMessage(LOG_LEVEL_INFO, "SlaveStateMachine", "Slave: Handling RESET state");
+    // A reset that ends a fault was dumped when the fault was entered; dump once per fault
+    if (stateHandler.currentState != SLAVE_STATE_FAULT) {
+        logFlightDump("Slave RESET requested");
+    }
     if(changeState(SLAVE_STATE_SLEEP) != RET_OK){
         logMessage(LOG_LEVEL_ERROR, "SlaveStateMachine", "Failed to change state to SLEEP");
         return RET_ERROR;
@@ -174,9 +220,40 @@ static RetVal_t handleResetState() {
     return RET_OK;
 }
 
+/**
+ * @brief Resets the slave if it is in FAULT while the master reports ERROR.
+ *
+ * Called by the task that enters the fault and by the task that receives the
+ * master state. The condition is checked under the semaphore and the fault
+ * is marked as reset, so a fault seen by both tasks is reset once.
+ *
+ * @return RET_OK if no reset was needed or the reset was handled, RET_ERROR otherwise.
+ */
+static RetVal_t resetOnMasterError(void) {
+    uint8_t reset = 0;
+    if (stateHandler.statusSemaphore == NULL) {
+        logMessage(LOG_LEVEL_ERROR, "SlaveStateMachine", "statusSemaphore is NULL");
+        return RET_ERROR;
+    }
+    if (xSemaphoreTake(stateHandler.statusSemaphore, portMAX_DELAY) != pdTRUE) {
+        logMessage(LOG_LEVEL_ERROR, "SlaveStateMachine", "Failed to take status semaphore");
+        return RET_ERROR;
+    }
+    if (stateHandler.currentState == SLAVE_STATE_FAULT && stateHandler.faultReset == 0 &&
+        __atomic_load_n(&stateHandler.masterError, __ATOMIC_RELAXED)) {
+        stateHandler.faultReset = 1;
+        reset = 1;
+    }
+    xSemaphoreGive(stateHandler.statusSemaphore);
+    return reset ? handleResetState() : RET_OK;
+}
+
 /**
  * @brief Initializes the semaphore used for managing state transitions.
  *
+ * Also creates the event group signalling them and publishes the initial
+ * state on the status page.
+ *
  * @return RET_OK if initialization succeeded, RET_ERROR otherwise.
  */
 RetVal_t initStateMachineSlave(QueueHandle_t resetHandler) {
@@ -186,6 +263,12 @@ RetVal_t initStateMachineSlave(QueueHandle_t resetHandler) {
         logMessage(LOG_LEVEL_ERROR, "SlaveStateMachine", "Failed to create status semaphore");
         return RET_ERROR;
     }
+    stateHandler.stateEvents = xEventGroupCreate();
+    if (stateHandler.stateEvents == NULL) {
+        logMessage(LOG_LEVEL_ERROR, "SlaveStateMachine", "Failed to create state event group");
+        return RET_ERROR;
+    }
+    logStatusSetSlaveState(stateHandler.currentState);
     return RET_OK;
 }
 
@@ -220,3 +303,44 @@ RetVal_t getState(SlaveStates* currentStatus) {
     *currentStatus = stateHandler.currentState;
     return RET_OK;
 }
+
+/**
+ * @brief Takes the trace that caused the current state.
+ *
+ * The trace is handed out once, so only the first report of a state carries it.
+ *
+ * @return Trace id, or 0 if the state was not caused by a traced input or was already reported.
+ */
+uint32_t takeStateTraceId(void) {
+    return __atomic_exchange_n(&stateHandler.traceId, 0, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Records the master state and resets a faulted slave if the master is in ERROR.
+ *
+ * @param state Master state last received.
+ * @return RET_OK if no reset was needed or the reset was handled, RET_ERROR otherwise.
+ */
+RetVal_t setMasterStateSlave(MasterStates state) {
+    __atomic_store_n(&stateHandler.masterError, (uint8_t)(state == MASTESR_STATE_ERROR), __ATOMIC_RELAXED);
+    return resetOnMasterError();
+}
+
+/**
+ * @brief Waits until the slave state changes.
+ *
+ * Without the event group (before initStateMachineSlave()) it only waits, so
+ * the caller keeps its heartbeat.
+ *
+ * @param ticksToWait Maximum time to wait.
+ * @return RET_OK if the state changed, RET_ERROR if the wait timed out.
+ */
+RetVal_t waitStateChangeSlave(TickType_t ticksToWait) {
+    if (stateHandler.stateEvents == NULL) {
+        vTaskDelay(ticksToWait);
+        return RET_ERROR;
+    }
+    EventBits_t bits = xEventGroupWaitBits(stateHandler.stateEvents, SLAVE_STATE_EVENT_CHANGED, pdTRUE, pdFALSE,
+                                           ticksToWait);
+    return ((bits & SLAVE_STATE_EVENT_CHANGED) != 0) ? RET_OK : RET_ERROR;
+}
@@ -4,7 +4,10 @@
 #include "queue.h"
 #include "logger.h"
 #include "slave_comm.h"
+#include "comm_pipeline.h"
+#include "state_mashine_types.h"
 #include "task.h"
+#include "comm_cfg.h"
 
 // ==========================
 // **Define Missing Constants**
@@ -37,6 +40,13 @@ public:
     MOCK_METHOD(BaseType_t, xQueueReceive, (QueueHandle_t queue, void* item, TickType_t wait));
     MOCK_METHOD(void, logMessage, (LogLevel level, const char* module, const char* message));
     MOCK_METHOD(void, vTaskDelay, (TickType_t xTicksToDelay));
+    MOCK_METHOD(RetVal_t, commRingSend, (CommRing* ring, const CommMessage* message, TickType_t wait));
+    MOCK_METHOD(RetVal_t, commTransportSend, (CommTransport* transport, const CommMessage* message, TickType_t wait));
+    MOCK_METHOD(RetVal_t, commTransportReceive, (CommTransport* transport, CommMessage* message, TickType_t wait));
+    MOCK_METHOD(RetVal_t, commRingReceive, (CommRing* ring, CommMessage* message, TickType_t wait));
+    MOCK_METHOD(void, commRingForget, (CommRing* ring, TaskHandle_t task));
+    MOCK_METHOD(RetVal_t, commPipelinePublish, (CommPipeline* pipeline, const void* payload, uint32_t length, TickType_t wait));
+    MOCK_METHOD(RetVal_t, commPipelineReceive, (CommPipeline* pipeline, uint32_t consumer, void* payload, uint32_t capacity, uint32_t* length, TickType_t wait));
 };
 
 // ==========================
@@ -45,6 +55,9 @@ public:
 // Global mock object for FreeRTOS interactions
 FreeRTOSMock* freeRTOSMock = nullptr;
 
+// Free space reported for the channels; it is their length when initSlaveComm() runs
+UBaseType_t channelSpaces = 1;
+
 // ==========================
 // **C Function Redirection**
 // ==========================
@@ -71,6 +84,60 @@ extern "C" {
         return freeRTOSMock->xQueueReceive(queue, item, wait);
     }
 
+    UBaseType_t uxQueueSpacesAvailable(const QueueHandle_t queue) {
+        return channelSpaces;
+    }
+
+    RetVal_t commTransportSend(CommTransport* transport, const CommMessage* message, TickType_t wait) {
+        if (freeRTOSMock == nullptr) {
+            abort();
+        }
+        return freeRTOSMock->commTransportSend(transport, message, wait);
+    }
+
+    RetVal_t commTransportReceive(CommTransport* transport, CommMessage* message, TickType_t wait) {
+        if (freeRTOSMock == nullptr) {
+            abort();
+        }
+        return freeRTOSMock->commTransportReceive(transport, message, wait);
+    }
+
+    RetVal_t commPipelinePublish(CommPipeline* pipeline, const void* payload, uint32_t length, TickType_t wait) {
+        if (freeRTOSMock == nullptr) {
+            abort();
+        }
+        return freeRTOSMock->commPipelinePublish(pipeline, payload, length, wait);
+    }
+
+    RetVal_t commPipelineReceive(CommPipeline* pipeline, uint32_t consumer, void* payload, uint32_t capacity,
+                                 uint32_t* length, TickType_t wait) {
+        if (freeRTOSMock == nullptr) {
+            abort();
+        }
+        return freeRTOSMock->commPipelineReceive(pipeline, consumer, payload, capacity, length, wait);
+    }
+
+    RetVal_t commRingSend(CommRing* ring, const CommMessage* message, TickType_t wait) {
+        if (freeRTOSMock == nullptr) {
+            abort();
+        }
+        return freeRTOSMock->commRingSend(ring, message, wait);
+    }
+
+    RetVal_t commRingReceive(CommRing* ring, CommMessage* message, TickType_t wait) {
+        if (freeRTOSMock == nullptr) {
+            abort();
+        }
+        return freeRTOSMock->commRingReceive(ring, message, wait);
+    }
+
+    void commRingForget(CommRing* ring, TaskHandle_t task) {
+        if (freeRTOSMock == nullptr) {
+            abort();
+        }
+        freeRTOSMock->commRingForget(ring, task);
+    }
+
     void vTaskDelay(TickType_t xTicksToDelay) {
         if (freeRTOSMock == nullptr) {
             abort();
@@ -84,6 +151,15 @@ extern "C" {
         }
         freeRTOSMock->logMessage(level, module, message);
     }
+
+    uint8_t logComponentLevelEnabled(LogComponentId* site, const char* component, LogLevel level) {
+        return 1;
+    }
+
+    uint8_t logRateLimitAllow(LogRateLimit* site, uint32_t limit, LogLevel level,
+                              const char* component, const char* text) {
+        return 1;
+    }
 }
 
 // ==========================
@@ -92,13 +168,16 @@ extern "C" {
 // Test setup and teardown for SlaveComm module
 class SlaveCommTest : public ::testing::Test {
 protected:
-    QueueHandle_t stateQueueHandler_ = nullptr;
+    QueueHandle_t sendQueueHandler_ = nullptr;
+    QueueHandle_t receiveQueueHandler_ = nullptr;
     void SetUp() override {
         freeRTOSMock = new FreeRTOSMock();
         ASSERT_NE(freeRTOSMock, nullptr);
 
-        stateQueueHandler_ = reinterpret_cast<QueueHandle_t>(0x1234);
-        initSlaveComm(stateQueueHandler_);
+        sendQueueHandler_ = reinterpret_cast<QueueHandle_t>(0x1234);
+        receiveQueueHandler_ = reinterpret_cast<QueueHandle_t>(0x5678);
+        channelSpaces = 1;
+        initSlaveComm(sendQueueHandler_, receiveQueueHandler_);
     }
 
     void TearDown() override {
@@ -112,25 +191,147 @@ protected:
 // ==========================
 // Test successful initialization of SlaveComm
 TEST_F(SlaveCommTest, InitSlaveComm_SuccessfulInitialization) {
-    RetVal_t result = initSlaveComm(stateQueueHandler_);
+    RetVal_t result = initSlaveComm(sendQueueHandler_, receiveQueueHandler_);
     EXPECT_EQ(result, RET_OK);
 }
 
 // Test failed initialization of SlaveComm with NULL queue
 TEST_F(SlaveCommTest, InitSlaveComm_FailedInitialization) {
-    RetVal_t result = initSlaveComm(NULL);
+    RetVal_t result = initSlaveComm(NULL, receiveQueueHandler_);
     EXPECT_EQ(result, RET_ERROR);
 }
 
 // ==========================
 // **2. Message Sending Tests**
 // ==========================
-// Test successful message sending
+// Test successful message sending on the slave-to-master channel
+TEST_F(SlaveCommTest, SendMsgSlave_Success) {
+    CommMessage message = {COMM_MSG_SLAVE_STATE, 0, 0, SLAVE_STATE_ACTIVE};
+    CommMessage sent;
+    EXPECT_CALL(*freeRTOSMock, xQueueGenericSend(sendQueueHandler_, ::testing::_, ::testing::_, ::testing::_))
+        .WillOnce(testing::Invoke([&](QueueHandle_t, const void* item, TickType_t, BaseType_t) {
+            sent = *static_cast<const CommMessage*>(item);
+            return pdPASS;
+        }));
+    EXPECT_CALL(*freeRTOSMock, vTaskDelay(::testing::_)).Times(::testing::AnyNumber());
+    EXPECT_EQ(sendMsgSlave(&message), RET_OK);
+    EXPECT_EQ(sent.sourceId, COMM_SOURCE_SLAVE);
+    EXPECT_EQ(sent.payload, SLAVE_STATE_ACTIVE);
+}
 
 // Test failed message sending
 TEST_F(SlaveCommTest, SendMsgSlave_Failure) {
-    uint8_t data = 1;
-    EXPECT_EQ(sendMsgSlave(&data), RET_ERROR);
+    CommMessage message = {COMM_MSG_SLAVE_STATE, 0, 0, SLAVE_STATE_ACTIVE};
+    EXPECT_EQ(sendMsgSlave(&message), RET_ERROR);
+}
+
+// Test batch sending on a FIFO channel without pacing
+TEST_F(SlaveCommTest, SendMsgBatchSlave_FifoWithoutPacing) {
+    CommMessage messages[4] = {{COMM_MSG_SLAVE_STATE, 0, 0, SLAVE_STATE_ACTIVE},
+                               {COMM_MSG_SLAVE_STATE, 0, 0, SLAVE_STATE_SLEEP},
+                               {COMM_MSG_SLAVE_STATE, 0, 0, SLAVE_STATE_FAULT},
+                               {COMM_MSG_SLAVE_STATE, 0, 0, SLAVE_STATE_ACTIVE}};
+    uint32_t sent = 0;
+    channelSpaces = 8;
+    ASSERT_EQ(initSlaveComm(sendQueueHandler_, receiveQueueHandler_), RET_OK);
+    setSendPacingSlave(0);
+    EXPECT_CALL(*freeRTOSMock, xQueueGenericSend(sendQueueHandler_, ::testing::_,
+                                                 pdMS_TO_TICKS(TICK_TO_WAIT_SEND_MS), queueSEND_TO_BACK))
+        .Times(4)
+        .WillRepeatedly(testing::Return(pdPASS));
+    EXPECT_CALL(*freeRTOSMock, vTaskDelay(::testing::_)).Times(0);
+    EXPECT_EQ(sendMsgBatchSlave(messages, 4, &sent), RET_OK);
+    EXPECT_EQ(sent, 4u);
+    setSendPacingSlave(DELAY_SEND_MS);
+}
+
+// Test that coalescing holds back the newest message instead of blocking
+TEST_F(SlaveCommTest, SendMsgSlave_Coalesce_HoldsBackNewest) {
+    CommMessage message = {COMM_MSG_SLAVE_STATE, 0, 0, SLAVE_STATE_ACTIVE};
+    CommMessage sent;
+    CommOverflowStats before, after;
+    channelSpaces = 8;
+    ASSERT_EQ(initSlaveComm(sendQueueHandler_, receiveQueueHandler_), RET_OK);
+    ASSERT_EQ(setOverflowPolicySlave(COMM_OVERFLOW_COALESCE, 0), RET_OK);
+    getOverflowStatsSlave(&before);
+    EXPECT_CALL(*freeRTOSMock, vTaskDelay(::testing::_)).Times(::testing::AnyNumber());
+    EXPECT_CALL(*freeRTOSMock, xQueueGenericSend(sendQueueHandler_, ::testing::_, 0, queueSEND_TO_BACK))
+        .WillOnce(testing::Return(errQUEUE_FULL))
+        .WillOnce(testing::Invoke([&](QueueHandle_t, const void* item, TickType_t, BaseType_t) {
+            sent = *static_cast<const CommMessage*>(item);
+            return pdPASS;
+        }))
+        .WillOnce(testing::Return(pdPASS));
+    EXPECT_EQ(sendMsgSlave(&message), RET_OK);
+    message.payload = SLAVE_STATE_FAULT;
+    EXPECT_EQ(sendMsgSlave(&message), RET_OK);
+    getOverflowStatsSlave(&after);
+    EXPECT_EQ(sent.payload, SLAVE_STATE_ACTIVE);
+    EXPECT_EQ(after.coalesced - before.coalesced, 1u);
+}
+
+// Test that dropping the oldest message is refused on a ring channel
+TEST_F(SlaveCommTest, SetOverflowPolicySlave_DropOldestOnRing_Failure) {
+    CommRing* sendRing = reinterpret_cast<CommRing*>(0x1000);
+    CommRing* receiveRing = reinterpret_cast<CommRing*>(0x2000);
+    ASSERT_EQ(initSlaveCommRing(sendRing, receiveRing), RET_OK);
+    EXPECT_CALL(*freeRTOSMock, logMessage(::testing::_, ::testing::_, ::testing::_)).Times(::testing::AnyNumber());
+    EXPECT_EQ(setOverflowPolicySlave(COMM_OVERFLOW_DROP_OLDEST, 0), RET_ERROR);
+    EXPECT_EQ(setOverflowPolicySlave(COMM_OVERFLOW_COALESCE, 0), RET_OK);
+}
+
+// Test that dropping the oldest message is refused on a queue read through the master fan-in queue set
+TEST_F(SlaveCommTest, SetOverflowPolicySlave_DropOldestOnQueueSetMember_Failure) {
+    channelSpaces = 8;
+    ASSERT_EQ(initSlaveComm(sendQueueHandler_, receiveQueueHandler_), RET_OK);
+    EXPECT_CALL(*freeRTOSMock, logMessage(::testing::_, ::testing::_, ::testing::_)).Times(::testing::AnyNumber());
+    ASSERT_EQ(setOverflowPolicySlave(COMM_OVERFLOW_DROP_OLDEST, 0), RET_OK);
+    EXPECT_EQ(setSendQueueInSetSlave(), RET_ERROR);
+
+    ASSERT_EQ(setOverflowPolicySlave(COMM_OVERFLOW_BLOCK, 0), RET_OK);
+    ASSERT_EQ(setSendQueueInSetSlave(), RET_OK);
+    EXPECT_EQ(setOverflowPolicySlave(COMM_OVERFLOW_DROP_OLDEST, 0), RET_ERROR);
+    EXPECT_EQ(setOverflowPolicySlave(COMM_OVERFLOW_COALESCE, 0), RET_OK);
+
+    // A new channel is not a set member until marked again
+    ASSERT_EQ(initSlaveComm(sendQueueHandler_, receiveQueueHandler_), RET_OK);
+    EXPECT_EQ(setOverflowPolicySlave(COMM_OVERFLOW_DROP_OLDEST, 0), RET_OK);
+}
+
+// Test that a block is queued by pointer without waiting, and a full channel fails
+TEST_F(SlaveCommTest, SendBlockSlave_QueuesPointerWithoutWaiting) {
+    QueueHandle_t blockQueueHandler = reinterpret_cast<QueueHandle_t>(0x9abc);
+    CommBlock* block = reinterpret_cast<CommBlock*>(0x4000);
+    CommBlock* queued = nullptr;
+    ASSERT_EQ(initBlockChannelSlave(blockQueueHandler), RET_OK);
+    EXPECT_CALL(*freeRTOSMock, xQueueGenericSend(blockQueueHandler, ::testing::_, 0, queueSEND_TO_BACK))
+        .WillOnce(testing::Invoke([&](QueueHandle_t, const void* item, TickType_t, BaseType_t) {
+            queued = *static_cast<CommBlock* const*>(item);
+            return pdPASS;
+        }))
+        .WillOnce(testing::Return(errQUEUE_FULL));
+    EXPECT_EQ(sendBlockSlave(block), RET_OK);
+    EXPECT_EQ(queued, block);
+    EXPECT_EQ(sendBlockSlave(block), RET_ERROR);
+}
+
+// Test that a payload is published with the pipeline wait and read as the slave consumer
+TEST_F(SlaveCommTest, SendPayloadSlave_PublishesAndReceivesAsSlaveConsumer) {
+    CommPipeline pipeline = {};
+    char payload[COMM_PIPELINE_MAX_PAYLOAD] = "ID=1;DATA=1";
+    uint32_t length = 0;
+    EXPECT_CALL(*freeRTOSMock, logMessage(::testing::_, ::testing::_, ::testing::_)).Times(::testing::AnyNumber());
+    EXPECT_EQ(initPayloadPipelineSlave(&pipeline), RET_ERROR);
+    pipeline.consumerCount = 1;
+    ASSERT_EQ(initPayloadPipelineSlave(&pipeline), RET_OK);
+    EXPECT_CALL(*freeRTOSMock, commPipelinePublish(&pipeline, payload, 11, pdMS_TO_TICKS(COMM_PIPELINE_PUBLISH_WAIT_MS)))
+        .WillOnce(testing::Return(RET_OK));
+    EXPECT_CALL(*freeRTOSMock, commPipelineReceive(&pipeline, COMM_PAYLOAD_CONSUMER_SLAVE, payload, sizeof(payload),
+                                                   &length, portMAX_DELAY))
+        .WillOnce(testing::DoAll(testing::SetArgPointee<4>(11u), testing::Return(RET_OK)));
+    EXPECT_EQ(sendPayloadSlave(payload, 11), RET_OK);
+    EXPECT_EQ(recivePayloadSlave(payload, sizeof(payload), &length), RET_OK);
+    EXPECT_EQ(length, 11u);
 }
 
 // ==========================
@@ -138,19 +339,229 @@ TEST_F(SlaveCommTest, SendMsgSlave_Failure) {
 // ==========================
 // Test successful message receiving
 TEST_F(SlaveCommTest, ReciveMsgSlave_Success) {
-    EXPECT_CALL(*freeRTOSMock, xQueueReceive(::testing::_, ::testing::_, ::testing::_))
-        .WillOnce(testing::Return(pdPASS));
-    char buffer[10];
-    RetVal_t result = reciveMsgSlave(buffer);
+    EXPECT_CALL(*freeRTOSMock, xQueueReceive(receiveQueueHandler_, ::testing::_, ::testing::_))
+        .WillOnce(testing::Invoke([](QueueHandle_t, void* item, TickType_t) {
+            *static_cast<CommMessage*>(item) = {COMM_MSG_MASTER_STATE, COMM_SOURCE_MASTER, 3, MASTESR_STATE_ERROR};
+            return pdPASS;
+        }));
+    CommMessage message;
+    RetVal_t result = reciveMsgSlave(&message);
     EXPECT_EQ(result, RET_OK);
+    EXPECT_EQ(message.payload, MASTESR_STATE_ERROR);
+}
+
+// Test that a message sent by the slave itself is rejected
+TEST_F(SlaveCommTest, ReciveMsgSlave_OwnMessage) {
+    EXPECT_CALL(*freeRTOSMock, xQueueReceive(receiveQueueHandler_, ::testing::_, ::testing::_))
+        .WillOnce(testing::Invoke([](QueueHandle_t, void* item, TickType_t) {
+            *static_cast<CommMessage*>(item) = {COMM_MSG_SLAVE_STATE, COMM_SOURCE_SLAVE, 0, SLAVE_STATE_SLEEP};
+            return pdPASS;
+        }));
+    CommMessage message;
+    RetVal_t result = reciveMsgSlave(&message);
+    EXPECT_EQ(result, RET_ERROR);
+}
+
+// Test that overwritten master states are counted as skipped
+TEST_F(SlaveCommTest, ReciveMsgSlave_SequenceGap_CountsSkipped) {
+    uint16_t sequences[2] = {10, 12};
+    int count = 0;
+    EXPECT_CALL(*freeRTOSMock, xQueueReceive(receiveQueueHandler_, ::testing::_, ::testing::_))
+        .Times(2)
+        .WillRepeatedly(testing::Invoke([&](QueueHandle_t, void* item, TickType_t) {
+            *static_cast<CommMessage*>(item) = {COMM_MSG_MASTER_STATE, COMM_SOURCE_MASTER, sequences[count++], 0};
+            return pdPASS;
+        }));
+    CommMessage message;
+    EXPECT_EQ(reciveMsgSlave(&message), RET_OK);
+    uint32_t skipped = getSkippedMsgSlave();
+    EXPECT_EQ(reciveMsgSlave(&message), RET_OK);
+    EXPECT_EQ(getSkippedMsgSlave() - skipped, 1u);
+}
+
+// Test that a ring channel failure is reported without touching the queues
+TEST_F(SlaveCommTest, ReciveMsgSlave_RingEmpty_Failure) {
+    CommRing* sendRing = reinterpret_cast<CommRing*>(0x1000);
+    CommRing* receiveRing = reinterpret_cast<CommRing*>(0x2000);
+    ASSERT_EQ(initSlaveCommRing(sendRing, receiveRing), RET_OK);
+    EXPECT_CALL(*freeRTOSMock, xQueueReceive(::testing::_, ::testing::_, ::testing::_)).Times(0);
+    EXPECT_CALL(*freeRTOSMock, commRingReceive(receiveRing, ::testing::_, portMAX_DELAY))
+        .WillOnce(testing::Return(RET_ERROR));
+    EXPECT_CALL(*freeRTOSMock, logMessage(::testing::_, ::testing::_, ::testing::_)).Times(::testing::AnyNumber());
+    CommMessage message;
+    EXPECT_EQ(reciveMsgSlave(&message), RET_ERROR);
+}
+
+// Test that a deleted task is removed from both rings, and that queues need nothing
+TEST_F(SlaveCommTest, ReleaseTaskSlave_ForgetsTaskInRings) {
+    CommRing* sendRing = reinterpret_cast<CommRing*>(0x1000);
+    CommRing* receiveRing = reinterpret_cast<CommRing*>(0x2000);
+    TaskHandle_t task = reinterpret_cast<TaskHandle_t>(0x4000);
+    EXPECT_CALL(*freeRTOSMock, commRingForget(::testing::_, ::testing::_)).Times(0);
+    releaseTaskSlave(task);
+
+    ASSERT_EQ(initSlaveCommRing(sendRing, receiveRing), RET_OK);
+    EXPECT_CALL(*freeRTOSMock, commRingForget(sendRing, task));
+    EXPECT_CALL(*freeRTOSMock, commRingForget(receiveRing, task));
+    releaseTaskSlave(task);
+}
+
+// Test that a transport carries the messages and refuses drop-oldest
+TEST_F(SlaveCommTest, InitSlaveCommTransport_SendsAndReceivesThroughTransport) {
+    CommTransport* transport = reinterpret_cast<CommTransport*>(0x3000);
+    CommMessage message = {COMM_MSG_SLAVE_STATE, 0, 0, SLAVE_STATE_FAULT};
+    EXPECT_CALL(*freeRTOSMock, logMessage(::testing::_, ::testing::_, ::testing::_)).Times(::testing::AnyNumber());
+    EXPECT_CALL(*freeRTOSMock, vTaskDelay(::testing::_)).Times(::testing::AnyNumber());
+    EXPECT_EQ(initSlaveCommTransport(nullptr), RET_ERROR);
+    ASSERT_EQ(initSlaveCommTransport(transport), RET_OK);
+    EXPECT_EQ(setOverflowPolicySlave(COMM_OVERFLOW_DROP_OLDEST, 0), RET_ERROR);
+    EXPECT_CALL(*freeRTOSMock, xQueueGenericSend(::testing::_, ::testing::_, ::testing::_, ::testing::_)).Times(0);
+    EXPECT_CALL(*freeRTOSMock, commTransportSend(transport, ::testing::_, pdMS_TO_TICKS(TICK_TO_WAIT_SEND_MS)))
+        .WillOnce(testing::Return(RET_OK));
+    EXPECT_CALL(*freeRTOSMock, commTransportReceive(transport, ::testing::_, portMAX_DELAY))
+        .WillOnce(testing::Invoke([](CommTransport*, CommMessage* item, TickType_t) {
+            *item = {COMM_MSG_MASTER_STATE, COMM_SOURCE_MASTER, 0, MASTESR_STATE_IDLE};
+            return RET_OK;
+        }));
+    EXPECT_EQ(sendMsgSlave(&message), RET_OK);
+    EXPECT_EQ(reciveMsgSlave(&message), RET_OK);
+    EXPECT_EQ(message.payload, MASTESR_STATE_IDLE);
+}
+
+// ==========================
+// **4. State Sync Tests**
+// ==========================
+// Test that the first sync asks for the master states and an unchanged state is not sent again
+TEST_F(SlaveCommTest, SyncStateSlave_UnchangedState_SendsNothingAfterFirstSync) {
+    CommMessage sent[2];
+    int count = 0;
+    uint32_t sentCount = 0;
+    channelSpaces = 8;
+    ASSERT_EQ(initSlaveComm(sendQueueHandler_, receiveQueueHandler_), RET_OK);
+    EXPECT_CALL(*freeRTOSMock, xQueueGenericSend(sendQueueHandler_, ::testing::_, ::testing::_, ::testing::_))
+        .Times(2)
+        .WillRepeatedly(testing::Invoke([&](QueueHandle_t, const void* item, TickType_t, BaseType_t) {
+            sent[count++] = *static_cast<const CommMessage*>(item);
+            return pdPASS;
+        }));
+    EXPECT_CALL(*freeRTOSMock, vTaskDelay(::testing::_)).Times(1);
+    EXPECT_EQ(syncStateSlave(COMM_SYNC_SLAVE_ID, SLAVE_STATE_ACTIVE, 0, &sentCount), RET_OK);
+    EXPECT_EQ(sentCount, 2u);
+    EXPECT_EQ(syncStateSlave(COMM_SYNC_SLAVE_ID, SLAVE_STATE_ACTIVE, 0, &sentCount), RET_OK);
+    EXPECT_EQ(sentCount, 0u);
+
+    EXPECT_EQ(sent[0].type, COMM_MSG_SYNC_REQUEST);
+    EXPECT_EQ(sent[0].sourceId, COMM_SOURCE_SLAVE);
+    EXPECT_EQ(sent[1].type, COMM_MSG_SLAVE_STATE);
+    EXPECT_EQ(sent[1].payload, SLAVE_STATE_ACTIVE);
+    EXPECT_EQ(sent[1].version, 1u);
+}
+
+// Test that stale master states and sync requests are consumed instead of returned
+TEST_F(SlaveCommTest, ReciveStateSyncSlave_DropsStaleAndConsumesRequests) {
+    CommMessage received[4] = {{COMM_MSG_MASTER_STATE, COMM_SOURCE_MASTER, 0, MASTESR_STATE_PROCESSING, 0, 0, 1, 0},
+                               {COMM_MSG_MASTER_STATE, COMM_SOURCE_MASTER, 1, MASTESR_STATE_ERROR, 0, 0, 2, 1},
+                               {COMM_MSG_MASTER_STATE, COMM_SOURCE_MASTER, 2, MASTESR_STATE_ERROR, 0, 0, 2, 1},
+                               {COMM_MSG_SYNC_REQUEST, COMM_SOURCE_MASTER, 3, 0, 0, 0, 0, 0}};
+    int count = 0;
+    CommMessage messages[4];
+    uint32_t receivedCount = 0;
+    EXPECT_CALL(*freeRTOSMock, xQueueReceive(receiveQueueHandler_, ::testing::_, 0))
+        .WillRepeatedly(testing::Invoke([&](QueueHandle_t, void* item, TickType_t) {
+            if (count == 4) {
+                return pdFAIL;
+            }
+            *static_cast<CommMessage*>(item) = received[count++];
+            return pdPASS;
+        }));
+    EXPECT_EQ(reciveStateSyncSlave(messages, 4, &receivedCount, 0), RET_OK);
+    EXPECT_EQ(receivedCount, 2u);
+    EXPECT_EQ(messages[1].payload, MASTESR_STATE_ERROR);
+}
+
+// Test that only the first master state change is waited for, and a consumed request does not end the wait
+TEST_F(SlaveCommTest, ReciveStateSyncSlave_WaitsForFirstChange) {
+    CommMessage messages[2];
+    uint32_t receivedCount = 0;
+    EXPECT_CALL(*freeRTOSMock, xQueueReceive(receiveQueueHandler_, ::testing::_, 20))
+        .WillOnce(testing::Invoke([](QueueHandle_t, void* item, TickType_t) {
+            *static_cast<CommMessage*>(item) = {COMM_MSG_SYNC_REQUEST, COMM_SOURCE_MASTER, 0, 0, 0, 0, 0, 0};
+            return pdPASS;
+        }))
+        .WillOnce(testing::Invoke([](QueueHandle_t, void* item, TickType_t) {
+            *static_cast<CommMessage*>(item) = {COMM_MSG_MASTER_STATE, COMM_SOURCE_MASTER, 1, MASTESR_STATE_ERROR, 0, 0, 1, 0};
+            return pdPASS;
+        }));
+    EXPECT_CALL(*freeRTOSMock, xQueueReceive(receiveQueueHandler_, ::testing::_, 0)).WillOnce(testing::Return(pdFAIL));
+    EXPECT_EQ(reciveStateSyncSlave(messages, 2, &receivedCount, 20), RET_OK);
+    EXPECT_EQ(receivedCount, 1u);
+    EXPECT_EQ(messages[0].payload, MASTESR_STATE_ERROR);
+}
+
+// Test that a lost master state is asked for again from the version the slave has
+TEST_F(SlaveCommTest, ReciveStateSyncSlave_Gap_RequestsChangesAgain) {
+    CommMessage received[2] = {{COMM_MSG_MASTER_STATE, COMM_SOURCE_MASTER, 0, MASTESR_STATE_PROCESSING, 0, 0, 1, 0},
+                               {COMM_MSG_MASTER_STATE, COMM_SOURCE_MASTER, 1, MASTESR_STATE_IDLE, 0, 0, 3, 2}};
+    int count = 0;
+    CommMessage messages[2];
+    CommMessage request = {};
+    uint32_t receivedCount = 0;
+    channelSpaces = 8;
+    ASSERT_EQ(initSlaveComm(sendQueueHandler_, receiveQueueHandler_), RET_OK);
+    EXPECT_CALL(*freeRTOSMock, xQueueReceive(receiveQueueHandler_, ::testing::_, 0))
+        .WillRepeatedly(testing::Invoke([&](QueueHandle_t, void* item, TickType_t) {
+            if (count == 2) {
+                return pdFAIL;
+            }
+            *static_cast<CommMessage*>(item) = received[count++];
+            return pdPASS;
+        }));
+    EXPECT_EQ(reciveStateSyncSlave(messages, 2, &receivedCount, 0), RET_OK);
+    EXPECT_EQ(receivedCount, 1u);
+
+    EXPECT_CALL(*freeRTOSMock, logMessage(::testing::_, ::testing::_, ::testing::_)).Times(::testing::AnyNumber());
+    EXPECT_CALL(*freeRTOSMock, xQueueGenericSend(sendQueueHandler_, ::testing::_, ::testing::_, ::testing::_))
+        .WillRepeatedly(testing::Invoke([&](QueueHandle_t, const void* item, TickType_t, BaseType_t) {
+            const CommMessage* sent = static_cast<const CommMessage*>(item);
+            if (sent->type == COMM_MSG_SYNC_REQUEST) {
+                request = *sent;
+            }
+            return pdPASS;
+        }));
+    EXPECT_CALL(*freeRTOSMock, vTaskDelay(::testing::_)).Times(::testing::AnyNumber());
+    EXPECT_EQ(syncStateSlave(COMM_SYNC_SLAVE_ID, SLAVE_STATE_SLEEP, 0, nullptr), RET_OK);
+    EXPECT_EQ(request.type, COMM_MSG_SYNC_REQUEST);
+    EXPECT_EQ(request.version, 1u);
+}
+
+// Test that over a mailbox every sync overwrites the slave state as a snapshot, with no request
+TEST_F(SlaveCommTest, SyncStateSlave_Mailbox_SendsSnapshotEveryCall) {
+    CommMessage sent[2];
+    int count = 0;
+    EXPECT_CALL(*freeRTOSMock, xQueueGenericSend(sendQueueHandler_, ::testing::_, 0, queueOVERWRITE))
+        .Times(2)
+        .WillRepeatedly(testing::Invoke([&](QueueHandle_t, const void* item, TickType_t, BaseType_t) {
+            sent[count++] = *static_cast<const CommMessage*>(item);
+            return pdPASS;
+        }));
+    EXPECT_CALL(*freeRTOSMock, vTaskDelay(::testing::_)).Times(2);
+    EXPECT_EQ(syncStateSlave(COMM_SYNC_SLAVE_ID, SLAVE_STATE_FAULT, 0, nullptr), RET_OK);
+    EXPECT_EQ(syncStateSlave(COMM_SYNC_SLAVE_ID, SLAVE_STATE_FAULT, 0, nullptr), RET_OK);
+
+    for (int i = 0; i < 2; i++) {
+        EXPECT_EQ(sent[i].type, COMM_MSG_SLAVE_STATE);
+        EXPECT_EQ(sent[i].payload, SLAVE_STATE_FAULT);
+        EXPECT_EQ(sent[i].version, 1u);
+        EXPECT_EQ(sent[i].baseVersion, 0u);
+    }
 }
 
 // Test failed message receiving
 TEST_F(SlaveCommTest, ReciveMsgSlave_Failure) {
     EXPECT_CALL(*freeRTOSMock, xQueueReceive(::testing::_, ::testing::_, ::testing::_))
         .WillOnce(testing::Return(pdFAIL));
-    char buffer[10];
-    RetVal_t result = reciveMsgSlave(buffer);
+    CommMessage message;
+    RetVal_t result = reciveMsgSlave(&message);
     EXPECT_EQ(result, RET_ERROR);
 }
 
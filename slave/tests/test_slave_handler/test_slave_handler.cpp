@@ -1,5 +1,6 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
+#include <cstring>
 
 // ==========================
 // **Include Dependencies**
@@ -7,6 +8,7 @@
 extern "C" {
     #include "slave_handler.h"
     #include "logger.h"
+    #include "logger_trace.h"
     #include "queue.h"
     #include "slave_comm.h"
     #include "slave_state_machine.h"
@@ -16,6 +18,7 @@ extern "C" {
     #include "task.h"
     #include "types.h"
     #include "state_mashine_types.h"
+    #include "comm_cfg.h"
 }
 
 // ==========================
@@ -36,8 +39,10 @@ public:
 // Mock class for Slave Communication
 class MockSlaveComm {
 public:
-    MOCK_METHOD(RetVal_t, reciveMsgSlave, (void*), ());
-    MOCK_METHOD(RetVal_t, sendMsgSlave, (const void*), ());
+    MOCK_METHOD(RetVal_t, reciveStateSyncSlave, (CommMessage*, uint32_t, uint32_t*, TickType_t), ());
+    MOCK_METHOD(RetVal_t, syncStateSlave, (uint32_t, int32_t, uint32_t, uint32_t*), ());
+    MOCK_METHOD(void, resyncStateSlave, (), ());
+    MOCK_METHOD(RetVal_t, recivePayloadSlave, (void*, uint32_t, uint32_t*), ());
 };
 
 // Mock class for FreeRTOS functionality
@@ -51,6 +56,8 @@ class MockStateMachine {
 public:
     MOCK_METHOD(RetVal_t, getState, (SlaveStates*), ());
     MOCK_METHOD(RetVal_t, handelStatus, (SlaveInputStates), ());
+    MOCK_METHOD(RetVal_t, waitStateChangeSlave, (TickType_t), ());
+    MOCK_METHOD(RetVal_t, setMasterStateSlave, (MasterStates), ());
 };
 
 // Mock class for TCP Communication
@@ -79,6 +86,7 @@ MockStateMachine* mockStateMachine;
 MockTCPComm* mockTCPComm;
 MockFreeRTOS* mockFreeRTOS;
 MockRestart* mockRestart;
+uint32_t receivedTrace = 0;
 
 // ==========================
 // **Mocked C Functions**
@@ -89,6 +97,22 @@ extern "C" {
         mockLogger->logMessage(priority, thread, message);
     }
 
+    void logStatusHeartbeat(void) {
+    }
+
+    void logTraceSpan(uint32_t traceId, LogTraceHop hop, uint32_t value) {
+        if (hop == LOG_TRACE_HOP_SLAVE_RECEIVED) {
+            receivedTrace = traceId;
+        }
+    }
+
+    void logTraceSetCurrent(uint32_t traceId) {
+    }
+
+    uint32_t takeStateTraceId(void) {
+        return 0;
+    }
+
     void vTaskDelay(TickType_t xTicksToDelay) {
         mockFreeRTOS->vTaskDelay(xTicksToDelay);
     }
@@ -101,22 +125,39 @@ extern "C" {
         return mockQueue->xQueueReceive(queue, pvBuffer, xTicksToWait);
     }
 
-    RetVal_t reciveMsgSlave(void* data) {
-        return mockSlaveComm->reciveMsgSlave(data);
+    RetVal_t reciveStateSyncSlave(CommMessage* messages, uint32_t capacity, uint32_t* receivedCount,
+                                  TickType_t ticksToWait) {
+        return mockSlaveComm->reciveStateSyncSlave(messages, capacity, receivedCount, ticksToWait);
+    }
+
+    void resyncStateSlave() {
+        mockSlaveComm->resyncStateSlave();
+    }
+
+    RetVal_t recivePayloadSlave(void* payload, uint32_t capacity, uint32_t* length) {
+        return mockSlaveComm->recivePayloadSlave(payload, capacity, length);
     }
 
     RetVal_t getState(SlaveStates* state) {
         return mockStateMachine->getState(state);
     }
 
-    RetVal_t sendMsgSlave(const void* state) {
-        return mockSlaveComm->sendMsgSlave(state);
+    RetVal_t syncStateSlave(uint32_t slaveId, int32_t state, uint32_t traceId, uint32_t* sentCount) {
+        return mockSlaveComm->syncStateSlave(slaveId, state, traceId, sentCount);
     }
 
     RetVal_t handelStatus(SlaveInputStates state) {
         return mockStateMachine->handelStatus(state);
     }
 
+    RetVal_t waitStateChangeSlave(TickType_t ticksToWait) {
+        return mockStateMachine->waitStateChangeSlave(ticksToWait);
+    }
+
+    RetVal_t setMasterStateSlave(MasterStates state) {
+        return mockStateMachine->setMasterStateSlave(state);
+    }
+
     void tcpEchoServerTask() {
         mockTCPComm->tcpEchoServerTask();
     }
@@ -170,26 +211,110 @@ TEST_F(SlaveHandlerTest, RestartHandler_ReceivesSignalAndRestartsTasks) {
 }
 
 // **2. Status Observation Handler Tests**
-// Test handling valid slave state
-TEST_F(SlaveHandlerTest, SlaveStatusObservationHandler_ReceivesStateAndHandlesStatus) {
-    EXPECT_CALL(*mockSlaveComm, reciveMsgSlave(_)).WillOnce(Return(RET_OK));
+// Test publishing the slave state and then waiting for its next change
+TEST_F(SlaveHandlerTest, SlaveStatusObservationHandler_SyncsStateAndWaitsForChange) {
     EXPECT_CALL(*mockStateMachine, getState(_))
         .WillOnce([](SlaveStates* state) {
             *state = SLAVE_STATE_ACTIVE;
             return RET_OK;
         });
-    EXPECT_CALL(*mockSlaveComm, sendMsgSlave(_)).WillOnce(Return(RET_OK));
+    EXPECT_CALL(*mockSlaveComm, syncStateSlave(COMM_SYNC_SLAVE_ID, SLAVE_STATE_ACTIVE, _, _)).WillOnce(Return(RET_OK));
+    EXPECT_CALL(*mockStateMachine, waitStateChangeSlave(_)).WillOnce(Return(RET_OK));
+    EXPECT_CALL(*mockFreeRTOS, vTaskDelay(_)).Times(0);
 
     vSlaveStatusHandler(nullptr);
 }
 
-// **3. TCP Echo Server Task Tests**
+// **3. Master State Handler Tests**
+// Test that the received master state is handed to the state machine
+TEST_F(SlaveHandlerTest, SlaveMasterStateHandler_HandsMasterStateToStateMachine) {
+    EXPECT_CALL(*mockSlaveComm, resyncStateSlave()).Times(1);
+    EXPECT_CALL(*mockSlaveComm, reciveStateSyncSlave(_, COMM_RECEIVE_BATCH_SIZE, _, _))
+        .WillOnce([](CommMessage* messages, uint32_t, uint32_t* receivedCount, TickType_t) {
+            messages[0] = {COMM_MSG_MASTER_STATE, COMM_SOURCE_MASTER, 0, MASTESR_STATE_PROCESSING};
+            messages[1] = {COMM_MSG_MASTER_STATE, COMM_SOURCE_MASTER, 1, MASTESR_STATE_ERROR};
+            *receivedCount = 2;
+            return RET_OK;
+        });
+    EXPECT_CALL(*mockStateMachine, setMasterStateSlave(MASTESR_STATE_ERROR)).WillOnce(Return(RET_OK));
+    EXPECT_CALL(*mockStateMachine, handelStatus(_)).Times(0);
+    EXPECT_CALL(*mockSlaveComm, syncStateSlave(_, _, _, _)).Times(0);
+
+    vSlaveMasterStateHandler(nullptr);
+}
+
+// Test that a heartbeat without a master state leaves the state machine alone
+TEST_F(SlaveHandlerTest, SlaveMasterStateHandler_NoMasterState) {
+    EXPECT_CALL(*mockSlaveComm, resyncStateSlave()).Times(1);
+    EXPECT_CALL(*mockSlaveComm, reciveStateSyncSlave(_, COMM_RECEIVE_BATCH_SIZE, _, _))
+        .WillOnce(Return(RET_ERROR));
+    EXPECT_CALL(*mockFreeRTOS, vTaskDelay(_)).Times(1);
+    EXPECT_CALL(*mockStateMachine, setMasterStateSlave(_)).Times(0);
+
+    vSlaveMasterStateHandler(nullptr);
+}
+
+// **4. TCP Echo Server Task Tests**
 // Ensure TCP server task starts
 TEST_F(SlaveHandlerTest, TCPEchoServerTask_LogsStartAndCallsTCPServer) {
     EXPECT_CALL(*mockTCPComm, tcpEchoServerTask()).Times(1);
     vTCPCommHandler(nullptr);
 }
 
+// **5. Payload Handler Tests**
+// Ensure the DATA field of a client payload reaches the state machine
+TEST_F(SlaveHandlerTest, SlavePayloadHandler_ParsesPayloadAndHandlesStatus) {
+    EXPECT_CALL(*mockSlaveComm, recivePayloadSlave(_, _, _))
+        .WillOnce([](void* payload, uint32_t, uint32_t* length) {
+            // No terminator: the payload keeps only its length
+            CommPayloadHeader header = {9};
+            memcpy(payload, &header, sizeof(header));
+            memcpy((uint8_t*)payload + sizeof(header), "ID=1;DATA=1", 11);
+            *length = sizeof(header) + 11;
+            return RET_OK;
+        });
+    EXPECT_CALL(*mockStateMachine, handelStatus(SLAVE_INPUT_STATE_RPOCES_OR_ACTIVE)).WillOnce(Return(RET_OK));
+    EXPECT_CALL(*mockLogger, logMessage(LOG_LEVEL_ERROR, _, _)).Times(0);
+
+    receivedTrace = 0;
+    vSlavePayloadHandler(nullptr);
+    EXPECT_EQ(receivedTrace, 9u);
+}
+
+// Ensure a malformed payload does not reach the state machine
+TEST_F(SlaveHandlerTest, SlavePayloadHandler_MalformedPayloadIsDropped) {
+    EXPECT_CALL(*mockSlaveComm, recivePayloadSlave(_, _, _))
+        .WillOnce([](void* payload, uint32_t, uint32_t* length) {
+            CommPayloadHeader header = {9};
+            memcpy(payload, &header, sizeof(header));
+            memcpy((uint8_t*)payload + sizeof(header), "garbage", 7);
+            *length = sizeof(header) + 7;
+            return RET_OK;
+        });
+    EXPECT_CALL(*mockStateMachine, handelStatus(_)).Times(0);
+    EXPECT_CALL(*mockLogger, logMessage(LOG_LEVEL_ERROR, _, _)).Times(1);
+
+    receivedTrace = 0;
+    vSlavePayloadHandler(nullptr);
+    EXPECT_EQ(receivedTrace, 0u);
+}
+
+// Ensure a DATA value that is not a slave input state is dropped
+TEST_F(SlaveHandlerTest, SlavePayloadHandler_OutOfRangeDataIsDropped) {
+    EXPECT_CALL(*mockSlaveComm, recivePayloadSlave(_, _, _))
+        .WillOnce([](void* payload, uint32_t, uint32_t* length) {
+            CommPayloadHeader header = {9};
+            memcpy(payload, &header, sizeof(header));
+            memcpy((uint8_t*)payload + sizeof(header), "ID=1;DATA=7", 11);
+            *length = sizeof(header) + 11;
+            return RET_OK;
+        });
+    EXPECT_CALL(*mockStateMachine, handelStatus(_)).Times(0);
+    EXPECT_CALL(*mockLogger, logMessage(LOG_LEVEL_ERROR, _, _)).Times(1);
+
+    vSlavePayloadHandler(nullptr);
+}
+
 // ==========================
 // **Main Test Runner**
 // ==========================
@@ -34,6 +34,8 @@ public:
 class MockFreeRTOS {
 public:
     MOCK_METHOD(void, vTaskDelete, (TaskHandle_t xTaskToDelete), ());
+    MOCK_METHOD(void, vTaskSuspendAll, (), ());
+    MOCK_METHOD(BaseType_t, xTaskResumeAll, (), ());
     MOCK_METHOD(BaseType_t, xTaskCreate, (TaskFunction_t pxTaskCode, const char* const pcName, uint32_t usStackDepth,
                                          void* const pvParameters, UBaseType_t uxPriority, TaskHandle_t* const pxCreatedTask), ());
 };
@@ -43,6 +45,11 @@ public:
     MOCK_METHOD(RetVal_t, handelStatus, (SlaveInputStates state), ());
 };
 
+class MockSlaveComm {
+public:
+    MOCK_METHOD(void, releaseTaskSlave, (TaskHandle_t task), ());
+};
+
 using ::testing::_;
 using ::testing::Return;
 
@@ -52,6 +59,7 @@ using ::testing::Return;
 MockLogger* mockLogger;
 MockFreeRTOS* mockFreeRTOS;
 MockStateMachine* mockStateMachine;
+MockSlaveComm* mockSlaveComm;
 static TaskHandler taskHandlers_[SLAVE_TAKS_HANDLERS_SIZE] = {
     {SLAVE_STATUS_OBSERVATION_HANDLER_ID, vSlaveStatusHandler, "SlaveStatusObservationHandler", 
     TASTK_PRIO_SLAVE_STATUS_OBSERVATION_HANDLING, NULL},
@@ -79,6 +87,14 @@ extern "C" {
         mockFreeRTOS->vTaskDelete(xTaskToDelete);
     }
 
+    void vTaskSuspendAll(void) {
+        mockFreeRTOS->vTaskSuspendAll();
+    }
+
+    BaseType_t xTaskResumeAll(void) {
+        return mockFreeRTOS->xTaskResumeAll();
+    }
+
     BaseType_t xTaskCreate(TaskFunction_t pxTaskCode, const char* const pcName, uint32_t usStackDepth,
                            void* const pvParameters, UBaseType_t uxPriority, TaskHandle_t* const pxCreatedTask) {
         return mockFreeRTOS->xTaskCreate(pxTaskCode, pcName, usStackDepth, pvParameters, uxPriority, pxCreatedTask);
@@ -88,6 +104,10 @@ extern "C" {
         return mockStateMachine->handelStatus(state);
     }
 
+    void releaseTaskSlave(TaskHandle_t task) {
+        mockSlaveComm->releaseTaskSlave(task);
+    }
+
     // Mock implementations of undefined functions
     void vSlaveStatusHandler(void* params) {
         // Mock implementation
@@ -107,12 +127,14 @@ protected:
         mockLogger = new MockLogger();
         mockFreeRTOS = new MockFreeRTOS();
         mockStateMachine = new MockStateMachine();
+        mockSlaveComm = new MockSlaveComm();
     }
 
     void TearDown() override {
         delete mockLogger;
         delete mockFreeRTOS;
         delete mockStateMachine;
+        delete mockSlaveComm;
     }
 };
 
@@ -154,6 +176,27 @@ TEST_F(SlaveRestartThreadsTest, RestartAllTasks_SetStateFailure) {
     EXPECT_EQ(result, RET_ERROR);
 }
 
+// Test that every task is released from the comm channels and deleted with the scheduler suspended
+TEST_F(SlaveRestartThreadsTest, RestartAllTasks_ReleasesTasksBeforeDeleting) {
+    TaskHandle_t handles[SLAVE_TAKS_HANDLERS_SIZE] = {(TaskHandle_t)0x10, (TaskHandle_t)0x20};
+    setTaskHandlers(handles);
+    EXPECT_CALL(*mockLogger, logMessage(LOG_LEVEL_INFO, _, _)).Times(1);
+    EXPECT_CALL(*mockLogger, logMessageFormattedHelper(_, _, _)).Times(testing::AnyNumber());
+    {
+        testing::InSequence sequence;
+        for (TaskHandle_t handle : handles) {
+            EXPECT_CALL(*mockFreeRTOS, vTaskSuspendAll());
+            EXPECT_CALL(*mockSlaveComm, releaseTaskSlave(handle));
+            EXPECT_CALL(*mockFreeRTOS, vTaskDelete(handle));
+            EXPECT_CALL(*mockFreeRTOS, xTaskResumeAll()).WillOnce(Return(pdFALSE));
+        }
+    }
+    EXPECT_CALL(*mockFreeRTOS, xTaskCreate(_, _, _, _, _, _)).WillRepeatedly(Return(pdPASS));
+    EXPECT_CALL(*mockStateMachine, handelStatus(SLAVE_INPUT_STATE_IDEL_OR_SLEEP)).WillOnce(Return(RET_OK));
+
+    EXPECT_EQ(restartAllTasks(), RET_OK);
+}
+
 // ==========================
 // **Main Test Runner**
 // ==========================
@@ -6,7 +6,10 @@
 extern "C" {
     #include "slave_state_machine.h"
     #include "semphr.h"
+    #include "event_groups.h"
     #include "logger.h"
+    #include "logger_flight.h"
+    #include "logger_trace.h"
     #include "types.h"
 }
 
@@ -33,10 +36,20 @@ public:
     MOCK_METHOD(BaseType_t, xQueueSemaphoreTake, (QueueHandle_t xQueue, TickType_t xTicksToWait), ());
 };
 
+class MockEventGroup {
+public:
+    MOCK_METHOD(EventGroupHandle_t, xEventGroupCreate, (), ());
+    MOCK_METHOD(EventBits_t, xEventGroupSetBits, (EventGroupHandle_t xEventGroup, EventBits_t uxBitsToSet), ());
+    MOCK_METHOD(EventBits_t, xEventGroupWaitBits, (EventGroupHandle_t xEventGroup, EventBits_t uxBitsToWaitFor, BaseType_t xClearOnExit, BaseType_t xWaitForAllBits, TickType_t xTicksToWait), ());
+};
+
 class MockLogger {
 public:
     MOCK_METHOD(void, logMessage, (LogLevel level, const char* tag, const char* message), ());
     MOCK_METHOD(void, logMessageFormattedHelper, (LogLevel level, const char* component, const char* format), ());
+    MOCK_METHOD(RetVal_t, logFlightDump, (const char* reason), ());
+    MOCK_METHOD(void, logStatusSetSlaveState, (SlaveStates state), ());
+    MOCK_METHOD(void, logTraceSpan, (uint32_t traceId, LogTraceHop hop, uint32_t value), ());
     void logMessageFormatted(LogLevel level, const char* component, const char* format, ...) {
         va_list args;
         va_start(args, format);
@@ -50,7 +63,9 @@ public:
 // Global Mock Instances
 MockSemaphore* mockSemaphore;
 MockQueue* mockQueue;
+MockEventGroup* mockEventGroup;
 MockLogger* mockLogger;
+uint32_t currentTrace = 0;
 
 // Replace FreeRTOS functions with mock implementations
 extern "C" {
@@ -66,6 +81,21 @@ extern "C" {
         return mockSemaphore->xQueueCreateMutex(ucQueueType);
     }
 
+    EventGroupHandle_t xEventGroupCreate(void) {
+        return mockEventGroup->xEventGroupCreate();
+    }
+
+    EventBits_t xEventGroupSetBits(EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet) {
+        return mockEventGroup->xEventGroupSetBits(xEventGroup, uxBitsToSet);
+    }
+
+    EventBits_t xEventGroupWaitBits(EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToWaitFor, const BaseType_t xClearOnExit, const BaseType_t xWaitForAllBits, TickType_t xTicksToWait) {
+        return mockEventGroup->xEventGroupWaitBits(xEventGroup, uxBitsToWaitFor, xClearOnExit, xWaitForAllBits, xTicksToWait);
+    }
+
+    void vTaskDelay(const TickType_t xTicksToDelay) {
+    }
+
     BaseType_t xQueueSend(QueueHandle_t xQueue, const void* pvItemToQueue, TickType_t xTicksToWait) {
         return mockQueue->xQueueSend(xQueue, pvItemToQueue, xTicksToWait);
     }
@@ -90,6 +120,22 @@ extern "C" {
         va_end(args);
         mockLogger->logMessageFormattedHelper(level, component, buffer);
     }
+
+    RetVal_t logFlightDump(const char* reason) {
+        return mockLogger->logFlightDump(reason);
+    }
+
+    void logStatusSetSlaveState(SlaveStates state) {
+        mockLogger->logStatusSetSlaveState(state);
+    }
+
+    void logTraceSpan(uint32_t traceId, LogTraceHop hop, uint32_t value) {
+        mockLogger->logTraceSpan(traceId, hop, value);
+    }
+
+    uint32_t logTraceCurrent(void) {
+        return currentTrace;
+    }
 }
 
 // Test Fixture
@@ -98,12 +144,17 @@ protected:
     void SetUp() override {
         mockSemaphore = new MockSemaphore();
         mockQueue = new MockQueue();
+        mockEventGroup = new MockEventGroup();
         mockLogger = new MockLogger();
+        currentTrace = 0;
+        EXPECT_CALL(*mockLogger, logTraceSpan(::testing::_, ::testing::_, ::testing::_)).Times(::testing::AnyNumber());
+        EXPECT_CALL(*mockEventGroup, xEventGroupSetBits(::testing::_, ::testing::_)).Times(::testing::AnyNumber());
     }
 
     void TearDown() override {
         delete mockSemaphore;
         delete mockQueue;
+        delete mockEventGroup;
         delete mockLogger;
     }
 };
@@ -114,6 +165,7 @@ protected:
 TEST_F(SlaveStateMachineTest, InitStateMachineSlave_Success) {
     EXPECT_CALL(*mockLogger, logMessage(::testing::_, ::testing::_, ::testing::_)).Times(0);
     EXPECT_CALL(*mockSemaphore, xQueueCreateMutex(::testing::_)).WillOnce(::testing::Return((QueueHandle_t)1));
+    EXPECT_CALL(*mockEventGroup, xEventGroupCreate()).WillOnce(::testing::Return((EventGroupHandle_t)2));
 
     QueueHandle_t dummyQueue = (QueueHandle_t)1;
 
@@ -139,6 +191,16 @@ TEST_F(SlaveStateMachineTest, HandelStatus_InvalidState) {
     EXPECT_EQ(result, RET_ERROR);
 }
 
+// Test that entering FAULT dumps the flight recorder once
+TEST_F(SlaveStateMachineTest, HandelStatus_FaultDumpsFlightRecorderOnce) {
+    EXPECT_CALL(*mockQueue, xQueueSemaphoreTake(::testing::_, ::testing::_)).WillRepeatedly(::testing::Return(pdTRUE));
+    EXPECT_CALL(*mockLogger, logFlightDump(::testing::_)).WillOnce(::testing::Return(RET_OK));
+
+    EXPECT_EQ(handelStatus(SLAVE_INPUT_STATE_RPOCES_OR_ACTIVE), RET_OK);
+    EXPECT_EQ(handelStatus(SLAVE_INPUT_STATE_ERROR_OR_FAULT), RET_OK);
+    EXPECT_EQ(handelStatus(SLAVE_INPUT_STATE_ERROR_OR_FAULT), RET_OK);
+}
+
 // Test getState with valid pointer
 TEST_F(SlaveStateMachineTest, GetState_ValidPointer) {
     SlaveStates currentState;
@@ -158,6 +220,95 @@ TEST_F(SlaveStateMachineTest, GetState_NullPointer) {
     EXPECT_EQ(result, RET_ERROR);
 }
 
+// Test that a state change is published on the status page once
+TEST_F(SlaveStateMachineTest, HandelStatus_PublishesStateChangeToStatusPage) {
+    EXPECT_CALL(*mockQueue, xQueueSemaphoreTake(::testing::_, ::testing::_)).WillRepeatedly(::testing::Return(pdTRUE));
+    EXPECT_CALL(*mockLogger, logStatusSetSlaveState(::testing::_)).Times(::testing::AnyNumber());
+    EXPECT_EQ(handelStatus(SLAVE_INPUT_STATE_IDEL_OR_SLEEP), RET_OK);
+
+    EXPECT_CALL(*mockLogger, logStatusSetSlaveState(SLAVE_STATE_ACTIVE)).Times(1);
+    EXPECT_EQ(handelStatus(SLAVE_INPUT_STATE_RPOCES_OR_ACTIVE), RET_OK);
+    EXPECT_EQ(handelStatus(SLAVE_INPUT_STATE_RPOCES_OR_ACTIVE), RET_OK);
+}
+
+// Test that a state change keeps the trace that caused it until the status handler takes it
+TEST_F(SlaveStateMachineTest, HandelStatus_KeepsTraceOfStateChange) {
+    EXPECT_CALL(*mockQueue, xQueueSemaphoreTake(::testing::_, ::testing::_)).WillRepeatedly(::testing::Return(pdTRUE));
+    EXPECT_CALL(*mockLogger, logStatusSetSlaveState(::testing::_)).Times(::testing::AnyNumber());
+    EXPECT_EQ(handelStatus(SLAVE_INPUT_STATE_IDEL_OR_SLEEP), RET_OK);
+    (void)takeStateTraceId();
+
+    EXPECT_CALL(*mockLogger, logTraceSpan(5u, LOG_TRACE_HOP_SLAVE_TRANSITION, SLAVE_STATE_ACTIVE)).Times(1);
+    currentTrace = 5;
+    EXPECT_EQ(handelStatus(SLAVE_INPUT_STATE_RPOCES_OR_ACTIVE), RET_OK);
+    EXPECT_EQ(takeStateTraceId(), 5u);
+    EXPECT_EQ(takeStateTraceId(), 0u);
+}
+
+// Test that a state change wakes the status handler once
+TEST_F(SlaveStateMachineTest, HandelStatus_SignalsStateChange) {
+    EXPECT_CALL(*mockQueue, xQueueSemaphoreTake(::testing::_, ::testing::_)).WillRepeatedly(::testing::Return(pdTRUE));
+    EXPECT_CALL(*mockLogger, logStatusSetSlaveState(::testing::_)).Times(::testing::AnyNumber());
+    EXPECT_EQ(handelStatus(SLAVE_INPUT_STATE_IDEL_OR_SLEEP), RET_OK);
+
+    EXPECT_CALL(*mockEventGroup, xEventGroupSetBits((EventGroupHandle_t)2, ::testing::_)).Times(1);
+    EXPECT_EQ(handelStatus(SLAVE_INPUT_STATE_RPOCES_OR_ACTIVE), RET_OK);
+    EXPECT_EQ(handelStatus(SLAVE_INPUT_STATE_RPOCES_OR_ACTIVE), RET_OK);
+}
+
+// Test that waitStateChangeSlave reports a state change and a timeout
+TEST_F(SlaveStateMachineTest, WaitStateChangeSlave_ChangeAndTimeout) {
+    EXPECT_CALL(*mockEventGroup, xEventGroupWaitBits((EventGroupHandle_t)2, ::testing::_, pdTRUE, pdFALSE, 20))
+        .WillOnce(::testing::ReturnArg<1>())
+        .WillOnce(::testing::Return(0));
+    EXPECT_EQ(waitStateChangeSlave(20), RET_OK);
+    EXPECT_EQ(waitStateChangeSlave(20), RET_ERROR);
+}
+
+// Test that a faulted slave is reset once when the master reports ERROR, with one flight recorder dump
+TEST_F(SlaveStateMachineTest, SetMasterStateSlave_ResetsFaultedSlaveOnce) {
+    EXPECT_CALL(*mockQueue, xQueueSemaphoreTake(::testing::_, ::testing::_)).WillRepeatedly(::testing::Return(pdTRUE));
+    EXPECT_CALL(*mockLogger, logStatusSetSlaveState(::testing::_)).Times(::testing::AnyNumber());
+    EXPECT_CALL(*mockLogger, logFlightDump(::testing::_)).WillOnce(::testing::Return(RET_OK));
+    EXPECT_CALL(*mockQueue, xQueueGenericSend(::testing::_, ::testing::IsNull(), 0, ::testing::_))
+        .WillRepeatedly(::testing::Return(pdTRUE));
+    EXPECT_EQ(handelStatus(SLAVE_INPUT_STATE_ERROR_OR_FAULT), RET_OK);
+
+    // The reset signal is the only send that waits forever
+    EXPECT_CALL(*mockQueue, xQueueGenericSend(::testing::_, ::testing::NotNull(), portMAX_DELAY, ::testing::_))
+        .WillOnce(::testing::Return(pdPASS));
+    EXPECT_EQ(setMasterStateSlave(MASTESR_STATE_ERROR), RET_OK);
+    EXPECT_EQ(setMasterStateSlave(MASTESR_STATE_ERROR), RET_OK);
+
+    SlaveStates state = SLAVE_STATE_MAX;
+    EXPECT_EQ(getState(&state), RET_OK);
+    EXPECT_EQ(state, SLAVE_STATE_SLEEP);
+    EXPECT_EQ(setMasterStateSlave(MASTESR_STATE_IDLE), RET_OK);
+}
+
+// Test that a slave faulting after the master error is reset when it enters FAULT
+TEST_F(SlaveStateMachineTest, HandelStatus_FaultAfterMasterErrorResetsSlave) {
+    EXPECT_CALL(*mockQueue, xQueueSemaphoreTake(::testing::_, ::testing::_)).WillRepeatedly(::testing::Return(pdTRUE));
+    EXPECT_CALL(*mockLogger, logStatusSetSlaveState(::testing::_)).Times(::testing::AnyNumber());
+    EXPECT_CALL(*mockLogger, logFlightDump(::testing::_)).WillRepeatedly(::testing::Return(RET_OK));
+    EXPECT_CALL(*mockQueue, xQueueGenericSend(::testing::_, ::testing::IsNull(), 0, ::testing::_))
+        .WillRepeatedly(::testing::Return(pdTRUE));
+    EXPECT_EQ(handelStatus(SLAVE_INPUT_STATE_RPOCES_OR_ACTIVE), RET_OK);
+
+    EXPECT_CALL(*mockQueue, xQueueGenericSend(::testing::_, ::testing::NotNull(), portMAX_DELAY, ::testing::_))
+        .Times(0);
+    EXPECT_EQ(setMasterStateSlave(MASTESR_STATE_ERROR), RET_OK);
+
+    EXPECT_CALL(*mockQueue, xQueueGenericSend(::testing::_, ::testing::NotNull(), portMAX_DELAY, ::testing::_))
+        .WillOnce(::testing::Return(pdPASS));
+    EXPECT_EQ(handelStatus(SLAVE_INPUT_STATE_ERROR_OR_FAULT), RET_OK);
+
+    SlaveStates state = SLAVE_STATE_MAX;
+    EXPECT_EQ(getState(&state), RET_OK);
+    EXPECT_EQ(state, SLAVE_STATE_SLEEP);
+    EXPECT_EQ(setMasterStateSlave(MASTESR_STATE_IDLE), RET_OK);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,747 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "types.h"
+#include "state_mashine_types.h"
+#include "logger_segment.h"
+#include "logger_compress.h"
+#include "logger_timestamp.h"
+#include "logger_cfg.h"
+
+/**
+ * @file log_analytics.c
+ * @brief Host-side transition and time-in-state report for the text logs.
+ *
+ * Reads the "New status is %d" (master), "New state is %d" (slave) and
+ * "Restarting all tasks" records and reports, for the master and the slave:
+ * the time spent in each state (count, total, percentiles), the number and
+ * rate of each transition, the number of task restarts and the gap between a
+ * slave transition and the master transition it triggers (SLEEP -> IDLE,
+ * ACTIVE -> PROCESSING, FAULT -> ERROR).
+ *
+ * The logs are mapped read-only and split into ANALYTICS_CHUNK_SIZE chunks at
+ * line boundaries; the chunks are parsed by a pool of threads and their events
+ * merged in log order, so only the event list is processed sequentially.
+ *
+ * Usage: log_analytics [-j THREADS] [file...]
+ * The default input is the log segments of the current directory, or LOG_FILE
+ * when there are none. THREADS defaults to the number of online cores.
+ */
+
+#define ANALYTICS_CHUNK_SIZE (8u * 1024u * 1024u)
+#define ANALYTICS_MAX_THREADS 64
+#define NS_PER_SECOND 1000000000ll
+#define NS_PER_MS 1000000.0
+
+/**
+ * @brief Kind of an extracted event.
+ */
+typedef enum {
+    EVENT_MASTER_STATE,
+    EVENT_SLAVE_STATE,
+    EVENT_RESTART
+} AnalyticsEventKind;
+
+/**
+ * @brief One extracted record.
+ *
+ * - time: Record time (nanoseconds since the epoch).
+ * - offset: Position of the record in its file (orders the events of a chunk).
+ * - kind: Event kind.
+ * - state: New state of a state event.
+ */
+typedef struct {
+    int64_t time;
+    size_t offset;
+    uint8_t kind;
+    uint8_t state;
+} AnalyticsEvent;
+
+/**
+ * @brief Growable list of events.
+ */
+typedef struct {
+    AnalyticsEvent *items;
+    size_t count;
+    size_t capacity;
+} AnalyticsEvents;
+
+/**
+ * @brief One mapped input file.
+ *
+ * - data: File contents (read-only mapping, or the decompressed contents of a compressed segment).
+ * - size: Number of bytes holding records (the zero-filled tail of an active segment excluded).
+ * - mappingSize: Size of the mapping.
+ * - compressed: Reader of a compressed segment (NULL otherwise).
+ */
+typedef struct {
+    const char *data;
+    size_t size;
+    size_t mappingSize;
+    LogCompressReader *compressed;
+} AnalyticsFile;
+
+/**
+ * @brief Line-aligned part of a file parsed by one thread, and its events.
+ */
+typedef struct {
+    const char *data;
+    size_t start;
+    size_t end;
+    AnalyticsEvents events;
+} AnalyticsChunk;
+
+/**
+ * @brief Shared work list of the parsing threads.
+ */
+typedef struct {
+    AnalyticsChunk *chunks;
+    uint32_t count;
+    uint32_t next;
+} AnalyticsWork;
+
+/**
+ * @brief Per-thread cache of the epoch time of the last parsed day.
+ */
+typedef struct {
+    char day[10];
+    int64_t midnight;
+} AnalyticsDayCache;
+
+/**
+ * @brief Growable list of durations (nanoseconds).
+ */
+typedef struct {
+    int64_t *items;
+    size_t count;
+    size_t capacity;
+} AnalyticsDurations;
+
+/**
+ * @brief Statistics of one state machine.
+ *
+ * - name: Name used in the report.
+ * - stateNames: Names of the states, indexed by state.
+ * - stateCount: Number of states.
+ * - current: Current state, or -1 before the first transition.
+ * - enteredAt: Time the current state was entered.
+ * - entries: Number of times each state was entered.
+ * - transitions: Number of transitions, indexed by [from][to].
+ * - dwell: Completed stays in each state.
+ */
+typedef struct {
+    const char *name;
+    const char *const *stateNames;
+    uint32_t stateCount;
+    int32_t current;
+    int64_t enteredAt;
+    uint64_t entries[SLAVE_STATE_MAX];
+    uint64_t transitions[SLAVE_STATE_MAX][SLAVE_STATE_MAX];
+    AnalyticsDurations dwell[SLAVE_STATE_MAX];
+} AnalyticsMachine;
+
+/**
+ * @brief Matching of slave transitions with the master transitions they trigger.
+ *
+ * - pending: Set while a slave transition waits for its master transition.
+ * - pendingTime: Time of the waiting slave transition.
+ * - pendingTarget: Master state the waiting slave transition maps to.
+ * - unmatched: Slave transitions superseded before the master followed.
+ * - alreadyThere: Slave transitions whose master state was already current.
+ * - gaps: Delays between matched slave and master transitions.
+ */
+typedef struct {
+    uint8_t pending;
+    int64_t pendingTime;
+    uint8_t pendingTarget;
+    uint64_t unmatched;
+    uint64_t alreadyThere;
+    AnalyticsDurations gaps;
+} AnalyticsReaction;
+
+static const char *masterStateNames_[MASTESR_STATE_MAX] = {"IDLE", "PROCESSING", "ERROR"};
+static const char *slaveStateNames_[SLAVE_STATE_MAX] = {"SLEEP", "ACTIVE", "FAULT", "RESET"};
+
+// Same mapping as slaveToMasterMap of the master state machine; RESET has no master state
+static const int32_t slaveToMaster_[SLAVE_STATE_MAX] = {
+    MASTESR_STATE_IDLE, MASTESR_STATE_PROCESSING, MASTESR_STATE_ERROR, -1
+};
+
+static const char stateNeedle_[] = "StateMachine] New stat";
+static const char restartNeedle_[] = "[SlaveRestartThread] Restarting all tasks";
+
+static void addEvent(AnalyticsEvents *events, const AnalyticsEvent *event) {
+    if (events->count == events->capacity) {
+        size_t capacity = (events->capacity == 0) ? 256 : events->capacity * 2;
+        AnalyticsEvent *grown = realloc(events->items, capacity * sizeof(*grown));
+        if (grown == NULL) {
+            return; // Out of memory: the event is left out
+        }
+        events->items = grown;
+        events->capacity = capacity;
+    }
+    events->items[events->count++] = *event;
+}
+
+static void addDuration(AnalyticsDurations *durations, int64_t value) {
+    if (durations->count == durations->capacity) {
+        size_t capacity = (durations->capacity == 0) ? 64 : durations->capacity * 2;
+        int64_t *grown = realloc(durations->items, capacity * sizeof(*grown));
+        if (grown == NULL) {
+            return;
+        }
+        durations->items = grown;
+        durations->capacity = capacity;
+    }
+    durations->items[durations->count++] = (value < 0) ? 0 : value;
+}
+
+static uint32_t parseDigits(const char *text, uint32_t count) {
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        value = value * 10u + (uint32_t)(text[i] - '0');
+    }
+    return value;
+}
+
+/**
+ * @brief Converts a line timestamp to nanoseconds since the epoch.
+ *
+ * The "YYYY-MM-DD HH:MM:SS.uuuuuu" layout is parsed directly, calling mktime()
+ * only once per day; the ctime() layout of older logs goes through strptime().
+ *
+ * @return The time, or -1 if the timestamp cannot be parsed.
+ */
+static int64_t parseTimestamp(const char *text, size_t length, AnalyticsDayCache *cache) {
+    if (length == LOG_TIMESTAMP_TEXT_SIZE - 1 && text[4] == '-' && text[10] == ' ' && text[19] == '.') {
+        if (memcmp(cache->day, text, sizeof(cache->day)) != 0) {
+            struct tm local;
+            memset(&local, 0, sizeof(local));
+            local.tm_year = (int)parseDigits(text, 4) - 1900;
+            local.tm_mon = (int)parseDigits(text + 5, 2) - 1;
+            local.tm_mday = (int)parseDigits(text + 8, 2);
+            local.tm_isdst = -1;
+            cache->midnight = (int64_t)mktime(&local);
+            memcpy(cache->day, text, sizeof(cache->day));
+        }
+        int64_t seconds = cache->midnight + parseDigits(text + 11, 2) * 3600 +
+                          parseDigits(text + 14, 2) * 60 + parseDigits(text + 17, 2);
+        return seconds * NS_PER_SECOND + (int64_t)parseDigits(text + 20, 6) * 1000;
+    }
+
+    char buffer[40];
+    if (length >= sizeof(buffer)) {
+        return -1;
+    }
+    memcpy(buffer, text, length);
+    buffer[length] = '\0';
+    struct tm local;
+    memset(&local, 0, sizeof(local));
+    if (strptime(buffer, "%a %b %e %H:%M:%S %Y", &local) == NULL) {
+        return -1;
+    }
+    local.tm_isdst = -1;
+    return (int64_t)mktime(&local) * NS_PER_SECOND;
+}
+
+/**
+ * @brief Returns the time of the line starting at the given position.
+ *
+ * @return The time, or -1 if the line has no timestamp.
+ */
+static int64_t lineTime(const char *line, const char *end, AnalyticsDayCache *cache) {
+    if (line >= end || line[0] != '[') {
+        return -1;
+    }
+    const char *timestampEnd = memchr(line + 1, ']', (size_t)(end - line - 1));
+    if (timestampEnd == NULL) {
+        return -1;
+    }
+    return parseTimestamp(line + 1, (size_t)(timestampEnd - line - 1), cache);
+}
+
+static const char *lineStart(const char *chunkStart, const char *position) {
+    const char *newline = memrchr(chunkStart, '\n', (size_t)(position - chunkStart));
+    return (newline == NULL) ? chunkStart : newline + 1;
+}
+
+/**
+ * @brief Extracts the state events of a chunk ("[Master|Slave]StateMachine] New stat...").
+ */
+static void scanStates(AnalyticsChunk *chunk, AnalyticsDayCache *cache) {
+    const char *start = chunk->data + chunk->start;
+    const char *end = chunk->data + chunk->end;
+    const char *hit = start;
+
+    while ((hit = memmem(hit, (size_t)(end - hit), stateNeedle_, sizeof(stateNeedle_) - 1)) != NULL) {
+        const char *line = lineStart(start, hit);
+        const char *text = hit + sizeof(stateNeedle_) - 1;
+        size_t prefix = (size_t)(hit - line);
+        const char *component = hit;
+        hit = text;
+
+        AnalyticsEvent event = {0, (size_t)(line - chunk->data), 0, 0};
+        const char *number;
+        if (prefix >= 7 && memcmp(component - 7, "[Master", 7) == 0 &&
+            end - text > 6 && memcmp(text, "us is ", 6) == 0) {
+            event.kind = EVENT_MASTER_STATE;
+            number = text + 6;
+        } else if (prefix >= 6 && memcmp(component - 6, "[Slave", 6) == 0 &&
+                   end - text > 5 && memcmp(text, "e is ", 5) == 0) {
+            event.kind = EVENT_SLAVE_STATE;
+            number = text + 5;
+        } else {
+            continue;
+        }
+
+        uint32_t state = 0;
+        uint32_t digits = 0;
+        while (number + digits < end && number[digits] >= '0' && number[digits] <= '9' && digits < 3) {
+            state = state * 10u + (uint32_t)(number[digits] - '0');
+            digits++;
+        }
+        uint32_t stateCount = (event.kind == EVENT_MASTER_STATE) ? MASTESR_STATE_MAX : SLAVE_STATE_MAX;
+        event.time = lineTime(line, end, cache);
+        if (digits == 0 || state >= stateCount || event.time < 0) {
+            continue;
+        }
+        event.state = (uint8_t)state;
+        addEvent(&chunk->events, &event);
+    }
+}
+
+/**
+ * @brief Extracts the task restart events of a chunk into a separate list.
+ */
+static void scanRestarts(const AnalyticsChunk *chunk, AnalyticsEvents *restarts, AnalyticsDayCache *cache) {
+    const char *start = chunk->data + chunk->start;
+    const char *end = chunk->data + chunk->end;
+    const char *hit = start;
+
+    while ((hit = memmem(hit, (size_t)(end - hit), restartNeedle_, sizeof(restartNeedle_) - 1)) != NULL) {
+        const char *line = lineStart(start, hit);
+        hit += sizeof(restartNeedle_) - 1;
+        AnalyticsEvent event = {lineTime(line, end, cache), (size_t)(line - chunk->data), EVENT_RESTART, 0};
+        if (event.time >= 0) {
+            addEvent(restarts, &event);
+        }
+    }
+}
+
+/**
+ * @brief Parses one chunk; its events end up in log order.
+ */
+static void parseChunk(AnalyticsChunk *chunk, AnalyticsDayCache *cache) {
+    AnalyticsEvents restarts = {NULL, 0, 0};
+    scanStates(chunk, cache);
+    scanRestarts(chunk, &restarts, cache);
+    if (restarts.count == 0) {
+        return;
+    }
+
+    // Merge the two sorted lists by file position
+    AnalyticsEvents states = chunk->events;
+    AnalyticsEvents merged = {NULL, 0, 0};
+    size_t s = 0;
+    size_t r = 0;
+    while (s < states.count || r < restarts.count) {
+        if (r == restarts.count || (s < states.count && states.items[s].offset < restarts.items[r].offset)) {
+            addEvent(&merged, &states.items[s++]);
+        } else {
+            addEvent(&merged, &restarts.items[r++]);
+        }
+    }
+    free(states.items);
+    free(restarts.items);
+    chunk->events = merged;
+}
+
+static void *parseWorker(void *args) {
+    AnalyticsWork *work = (AnalyticsWork *)args;
+    AnalyticsDayCache cache;
+    memset(&cache, 0, sizeof(cache));
+
+    uint32_t index;
+    while ((index = __atomic_fetch_add(&work->next, 1, __ATOMIC_RELAXED)) < work->count) {
+        parseChunk(&work->chunks[index], &cache);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Maps one input file read-only.
+ *
+ * @return RET_OK on success, RET_ERROR if the file could not be read.
+ */
+static RetVal_t mapFile(const char *path, AnalyticsFile *file) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return RET_ERROR;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+        perror(path);
+        close(fd);
+        return RET_ERROR;
+    }
+
+    file->data = NULL;
+    file->size = 0;
+    file->mappingSize = (size_t)status.st_size;
+    file->compressed = NULL;
+    if (file->mappingSize != 0) {
+        void *data = mmap(NULL, file->mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            perror(path);
+            close(fd);
+            return RET_ERROR;
+        }
+        madvise(data, file->mappingSize, MADV_SEQUENTIAL);
+        file->data = data;
+
+        // Only the active segment has a zero-filled tail; walking back from the end stays cheap
+        file->size = file->mappingSize;
+        while (file->size != 0 && file->data[file->size - 1] == '\0') {
+            file->size--;
+        }
+    }
+    close(fd);
+    return RET_OK;
+}
+
+/**
+ * @brief Maps one log segment, decompressing it if it has been compressed.
+ *
+ * @return RET_OK on success, RET_ERROR if the segment could not be read.
+ */
+static RetVal_t mapSegment(uint32_t sequence, AnalyticsFile *file) {
+    char path[256];
+    logSegmentPath(path, sizeof(path), sequence);
+    if (access(path, R_OK) == 0) {
+        return mapFile(path, file);
+    }
+
+    memset(file, 0, sizeof(*file));
+    file->compressed = malloc(sizeof(*file->compressed));
+    if (file->compressed == NULL || logCompressOpen(sequence, file->compressed) != RET_OK) {
+        free(file->compressed);
+        file->compressed = NULL;
+        return RET_ERROR;
+    }
+    file->data = file->compressed->data;
+    file->size = file->compressed->size;
+    if (logCompressRead(file->compressed, 0, file->size) != RET_OK) {
+        fprintf(stderr, "Corrupted compressed log segment %u\n", sequence);
+        logCompressClose(file->compressed);
+        free(file->compressed);
+        file->compressed = NULL;
+        return RET_ERROR;
+    }
+    return RET_OK;
+}
+
+/**
+ * @brief Splits the files into line-aligned chunks.
+ *
+ * @return Number of chunks written to the array (allocated by the function).
+ */
+static uint32_t splitFiles(const AnalyticsFile *files, uint32_t fileCount, AnalyticsChunk **chunks) {
+    uint32_t capacity = 0;
+    for (uint32_t i = 0; i < fileCount; i++) {
+        capacity += (uint32_t)(files[i].size / ANALYTICS_CHUNK_SIZE) + 1;
+    }
+    *chunks = calloc(capacity, sizeof(**chunks));
+    if (*chunks == NULL) {
+        return 0;
+    }
+
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < fileCount; i++) {
+        size_t start = 0;
+        while (start < files[i].size) {
+            size_t end = start + ANALYTICS_CHUNK_SIZE;
+            if (end >= files[i].size) {
+                end = files[i].size;
+            } else {
+                const char *newline = memchr(files[i].data + end, '\n', files[i].size - end);
+                end = (newline == NULL) ? files[i].size : (size_t)(newline - files[i].data) + 1;
+            }
+            (*chunks)[count].data = files[i].data;
+            (*chunks)[count].start = start;
+            (*chunks)[count].end = end;
+            count++;
+            start = end;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Returns the times of the first and the last timestamped line of the input.
+ */
+static void findSpan(const AnalyticsFile *files, uint32_t fileCount, int64_t *first, int64_t *last) {
+    AnalyticsDayCache cache;
+    memset(&cache, 0, sizeof(cache));
+    *first = -1;
+    *last = -1;
+
+    for (uint32_t i = 0; i < fileCount && *first < 0; i++) {
+        *first = lineTime(files[i].data, files[i].data + files[i].size, &cache);
+    }
+    for (uint32_t i = fileCount; i-- > 0 && *last < 0;) {
+        const char *data = files[i].data;
+        size_t end = files[i].size;
+        while (end != 0 && data[end - 1] == '\n') {
+            end--;
+        }
+        if (end != 0) {
+            *last = lineTime(lineStart(data, data + end), data + end, &cache);
+        }
+    }
+}
+
+static void applyTransition(AnalyticsMachine *machine, uint8_t state, int64_t time) {
+    if (machine->current >= 0) {
+        addDuration(&machine->dwell[machine->current], time - machine->enteredAt);
+        machine->transitions[machine->current][state]++;
+    }
+    machine->entries[state]++;
+    machine->current = state;
+    machine->enteredAt = time;
+}
+
+static void applyEvent(const AnalyticsEvent *event, AnalyticsMachine *master, AnalyticsMachine *slave,
+                       AnalyticsReaction *reaction, uint64_t *restarts) {
+    switch (event->kind) {
+        case EVENT_MASTER_STATE:
+            applyTransition(master, event->state, event->time);
+            if (reaction->pending && event->state == reaction->pendingTarget) {
+                addDuration(&reaction->gaps, event->time - reaction->pendingTime);
+                reaction->pending = 0;
+            }
+            break;
+        case EVENT_SLAVE_STATE: {
+            applyTransition(slave, event->state, event->time);
+            if (reaction->pending) {
+                reaction->unmatched++;
+                reaction->pending = 0;
+            }
+            int32_t target = slaveToMaster_[event->state];
+            if (target >= 0 && target == master->current) {
+                reaction->alreadyThere++;
+            } else if (target >= 0) {
+                reaction->pending = 1;
+                reaction->pendingTime = event->time;
+                reaction->pendingTarget = (uint8_t)target;
+            }
+            break;
+        }
+        default:
+            (*restarts)++;
+            break;
+    }
+}
+
+static int compareDurations(const void *left, const void *right) {
+    int64_t a = *(const int64_t *)left;
+    int64_t b = *(const int64_t *)right;
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief Returns a percentile of sorted durations (nearest rank), in milliseconds.
+ */
+static double percentileMs(const AnalyticsDurations *durations, double percentile) {
+    size_t rank = (size_t)(percentile / 100.0 * (double)durations->count + 0.999999);
+    if (rank == 0) {
+        rank = 1;
+    }
+    return (double)durations->items[rank - 1] / NS_PER_MS;
+}
+
+static void printDurations(const char *name, AnalyticsDurations *durations, uint64_t entries) {
+    if (durations->count == 0) {
+        printf("  %-12s %10llu %12s\n", name, (unsigned long long)entries, "-");
+        return;
+    }
+    qsort(durations->items, durations->count, sizeof(durations->items[0]), compareDurations);
+    double total = 0.0;
+    for (size_t i = 0; i < durations->count; i++) {
+        total += (double)durations->items[i];
+    }
+    printf("  %-12s %10llu %12.1f %10.3f %10.3f %10.3f %10.3f %10.3f\n", name, (unsigned long long)entries,
+           total / NS_PER_MS, percentileMs(durations, 0.0), percentileMs(durations, 50.0),
+           percentileMs(durations, 90.0), percentileMs(durations, 99.0), percentileMs(durations, 100.0));
+}
+
+static void printMachine(AnalyticsMachine *machine, double hours) {
+    printf("\n%s time in state (ms; the state open at the end of the log is not counted)\n", machine->name);
+    printf("  %-12s %10s %12s %10s %10s %10s %10s %10s\n", "state", "entries", "total", "min", "p50", "p90",
+           "p99", "max");
+    for (uint32_t state = 0; state < machine->stateCount; state++) {
+        printDurations(machine->stateNames[state], &machine->dwell[state], machine->entries[state]);
+    }
+
+    printf("\n%s transitions\n", machine->name);
+    printf("  %-26s %10s %10s\n", "transition", "count", "per hour");
+    for (uint32_t from = 0; from < machine->stateCount; from++) {
+        for (uint32_t to = 0; to < machine->stateCount; to++) {
+            uint64_t count = machine->transitions[from][to];
+            if (count != 0) {
+                char name[32];
+                snprintf(name, sizeof(name), "%s -> %s", machine->stateNames[from], machine->stateNames[to]);
+                printf("  %-26s %10llu %10.1f\n", name, (unsigned long long)count,
+                       (hours > 0.0) ? (double)count / hours : 0.0);
+            }
+        }
+    }
+}
+
+static void printUsage(const char *name) {
+    fprintf(stderr, "Usage: %s [-j THREADS] [file...]\n", name);
+}
+
+int main(int argc, char **argv) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t threads = (cores > 0) ? (uint32_t)cores : 1;
+    char **paths = calloc((size_t)argc, sizeof(*paths));
+    uint32_t pathCount = 0;
+    if (paths == NULL) {
+        return 1;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            threads = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (argv[i][0] == '-') {
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            paths[pathCount++] = strdup(argv[i]);
+        }
+    }
+    if (threads == 0) {
+        threads = 1;
+    } else if (threads > ANALYTICS_MAX_THREADS) {
+        threads = ANALYTICS_MAX_THREADS;
+    }
+
+    uint32_t first = 0;
+    uint32_t last = 0;
+    uint32_t segmentCount = 0;
+    if (pathCount == 0 && logSegmentFind(&first, &last) == RET_OK) {
+        segmentCount = last - first + 1;
+    } else if (pathCount == 0) {
+        paths[pathCount++] = strdup(LOG_FILE);
+    }
+
+    uint64_t startNs = logTimestampMonotonicNs();
+    AnalyticsFile *files = calloc((size_t)pathCount + segmentCount, sizeof(*files));
+    uint32_t fileCount = 0;
+    size_t totalBytes = 0;
+    for (uint32_t i = 0; files != NULL && i < segmentCount; i++) {
+        // Expired segments may be missing from the range
+        if (mapSegment(first + i, &files[fileCount]) == RET_OK) {
+            totalBytes += files[fileCount].size;
+            fileCount++;
+        }
+    }
+    for (uint32_t i = 0; files != NULL && i < pathCount; i++) {
+        if (mapFile(paths[i], &files[fileCount]) == RET_OK) {
+            totalBytes += files[fileCount].size;
+            fileCount++;
+        }
+    }
+    if (fileCount == 0) {
+        fprintf(stderr, "No log files to analyze\n");
+        return 1;
+    }
+
+    AnalyticsChunk *chunks = NULL;
+    AnalyticsWork work = {NULL, 0, 0};
+    work.count = splitFiles(files, fileCount, &chunks);
+    work.chunks = chunks;
+    if (threads > work.count) {
+        threads = (work.count == 0) ? 1 : work.count;
+    }
+
+    pthread_t workers[ANALYTICS_MAX_THREADS];
+    uint32_t started = 0;
+    for (uint32_t i = 1; i < threads; i++) {
+        if (pthread_create(&workers[started], NULL, parseWorker, &work) == 0) {
+            started++;
+        }
+    }
+    parseWorker(&work);
+    for (uint32_t i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+
+    AnalyticsMachine master = {"Master", masterStateNames_, MASTESR_STATE_MAX, -1, 0, {0}, {{0}}, {{0}}};
+    AnalyticsMachine slave = {"Slave", slaveStateNames_, SLAVE_STATE_MAX, -1, 0, {0}, {{0}}, {{0}}};
+    AnalyticsReaction reaction;
+    memset(&reaction, 0, sizeof(reaction));
+    uint64_t restarts = 0;
+    uint64_t events = 0;
+    for (uint32_t i = 0; i < work.count; i++) {
+        for (size_t e = 0; e < chunks[i].events.count; e++) {
+            applyEvent(&chunks[i].events.items[e], &master, &slave, &reaction, &restarts);
+        }
+        events += chunks[i].events.count;
+        free(chunks[i].events.items);
+    }
+
+    int64_t spanFirst;
+    int64_t spanLast;
+    findSpan(files, fileCount, &spanFirst, &spanLast);
+    double seconds = (spanFirst >= 0 && spanLast > spanFirst) ? (double)(spanLast - spanFirst) / NS_PER_SECOND : 0.0;
+    double elapsed = (double)(logTimestampMonotonicNs() - startNs) / NS_PER_SECOND;
+
+    printf("Parsed %u file(s), %.1f MB, %u chunk(s) with %u thread(s) in %.3f s (%.0f MB/s)\n",
+           (unsigned)fileCount, (double)totalBytes / 1e6, (unsigned)work.count, (unsigned)threads, elapsed,
+           (elapsed > 0.0) ? (double)totalBytes / 1e6 / elapsed : 0.0);
+    printf("Log span %.1f s, %llu events\n", seconds, (unsigned long long)events);
+
+    printMachine(&slave, seconds / 3600.0);
+    printMachine(&master, seconds / 3600.0);
+
+    printf("\nTask restarts (Restarting all tasks): %llu (%.1f per hour)\n", (unsigned long long)restarts,
+           (seconds > 0.0) ? (double)restarts * 3600.0 / seconds : 0.0);
+
+    printf("\nSlave -> master transition gap (ms)\n");
+    printf("  %-12s %10s %12s %10s %10s %10s %10s %10s\n", "", "matched", "total", "min", "p50", "p90", "p99",
+           "max");
+    printDurations("gap", &reaction.gaps, reaction.gaps.count);
+    printf("  %llu slave transition(s) superseded before the master followed, %llu with the master already "
+           "in the matching state, %u pending at the end of the log\n", (unsigned long long)reaction.unmatched,
+           (unsigned long long)reaction.alreadyThere, (unsigned)reaction.pending);
+
+    for (uint32_t state = 0; state < SLAVE_STATE_MAX; state++) {
+        free(master.dwell[state].items);
+        free(slave.dwell[state].items);
+    }
+    free(reaction.gaps.items);
+    free(chunks);
+    for (uint32_t i = 0; i < fileCount; i++) {
+        if (files[i].compressed != NULL) {
+            logCompressClose(files[i].compressed);
+            free(files[i].compressed);
+        } else if (files[i].mappingSize != 0) {
+            munmap((void *)files[i].data, files[i].mappingSize);
+        }
+    }
+    free(files);
+    for (uint32_t i = 0; i < pathCount; i++) {
+        free(paths[i]);
+    }
+    free(paths);
+    return 0;
+}
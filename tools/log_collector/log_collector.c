@@ -0,0 +1,137 @@
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "types.h"
+#include "logger_cfg.h"
+
+/**
+ * @file log_collector.c
+ * @brief Host-side collector for the streamed log (LOG_STREAM_ENABLED).
+ *
+ * Listens on the Unix domain socket the logger streams to and appends the
+ * received records to a file, or to stdout. Text records are complete log
+ * lines; binary records can be decoded with log_decoder (every connection
+ * starts with the session and definition records). Serves one logger at a
+ * time and waits for the next connection when it goes away.
+ *
+ * Usage: log_collector [-s SOCKET] [-o FILE]
+ * The default socket is LOG_STREAM_SOCKET_PATH.
+ */
+
+#define COLLECTOR_BUFFER_SIZE (64 * 1024)
+
+static volatile sig_atomic_t stop_ = 0;
+
+static void handleSignal(int signal) {
+    (void)signal;
+    stop_ = 1;
+}
+
+/**
+ * @brief Creates the listening socket, replacing a stale socket file.
+ *
+ * @return Socket descriptor, or -1 on error.
+ */
+static int listenOn(const char *path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("Failed to create socket");
+        return -1;
+    }
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+    unlink(path);
+
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(fd, 1) != 0) {
+        perror("Failed to listen on socket");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Copies everything received on one connection to the output.
+ *
+ * @return RET_OK when the logger closed the connection, RET_ERROR on an output error.
+ */
+static RetVal_t collect(int connection, FILE *output) {
+    static char buffer[COLLECTOR_BUFFER_SIZE];
+    ssize_t received;
+
+    while ((received = read(connection, buffer, sizeof(buffer))) != 0) {
+        if (received < 0) {
+            if (errno == EINTR && !stop_) {
+                continue;
+            }
+            break;
+        }
+        if (fwrite(buffer, 1, (size_t)received, output) != (size_t)received) {
+            perror("Failed to write output");
+            return RET_ERROR;
+        }
+        fflush(output);
+    }
+    return RET_OK;
+}
+
+int main(int argc, char **argv) {
+    const char *socketPath = LOG_STREAM_SOCKET_PATH;
+    const char *outputPath = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [-s SOCKET] [-o FILE]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    FILE *output = stdout;
+    if (outputPath != NULL && (output = fopen(outputPath, "ab")) == NULL) {
+        perror("Failed to open output file");
+        return 1;
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handleSignal;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    int listener = listenOn(socketPath);
+    if (listener < 0) {
+        return 1;
+    }
+
+    RetVal_t ret = RET_OK;
+    while (!stop_ && ret == RET_OK) {
+        int connection = accept(listener, NULL, NULL);
+        if (connection < 0) {
+            if (errno != EINTR) {
+                perror("Failed to accept connection");
+                ret = RET_ERROR;
+            }
+            continue;
+        }
+        ret = collect(connection, output);
+        close(connection);
+    }
+
+    close(listener);
+    unlink(socketPath);
+    if (output != stdout) {
+        fclose(output);
+    }
+    return (ret == RET_OK) ? 0 : 1;
+}
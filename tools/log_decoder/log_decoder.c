@@ -0,0 +1,81 @@
+#include <stdio.h>
+#include <string.h>
+#include "logger.h"
+#include "logger_binary.h"
+#include "logger_cfg.h"
+
+/**
+ * @file log_decoder.c
+ * @brief Host-side decoder for binary log files.
+ *
+ * Turns a binary log written with LOG_BINARY_ENABLED back into the
+ * "[time] [LEVEL] [component] message" text produced by the text logger.
+ *
+ * Usage: log_decoder [-l DEBUG|INFO|WARN|ERROR] [file...]
+ * Files are decoded in the given order (e.g. all log segments). The default
+ * input file is LOG_BINARY_FILE; the text is written to stdout.
+ */
+
+/**
+ * @brief Parses a level name given on the command line.
+ *
+ * @return RET_OK if the name is a known level, RET_ERROR otherwise.
+ */
+static RetVal_t parseLevel(const char *name, LogLevel *level) {
+    static const char *names[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+    for (uint32_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (strcmp(name, names[i]) == 0) {
+            *level = (LogLevel)i;
+            return RET_OK;
+        }
+    }
+    return RET_ERROR;
+}
+
+/**
+ * @brief Decodes one binary log file to stdout.
+ *
+ * @return RET_OK on success, RET_ERROR if the file could not be read.
+ */
+static RetVal_t decodeFile(const char *path, LogLevel level) {
+    FILE *input = fopen(path, "rb");
+    if (input == NULL) {
+        perror("Failed to open binary log file");
+        return RET_ERROR;
+    }
+
+    RetVal_t ret = logBinaryDecode(input, stdout, level);
+    fclose(input);
+    return ret;
+}
+
+int main(int argc, char **argv) {
+    LogLevel level = LOG_LEVEL_DEBUG;
+    const char *paths[argc];
+    int pathCount = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+            if (parseLevel(argv[++i], &level) != RET_OK) {
+                fprintf(stderr, "Unknown log level: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "Usage: %s [-l DEBUG|INFO|WARN|ERROR] [file...]\n", argv[0]);
+            return 1;
+        } else {
+            paths[pathCount++] = argv[i];
+        }
+    }
+    if (pathCount == 0) {
+        paths[pathCount++] = LOG_BINARY_FILE;
+    }
+
+    RetVal_t ret = RET_OK;
+    for (int i = 0; i < pathCount; i++) {
+        if (decodeFile(paths[i], level) != RET_OK) {
+            ret = RET_ERROR;
+        }
+    }
+    return (ret == RET_OK) ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "logger.h"
+#include "logger_query.h"
+
+/**
+ * @file log_query.c
+ * @brief Host-side query tool for the text log segments.
+ *
+ * Prints the records of the log segments in the current directory that match
+ * the given filters, using the segment indexes to skip unrelated blocks.
+ *
+ * Usage: log_query [-l LEVEL] [-c COMPONENT] [-s FROM] [-u UNTIL] [-j THREADS] [-f]
+ *   -l  Minimum level (DEBUG, INFO, WARN, ERROR).
+ *   -c  Component name.
+ *   -s  Earliest record time ("YYYY-MM-DD HH:MM:SS" local time, or seconds since the epoch).
+ *   -u  Latest record time (same formats as -s).
+ *   -j  Number of scanning threads (default 1).
+ *   -f  Follow the log and print new matching records as they are written.
+ */
+
+/**
+ * @brief Parses a level name given on the command line.
+ *
+ * @return RET_OK if the name is a known level, RET_ERROR otherwise.
+ */
+static RetVal_t parseLevel(const char *name, LogLevel *level) {
+    static const char *names[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+    for (uint32_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (strcmp(name, names[i]) == 0) {
+            *level = (LogLevel)i;
+            return RET_OK;
+        }
+    }
+    return RET_ERROR;
+}
+
+/**
+ * @brief Parses a time given on the command line.
+ *
+ * @return RET_OK if the time could be parsed, RET_ERROR otherwise.
+ */
+static RetVal_t parseTime(const char *text, int64_t *time) {
+    struct tm local;
+    memset(&local, 0, sizeof(local));
+    const char *end = strptime(text, "%Y-%m-%d %H:%M:%S", &local);
+    if (end != NULL && *end == '\0') {
+        local.tm_isdst = -1;
+        *time = (int64_t)mktime(&local);
+        return RET_OK;
+    }
+
+    char *numberEnd = NULL;
+    long long seconds = strtoll(text, &numberEnd, 10);
+    if (numberEnd == text || *numberEnd != '\0' || seconds <= 0) {
+        return RET_ERROR;
+    }
+    *time = (int64_t)seconds;
+    return RET_OK;
+}
+
+static void printUsage(const char *name) {
+    fprintf(stderr, "Usage: %s [-l DEBUG|INFO|WARN|ERROR] [-c COMPONENT] [-s FROM] [-u UNTIL] "
+                    "[-j THREADS] [-f]\n", name);
+}
+
+int main(int argc, char **argv) {
+    LogQuery query = {LOG_LEVEL_DEBUG, NULL, 0, 0};
+    uint32_t threads = 1;
+    uint8_t follow = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(argv[i], "-f") == 0) {
+            follow = 1;
+        } else if (value == NULL) {
+            printUsage(argv[0]);
+            return 1;
+        } else if (strcmp(argv[i], "-l") == 0) {
+            if (parseLevel(value, &query.level) != RET_OK) {
+                fprintf(stderr, "Unknown log level: %s\n", value);
+                return 1;
+            }
+            i++;
+        } else if (strcmp(argv[i], "-c") == 0) {
+            query.component = value;
+            i++;
+        } else if (strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "-u") == 0) {
+            int64_t *bound = (argv[i][1] == 's') ? &query.from : &query.until;
+            if (parseTime(value, bound) != RET_OK) {
+                fprintf(stderr, "Invalid time: %s\n", value);
+                return 1;
+            }
+            i++;
+        } else if (strcmp(argv[i], "-j") == 0) {
+            threads = (uint32_t)strtoul(value, NULL, 10);
+            i++;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    RetVal_t ret = follow ? logQueryFollow(&query, stdout) : logQueryRun(&query, threads, stdout);
+    return (ret == RET_OK) ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "types.h"
+#include "state_mashine_types.h"
+#include "logger_status.h"
+#include "logger_timestamp.h"
+#include "logger_cfg.h"
+
+/**
+ * @file status_monitor.c
+ * @brief Host-side reader of the shared-memory status page.
+ *
+ * Maps the status page read-only and prints a snapshot: the master and slave
+ * states with the time spent in them and their transition counters, and for
+ * every task its start count, heartbeats and the age of its last heartbeat.
+ * Reading takes no lock and makes no system call, so it can run as often as
+ * needed without disturbing the application.
+ *
+ * Usage: status_monitor [-i INTERVAL_MS] [-n COUNT] [file]
+ * The default file is LOG_STATUS_FILE. With -i the snapshot is printed every
+ * INTERVAL_MS, COUNT times (forever when COUNT is 0, the default).
+ */
+
+#define NS_PER_MS 1000000.0
+
+static const char *masterStateNames_[MASTESR_STATE_MAX] = {"IDLE", "PROCESSING", "ERROR"};
+static const char *slaveStateNames_[SLAVE_STATE_MAX] = {"SLEEP", "ACTIVE", "FAULT", "RESET"};
+
+/**
+ * @brief Prints one state section.
+ *
+ * @param name Name of the state machine.
+ * @param stateNames Names of the states, indexed by state.
+ * @param stateCount Number of states.
+ * @param state Current state, or stateCount if the writer does not run this state machine.
+ * @param transitions Number of state changes.
+ * @param counts First entry of the [from][to] counters.
+ * @param enteredNs Time the current state was entered.
+ * @param nowNs Current time.
+ */
+static void printMachine(const char *name, const char *const *stateNames, uint32_t stateCount, uint32_t state,
+                         uint32_t transitions, const uint32_t *counts, uint64_t enteredNs, uint64_t nowNs) {
+    if (state >= stateCount) {
+        printf("%s: not running\n", name);
+        return;
+    }
+    printf("%s: %s for %.1f ms, %u transitions\n", name, stateNames[state],
+           (double)(nowNs - enteredNs) / NS_PER_MS, transitions);
+    for (uint32_t from = 0; from < stateCount; from++) {
+        for (uint32_t to = 0; to < stateCount; to++) {
+            if (counts[from * stateCount + to] != 0) {
+                printf("  %s -> %s: %u\n", stateNames[from], stateNames[to], counts[from * stateCount + to]);
+            }
+        }
+    }
+}
+
+static void printSnapshot(const LogStatusSnapshot *snapshot) {
+    uint64_t nowNs = logTimestampMonotonicNs();
+
+    printf("Status of process %u\n", snapshot->pid);
+    printMachine("Master", masterStateNames_, MASTESR_STATE_MAX, snapshot->master.state,
+                 snapshot->master.transitions, &snapshot->master.counts[0][0], snapshot->master.enteredNs, nowNs);
+    printMachine("Slave", slaveStateNames_, SLAVE_STATE_MAX, snapshot->slave.state, snapshot->slave.transitions,
+                 &snapshot->slave.counts[0][0], snapshot->slave.enteredNs, nowNs);
+
+    printf("%-16s %8s %12s %16s\n", "Task", "Starts", "Heartbeats", "Last beat (ms)");
+    for (uint32_t i = 0; i < snapshot->taskCount; i++) {
+        const LogStatusTask *task = &snapshot->tasks[i];
+        if (task->heartbeats == 0) {
+            printf("%-16s %8u %12u %16s\n", task->name, task->starts, task->heartbeats, "-");
+        } else {
+            printf("%-16s %8u %12u %16.1f\n", task->name, task->starts, task->heartbeats,
+                   (double)(nowNs - task->lastHeartbeatNs) / NS_PER_MS);
+        }
+    }
+}
+
+static void printUsage(const char *name) {
+    fprintf(stderr, "Usage: %s [-i INTERVAL_MS] [-n COUNT] [file]\n", name);
+}
+
+int main(int argc, char **argv) {
+    const char *path = LOG_STATUS_FILE;
+    uint32_t intervalMs = 0;
+    uint32_t count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+            intervalMs = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            count = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (argv[i][0] == '-') {
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    const LogStatusPage *page = NULL;
+    if (logStatusOpenView(path, &page) != RET_OK) {
+        fprintf(stderr, "No status page at %s\n", path);
+        return 1;
+    }
+
+    LogStatusSnapshot snapshot;
+    struct timespec interval = {(time_t)(intervalMs / 1000), (long)(intervalMs % 1000) * 1000000L};
+    for (uint32_t printed = 0; intervalMs == 0 ? printed < 1 : (count == 0 || printed < count); printed++) {
+        if (printed != 0) {
+            nanosleep(&interval, NULL);
+            printf("\n");
+        }
+        if (logStatusRead(page, &snapshot) != RET_OK) {
+            fprintf(stderr, "The status page is being rewritten continuously\n");
+            logStatusCloseView(page);
+            return 1;
+        }
+        printSnapshot(&snapshot);
+        fflush(stdout);
+    }
+
+    logStatusCloseView(page);
+    return 0;
+}
@@ -0,0 +1,193 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "types.h"
+#include "state_mashine_types.h"
+#include "logger_trace.h"
+#include "logger_cfg.h"
+
+/**
+ * @file trace_report.c
+ * @brief Host-side exporter of the end-to-end traces.
+ *
+ * Reads the span rings of one or more trace files, so the spans of a master
+ * and a slave running in separate processes are joined by trace id. For every
+ * hop it prints the p50/p99/p999 latency since the previous hop the trace
+ * passed, and the same for the whole trace, from the TCP server to the master
+ * transition, in total and per master state reached.
+ *
+ * Usage: trace_report [file...]
+ * Without files LOG_TRACE_FILE and its ".master" and ".slave" variants are
+ * read, as far as they exist.
+ */
+
+#define NS_PER_US 1000.0
+
+/**
+ * @brief Maximum number of trace files read.
+ */
+#define MAX_TRACE_FILES 8
+
+static const char *hopNames_[LOG_TRACE_HOP_MAX] = {
+    "TCP received", "Slave received", "Slave transition", "Slave sent", "Master received", "Master transition",
+};
+static const char *masterStateNames_[MASTESR_STATE_MAX] = {"IDLE", "PROCESSING", "ERROR"};
+
+static int compareSpans(const void *a, const void *b) {
+    const LogTraceSpan *x = (const LogTraceSpan *)a;
+    const LogTraceSpan *y = (const LogTraceSpan *)b;
+    if (x->traceId != y->traceId) {
+        return (x->traceId > y->traceId) - (x->traceId < y->traceId);
+    }
+    return (x->timeNs > y->timeNs) - (x->timeNs < y->timeNs);
+}
+
+static int compareLatency(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Returns the nearest-rank percentile of sorted latencies.
+ */
+static double percentileUs(const uint64_t *sorted, uint32_t count, double percentile) {
+    uint32_t rank = (uint32_t)(percentile * count + 0.999999);
+    return (double)sorted[(rank == 0 ? 1 : rank) - 1] / NS_PER_US;
+}
+
+/**
+ * @brief Sorts latencies and prints one line of the report.
+ */
+static void printLatencies(const char *name, uint64_t *latencies, uint32_t count) {
+    if (count == 0) {
+        printf("%-28s %8u %12s %12s %12s\n", name, count, "-", "-", "-");
+        return;
+    }
+    qsort(latencies, count, sizeof(latencies[0]), compareLatency);
+    printf("%-28s %8u %12.1f %12.1f %12.1f\n", name, count, percentileUs(latencies, count, 0.50),
+           percentileUs(latencies, count, 0.99), percentileUs(latencies, count, 0.999));
+}
+
+/**
+ * @brief Appends the spans of a trace file.
+ *
+ * @return RET_OK on success, RET_ERROR if the file is not a trace file.
+ */
+static RetVal_t readFile(const char *path, LogTraceSpan *spans, uint32_t capacity, uint32_t *count) {
+    const LogTracePage *page = NULL;
+    uint32_t read = 0;
+
+    if (logTraceOpenView(path, &page) != RET_OK) {
+        return RET_ERROR;
+    }
+    logTraceRead(page, &spans[*count], capacity - *count, &read);
+    logTraceCloseView(page);
+    *count += read;
+    return RET_OK;
+}
+
+int main(int argc, char **argv) {
+    static const char *defaultFiles[] = {LOG_TRACE_FILE, LOG_TRACE_FILE ".master", LOG_TRACE_FILE ".slave"};
+    const char **files = defaultFiles;
+    uint32_t fileCount = sizeof(defaultFiles) / sizeof(defaultFiles[0]);
+    uint32_t filesRead = 0;
+
+    if (argc > 1) {
+        if (argv[1][0] == '-' || argc - 1 > MAX_TRACE_FILES) {
+            fprintf(stderr, "Usage: %s [file...]\n", argv[0]);
+            return 1;
+        }
+        files = (const char **)&argv[1];
+        fileCount = (uint32_t)(argc - 1);
+    }
+
+    uint32_t capacity = fileCount * LOG_TRACE_SPANS;
+    uint32_t count = 0;
+    LogTraceSpan *spans = malloc(capacity * sizeof(*spans));
+    // One latency per hop and per end-to-end view, at most one per trace
+    uint64_t *latencies = malloc((size_t)(LOG_TRACE_HOP_MAX + 1 + MASTESR_STATE_MAX) * capacity * sizeof(uint64_t));
+    if (spans == NULL || latencies == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    for (uint32_t i = 0; i < fileCount; i++) {
+        if (readFile(files[i], spans, capacity, &count) == RET_OK) {
+            filesRead++;
+        } else if (argc > 1) {
+            fprintf(stderr, "No trace file at %s\n", files[i]);
+        }
+    }
+    if (filesRead == 0) {
+        fprintf(stderr, "No trace file found\n");
+        return 1;
+    }
+    qsort(spans, count, sizeof(spans[0]), compareSpans);
+
+    uint64_t *hopLatencies[LOG_TRACE_HOP_MAX];
+    uint32_t hopCounts[LOG_TRACE_HOP_MAX] = {0};
+    uint64_t *endToEnd = &latencies[(size_t)LOG_TRACE_HOP_MAX * capacity];
+    uint64_t *perState[MASTESR_STATE_MAX];
+    uint32_t endToEndCount = 0;
+    uint32_t perStateCounts[MASTESR_STATE_MAX] = {0};
+    uint32_t traces = 0;
+    for (uint32_t hop = 0; hop < LOG_TRACE_HOP_MAX; hop++) {
+        hopLatencies[hop] = &latencies[(size_t)hop * capacity];
+    }
+    for (uint32_t state = 0; state < MASTESR_STATE_MAX; state++) {
+        perState[state] = &latencies[(size_t)(LOG_TRACE_HOP_MAX + 1 + state) * capacity];
+    }
+
+    for (uint32_t first = 0; first < count;) {
+        uint64_t hopNs[LOG_TRACE_HOP_MAX] = {0};
+        uint32_t hopValues[LOG_TRACE_HOP_MAX] = {0};
+        uint32_t last = first;
+
+        // Spans are sorted by time within a trace, so the first span of a hop is its earliest
+        for (; last < count && spans[last].traceId == spans[first].traceId; last++) {
+            if (hopNs[spans[last].hop] == 0) {
+                hopNs[spans[last].hop] = spans[last].timeNs;
+                hopValues[spans[last].hop] = spans[last].value;
+            }
+        }
+        first = last;
+
+        // A trace whose first span was overwritten has no reference time
+        if (hopNs[LOG_TRACE_HOP_TCP_RECEIVED] == 0) {
+            continue;
+        }
+        traces++;
+        uint64_t previousNs = hopNs[LOG_TRACE_HOP_TCP_RECEIVED];
+        for (uint32_t hop = LOG_TRACE_HOP_TCP_RECEIVED + 1; hop < LOG_TRACE_HOP_MAX; hop++) {
+            if (hopNs[hop] != 0) {
+                hopLatencies[hop][hopCounts[hop]++] = hopNs[hop] - previousNs;
+                previousNs = hopNs[hop];
+            }
+        }
+        if (hopNs[LOG_TRACE_HOP_MASTER_TRANSITION] != 0) {
+            uint64_t total = hopNs[LOG_TRACE_HOP_MASTER_TRANSITION] - hopNs[LOG_TRACE_HOP_TCP_RECEIVED];
+            uint32_t state = hopValues[LOG_TRACE_HOP_MASTER_TRANSITION];
+            endToEnd[endToEndCount++] = total;
+            if (state < MASTESR_STATE_MAX) {
+                perState[state][perStateCounts[state]++] = total;
+            }
+        }
+    }
+
+    printf("%u spans from %u file(s), %u traces, %u reached a master transition\n", count, filesRead, traces,
+           endToEndCount);
+    printf("%-28s %8s %12s %12s %12s\n", "Hop (since previous hop)", "Count", "p50 (us)", "p99 (us)", "p999 (us)");
+    for (uint32_t hop = LOG_TRACE_HOP_TCP_RECEIVED + 1; hop < LOG_TRACE_HOP_MAX; hop++) {
+        printLatencies(hopNames_[hop], hopLatencies[hop], hopCounts[hop]);
+    }
+    printLatencies("End to end", endToEnd, endToEndCount);
+    for (uint32_t state = 0; state < MASTESR_STATE_MAX; state++) {
+        char name[32];
+        snprintf(name, sizeof(name), "  to %s", masterStateNames_[state]);
+        printLatencies(name, perState[state], perStateCounts[state]);
+    }
+
+    free(latencies);
+    free(spans);
+    return 0;
+}
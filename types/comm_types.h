@@ -0,0 +1,137 @@
+#ifndef COMM_TYPES_H
+#define COMM_TYPES_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file comm_types.h
+ * @brief Message envelope exchanged between the master and the slave.
+ *
+ * The master and the slave talk over two directional channels (master to slave
+ * and slave to master). Every message carries its type, the id of the sender
+ * and a per-sender sequence number, so a receiver can reject anything that was
+ * not addressed to it.
+ *
+ * States are exchanged as versioned deltas (comm_sync.h): a state message is
+ * one (slave id, state) pair of the sender, stamped with the version of the
+ * change and the version of the change sent before it.
+ */
+
+/**
+ * @brief Enumeration of message types.
+ */
+typedef enum {
+    COMM_MSG_MASTER_STATE, ///< Payload is a MasterStates value.
+    COMM_MSG_SLAVE_STATE,  ///< Payload is a SlaveStates value.
+    COMM_MSG_SYNC_REQUEST, ///< Asks the peer for every change of its states after version.
+    COMM_MSG_MAX           ///< Maximum message type value.
+} CommMsgType;
+
+/**
+ * @brief Enumeration of message sources.
+ */
+typedef enum {
+    COMM_SOURCE_MASTER, ///< Sent by the master.
+    COMM_SOURCE_SLAVE,  ///< Sent by the slave.
+    COMM_SOURCE_MAX     ///< Maximum source id value.
+} CommSourceId;
+
+/**
+ * @brief Message envelope.
+ *
+ * - type: Message type (CommMsgType).
+ * - sourceId: Sender (CommSourceId), set by the sending comm module.
+ * - sequence: Per-sender sequence number, set by the sending comm module.
+ * - payload: Message value, e.g. the state.
+ * - traceId: Trace of the client input that caused the value, 0 if untraced (see logger_trace.h).
+ * - slaveId: Slave the state belongs to; 0 for the master state.
+ * - version: Version of the state change; for COMM_MSG_SYNC_REQUEST, the version the receiver has.
+ * - baseVersion: Version of the change the sender sent before this one, 0 if the sender starts over.
+ */
+typedef struct {
+    uint8_t type;
+    uint8_t sourceId;
+    uint16_t sequence;
+    int32_t payload;
+    uint32_t traceId;
+    uint32_t slaveId;
+    uint32_t version;
+    uint32_t baseVersion;
+} CommMessage;
+
+/**
+ * @brief What a send does when its FIFO channel is full.
+ */
+typedef enum {
+    COMM_OVERFLOW_BLOCK,       ///< Wait for space up to a deadline, then fail.
+    COMM_OVERFLOW_DROP_OLDEST, ///< Discard the oldest queued message to make room.
+    COMM_OVERFLOW_COALESCE,    ///< Hold the newest message back, replacing the one held before.
+    COMM_OVERFLOW_MAX          ///< Maximum policy value.
+} CommOverflowPolicy;
+
+/**
+ * @brief Number of times each overflow policy fired on a channel.
+ *
+ * - deadlineExpired: Blocking sends that failed because the deadline passed.
+ * - droppedOldest: Queued messages discarded to make room for a newer one.
+ * - coalesced: Messages held back because the channel was full; each one
+ *   replaces the message held before it.
+ */
+typedef struct {
+    uint32_t deadlineExpired;
+    uint32_t droppedOldest;
+    uint32_t coalesced;
+} CommOverflowStats;
+
+/**
+ * @brief Pooled message block passed by pointer, see comm_pool.h.
+ */
+typedef struct CommBlock CommBlock;
+
+/**
+ * @brief Lock-free ring channel of CommMessage, see comm_ring.h.
+ */
+typedef struct CommRing CommRing;
+
+/**
+ * @brief End of a master-slave link, see comm_transport.h.
+ */
+typedef struct CommTransport CommTransport;
+
+/**
+ * @brief Versioned table of the states a side holds, see comm_sync.h.
+ */
+typedef struct CommSyncHolder CommSyncHolder;
+
+/**
+ * @brief Fan-out pipeline of variable-length payloads, see comm_pipeline.h.
+ */
+typedef struct CommPipeline CommPipeline;
+
+/**
+ * @brief Consumers of the TCP payload pipeline.
+ */
+typedef enum {
+    COMM_PAYLOAD_CONSUMER_SLAVE,  ///< Slave payload handler.
+    COMM_PAYLOAD_CONSUMER_MASTER, ///< Master telemetry handler.
+    COMM_PAYLOAD_CONSUMER_MAX     ///< Number of consumers.
+} CommPayloadConsumer;
+
+/**
+ * @brief Header in front of every payload of the TCP payload pipeline.
+ *
+ * - traceId: Trace of the client message, 0 if untraced (see logger_trace.h).
+ */
+typedef struct {
+    uint32_t traceId;
+} CommPayloadHeader;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COMM_TYPES_H